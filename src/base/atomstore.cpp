@@ -0,0 +1,197 @@
+/*
+	*** Packed atom data store
+	*** src/base/atomstore.cpp
+	Copyright T. Youngs 2007-2017
+
+	This file is part of Aten.
+
+	Aten is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Aten is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Aten.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "base/atomstore.h"
+#include "model/model.h"
+
+ATEN_USING_NAMESPACE
+
+// Constructor
+AtomStore::AtomStore()
+{
+	// Private variables
+	nAtoms_ = 0;
+	sourceModel_ = NULL;
+	structurePoint_ = -1;
+	coordinatesPoint_ = -1;
+	stylePoint_ = -1;
+}
+
+/*
+ * Data
+ */
+
+// Return number of atoms in the store
+int AtomStore::nAtoms() const
+{
+	return nAtoms_;
+}
+
+// Return x coordinate array
+double* AtomStore::x()
+{
+	return x_.array();
+}
+
+// Return y coordinate array
+double* AtomStore::y()
+{
+	return y_.array();
+}
+
+// Return z coordinate array
+double* AtomStore::z()
+{
+	return z_.array();
+}
+
+// Return coordinates of specified atom
+Vec3<double> AtomStore::r(int i) const
+{
+	return Vec3<double>(x_.value(i), y_.value(i), z_.value(i));
+}
+
+// Return charge array
+double* AtomStore::charges()
+{
+	return charges_.array();
+}
+
+// Return element array
+int* AtomStore::elements()
+{
+	return elements_.array();
+}
+
+// Return type index array
+int* AtomStore::typeIndices()
+{
+	return typeIndices_.array();
+}
+
+// Return number of distinct forcefield types
+int AtomStore::nTypes() const
+{
+	return types_.nItems();
+}
+
+// Return forcefield type with specified index
+ForcefieldAtom* AtomStore::type(int index) const
+{
+	return types_.value(index);
+}
+
+// Return fixed position array
+bool* AtomStore::fixed()
+{
+	return fixed_.array();
+}
+
+/*
+ * Synchronisation
+ */
+
+// Copy per-atom data from source model
+void AtomStore::copyAtoms(Model* sourceModel)
+{
+	nAtoms_ = sourceModel->nAtoms();
+	x_.createEmpty(nAtoms_, 0.0);
+	y_.createEmpty(nAtoms_, 0.0);
+	z_.createEmpty(nAtoms_, 0.0);
+	charges_.createEmpty(nAtoms_, 0.0);
+	elements_.createEmpty(nAtoms_, 0);
+	typeIndices_.createEmpty(nAtoms_, -1);
+	fixed_.createEmpty(nAtoms_, false);
+	types_.clear();
+
+	// Atoms of the same type tend to be adjacent, so check the last type found before searching the list
+	int n = 0, t, lastIndex = -1;
+	ForcefieldAtom* ffa;
+	for (Atom* i = sourceModel->atoms(); i != NULL; i = i->next)
+	{
+		x_[n] = i->r().x;
+		y_[n] = i->r().y;
+		z_[n] = i->r().z;
+		charges_[n] = i->charge();
+		elements_[n] = i->element();
+		fixed_[n] = i->isPositionFixed();
+		ffa = i->type();
+		if (ffa != NULL)
+		{
+			if ((lastIndex == -1) || (types_[lastIndex] != ffa))
+			{
+				for (t=0; t<types_.nItems(); ++t) if (types_[t] == ffa) break;
+				if (t == types_.nItems()) types_.add(ffa);
+				lastIndex = t;
+			}
+			typeIndices_[n] = lastIndex;
+		}
+		++n;
+	}
+}
+
+// Copy coordinates from source model
+void AtomStore::copyCoordinates(Model* sourceModel)
+{
+	int n = 0;
+	for (Atom* i = sourceModel->atoms(); i != NULL; i = i->next)
+	{
+		x_[n] = i->r().x;
+		y_[n] = i->r().y;
+		z_[n] = i->r().z;
+		++n;
+	}
+}
+
+// Update store from the supplied model if its structure, coordinates, or style have changed (or if forced)
+void AtomStore::update(Model* sourceModel, bool force)
+{
+	int structure = sourceModel->revision(Log::Structure), coordinates = sourceModel->revision(Log::Coordinates), style = sourceModel->revision(Log::Style);
+	if ((!force) && (sourceModel == sourceModel_) && (nAtoms_ == sourceModel->nAtoms()) && (structure == structurePoint_) && (coordinates == coordinatesPoint_) && (style == stylePoint_)) return;
+
+	// Charges and types are changed alongside coordinate and style logs as well as structural ones, so copy everything
+	copyAtoms(sourceModel);
+	sourceModel_ = sourceModel;
+	structurePoint_ = structure;
+	coordinatesPoint_ = coordinates;
+	stylePoint_ = style;
+}
+
+// Update coordinates only from the supplied model, regardless of its log revisions
+void AtomStore::updateCoordinates(Model* sourceModel)
+{
+	// If the structure has changed, a full update is required
+	if ((sourceModel != sourceModel_) || (nAtoms_ != sourceModel->nAtoms()) || (structurePoint_ != sourceModel->revision(Log::Structure))) update(sourceModel, true);
+	else
+	{
+		copyCoordinates(sourceModel);
+		coordinatesPoint_ = sourceModel->revision(Log::Coordinates);
+	}
+}
+
+// Invalidate store, forcing a full update on next call to update()
+void AtomStore::invalidate()
+{
+	sourceModel_ = NULL;
+	structurePoint_ = -1;
+	coordinatesPoint_ = -1;
+	stylePoint_ = -1;
+}
@@ -0,0 +1,111 @@
+/*
+	*** Packed atom data store
+	*** src/base/atomstore.h
+	Copyright T. Youngs 2007-2017
+
+	This file is part of Aten.
+
+	Aten is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Aten is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Aten.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef ATEN_ATOMSTORE_H
+#define ATEN_ATOMSTORE_H
+
+#include "templates/vector3.h"
+#include "templates/array.h"
+#include "base/namespace.h"
+
+ATEN_BEGIN_NAMESPACE
+
+// Forward Declarations (Aten)
+class Model;
+class ForcefieldAtom;
+
+// Packed Atom Store
+// Holds copies of the commonly-used atom data of a model in contiguous arrays (one per quantity), so that pair loops
+// may run over them without touching the Atom objects themselves.
+class AtomStore
+{
+	public:
+	// Constructor
+	AtomStore();
+
+
+	/*
+	 * Data
+	 */
+	private:
+	// Number of atoms in the store
+	int nAtoms_;
+	// Atomic coordinates
+	Array<double> x_, y_, z_;
+	// Atomic charges
+	Array<double> charges_;
+	// Atomic elements
+	Array<int> elements_;
+	// Index of the forcefield type of each atom in types_ (or -1 if the atom is untyped)
+	Array<int> typeIndices_;
+	// Forcefield types present in the model
+	Array<ForcefieldAtom*> types_;
+	// Whether each atom's position is fixed
+	Array<bool> fixed_;
+
+	public:
+	// Return number of atoms in the store
+	int nAtoms() const;
+	// Return x, y, and z coordinate arrays
+	double* x();
+	double* y();
+	double* z();
+	// Return coordinates of specified atom
+	Vec3<double> r(int i) const;
+	// Return charge array
+	double* charges();
+	// Return element array
+	int* elements();
+	// Return type index array
+	int* typeIndices();
+	// Return number of distinct forcefield types
+	int nTypes() const;
+	// Return forcefield type with specified index
+	ForcefieldAtom* type(int index) const;
+	// Return fixed position array
+	bool* fixed();
+
+
+	/*
+	 * Synchronisation
+	 */
+	private:
+	// Model for which the store was last updated
+	Model* sourceModel_;
+	// Revisions of the source model's logs at which the store was last updated (revisions are never rewound, unlike the logs themselves)
+	int structurePoint_, coordinatesPoint_, stylePoint_;
+	// Copy per-atom data from source model
+	void copyAtoms(Model* sourceModel);
+	// Copy coordinates from source model
+	void copyCoordinates(Model* sourceModel);
+
+	public:
+	// Update store from the supplied model if its structure, coordinates, or style have changed (or if forced)
+	void update(Model* sourceModel, bool force = false);
+	// Update coordinates only from the supplied model, regardless of its log revisions
+	void updateCoordinates(Model* sourceModel);
+	// Invalidate store, forcing a full update on next call to update()
+	void invalidate();
+};
+
+ATEN_END_NAMESPACE
+
+#endif
@@ -636,8 +636,7 @@ void UnitCell::calculateInverse()
 // Minimum image vector from r1 to r2
 Vec3<double> UnitCell::mimVector(const Vec3<double>& r1, const Vec3<double>& r2) const
 {
-	static Vec3<double> R;
-	static double half;
+	Vec3<double> R;
 	switch (type_)
 	{
 		// No cell - just return r1
@@ -711,7 +710,7 @@ Vec3<double> UnitCell::fold(Vec3<double>& r) const
 {
 	// Folds the coordinates in 'r' into the defined unit cell
 	Messenger::enter("UnitCell::fold");
-	static Vec3<double> R;
+	Vec3<double> R;
 	switch (type_)
 	{
 		// No cell, so no image to fold into
@@ -790,7 +789,7 @@ bool UnitCell::isInsideCell(Vec3<double>& v) const
 double UnitCell::distance(const Vec3<double>& r1, const Vec3<double>& r2, bool useMim) const
 {
 	// Calculate the distance between atoms i and j
-	static Vec3<double> mimi;
+	Vec3<double> mimi;
 	mimi = (useMim ? mimVector(r1,r2) : r1-r2);
 	return mimi.magnitude();
 }
@@ -805,8 +804,8 @@ double UnitCell::distance(Atom* i, Atom* j, bool useMim) const
 double UnitCell::angle(const Vec3<double>& r1, const Vec3<double>& r2, const Vec3<double>& r3, bool useMim) const
 {
 	// Calculate the angle formed between atoms i, j, and k
-	static Vec3<double> vecji, vecjk;
-	static double dp, a;
+	Vec3<double> vecji, vecjk;
+	double dp, a;
 	vecji = (useMim ? mimVector(r2,r1) : r1-r2);
 	vecjk = (useMim ? mimVector(r2,r3) : r3-r2);
 	// Normalise vectors and calculate dot product and angle.
@@ -827,8 +826,8 @@ double UnitCell::angle(Atom* i, Atom* j, Atom* k, bool useMim) const
 double UnitCell::torsion(const Vec3<double>& i, const Vec3<double>& j, const Vec3<double>& k, const Vec3<double>& l, bool useMim) const
 {
 	// Calculate the torsion angle formed between the atoms i, j, k, and l.
-	static Vec3<double> vecji, veckl, vecjk, veckj, mim_k, xpj, xpk;
-	static double dp, angle;
+	Vec3<double> vecji, veckl, vecjk, veckj, mim_k, xpj, xpk;
+	double dp, angle;
 	// Vector j->i
 	vecji = (useMim ? mimVector(j,i) : i-j);
 	// Vectors j->k and k->j (minimum image of k w.r.t. j)
@@ -192,6 +192,47 @@ class FileParser
 	{
 		return (parser_.getDoubleArray(array, nValues) == 0);
 	}
+	// Read float array
+	bool readRawFloatArray(float* array, int nValues)
+	{
+		return (parser_.getFloatArray(array, nValues) == 0);
+	}
+
+
+	/*
+	 * Raw Write Functions
+	 */
+	public:
+	// Write integer
+	bool writeRawInteger(int value)
+	{
+		return parser_.writeRaw((const char*) &value, sizeof(int));
+	}
+	// Write double
+	bool writeRawDouble(double value)
+	{
+		return parser_.writeRaw((const char*) &value, sizeof(double));
+	}
+	// Write characters
+	bool writeRawChars(const char* chars, int nChars)
+	{
+		return parser_.writeRaw(chars, nChars);
+	}
+	// Write integer array
+	bool writeRawIntegerArray(const int* array, int nValues)
+	{
+		return parser_.writeRaw((const char*) array, nValues*sizeof(int));
+	}
+	// Write double array
+	bool writeRawDoubleArray(const double* array, int nValues)
+	{
+		return parser_.writeRaw((const char*) array, nValues*sizeof(double));
+	}
+	// Write float array
+	bool writeRawFloatArray(const float* array, int nValues)
+	{
+		return parser_.writeRaw((const char*) array, nValues*sizeof(float));
+	}
 
 
 	/*
@@ -314,6 +355,42 @@ class FileParser
 	{
 		return parser_.hasArg(i);
 	}
+
+
+	/*
+	 * Fast Argument Data
+	 */
+	public:
+	// Read and parse next line into whitespace / comma-delimited arguments, without quote handling or intermediate strings
+	bool parseLineFast()
+	{
+		return (parser_.getArgsFast() == 0);
+	}
+	// Returns number of arguments grabbed from last fast parse
+	int nFastArgs() const
+	{
+		return parser_.nFastArgs();
+	}
+	// Returns the specified fast argument as a character string
+	QString fastArgc(int i) const
+	{
+		return parser_.fastArgc(i);
+	}
+	// Returns the specified fast argument as an integer
+	int fastArgi(int i) const
+	{
+		return parser_.fastArgi(i);
+	}
+	// Returns the specified fast argument as a double
+	double fastArgd(int i) const
+	{
+		return parser_.fastArgd(i);
+	}
+	// Returns the specified fast argument (+1, and +2) as a Vec3<double>
+	Vec3<double> fastArg3d(int i) const
+	{
+		return Vec3<double>(parser_.fastArgd(i), parser_.fastArgd(i+1), parser_.fastArgd(i+2));
+	}
 };
 
 ATEN_END_NAMESPACE
@@ -0,0 +1,395 @@
+/*
+	*** Compact trajectory frame store
+	*** src/base/framestore.cpp
+	Copyright T. Youngs 2007-2017
+
+	This file is part of Aten.
+
+	Aten is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Aten is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Aten.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "base/framestore.h"
+#include "model/model.h"
+#include "base/prefs.h"
+
+ATEN_USING_NAMESPACE
+
+/*
+ * Stored Frame
+ */
+
+// Constructor
+StoredFrame::StoredFrame() : ListItem<StoredFrame>()
+{
+	// Private variables
+	hasCell_ = false;
+	view_ = NULL;
+}
+
+// Destructor
+StoredFrame::~StoredFrame()
+{
+	if (view_) delete view_;
+}
+
+// Clear packed data
+void StoredFrame::clearPacked()
+{
+	r_.clear();
+	v_.clear();
+	f_.clear();
+	floatR_.clear();
+	floatV_.clear();
+	floatF_.clear();
+}
+
+// Pack coordinates, and any non-zero velocities and forces, of the supplied atoms
+template <class T> static void packAtoms(Atom** atoms, int nAtoms, Array<T>& r, Array<T>& v, Array<T>& f)
+{
+	bool hasVelocities = false, hasForces = false;
+	int n, m;
+	r.createEmpty(3*nAtoms);
+	for (n=0; n<nAtoms; ++n)
+	{
+		for (m=0; m<3; ++m) r[n*3+m] = atoms[n]->r()[m];
+		if (!hasVelocities) hasVelocities = atoms[n]->v().magnitudeSq() > 0.0;
+		if (!hasForces) hasForces = atoms[n]->f().magnitudeSq() > 0.0;
+	}
+	if (hasVelocities)
+	{
+		v.createEmpty(3*nAtoms);
+		for (n=0; n<nAtoms; ++n) for (m=0; m<3; ++m) v[n*3+m] = atoms[n]->v()[m];
+	}
+	if (hasForces)
+	{
+		f.createEmpty(3*nAtoms);
+		for (n=0; n<nAtoms; ++n) for (m=0; m<3; ++m) f[n*3+m] = atoms[n]->f()[m];
+	}
+}
+
+// Unpack coordinates, velocities, and forces into the supplied atoms (zeroing velocities and forces if none were packed)
+template <class T> static void unpackAtoms(Array<T>& r, Array<T>& v, Array<T>& f, Atom** atoms, int nAtoms)
+{
+	bool hasVelocities = (v.nItems() != 0), hasForces = (f.nItems() != 0);
+	for (int n=0; n<nAtoms; ++n)
+	{
+		atoms[n]->r().set(r[n*3], r[n*3+1], r[n*3+2]);
+		if (hasVelocities) atoms[n]->v().set(v[n*3], v[n*3+1], v[n*3+2]);
+		else atoms[n]->v().zero();
+		if (hasForces) atoms[n]->f().set(f[n*3], f[n*3+1], f[n*3+2]);
+		else atoms[n]->f().zero();
+	}
+}
+
+/*
+ * Frame Store
+ */
+
+// Constructor
+FrameStore::FrameStore()
+{
+	// Private variables
+	parent_ = NULL;
+	topology_ = NULL;
+	nAtoms_ = 0;
+	displayFrame_ = NULL;
+	displayIndex_ = -1;
+	displayStructurePoint_ = -1;
+	displayCoordinatesPoint_ = -1;
+	displayCellPoint_ = -1;
+}
+
+// Destructor
+FrameStore::~FrameStore()
+{
+	clear();
+}
+
+/*
+ * Topology
+ */
+
+// Set parent model of the trajectory
+void FrameStore::setParent(Model* parent)
+{
+	parent_ = parent;
+}
+
+// Return whether the supplied frame may be packed against the shared topology
+bool FrameStore::isCompatible(Model* frame) const
+{
+	// If there is no topology yet, the frame will provide it
+	if (topology_ == NULL) return true;
+
+	if (frame->nAtoms() != nAtoms_) return false;
+	Atom** ii = topology_->atomArray(), **jj = frame->atomArray();
+	for (int n=0; n<nAtoms_; ++n) if (ii[n]->element() != jj[n]->element()) return false;
+
+	// Packed frames take their bonds from the topology, so any frame bonded differently (e.g. rebonded on load) must be kept whole
+	if (frame->nBonds() != topology_->nBonds()) return false;
+	RefListItem<Bond,int>* ri, *rj;
+	int partner;
+	for (int n=0; n<nAtoms_; ++n)
+	{
+		if (ii[n]->nBonds() != jj[n]->nBonds()) return false;
+		for (rj = jj[n]->bonds(); rj != NULL; rj = rj->next)
+		{
+			partner = rj->item->partner(jj[n])->id();
+			for (ri = ii[n]->bonds(); ri != NULL; ri = ri->next) if (ri->item->partner(ii[n])->id() == partner) break;
+			if (ri == NULL) return false;
+		}
+	}
+
+	return true;
+}
+
+/*
+ * Frames
+ */
+
+// Return stored frame containing the specified view
+StoredFrame* FrameStore::storedFrame(Model* view)
+{
+	// Search backwards, since the most recently added frame is the one most often required
+	for (StoredFrame* frame = frames_.last(); frame != NULL; frame = frame->prev) if (frame->view_ == view) return frame;
+	return NULL;
+}
+
+// Create new model with the shared topology
+Model* FrameStore::createView()
+{
+	Model* view = new Model;
+	view->setType(Model::TrajectoryFrameType);
+	view->setParent(parent_);
+	view->copy(topology_);
+	view->setDrawStyle(topology_->drawStyle());
+	view->setColourScheme(topology_->colourScheme());
+	view->calculateMass();
+	view->selectNone();
+	view->resetLogs();
+
+	return view;
+}
+
+// Pack data from the supplied model into the stored frame
+void FrameStore::storeFrame(StoredFrame* frame, Model* source)
+{
+	// Coordinates are always stored - velocities and forces only if any are non-zero
+	frame->clearPacked();
+	if (prefs.singlePrecisionFrames()) packAtoms(source->atomArray(), source->nAtoms(), frame->floatR_, frame->floatV_, frame->floatF_);
+	else packAtoms(source->atomArray(), source->nAtoms(), frame->r_, frame->v_, frame->f_);
+
+	frame->hasCell_ = (source->cell().type() != UnitCell::NoCell);
+	if (frame->hasCell_) frame->axes_ = source->cell().axes();
+	frame->name_ = source->name();
+}
+
+// Load packed data from the stored frame into the supplied model
+void FrameStore::loadFrame(StoredFrame* frame, Model* target)
+{
+	if (frame->floatR_.nItems() != 0) unpackAtoms(frame->floatR_, frame->floatV_, frame->floatF_, target->atomArray(), nAtoms_);
+	else unpackAtoms(frame->r_, frame->v_, frame->f_, target->atomArray(), nAtoms_);
+	target->logChange(Log::Coordinates);
+
+	// Set the cell directly, so that no undo events are recorded
+	if (frame->hasCell_) target->cell().set(frame->axes_);
+	else target->cell().reset();
+	target->logChange(Log::Cell);
+
+	target->setName(frame->name_);
+}
+
+// Store any changes made to the display model back into its frame
+void FrameStore::storeDisplayFrame()
+{
+	if (displayIndex_ == -1) return;
+
+	StoredFrame* frame = frames_[displayIndex_];
+	if (displayFrame_->log(Log::Structure) != displayStructurePoint_)
+	{
+		// Structure has been modified, so the frame can no longer share the topology - the display model becomes its view
+		frame->view_ = displayFrame_;
+		frame->clearPacked();
+		displayFrame_ = NULL;
+		displayIndex_ = -1;
+	}
+	else if ((displayFrame_->log(Log::Coordinates) != displayCoordinatesPoint_) || (displayFrame_->log(Log::Cell) != displayCellPoint_))
+	{
+		storeFrame(frame, displayFrame_);
+		displayCoordinatesPoint_ = displayFrame_->log(Log::Coordinates);
+		displayCellPoint_ = displayFrame_->log(Log::Cell);
+	}
+}
+
+// Clear all frames
+void FrameStore::clear()
+{
+	frames_.clear();
+	threadFrames_.clear();
+	if (displayFrame_) delete displayFrame_;
+	displayFrame_ = NULL;
+	displayIndex_ = -1;
+	if (topology_) delete topology_;
+	topology_ = NULL;
+	nAtoms_ = 0;
+}
+
+// Return number of frames in the store
+int FrameStore::nFrames() const
+{
+	return frames_.nItems();
+}
+
+// Add new frame to the end of the store, returning its (materialised) view
+Model* FrameStore::add()
+{
+	StoredFrame* frame = frames_.add();
+	frame->view_ = new Model;
+	frame->view_->setType(Model::TrajectoryFrameType);
+	frame->view_->setParent(parent_);
+
+	return frame->view_;
+}
+
+// Remove the frame with the supplied view, returning its former index (or -1 if it was not found)
+int FrameStore::remove(Model* view)
+{
+	// If the view is the display model, the frame it is displaying is the one to remove
+	StoredFrame* frame = NULL;
+	if ((view == displayFrame_) && (displayIndex_ != -1)) frame = frames_[displayIndex_];
+	else frame = storedFrame(view);
+	if (frame == NULL) return -1;
+
+	int index = frames_.indexOf(frame);
+	if (displayIndex_ == index) displayIndex_ = -1;
+	else if (displayIndex_ > index) --displayIndex_;
+	frames_.remove(frame);
+
+	return index;
+}
+
+// Pack the frame with the supplied view, deleting the view
+bool FrameStore::pack(Model* view)
+{
+	StoredFrame* frame = storedFrame(view);
+	if ((frame == NULL) || (!isCompatible(view))) return false;
+
+	storeFrame(frame, view);
+	frame->view_ = NULL;
+
+	// The first frame to be packed provides the topology shared by all others
+	if (topology_ == NULL)
+	{
+		topology_ = view;
+		nAtoms_ = topology_->nAtoms();
+	}
+	else delete view;
+
+	return true;
+}
+
+// Return persistent model for the specified frame, materialising it if necessary
+Model* FrameStore::frame(int index)
+{
+	if ((index < 0) || (index >= frames_.nItems())) return NULL;
+
+	StoredFrame* frame = frames_[index];
+	if (frame->view_) return frame->view_;
+
+	// If the frame is being displayed, keep any changes by handing over the display model
+	if (displayIndex_ == index)
+	{
+		frame->view_ = displayFrame_;
+		displayFrame_ = NULL;
+		displayIndex_ = -1;
+	}
+	else
+	{
+		frame->view_ = createView();
+		loadFrame(frame, frame->view_);
+	}
+	frame->clearPacked();
+
+	return frame->view_;
+}
+
+// Return model to display the specified frame (its materialised view if it has one, or the shared display model)
+Model* FrameStore::displayFrame(int index)
+{
+	if ((index < 0) || (index >= frames_.nItems())) return NULL;
+	if (displayIndex_ == index) return displayFrame_;
+
+	storeDisplayFrame();
+
+	StoredFrame* frame = frames_[index];
+	if (frame->view_) return frame->view_;
+
+	displayIndex_ = -1;
+	if (displayFrame_ == NULL) displayFrame_ = createView();
+	loadFrame(frame, displayFrame_);
+	displayIndex_ = index;
+	displayStructurePoint_ = displayFrame_->log(Log::Structure);
+	displayCoordinatesPoint_ = displayFrame_->log(Log::Coordinates);
+	displayCellPoint_ = displayFrame_->log(Log::Cell);
+
+	return displayFrame_;
+}
+
+// Prepare models for the specified number of analysis threads (or release them if zero)
+void FrameStore::prepareThreads(int nThreads)
+{
+	// Make sure any changes in the display model are stored, and the frame array is up to date
+	storeDisplayFrame();
+	frames_.array();
+
+	threadFrames_.clear();
+	if (topology_ == NULL) return;
+	for (int n=0; n<nThreads; ++n) threadFrames_.own(createView());
+	threadFrames_.array();
+}
+
+// Return model containing specified frame for use by the specified analysis thread
+Model* FrameStore::threadFrame(int index, int thread)
+{
+	StoredFrame* frame = frames_[index];
+	if (frame->view_) return frame->view_;
+
+	Model* target = threadFrames_[thread];
+	loadFrame(frame, target);
+	return target;
+}
+
+// Apply the atom style of the supplied model to all frames, returning the number of models updated
+int FrameStore::copyAtomStyle(Model* source)
+{
+	int count = 0;
+	if (topology_ && (topology_ != source) && (topology_->nAtoms() == source->nAtoms()))
+	{
+		topology_->copyAtomStyle(source);
+		++count;
+	}
+	if (displayFrame_ && (displayFrame_ != source) && (displayFrame_->nAtoms() == source->nAtoms()))
+	{
+		displayFrame_->copyAtomStyle(source);
+		++count;
+	}
+	for (StoredFrame* frame = frames_.first(); frame != NULL; frame = frame->next)
+	{
+		if ((frame->view_ == NULL) || (frame->view_ == source) || (frame->view_->nAtoms() != source->nAtoms())) continue;
+		frame->view_->copyAtomStyle(source);
+		++count;
+	}
+
+	return count;
+}
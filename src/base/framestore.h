@@ -0,0 +1,148 @@
+/*
+	*** Compact trajectory frame store
+	*** src/base/framestore.h
+	Copyright T. Youngs 2007-2017
+
+	This file is part of Aten.
+
+	Aten is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Aten is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Aten.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef ATEN_FRAMESTORE_H
+#define ATEN_FRAMESTORE_H
+
+#include "math/matrix.h"
+#include "templates/list.h"
+#include "templates/array.h"
+#include "base/namespace.h"
+#include <QString>
+
+ATEN_BEGIN_NAMESPACE
+
+// Forward Declarations (Aten)
+class Model;
+class FrameStore;
+
+// Stored Trajectory Frame
+class StoredFrame : public ListItem<StoredFrame>
+{
+	public:
+	// Constructor / Destructor
+	StoredFrame();
+	~StoredFrame();
+	// Friend class
+	friend class FrameStore;
+
+	private:
+	// Name of frame
+	QString name_;
+	// Whether the frame has a unit cell
+	bool hasCell_;
+	// Unit cell axes
+	Matrix axes_;
+	// Packed atomic coordinates (x,y,z for each atom, empty if the frame is not packed), velocities and forces (empty if not present in the frame)
+	Array<double> r_, v_, f_;
+	// Single-precision packed data, used instead of the above if requested in the preferences
+	Array<float> floatR_, floatV_, floatF_;
+	// Full model of the frame, if materialised (takes precedence over packed data)
+	Model* view_;
+
+	private:
+	// Clear packed data
+	void clearPacked();
+};
+
+// Trajectory Frame Store
+// Holds cached trajectory frames as packed atomic data (double precision, unless single precision is requested in the preferences)
+// and unit cell axes only, sharing a single reference model for the atoms, bonds, and styles. Full Model views of individual frames
+// are materialised on demand, and frames whose atoms or bonds differ from the reference are kept as full models.
+class FrameStore
+{
+	public:
+	// Constructor / Destructor
+	FrameStore();
+	~FrameStore();
+
+
+	/*
+	 * Topology
+	 */
+	private:
+	// Parent model of the trajectory
+	Model* parent_;
+	// Reference model providing the atoms, bonds, and styles shared by all packed frames
+	Model* topology_;
+	// Number of atoms in each packed frame
+	int nAtoms_;
+
+	public:
+	// Set parent model of the trajectory
+	void setParent(Model* parent);
+	// Return whether the supplied frame may be packed against the shared topology
+	bool isCompatible(Model* frame) const;
+
+
+	/*
+	 * Frames
+	 */
+	private:
+	// List of stored frames
+	List<StoredFrame> frames_;
+	// Model into which packed frames are loaded for display
+	Model* displayFrame_;
+	// Index of frame currently loaded into the display model (or -1 for none)
+	int displayIndex_;
+	// Structure, coordinate, and cell log points of the display model when last loaded
+	int displayStructurePoint_, displayCoordinatesPoint_, displayCellPoint_;
+	// Per-thread models into which packed frames are loaded for analysis
+	List<Model> threadFrames_;
+
+	private:
+	// Return stored frame containing the specified view
+	StoredFrame* storedFrame(Model* view);
+	// Create new model with the shared topology
+	Model* createView();
+	// Pack data from the supplied model into the stored frame
+	void storeFrame(StoredFrame* frame, Model* source);
+	// Load packed data from the stored frame into the supplied model
+	void loadFrame(StoredFrame* frame, Model* target);
+	// Store any changes made to the display model back into its frame
+	void storeDisplayFrame();
+
+	public:
+	// Clear all frames
+	void clear();
+	// Return number of frames in the store
+	int nFrames() const;
+	// Add new frame to the end of the store, returning its (materialised) view
+	Model* add();
+	// Remove the frame with the supplied view, returning its former index (or -1 if it was not found)
+	int remove(Model* view);
+	// Pack the frame with the supplied view, deleting the view
+	bool pack(Model* view);
+	// Return persistent model for the specified frame, materialising it if necessary
+	Model* frame(int index);
+	// Return model to display the specified frame (its materialised view if it has one, or the shared display model)
+	Model* displayFrame(int index);
+	// Prepare models for the specified number of analysis threads (or release them if zero)
+	void prepareThreads(int nThreads);
+	// Return model containing specified frame for use by the specified analysis thread
+	Model* threadFrame(int index, int thread);
+	// Apply the atom style of the supplied model to all frames, returning the number of models updated
+	int copyAtomStyle(Model* source);
+};
+
+ATEN_END_NAMESPACE
+
+#endif
@@ -20,6 +20,7 @@
 */
 
 #include "base/grid.h"
+#include "base/mappedfile.h"
 #include "base/messenger.h"
 #include "base/prefs.h"
 #include "base/sysfunc.h"
@@ -53,6 +54,19 @@ const char* Grid::gridType(Grid::GridType gt)
 	return GridTypeKeywords[gt];
 }
 
+// Storage types for regular 3D data
+const char* StorageTypeKeywords[Grid::nStorageTypes] = { "double", "float" };
+Grid::StorageType Grid::storageType(QString s, bool reportError)
+{
+	Grid::StorageType st = (Grid::StorageType) enumSearch("storage type", Grid::nStorageTypes, StorageTypeKeywords, s, reportError);
+	if ((st == Grid::nStorageTypes) && reportError) enumPrintValid(Grid::nStorageTypes,StorageTypeKeywords);
+	return st;
+}
+const char* Grid::storageType(Grid::StorageType st)
+{
+	return StorageTypeKeywords[st];
+}
+
 // Surface rendering styles
 const char* SurfaceStyleKeywords[] = { "points", "mesh", "solid" };
 Grid::SurfaceStyle Grid::surfaceStyle(QString s)
@@ -68,7 +82,11 @@ const char* Grid::surfaceStyle(Grid::SurfaceStyle ss)
 Grid::Grid() : ListItem<Grid>(), ObjectStore<Grid>(this, ObjectTypes::GridObject)
 {
 	// Private variables
+	storageType_ = Grid::DoubleStorage;
 	data3d_ = NULL;
+	voxels_ = NULL;
+	floatVoxels_ = NULL;
+	mappedFile_ = NULL;
 	data2d_ = NULL;
 	type_ = Grid::NoData;
 	dataFull_ = false;
@@ -109,6 +127,9 @@ Grid::Grid() : ListItem<Grid>(), ObjectStore<Grid>(this, ObjectTypes::GridObject
 	partialPrimarySum_ = 0.0;
 	partialSecondarySum_ = 0.0;
 	sumPoint_ = -1;
+	dataLog_ = 0;
+	octreePoint_ = -1;
+	distributionPoint_ = -1;
 	axisVisible_[0] = false;
 	axisVisible_[1] = false;
 	axisVisible_[2] = false;
@@ -168,8 +189,9 @@ Grid& Grid::operator=(Grid& source)
 	axisLoopOrder_ = source.axisLoopOrder_;
 	axisLoopSigns_ = source.axisLoopSigns_;
 
-	// Delete any existing 2D or 3D array in this Grid
+	// Delete any existing 2D or 3D array in this Grid (values mapped from file in the source are copied into memory)
 	deleteArrays();
+	storageType_ = source.storageType_;
 
 	// Create new data structure
 	allocateArrays();
@@ -182,7 +204,7 @@ Grid& Grid::operator=(Grid& source)
 		{
 			for (y=0; y<nXYZ_.y; y++)
 			{
-				for (z=0; z<nXYZ_.z; z++) data3d_[x][y][z] = source.data3d_[x][y][z];
+				for (z=0; z<nXYZ_.z; z++) setVoxel(x, y, z, source.value(x, y, z));
 			}
 		}
 	}
@@ -193,6 +215,7 @@ Grid& Grid::operator=(Grid& source)
 			for (y=0; y<nXYZ_.y; y++) data2d_[x][y] = source.data2d_[x][y];
 		}
 	}
+	logDataChange();
 	name_ = source.name_;
 	filename_ = source.filename_;
 
@@ -256,7 +279,7 @@ bool Grid::initialise(Grid::GridType type, Vec3<int> nXYZ)
 		case (Grid::RegularXYZData):
 			nXYZ_ = nXYZ;
 			result = allocateArrays();
-			if (result) Messenger::print("Initialised grid structure for regular 3D XY data, %i points total.", nXYZ_.x*nXYZ_.y*nXYZ_.z);
+			if (result) Messenger::print("Initialised grid structure for regular 3D XY data, %lli points total.", qint64(nXYZ_.x)*nXYZ_.y*nXYZ_.z);
 			break;
 		case (Grid::FreeXYZData):
 			Messenger::print("Initialised grid structure for free 3D XYZ data.");
@@ -316,17 +339,30 @@ void Grid::clear()
 void Grid::deleteArrays()
 {
 	Messenger::enter("Grid::deleteArrays");
-	int i, j;
+	int i;
 	if (data3d_ != NULL)
 	{
-		for (i = 0; i<nXYZ_.x; i++)
-		{
-			for (j = 0; j<nXYZ_.y; j++) delete[] data3d_[i][j];
-			delete[] data3d_[i];
-		}
+		for (i = 0; i<nXYZ_.x; i++) delete[] data3d_[i];
 		delete[] data3d_;
 		data3d_ = NULL;
 	}
+	// Contiguous storage is only owned by the grid if it was not mapped from a file
+	if (mappedFile_ == NULL)
+	{
+		if (voxels_ != NULL) delete[] voxels_;
+		if (floatVoxels_ != NULL) delete[] floatVoxels_;
+	}
+	else
+	{
+		delete mappedFile_;
+		mappedFile_ = NULL;
+	}
+	voxels_ = NULL;
+	floatVoxels_ = NULL;
+	octree_.clear();
+	octreePoint_ = -1;
+	distribution_.clear();
+	distributionPoint_ = -1;
 	if (data2d_ != NULL)
 	{
 		for (i = 0; i<nXYZ_.x; i++)
@@ -345,11 +381,11 @@ void Grid::deleteArrays()
 bool Grid::allocateArrays()
 {
 	Messenger::enter("Grid::allocateArrays");
-	int i, j;
+	int i;
 	switch (type_)
 	{
 		case (Grid::RegularXYZData):
-			if (data3d_ != NULL) clear();
+			if ((voxels_ != NULL) || (floatVoxels_ != NULL)) clear();
 			// Check point limits (secondary only)
 			if (nXYZ_.min() < 1)
 			{
@@ -357,12 +393,14 @@ bool Grid::allocateArrays()
 				Messenger::exit("Grid::allocateArrays");
 				return false;
 			}
-			data3d_ = new double**[nXYZ_.x];
-			for (i = 0; i<nXYZ_.x; i++)
+			// Values are stored contiguously (x-major), with data3d_ providing row pointers into double-precision storage
+			if (storageType_ == Grid::FloatStorage) floatVoxels_ = new float[qint64(nXYZ_.x)*nXYZ_.y*nXYZ_.z];
+			else
 			{
-				data3d_[i] = new double*[nXYZ_.y];
-				for (j = 0; j<nXYZ_.y; j++) data3d_[i][j] = new double[nXYZ_.z];
+				voxels_ = new double[qint64(nXYZ_.x)*nXYZ_.y*nXYZ_.z];
+				createRows();
 			}
+			logDataChange();
 			break;
 		case (Grid::RegularXYData):
 			if (data2d_ != NULL) clear();
@@ -385,6 +423,25 @@ bool Grid::allocateArrays()
 	return true;
 }
 
+// Create row pointers into contiguous voxel storage
+void Grid::createRows()
+{
+	data3d_ = new double**[nXYZ_.x];
+	for (int i = 0; i<nXYZ_.x; i++)
+	{
+		data3d_[i] = new double*[nXYZ_.y];
+		for (int j = 0; j<nXYZ_.y; j++) data3d_[i][j] = &voxels_[(qint64(i)*nXYZ_.y + j)*nXYZ_.z];
+	}
+}
+
+// Set value at specified point of regular 3D data
+void Grid::setVoxel(int x, int y, int z, double d)
+{
+	qint64 index = (qint64(x)*nXYZ_.y + y)*nXYZ_.z + z;
+	if (floatVoxels_ != NULL) floatVoxels_[index] = d;
+	else voxels_[index] = d;
+}
+
 // Update minimum / maximum based on supplied value
 void Grid::setLimits(double d)
 {
@@ -400,30 +457,25 @@ void Grid::setLimits(double d)
 void Grid::calculateSums()
 {
 	Messenger::enter("Grid::calculateSums");
-	int i,j,k;
-	double** data2, *data1;
+	int i,j;
+	double* data1;
 	totalPositiveSum_ = 0.0;
 	totalNegativeSum_ = 0.0;
 	partialPrimarySum_ = 0.0;
 	partialSecondarySum_ = 0.0;
 	if (type_ == Grid::RegularXYZData)
 	{
-		for (i = 0; i < nXYZ_.x; i++)
-		{
-			data2 = data3d_[i];
-			for (j = 0; j<nXYZ_.y; j++)
-			{
-				data1 = data2[j];
-				for (k = 0; k<nXYZ_.z; k++)
-				{
-					if (data1[k] > 0) totalPositiveSum_ += data1[k];
-					else totalNegativeSum_ += data1[k];
-					// Calculate cutoff sums
-					if (withinPrimaryCutoff(data1[k])) partialPrimarySum_ += fabs(data1[k]);
-					if (withinSecondaryCutoff(data1[k])) partialSecondarySum_ += fabs(data1[k]);
-				}
-			}
-		}
+		// Totals come from the root of the octree, and partial sums from those of its nodes lying within (or straddling) the cutoffs
+		GridOctree& tree = octree();
+		double positiveSum, negativeSum;
+		totalPositiveSum_ = tree.root().positiveSum;
+		totalNegativeSum_ = tree.root().negativeSum;
+		if (lowerPrimaryCutoff_ < upperPrimaryCutoff_) tree.sum(lowerPrimaryCutoff_, upperPrimaryCutoff_, positiveSum, negativeSum);
+		else tree.sum(upperPrimaryCutoff_, lowerPrimaryCutoff_, positiveSum, negativeSum);
+		partialPrimarySum_ = positiveSum - negativeSum;
+		if (lowerSecondaryCutoff_ < upperSecondaryCutoff_) tree.sum(lowerSecondaryCutoff_, upperSecondaryCutoff_, positiveSum, negativeSum);
+		else tree.sum(upperSecondaryCutoff_, lowerSecondaryCutoff_, positiveSum, negativeSum);
+		partialSecondarySum_ = positiveSum - negativeSum;
 	}
 	else if (type_ == Grid::RegularXYData)
 	{
@@ -491,22 +543,13 @@ void Grid::calculateBounds()
 double Grid::sum(double lowerCutoff, double upperCutoff)
 {
 	// Get sum between specified points
-	int x, y, z;
+	int x, y;
 	double sum = 0.0;
 	if (type_ == Grid::RegularXYZData)
 	{
-		for (x=0; x<nXYZ_.x; x++)
-		{
-			for (y=0; y<nXYZ_.y; y++)
-			{
-				for (z=0; z<nXYZ_.z; z++)
-				{
-					if (data3d_[x][y][z] < lowerCutoff) continue;
-					if (data3d_[x][y][z] > upperCutoff) continue;
-					sum += data3d_[x][y][z];
-				}
-			}
-		}
+		double positiveSum, negativeSum;
+		octree().sum(lowerCutoff, upperCutoff, positiveSum, negativeSum);
+		sum = positiveSum + negativeSum;
 	}
 	else
 	{
@@ -527,122 +570,21 @@ double Grid::sum(double lowerCutoff, double upperCutoff)
 // Calculate lower (or upper) cutoff to give requested percentage of grid encapsulated in displayed surface
 bool Grid::calculateCutoff(double percentage, bool upperCutoff, bool secondary, double& newCutoff)
 {
-	const int nBins = 100, maxPasses = 10;
-	double binDelta, histogramStart;
-	Array<double> histogram(nBins), fractions(nBins);
-	double point;
-	int bin, x, y, z, n, m, lowBin, highBin;
-
-	// Set initial histogram limits
-	histogramStart = minimum_;
-	if (secondary)
-	{
-		if (upperCutoff) binDelta = (maximum_ - lowerSecondaryCutoff_) / nBins;
-		else binDelta = (upperSecondaryCutoff_ - minimum_) / nBins;
-		newCutoff = (upperCutoff ? upperSecondaryCutoff_ : lowerSecondaryCutoff_);
-	}
-	else
-	{
-		if (upperCutoff) binDelta = (maximum_ - lowerPrimaryCutoff_) / nBins;
-		else binDelta = (upperPrimaryCutoff_ - minimum_) / nBins;
-		newCutoff = (upperCutoff ? upperPrimaryCutoff_ : lowerPrimaryCutoff_);
-	}
+	newCutoff = (upperCutoff ? (secondary ? upperSecondaryCutoff_ : upperPrimaryCutoff_) : (secondary ? lowerSecondaryCutoff_ : lowerPrimaryCutoff_));
 
-	// Loop over passes
-	for (int pass = 0; pass < maxPasses; ++pass)
+	// Query the distribution of values, keeping the opposite cutoff fixed
+	GridDistribution& dist = distribution();
+	if (dist.nValues() == 0)
 	{
-		// Zero histogram
-		histogram = 0.0;
-
-		// Bin grid data
-		if (type_ == Grid::RegularXYZData)
-		{
-			for (x=0; x<nXYZ_.x; ++x)
-			{
-				for (y=0; y<nXYZ_.y; ++y)
-				{
-					for (z=0; z<nXYZ_.z; ++z)
-					{
-						point = data3d_[x][y][z];
-						// Ignore points above / below relevant cutoffs
-						if (upperCutoff)
-						{
-							if (point < (secondary ? lowerSecondaryCutoff_ : lowerPrimaryCutoff_)) continue;
-						}
-						else if (point > (secondary ? upperSecondaryCutoff_ : upperPrimaryCutoff_)) continue;
-						bin = (point - histogramStart) / binDelta;
-						if (bin < 0) bin = 0;
-						else if (bin >= nBins) bin = nBins-1;
-						histogram[bin] += fabs(point);
-					}
-				}
-			}
-		}
-		else if (type_ == Grid::RegularXYData)
-		{
-			for (x=0; x<nXYZ_.x; ++x)
-			{
-				for (y=0; y<nXYZ_.y; ++y)
-				{
-					point = data2d_[x][y];
-					// Ignore points above / below relevant cutoffs
-					if (upperCutoff)
-					{
-						if (point < (secondary ? lowerSecondaryCutoff_ : lowerPrimaryCutoff_)) continue;
-					}
-					else if (point > (secondary ? upperSecondaryCutoff_ : upperPrimaryCutoff_)) continue;
-					bin = (point - histogramStart) / binDelta;
-					if (bin < 0) bin = 0;
-					else if (bin >= nBins) bin = nBins-1;
-					histogram[bin] += fabs(point);
-				}
-			}
-		}
-		else if (type_ == Grid::FreeXYZData)
-		{
-			printf("TODO - Not implemented yet!\n");
-		}
-
-		// Calculate fractions of data represented by each bin (cutoff)
-		fractions = 0.0;
-		for (n=0; n<nBins; ++n)
-		{
-			for (m=0; m<=n; ++m) fractions[m] += histogram[n];
-		}
-		fractions /= totalAbsoluteSum();
-
-		// TEST print out bin values and sums
-// 		for (n=0; n<nBins; ++n) printf("HistoBin %i (x=%f) grid% = %f\n", n, histogramStart+binDelta*n, fractions[n]*100.0);
-
-		// Find new limits for next pass
-		for (highBin=0; highBin<nBins; ++highBin) if ((fractions[highBin]*100.0) < percentage) break;
-		if (highBin >= nBins)
-		{
-			// Target cutoff is beyond the current maximum limit of the histogram?
-			Messenger::print("Unable to find suitable cutoff for requested percentage (%f)", percentage);
-			return false;
-		}
-		for (lowBin=highBin-1; lowBin>=0; --lowBin) if ((fractions[lowBin]*100.0) > percentage) break;
-		if (lowBin < 0)
-		{
-			// Target cutoff is beyond the current minimum limit of the histogram?
-			Messenger::print("Unable to find suitable cutoff for requested percentage (%f)", percentage);
-			return false;
-		}
-
-		// Set new cutoff limits for next pass
-// 		printf("Low/Hi bins are %i and %i\n", lowBin, highBin);
-		histogramStart = histogramStart+binDelta*lowBin;
-		binDelta = (binDelta*(highBin-lowBin)) / nBins;
-// 		printf("New start and delta are %f and %f\n", histogramStart, binDelta);
-
-		// Done?
-		if (binDelta < (maximum_-minimum_)*0.00001) break;
+		if (type_ == Grid::FreeXYZData) Messenger::print("View percentage cutoffs are not supported for free (irregular) grid data.");
+		return false;
 	}
+	bool result;
+	if (upperCutoff) result = dist.upperCutoff(percentage*0.01, secondary ? lowerSecondaryCutoff_ : lowerPrimaryCutoff_, newCutoff);
+	else result = dist.lowerCutoff(percentage*0.01, secondary ? upperSecondaryCutoff_ : upperPrimaryCutoff_, newCutoff);
+	if (!result) Messenger::print("Unable to find suitable cutoff for requested percentage (%f)", percentage);
 
-	newCutoff = histogramStart;
-
-	return true;
+	return result;
 }
 
 // Return pointer to the underlying cell structure
@@ -946,12 +888,193 @@ bool Grid::withinSecondaryCutoff(double d) const
 	return false;
 }
 
-// Return 3D data array
+// Set storage type for regular 3D data, converting any existing values
+void Grid::setStorageType(Grid::StorageType type)
+{
+	if (type == storageType_) return;
+	storageType_ = type;
+	if ((type_ != Grid::RegularXYZData) || ((voxels_ == NULL) && (floatVoxels_ == NULL))) return;
+
+	// Copy existing values into new storage, keeping the current point, limits and cutoffs
+	int i;
+	qint64 n, nPoints = qint64(nXYZ_.x)*nXYZ_.y*nXYZ_.z;
+	double* oldVoxels = voxels_;
+	float* oldFloatVoxels = floatVoxels_;
+	MappedFile* oldMappedFile = mappedFile_;
+	if (data3d_ != NULL)
+	{
+		for (i = 0; i<nXYZ_.x; i++) delete[] data3d_[i];
+		delete[] data3d_;
+		data3d_ = NULL;
+	}
+	voxels_ = NULL;
+	floatVoxels_ = NULL;
+	mappedFile_ = NULL;
+	if (type == Grid::FloatStorage)
+	{
+		floatVoxels_ = new float[nPoints];
+		for (n=0; n<nPoints; ++n) floatVoxels_[n] = oldVoxels[n];
+	}
+	else
+	{
+		voxels_ = new double[nPoints];
+		for (n=0; n<nPoints; ++n) voxels_[n] = oldFloatVoxels[n];
+		createRows();
+	}
+	if (oldMappedFile != NULL) delete oldMappedFile;
+	else
+	{
+		if (oldVoxels != NULL) delete[] oldVoxels;
+		if (oldFloatVoxels != NULL) delete[] oldFloatVoxels;
+	}
+	logDataChange();
+	logChange();
+}
+
+// Return storage type for regular 3D data
+Grid::StorageType Grid::storageType() const
+{
+	return storageType_;
+}
+
+// Initialise regular 3D grid with values mapped (copy-on-write) from binary data in the specified file
+bool Grid::initialiseMapped(Vec3<int> nXYZ, QString filename, qint64 offset, Grid::StorageType type)
+{
+	Messenger::enter("Grid::initialiseMapped");
+	clear();
+	type_ = Grid::RegularXYZData;
+	storageType_ = type;
+	nXYZ_ = nXYZ;
+	if (nXYZ_.min() < 1)
+	{
+		Messenger::print("Can't map 3D grid array - One or more grid limits are secondary (%i,%i,%i).", nXYZ_.x, nXYZ_.y, nXYZ_.z);
+		Messenger::exit("Grid::initialiseMapped");
+		return false;
+	}
+
+	// Map the file privately, so that any changes made to the values are never written back to it
+	int valueSize = (type == Grid::FloatStorage ? sizeof(float) : sizeof(double));
+	qint64 nPoints = qint64(nXYZ_.x)*nXYZ_.y*nXYZ_.z;
+	mappedFile_ = new MappedFile;
+	if (!mappedFile_->open(filename, true))
+	{
+		Messenger::print("Couldn't map grid data from file '%s'.", qPrintable(filename));
+		delete mappedFile_;
+		mappedFile_ = NULL;
+		Messenger::exit("Grid::initialiseMapped");
+		return false;
+	}
+	if ((offset % valueSize) != 0)
+	{
+		Messenger::print("Grid data in file '%s' is not aligned to its value size (offset is %lli).", qPrintable(filename), offset);
+		delete mappedFile_;
+		mappedFile_ = NULL;
+		Messenger::exit("Grid::initialiseMapped");
+		return false;
+	}
+	if (offset + nPoints*valueSize > mappedFile_->size())
+	{
+		Messenger::print("File '%s' is too small to contain %lli grid values.", qPrintable(filename), nPoints);
+		delete mappedFile_;
+		mappedFile_ = NULL;
+		Messenger::exit("Grid::initialiseMapped");
+		return false;
+	}
+	if (type == Grid::FloatStorage) floatVoxels_ = (float*) (mappedFile_->data() + offset);
+	else
+	{
+		voxels_ = (double*) (mappedFile_->data() + offset);
+		createRows();
+	}
+	logDataChange();
+
+	// Take limits and initial cutoffs from the octree, rather than from individually set values
+	GridOctreeNode& root = octree().root();
+	minimum_ = root.minimum;
+	maximum_ = root.maximum;
+	lowerPrimaryCutoff_ = 0.5 * maximum_;
+	upperPrimaryCutoff_ = maximum_;
+	lowerSecondaryCutoff_ = 0.5 * maximum_;
+	upperSecondaryCutoff_ = maximum_;
+	dataFull_ = true;
+
+	Messenger::print("Mapped grid structure for regular 3D XYZ data, %lli points total.", nPoints);
+	logChange();
+	Messenger::exit("Grid::initialiseMapped");
+	return true;
+}
+
+// Return whether voxel values are mapped from a file
+bool Grid::isMapped() const
+{
+	return (mappedFile_ != NULL);
+}
+
+// Return value at specified point of regular 3D data
+double Grid::value(int x, int y, int z) const
+{
+	qint64 index = (qint64(x)*nXYZ_.y + y)*nXYZ_.z + z;
+	if (floatVoxels_ != NULL) return floatVoxels_[index];
+	return voxels_[index];
+}
+
+// Return contiguous voxel values (for DoubleStorage, otherwise NULL)
+double* Grid::voxels()
+{
+	return voxels_;
+}
+
+// Return contiguous single-precision voxel values (for FloatStorage, otherwise NULL)
+float* Grid::floatVoxels()
+{
+	return floatVoxels_;
+}
+
+// Return 3D data array (for DoubleStorage, otherwise NULL)
 double** *Grid::data3d()
 {
 	return data3d_;
 }
 
+// Log change to data values (required after modifying values through data3d())
+void Grid::logDataChange()
+{
+	++dataLog_;
+}
+
+// Return min/max/sum octree over voxel values, rebuilding it first if necessary
+GridOctree& Grid::octree()
+{
+	if (octreePoint_ != dataLog_)
+	{
+		if ((type_ == Grid::RegularXYZData) && (floatVoxels_ != NULL)) octree_.build(floatVoxels_, nXYZ_, prefs.nThreadsToUse());
+		else if (type_ == Grid::RegularXYZData) octree_.build(voxels_, nXYZ_, prefs.nThreadsToUse());
+		else octree_.clear();
+		octreePoint_ = dataLog_;
+	}
+	return octree_;
+}
+
+// Return distribution of data values, rebuilding it first if necessary
+GridDistribution& Grid::distribution()
+{
+	if (distributionPoint_ != dataLog_)
+	{
+		if ((type_ == Grid::RegularXYZData) && (floatVoxels_ != NULL)) distribution_.build(floatVoxels_, qint64(nXYZ_.x)*nXYZ_.y*nXYZ_.z, prefs.nThreadsToUse());
+		else if (type_ == Grid::RegularXYZData) distribution_.build(voxels_, qint64(nXYZ_.x)*nXYZ_.y*nXYZ_.z, prefs.nThreadsToUse());
+		else if (type_ == Grid::RegularXYData)
+		{
+			Array<double> values(nXYZ_.x*nXYZ_.y);
+			for (int x=0; x<nXYZ_.x; ++x)
+				for (int y=0; y<nXYZ_.y; ++y) values[x*nXYZ_.y+y] = data2d_[x][y];
+			distribution_.build(values.array(), values.nItems(), prefs.nThreadsToUse(), true);
+		}
+		else distribution_.clear();
+		distributionPoint_ = dataLog_;
+	}
+	return distribution_;
+}
+
 // Return 2D data array
 double** Grid::data2d()
 {
@@ -1220,20 +1343,14 @@ void Grid::setColourScale(int id)
 	logChange();
 	prefs.colourScale[colourScale_].addLink(this);
 	useColourScale_ = true;
-	int i, j, k;
-	double** data2, *data1;
+	int i, j;
+	double* data1;
 	// Adjust the colour scale to encompass all grid values...
 	if (type_ == Grid::RegularXYZData)
 	{
-		for (i = 0; i < nXYZ_.x; i++)
-		{
-			data2 = data3d_[i];
-			for (j = 0; j<nXYZ_.y; j++)
-			{
-				data1 = data2[j];
-				for (k = 0; k<nXYZ_.z; k++) prefs.colourScale[colourScale_].adjustRange(data1[k]);
-			}
-		}
+		GridOctree& tree = octree();
+		prefs.colourScale[colourScale_].adjustRange(tree.root().minimum);
+		prefs.colourScale[colourScale_].adjustRange(tree.root().maximum);
 	}
 	else if (type_ == Grid::RegularXYData)
 	{
@@ -1433,7 +1550,6 @@ void Grid::sendSecondaryPrimitive()
 		if (!secondaryPrimitive_.registeredAsDynamic()) PrimitiveSet::registerDynamicPrimitive(&secondaryPrimitive_);
 
 		Vec4<GLfloat> colour(secondaryColour_[0], secondaryColour_[1], secondaryColour_[2], secondaryColour_[3]);
-		secondaryPrimitive_.marchingCubes(this, lowerSecondaryCutoff_, upperSecondaryCutoff_, useColourScale_ ? colourScale_ : -1);
 		if (type_ == Grid::RegularXYData) secondaryPrimitive_.createSurface(this, colour, useColourScale_ ? colourScale_ : -1);
 		else if (type_ == Grid::RegularXYZData) secondaryPrimitive_.marchingCubes(this, lowerSecondaryCutoff_, upperSecondaryCutoff_, useColourScale_ ? colourScale_ : -1);
 		else printf("Don't know how to create a primitive based on this type of Grid data (%s)\n", Grid::gridType(type_));
@@ -1484,8 +1600,9 @@ void Grid::setData(int x, int y, int z, double d)
 		return;
 	}
 	// Okay, so store data
-	if (type_ == Grid::RegularXYZData) data3d_[x][y][z] = d;
+	if (type_ == Grid::RegularXYZData) setVoxel(x, y, z, d);
 	else data2d_[x][y] = d;
+	logDataChange();
 	// Set new minimum / maximum
 	setLimits(d);
 }
@@ -1502,7 +1619,7 @@ void Grid::setNextData(double d)
 	// Set current point referenced by currentpoint and increase it
 	if (type_ == Grid::RegularXYZData)
 	{
-		data3d_[currentPoint_.x][currentPoint_.y][currentPoint_.z] = d;
+		setVoxel(currentPoint_.x, currentPoint_.y, currentPoint_.z, d);
 		currentPoint_.set(loopOrder_.x, currentPoint_.get(loopOrder_.x) + 1);
 		if (currentPoint_.get(loopOrder_.x) == nXYZ_.get(loopOrder_.x))
 		{
@@ -1527,6 +1644,7 @@ void Grid::setNextData(double d)
 			if (currentPoint_.get(loopOrder_.y) == nXYZ_.get(loopOrder_.y)) dataFull_ = true;
 		}
 	}
+	logDataChange();
 	// Set new minimum / maximum
 	setLimits(d);
 }
@@ -1576,7 +1694,7 @@ int Grid::modifyRegion(int startX, int startY, int startZ, double minValue, doub
 			Vec3<int>& vec = queue.last();
 
 			// If this cell value is not in the range required, remove point from queue and continue
-			value = data3d_[vec.x][vec.y][vec.z];
+			value = Grid::value(vec.x, vec.y, vec.z);
 			if ((value < minValue) || (value > maxValue))
 			{
 				queue.removeLast();
@@ -1597,7 +1715,7 @@ int Grid::modifyRegion(int startX, int startY, int startZ, double minValue, doub
 					// Fold position if necessary
 					if (v[x] < 0) { if (periodic) v.set(x,nXYZ_[x]-1); else continue; }
 					else if (v[x] >= nXYZ_[x]) { if (periodic) v.set(x,0); else continue; }
-					value = data3d_[v.x][v.y][v.z];
+					value = Grid::value(v.x, v.y, v.z);
 					if ((value < minValue) || (value > maxValue)) continue;
 					else
 					{
@@ -25,6 +25,8 @@
 #include "templates/vector3.h"
 #include "base/cell.h"
 #include "base/gridpoint.h"
+#include "base/gridoctree.h"
+#include "base/griddistribution.h"
 #include "math/constants.h"
 #include "base/namespace.h"
 #include "render/primitive.h"
@@ -34,6 +36,7 @@ ATEN_BEGIN_NAMESPACE
 
 // Forward Declarations
 class FilePluginInterface;
+class MappedFile;
 
 // Grid Data
 class Grid : public ListItem<Grid>, ObjectStore<Grid>
@@ -46,6 +49,10 @@ class Grid : public ListItem<Grid>, ObjectStore<Grid>
 	enum GridType { NoData, RegularXYData, RegularXYZData, FreeXYZData, nGridTypes };
 	static GridType gridType(QString s, bool reportError = false);
 	static const char* gridType(Grid::GridType gt);
+	// Storage types for regular 3D data
+	enum StorageType { DoubleStorage, FloatStorage, nStorageTypes };
+	static StorageType storageType(QString s, bool reportError = false);
+	static const char* storageType(Grid::StorageType st);
 	// Surface rendering styles
 	enum SurfaceStyle { PointSurface, MeshSurface, SolidSurface, nSurfaceStyles };
 	static SurfaceStyle surfaceStyle(QString s);
@@ -114,8 +121,16 @@ class Grid : public ListItem<Grid>, ObjectStore<Grid>
 	Vec3<int> axisMinorTicks_;
 	// Number of points in each direction
 	Vec3<int> nXYZ_;
-	// Voxel values
+	// Storage type for regular 3D data
+	StorageType storageType_;
+	// Voxel values (for DoubleStorage only)
 	double** *data3d_;
+	// Contiguous storage for voxel values (indexed by the rows of data3d_)
+	double* voxels_;
+	// Contiguous single-precision storage for voxel values (for FloatStorage)
+	float* floatVoxels_;
+	// File from which voxel values are mapped, if any
+	MappedFile* mappedFile_;
 	// Surface values
 	double** data2d_;
 	// Free grid data
@@ -139,6 +154,16 @@ class Grid : public ListItem<Grid>, ObjectStore<Grid>
 	double totalPositiveSum_, totalNegativeSum_;
 	// Partial sums of the grid surfaces, determined by cutoffs
 	double partialPrimarySum_, partialSecondarySum_;
+	// Log point for changes to data values
+	int dataLog_;
+	// Min/max/sum octree over voxel values
+	GridOctree octree_;
+	// Data log point at which octree was last built
+	int octreePoint_;
+	// Distribution (range and sum) of data values, used to find view-percentage cutoffs
+	GridDistribution distribution_;
+	// Data log point at which distribution was last built
+	int distributionPoint_;
 
 	private:
 	// Clear all data
@@ -147,6 +172,10 @@ class Grid : public ListItem<Grid>, ObjectStore<Grid>
 	void deleteArrays();
 	// Allocate grid arrays
 	bool allocateArrays();
+	// Create row pointers into contiguous voxel storage
+	void createRows();
+	// Set value at specified point of regular 3D data
+	void setVoxel(int x, int y, int z, double d);
 	// Update minimum and maximum values
 	void setLimits(double d);
 	// Calculate sums
@@ -237,8 +266,28 @@ class Grid : public ListItem<Grid>, ObjectStore<Grid>
 	double upperSecondaryCutoff() const;
 	// Return whether supplied number is within secondary cutoff range
 	bool withinSecondaryCutoff(double d) const;
-	// Return 3D data array
+	// Set storage type for regular 3D data, converting any existing values
+	void setStorageType(StorageType type);
+	// Return storage type for regular 3D data
+	StorageType storageType() const;
+	// Initialise regular 3D grid with values mapped (copy-on-write) from binary data in the specified file
+	bool initialiseMapped(Vec3<int> nXYZ, QString filename, qint64 offset, StorageType type);
+	// Return whether voxel values are mapped from a file
+	bool isMapped() const;
+	// Return value at specified point of regular 3D data
+	double value(int x, int y, int z) const;
+	// Return contiguous voxel values (for DoubleStorage, otherwise NULL)
+	double* voxels();
+	// Return contiguous single-precision voxel values (for FloatStorage, otherwise NULL)
+	float* floatVoxels();
+	// Return 3D data array (for DoubleStorage, otherwise NULL)
 	double*** data3d();
+	// Log change to data values (required after modifying values through data3d())
+	void logDataChange();
+	// Return min/max/sum octree over voxel values, rebuilding it first if necessary
+	GridOctree& octree();
+	// Return distribution of data values, rebuilding it first if necessary
+	GridDistribution& distribution();
 	// Return 2D data array
 	double** data2d();
 	// Return head of gridpoints array
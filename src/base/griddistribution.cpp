@@ -0,0 +1,276 @@
+/*
+	*** Grid value distribution
+	*** src/base/griddistribution.cpp
+	Copyright T. Youngs 2007-2017
+
+	This file is part of Aten.
+
+	Aten is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Aten is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Aten.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "base/griddistribution.h"
+#include "base/threadpool.h"
+#include <algorithm>
+#include <math.h>
+
+ATEN_USING_NAMESPACE
+
+// Number of histogram bins used to locate the bin containing a cutoff
+static const int nCutoffBins = 4096;
+// Relative tolerance on target sums, since partial sums are accumulated in a different order to the total
+static const double sumTolerance = 1.0e-10;
+
+// Return number of chunks (one per thread) into which values should be split, and the size of each
+static int chunkValues(qint64 nValues, int nThreads, qint64& chunkSize)
+{
+	int nChunks = (nThreads < 1 ? 1 : nThreads);
+	if (nChunks > nValues) nChunks = nValues;
+	chunkSize = (nValues + nChunks - 1) / nChunks;
+	return nChunks;
+}
+
+// Determine range and total absolute sum of values, using the specified number of threads
+template <class T> static void scanValues(const T* values, qint64 nValues, int nThreads, double& minimum, double& maximum, double& total)
+{
+	qint64 chunkSize;
+	int nChunks = chunkValues(nValues, nThreads, chunkSize);
+	Array<double> chunkData(nChunks*3);
+	ThreadPool::run(nChunks, nThreads, [&](int task, int thread)
+	{
+		qint64 first = task*chunkSize, last = (first+chunkSize < nValues ? first+chunkSize : nValues);
+		double* data = chunkData.array() + task*3;
+		data[0] = values[first];
+		data[1] = values[first];
+		data[2] = 0.0;
+		for (qint64 n=first; n<last; ++n)
+		{
+			if (values[n] < data[0]) data[0] = values[n];
+			else if (values[n] > data[1]) data[1] = values[n];
+			data[2] += fabs(values[n]);
+		}
+	});
+	minimum = chunkData[0];
+	maximum = chunkData[1];
+	total = 0.0;
+	for (int n=0; n<nChunks; ++n)
+	{
+		if (chunkData[n*3] < minimum) minimum = chunkData[n*3];
+		if (chunkData[n*3+1] > maximum) maximum = chunkData[n*3+1];
+		total += chunkData[n*3+2];
+	}
+}
+
+// Return absolute sum of values lying between the limits supplied, using the specified number of threads
+template <class T> static double sumValues(const T* values, qint64 nValues, int nThreads, double lowerLimit, double upperLimit)
+{
+	qint64 chunkSize;
+	int nChunks = chunkValues(nValues, nThreads, chunkSize);
+	Array<double> chunkSums(nChunks);
+	ThreadPool::run(nChunks, nThreads, [&](int task, int thread)
+	{
+		qint64 first = task*chunkSize, last = (first+chunkSize < nValues ? first+chunkSize : nValues);
+		double sum = 0.0;
+		for (qint64 n=first; n<last; ++n) if ((values[n] >= lowerLimit) && (values[n] <= upperLimit)) sum += fabs(values[n]);
+		chunkSums[task] = sum;
+	});
+	double total = 0.0;
+	for (int n=0; n<nChunks; ++n) total += chunkSums[n];
+	return total;
+}
+
+/*
+ * Find the cutoff such that the absolute sum of values between it and one of the limits reaches the target. Accumulating from the
+ * upper limit, this is the largest value v for which the sum over v <= x <= upperLimit is at least the target, and accumulating from
+ * the lower limit, the smallest value v for which the sum over lowerLimit <= x <= v is.
+ * A histogram of absolute sums over the limits locates the bin containing the cutoff, and the values in that bin alone are then
+ * copied and partitioned (selecting on the sum, rather than the count, of the values either side of each pivot) to find it exactly.
+ */
+template <class T> static bool findCutoff(const T* values, qint64 nValues, int nThreads, double lowerLimit, double upperLimit, double target, bool fromUpper, double& cutoff)
+{
+	if (upperLimit < lowerLimit) return false;
+	double scale = (upperLimit > lowerLimit ? nCutoffBins / (upperLimit - lowerLimit) : 0.0);
+	auto bin = [&](T value) { int b = int((value - lowerLimit) * scale); return (b < nCutoffBins ? b : nCutoffBins-1); };
+
+	// Histogram absolute sums and counts of values within the limits, one histogram per chunk
+	qint64 n, chunkSize;
+	int b, nChunks = chunkValues(nValues, nThreads, chunkSize);
+	Array<double> sums;
+	Array<qint64> counts;
+	sums.createEmpty(nChunks*nCutoffBins, 0.0);
+	counts.createEmpty(nChunks*nCutoffBins, 0);
+	ThreadPool::run(nChunks, nThreads, [&](int task, int thread)
+	{
+		qint64 first = task*chunkSize, last = (first+chunkSize < nValues ? first+chunkSize : nValues);
+		int index;
+		double* chunkSums = sums.array() + task*nCutoffBins;
+		qint64* chunkCounts = counts.array() + task*nCutoffBins;
+		for (qint64 m=first; m<last; ++m)
+		{
+			if ((values[m] < lowerLimit) || (values[m] > upperLimit)) continue;
+			index = bin(values[m]);
+			chunkSums[index] += fabs(values[m]);
+			++chunkCounts[index];
+		}
+	});
+	for (n=1; n<nChunks; ++n)
+	{
+		for (b=0; b<nCutoffBins; ++b)
+		{
+			sums[b] += sums[n*nCutoffBins+b];
+			counts[b] += counts[n*nCutoffBins+b];
+		}
+	}
+
+	// Walk bins from the accumulation limit until the target is reached
+	double accumulated = 0.0;
+	for (b = (fromUpper ? nCutoffBins-1 : 0); (b >= 0) && (b < nCutoffBins); b += (fromUpper ? -1 : 1))
+	{
+		if (counts[b] == 0) continue;
+		if (accumulated + sums[b] >= target) break;
+		accumulated += sums[b];
+	}
+	if ((b < 0) || (b >= nCutoffBins)) return false;
+
+	// Copy values in the bin, and select the cutoff from them
+	T* data = new T[counts[b]];
+	qint64 first = 0, last = 0, mid;
+	for (n=0; n<nValues; ++n) if ((values[n] >= lowerLimit) && (values[n] <= upperLimit) && (bin(values[n]) == b)) data[last++] = values[n];
+	double remaining = target - accumulated, sum;
+	while (last - first > 1)
+	{
+		// Partition so that values [first,mid) are not greater than any of [mid,last), and sum those on the side of the accumulation limit
+		mid = (first + last) / 2;
+		std::nth_element(data+first, data+mid, data+last);
+		sum = 0.0;
+		if (fromUpper)
+		{
+			for (n=mid; n<last; ++n) sum += fabs(data[n]);
+			if (sum >= remaining) first = mid;
+			else
+			{
+				remaining -= sum;
+				last = mid;
+			}
+		}
+		else
+		{
+			for (n=first; n<mid; ++n) sum += fabs(data[n]);
+			if (sum >= remaining) last = mid;
+			else
+			{
+				remaining -= sum;
+				first = mid;
+			}
+		}
+	}
+	cutoff = data[first];
+	delete[] data;
+	return true;
+}
+
+// Constructor
+GridDistribution::GridDistribution()
+{
+	// Private variables
+	values_ = NULL;
+	floatValues_ = NULL;
+	nValues_ = 0;
+	nThreads_ = 1;
+	minimum_ = 0.0;
+	maximum_ = 0.0;
+	totalAbsoluteSum_ = 0.0;
+}
+
+/*
+ * Data
+ */
+
+// Clear data
+void GridDistribution::clear()
+{
+	values_ = NULL;
+	floatValues_ = NULL;
+	valuesCopy_.clear();
+	nValues_ = 0;
+	minimum_ = 0.0;
+	maximum_ = 0.0;
+	totalAbsoluteSum_ = 0.0;
+}
+
+// Set source values (copying them if they are temporary) and determine their range and sum, using the specified number of threads
+void GridDistribution::build(const double* values, qint64 nValues, int nThreads, bool copyValues)
+{
+	clear();
+	if ((values == NULL) || (nValues < 1)) return;
+
+	if (copyValues)
+	{
+		valuesCopy_.createEmpty(nValues);
+		for (qint64 n=0; n<nValues; ++n) valuesCopy_[n] = values[n];
+		values = valuesCopy_.array();
+	}
+	values_ = values;
+	nValues_ = nValues;
+	nThreads_ = nThreads;
+	scanValues(values_, nValues_, nThreads_, minimum_, maximum_, totalAbsoluteSum_);
+}
+
+void GridDistribution::build(const float* values, qint64 nValues, int nThreads)
+{
+	clear();
+	if ((values == NULL) || (nValues < 1)) return;
+
+	floatValues_ = values;
+	nValues_ = nValues;
+	nThreads_ = nThreads;
+	scanValues(floatValues_, nValues_, nThreads_, minimum_, maximum_, totalAbsoluteSum_);
+}
+
+// Return number of values in distribution
+qint64 GridDistribution::nValues() const
+{
+	return nValues_;
+}
+
+// Return total absolute sum of values
+double GridDistribution::totalAbsoluteSum()
+{
+	return totalAbsoluteSum_;
+}
+
+// Return absolute sum of values lying between the limits supplied
+double GridDistribution::absoluteSum(double lowerLimit, double upperLimit)
+{
+	if (nValues_ == 0) return 0.0;
+	if (floatValues_ != NULL) return sumValues(floatValues_, nValues_, nThreads_, lowerLimit, upperLimit);
+	return sumValues(values_, nValues_, nThreads_, lowerLimit, upperLimit);
+}
+
+// Find lower cutoff such that the absolute sum of values between it and the upper limit supplied is the specified fraction of the total
+bool GridDistribution::lowerCutoff(double fraction, double upperLimit, double& cutoff)
+{
+	if (nValues_ == 0) return false;
+	double target = (fraction - sumTolerance) * totalAbsoluteSum_, limit = (upperLimit < maximum_ ? upperLimit : maximum_);
+	if (floatValues_ != NULL) return findCutoff(floatValues_, nValues_, nThreads_, minimum_, limit, target, true, cutoff);
+	return findCutoff(values_, nValues_, nThreads_, minimum_, limit, target, true, cutoff);
+}
+
+// Find upper cutoff such that the absolute sum of values between the lower limit supplied and it is the specified fraction of the total
+bool GridDistribution::upperCutoff(double fraction, double lowerLimit, double& cutoff)
+{
+	if (nValues_ == 0) return false;
+	double target = (fraction - sumTolerance) * totalAbsoluteSum_, limit = (lowerLimit > minimum_ ? lowerLimit : minimum_);
+	if (floatValues_ != NULL) return findCutoff(floatValues_, nValues_, nThreads_, limit, maximum_, target, false, cutoff);
+	return findCutoff(values_, nValues_, nThreads_, limit, maximum_, target, false, cutoff);
+}
@@ -0,0 +1,83 @@
+/*
+	*** Grid value distribution
+	*** src/base/griddistribution.h
+	Copyright T. Youngs 2007-2017
+
+	This file is part of Aten.
+
+	Aten is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Aten is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Aten.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef ATEN_GRIDDISTRIBUTION_H
+#define ATEN_GRIDDISTRIBUTION_H
+
+#include "templates/array.h"
+#include "base/namespace.h"
+#include <QtGlobal>
+
+ATEN_BEGIN_NAMESPACE
+
+// Forward Declarations (Aten)
+/* none */
+
+// Grid Value Distribution
+// Range and total absolute sum of a grid's values, from which the cutoff enclosing any fraction of the total absolute density
+// can be found exactly. The grid's own data are referenced rather than copied - each query histograms the values, and then
+// selects within the single bin containing the cutoff, so only a temporary buffer of the values in that bin is ever held.
+class GridDistribution
+{
+	public:
+	// Constructor
+	GridDistribution();
+
+
+	/*
+	 * Data
+	 */
+	private:
+	// Source values (only one of which is used, matching the precision of the source data)
+	const double* values_;
+	const float* floatValues_;
+	// Copy of the source values, made only when the supplied values are temporary
+	Array<double> valuesCopy_;
+	// Number of values
+	qint64 nValues_;
+	// Number of threads to use when scanning values
+	int nThreads_;
+	// Minimum and maximum values
+	double minimum_, maximum_;
+	// Total absolute sum of values
+	double totalAbsoluteSum_;
+
+	public:
+	// Clear data
+	void clear();
+	// Set source values (copying them if they are temporary) and determine their range and sum, using the specified number of threads
+	void build(const double* values, qint64 nValues, int nThreads, bool copyValues = false);
+	void build(const float* values, qint64 nValues, int nThreads);
+	// Return number of values in distribution
+	qint64 nValues() const;
+	// Return total absolute sum of values
+	double totalAbsoluteSum();
+	// Return absolute sum of values lying between the limits supplied
+	double absoluteSum(double lowerLimit, double upperLimit);
+	// Find lower cutoff such that the absolute sum of values between it and the upper limit supplied is the specified fraction of the total
+	bool lowerCutoff(double fraction, double upperLimit, double& cutoff);
+	// Find upper cutoff such that the absolute sum of values between the lower limit supplied and it is the specified fraction of the total
+	bool upperCutoff(double fraction, double lowerLimit, double& cutoff);
+};
+
+ATEN_END_NAMESPACE
+
+#endif
@@ -0,0 +1,328 @@
+/*
+	*** Grid min/max/sum octree
+	*** src/base/gridoctree.cpp
+	Copyright T. Youngs 2007-2017
+
+	This file is part of Aten.
+
+	Aten is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Aten is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Aten.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "base/gridoctree.h"
+#include "base/threadpool.h"
+#include <QtGlobal>
+#include <limits>
+
+ATEN_USING_NAMESPACE
+
+// Accumulate node data for specified region of points
+template <class T> static void scanRegion(const T* data, Vec3<int> nPoints, Vec3<int> first, Vec3<int> last, GridOctreeNode& result)
+{
+	int x, y, z;
+	double value;
+	const T* row;
+	for (x=first.x; x<=last.x; ++x)
+	{
+		for (y=first.y; y<=last.y; ++y)
+		{
+			row = &data[(qint64(x)*nPoints.y + y)*nPoints.z];
+			for (z=first.z; z<=last.z; ++z)
+			{
+				value = row[z];
+				if (value < result.minimum) result.minimum = value;
+				if (value > result.maximum) result.maximum = value;
+				if (value > 0.0) result.positiveSum += value;
+				else result.negativeSum += value;
+			}
+		}
+	}
+}
+
+// Accumulate sums of values between cutoffs for specified region of points
+template <class T> static void sumRegion(const T* data, Vec3<int> nPoints, Vec3<int> first, Vec3<int> last, double lowerCutoff, double upperCutoff, double& positiveSum, double& negativeSum)
+{
+	int x, y, z;
+	double value;
+	const T* row;
+	for (x=first.x; x<=last.x; ++x)
+	{
+		for (y=first.y; y<=last.y; ++y)
+		{
+			row = &data[(qint64(x)*nPoints.y + y)*nPoints.z];
+			for (z=first.z; z<=last.z; ++z)
+			{
+				value = row[z];
+				if ((value < lowerCutoff) || (value > upperCutoff)) continue;
+				if (value > 0.0) positiveSum += value;
+				else negativeSum += value;
+			}
+		}
+	}
+}
+
+/*
+ * Grid Octree Node
+ */
+
+// Constructor
+GridOctreeNode::GridOctreeNode()
+{
+	minimum = std::numeric_limits<double>::max();
+	maximum = -std::numeric_limits<double>::max();
+	positiveSum = 0.0;
+	negativeSum = 0.0;
+}
+
+// Combine supplied node into this one
+void GridOctreeNode::combine(const GridOctreeNode& node)
+{
+	if (node.minimum < minimum) minimum = node.minimum;
+	if (node.maximum > maximum) maximum = node.maximum;
+	positiveSum += node.positiveSum;
+	negativeSum += node.negativeSum;
+}
+
+/*
+ * Grid Octree
+ */
+
+// Constructor
+GridOctree::GridOctree()
+{
+	// Private variables
+	brickSize_ = 8;
+	data_ = NULL;
+	floatData_ = NULL;
+	nLevels_ = 0;
+}
+
+/*
+ * Tree
+ */
+
+// Return node at specified level and position
+GridOctreeNode& GridOctree::node(int level, int i, int j, int k)
+{
+	return nodes_[level].array()[(i*levelDims_[level].y + j)*levelDims_[level].z + k];
+}
+
+// Calculate node data for specified region of points
+void GridOctree::scanPoints(Vec3<int> first, Vec3<int> last, GridOctreeNode& result)
+{
+	if (floatData_ != NULL) scanRegion(floatData_, nPoints_, first, last, result);
+	else scanRegion(data_, nPoints_, first, last, result);
+}
+
+// Accumulate sums of values between cutoffs for specified node
+void GridOctree::sumNode(int level, int i, int j, int k, double lowerCutoff, double upperCutoff, double& positiveSum, double& negativeSum)
+{
+	GridOctreeNode& target = node(level, i, j, k);
+
+	// Node lies entirely outside or inside the cutoffs?
+	if ((target.maximum < lowerCutoff) || (target.minimum > upperCutoff)) return;
+	if ((target.minimum >= lowerCutoff) && (target.maximum <= upperCutoff))
+	{
+		positiveSum += target.positiveSum;
+		negativeSum += target.negativeSum;
+		return;
+	}
+
+	// Brick straddles a cutoff, so visit its points
+	if (level == 0)
+	{
+		Vec3<int> first(i*brickSize_, j*brickSize_, k*brickSize_), last;
+		for (int n=0; n<3; ++n) last[n] = (first[n]+brickSize_ < nPoints_[n] ? first[n]+brickSize_ : nPoints_[n]) - 1;
+		if (floatData_ != NULL) sumRegion(floatData_, nPoints_, first, last, lowerCutoff, upperCutoff, positiveSum, negativeSum);
+		else sumRegion(data_, nPoints_, first, last, lowerCutoff, upperCutoff, positiveSum, negativeSum);
+		return;
+	}
+
+	// Descend to child nodes
+	const Vec3<int>& childDims = levelDims_[level-1];
+	for (int a = i*2; (a < i*2+2) && (a < childDims.x); ++a)
+		for (int b = j*2; (b < j*2+2) && (b < childDims.y); ++b)
+			for (int c = k*2; (c < k*2+2) && (c < childDims.z); ++c) sumNode(level-1, a, b, c, lowerCutoff, upperCutoff, positiveSum, negativeSum);
+}
+
+// Accumulate bounds on values within region for specified node
+void GridOctree::boundsNode(int level, int i, int j, int k, Vec3<int> first, Vec3<int> last, GridOctreeNode& result)
+{
+	// Determine range of points covered by node, and check for overlap with the region
+	int extent = brickSize_ << level, n;
+	Vec3<int> nodeFirst(i*extent, j*extent, k*extent);
+	bool contained = true;
+	for (n=0; n<3; ++n)
+	{
+		if ((nodeFirst[n] > last[n]) || (nodeFirst[n]+extent-1 < first[n])) return;
+		if ((nodeFirst[n] < first[n]) || (nodeFirst[n]+extent-1 > last[n])) contained = false;
+	}
+
+	// Bricks are used whole even if only partially covered by the region
+	if (contained || (level == 0))
+	{
+		result.combine(node(level, i, j, k));
+		return;
+	}
+
+	// Descend to child nodes
+	const Vec3<int>& childDims = levelDims_[level-1];
+	for (int a = i*2; (a < i*2+2) && (a < childDims.x); ++a)
+		for (int b = j*2; (b < j*2+2) && (b < childDims.y); ++b)
+			for (int c = k*2; (c < k*2+2) && (c < childDims.z); ++c) boundsNode(level-1, a, b, c, first, last, result);
+}
+
+// Clear tree
+void GridOctree::clear()
+{
+	for (int n=0; n<nLevels_; ++n) nodes_[n].clear();
+	nLevels_ = 0;
+	data_ = NULL;
+	floatData_ = NULL;
+}
+
+// Build levels of tree over source data, using the specified number of threads
+void GridOctree::buildLevels(Vec3<int> nPoints, int nThreads)
+{
+	nPoints_ = nPoints;
+
+	// Determine dimensions of each level, halving (and rounding up) until a single node remains
+	levelDims_[0].set((nPoints.x + brickSize_ - 1) / brickSize_, (nPoints.y + brickSize_ - 1) / brickSize_, (nPoints.z + brickSize_ - 1) / brickSize_);
+	nLevels_ = 1;
+	while ((levelDims_[nLevels_-1].max() > 1) && (nLevels_ < MAXOCTREELEVELS))
+	{
+		const Vec3<int>& dims = levelDims_[nLevels_-1];
+		levelDims_[nLevels_].set((dims.x + 1) / 2, (dims.y + 1) / 2, (dims.z + 1) / 2);
+		++nLevels_;
+	}
+	for (int n=0; n<nLevels_; ++n) nodes_[n].createEmpty(levelDims_[n].x * levelDims_[n].y * levelDims_[n].z);
+
+	// Scan bricks in parallel - each thread writes only to the bricks it is given
+	const Vec3<int> brickDims = levelDims_[0];
+	ThreadPool::run(brickDims.x, nThreads, [&](int task, int thread)
+	{
+		Vec3<int> first, last;
+		for (int j=0; j<brickDims.y; ++j)
+		{
+			for (int k=0; k<brickDims.z; ++k)
+			{
+				first.set(task*brickSize_, j*brickSize_, k*brickSize_);
+				for (int n=0; n<3; ++n) last[n] = (first[n]+brickSize_ < nPoints_[n] ? first[n]+brickSize_ : nPoints_[n]) - 1;
+				scanPoints(first, last, node(0, task, j, k));
+			}
+		}
+	});
+
+	// Combine nodes into successively coarser levels
+	for (int level=1; level<nLevels_; ++level)
+	{
+		const Vec3<int>& childDims = levelDims_[level-1];
+		for (int i=0; i<childDims.x; ++i)
+			for (int j=0; j<childDims.y; ++j)
+				for (int k=0; k<childDims.z; ++k) node(level, i/2, j/2, k/2).combine(node(level-1, i, j, k));
+	}
+}
+
+// Build tree over supplied data, using the specified number of threads
+void GridOctree::build(const double* data, Vec3<int> nPoints, int nThreads)
+{
+	clear();
+	if ((data == NULL) || (nPoints.min() < 1)) return;
+	data_ = data;
+	buildLevels(nPoints, nThreads);
+}
+
+void GridOctree::build(const float* data, Vec3<int> nPoints, int nThreads)
+{
+	clear();
+	if ((data == NULL) || (nPoints.min() < 1)) return;
+	floatData_ = data;
+	buildLevels(nPoints, nThreads);
+}
+
+// Return whether the tree has been built
+bool GridOctree::isBuilt() const
+{
+	return (nLevels_ > 0);
+}
+
+// Return number of bricks at the lowest level of the tree
+int GridOctree::nBricks() const
+{
+	return (nLevels_ > 0 ? nodes_[0].nItems() : 0);
+}
+
+// Return root node, summarising all data
+GridOctreeNode& GridOctree::root()
+{
+	if (nLevels_ == 0) return emptyNode_;
+	return nodes_[nLevels_-1][0];
+}
+
+// Return sums of positive and negative values lying between the cutoffs supplied
+void GridOctree::sum(double lowerCutoff, double upperCutoff, double& positiveSum, double& negativeSum)
+{
+	positiveSum = 0.0;
+	negativeSum = 0.0;
+	if (nLevels_ == 0) return;
+	sumNode(nLevels_-1, 0, 0, 0, lowerCutoff, upperCutoff, positiveSum, negativeSum);
+}
+
+// Return limits on values within the region of points supplied (which may wrap around the grid), from the bricks it intersects
+void GridOctree::bounds(Vec3<int> first, Vec3<int> last, double& minimum, double& maximum)
+{
+	GridOctreeNode result;
+	if (nLevels_ > 0)
+	{
+		// Fold the region into the grid, splitting it into two pieces along any axis over whose edge it wraps
+		Vec3<int> pieceFirst[2], pieceLast[2], nPieces;
+		int n, length;
+		for (n=0; n<3; ++n)
+		{
+			length = last[n] - first[n];
+			if (length >= nPoints_[n]-1)
+			{
+				pieceFirst[0][n] = 0;
+				pieceLast[0][n] = nPoints_[n]-1;
+				nPieces[n] = 1;
+				continue;
+			}
+			pieceFirst[0][n] = ((first[n] % nPoints_[n]) + nPoints_[n]) % nPoints_[n];
+			pieceLast[0][n] = pieceFirst[0][n] + length;
+			nPieces[n] = 1;
+			if (pieceLast[0][n] >= nPoints_[n])
+			{
+				pieceFirst[1][n] = 0;
+				pieceLast[1][n] = pieceLast[0][n] - nPoints_[n];
+				pieceLast[0][n] = nPoints_[n]-1;
+				nPieces[n] = 2;
+			}
+		}
+
+		Vec3<int> regionFirst, regionLast;
+		for (int a=0; a<nPieces.x; ++a)
+		{
+			for (int b=0; b<nPieces.y; ++b)
+			{
+				for (int c=0; c<nPieces.z; ++c)
+				{
+					regionFirst.set(pieceFirst[a].x, pieceFirst[b].y, pieceFirst[c].z);
+					regionLast.set(pieceLast[a].x, pieceLast[b].y, pieceLast[c].z);
+					boundsNode(nLevels_-1, 0, 0, 0, regionFirst, regionLast, result);
+				}
+			}
+		}
+	}
+	minimum = result.minimum;
+	maximum = result.maximum;
+}
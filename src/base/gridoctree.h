@@ -0,0 +1,113 @@
+/*
+	*** Grid min/max/sum octree
+	*** src/base/gridoctree.h
+	Copyright T. Youngs 2007-2017
+
+	This file is part of Aten.
+
+	Aten is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Aten is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Aten.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef ATEN_GRIDOCTREE_H
+#define ATEN_GRIDOCTREE_H
+
+#include "templates/array.h"
+#include "templates/vector3.h"
+#include "base/namespace.h"
+
+#define MAXOCTREELEVELS 24
+
+ATEN_BEGIN_NAMESPACE
+
+// Forward Declarations (Aten)
+/* none */
+
+// Grid Octree Node
+class GridOctreeNode
+{
+	public:
+	// Constructor
+	GridOctreeNode();
+	// Minimum and maximum values within node
+	double minimum, maximum;
+	// Sums of positive and negative values within node
+	double positiveSum, negativeSum;
+	// Combine supplied node into this one
+	void combine(const GridOctreeNode& node);
+};
+
+// Grid Octree
+// Summarises contiguous (x-major) 3D grid data, held in double or single precision, as bricks of points, each holding the range
+// and sums of its values, and builds successively coarser levels over them so that range and cutoff queries can avoid visiting
+// individual points
+class GridOctree
+{
+	public:
+	// Constructor
+	GridOctree();
+
+
+	/*
+	 * Tree
+	 */
+	private:
+	// Number of points along each side of a brick
+	int brickSize_;
+	// Source data (only one of which is set)
+	const double* data_;
+	const float* floatData_;
+	// Number of grid points along each axis
+	Vec3<int> nPoints_;
+	// Number of levels in tree
+	int nLevels_;
+	// Number of nodes along each axis at each level
+	Vec3<int> levelDims_[MAXOCTREELEVELS];
+	// Nodes at each level (level zero contains the bricks, and the last level the single root node)
+	Array<GridOctreeNode> nodes_[MAXOCTREELEVELS];
+	// Empty node, returned as the root when no tree exists
+	GridOctreeNode emptyNode_;
+
+	private:
+	// Return node at specified level and position
+	GridOctreeNode& node(int level, int i, int j, int k);
+	// Build levels of tree over source data, using the specified number of threads
+	void buildLevels(Vec3<int> nPoints, int nThreads);
+	// Calculate node data for specified region of points
+	void scanPoints(Vec3<int> first, Vec3<int> last, GridOctreeNode& result);
+	// Accumulate sums of values between cutoffs for specified node
+	void sumNode(int level, int i, int j, int k, double lowerCutoff, double upperCutoff, double& positiveSum, double& negativeSum);
+	// Accumulate bounds on values within region for specified node
+	void boundsNode(int level, int i, int j, int k, Vec3<int> first, Vec3<int> last, GridOctreeNode& result);
+
+	public:
+	// Clear tree
+	void clear();
+	// Build tree over supplied data, using the specified number of threads
+	void build(const double* data, Vec3<int> nPoints, int nThreads);
+	void build(const float* data, Vec3<int> nPoints, int nThreads);
+	// Return whether the tree has been built
+	bool isBuilt() const;
+	// Return number of bricks at the lowest level of the tree
+	int nBricks() const;
+	// Return root node, summarising all data
+	GridOctreeNode& root();
+	// Return sums of positive and negative values lying between the cutoffs supplied
+	void sum(double lowerCutoff, double upperCutoff, double& positiveSum, double& negativeSum);
+	// Return limits on values within the region of points supplied (which may wrap around the grid), from the bricks it intersects
+	void bounds(Vec3<int> first, Vec3<int> last, double& minimum, double& maximum);
+};
+
+ATEN_END_NAMESPACE
+
+#endif
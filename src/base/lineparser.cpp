@@ -25,8 +25,11 @@
 #include "math/constants.h"
 #include "parser/format.h"
 #include "base/messenger.h"
+#include "base/mappedfile.h"
 #include <string.h>
 #include <stdarg.h>
+#include <stdlib.h>
+#include <limits.h>
 
 ATEN_USING_NAMESPACE
 
@@ -47,6 +50,7 @@ LineParser::LineParser()
 LineParser::~LineParser()
 {
 	if (inputFile_ != NULL) delete inputFile_;
+	if (mappedInput_ != NULL) delete mappedInput_;
 	if (outputFile_ != NULL) delete outputFile_;
 	if (cachedFile_ != NULL) delete cachedFile_;
 }
@@ -61,9 +65,14 @@ void LineParser::reset()
 	linePos_ = 0;
 	lastLineNo_ = 0;
 	inputFile_ = NULL;
+	mappedInput_ = NULL;
 	outputFile_ = NULL;
 	cachedFile_ = NULL;
 	directOutput_ = false;
+	binaryOutput_ = false;
+	fastLine_ = NULL;
+	fastLineLength_ = 0;
+	nFastArgs_ = 0;
 }
 
 /*
@@ -102,8 +111,8 @@ int LineParser::lastLineNo() const
 	return lastLineNo_;
 }
 
-// Open new file for reading
-bool LineParser::openInput(QString filename)
+// Open new file for reading, mapping it (privately) into memory if requested
+bool LineParser::openInput(QString filename, bool mapFile)
 {
 	Messenger::enter("LineParser::openInput");
 
@@ -111,19 +120,34 @@ bool LineParser::openInput(QString filename)
 	if (inputFile_ != NULL)
 	{
 		printf("Warning - LineParser already appears to have an open file...\n");
-		inputFile_->close();
 		delete inputFile_;
 		inputFile_ = NULL;
+		if (mappedInput_ != NULL) delete mappedInput_;
+		mappedInput_ = NULL;
 	}
 
-	// Open new file
-	inputFile_ = new std::ifstream(qPrintable(filename), std::ios::in | std::ios::binary);
-	if (!inputFile_->is_open())
+	// Open new file - if requested, map it into memory so that reading and seeking avoid system calls, otherwise (or if it can't be mapped) read through a standard stream
+	if (mapFile)
 	{
-		closeFiles();
-		Messenger::print("Error: Failed to open file '%s' for reading.", qPrintable(filename));
-		Messenger::exit("LineParser::openInput");
-		return false;
+		mappedInput_ = new MappedFile;
+		if (mappedInput_->open(filename, true)) inputFile_ = new std::istream(mappedInput_->buffer());
+		else
+		{
+			delete mappedInput_;
+			mappedInput_ = NULL;
+		}
+	}
+	if (inputFile_ == NULL)
+	{
+		std::ifstream* file = new std::ifstream(qPrintable(filename), std::ios::in | std::ios::binary);
+		inputFile_ = file;
+		if (!file->is_open())
+		{
+			closeFiles();
+			Messenger::print("Error: Failed to open file '%s' for reading.", qPrintable(filename));
+			Messenger::exit("LineParser::openInput");
+			return false;
+		}
 	}
 
 	// Reset variables
@@ -135,7 +159,7 @@ bool LineParser::openInput(QString filename)
 }
 
 // Open new stream for writing
-bool LineParser::openOutput(QString filename, bool directOutput)
+bool LineParser::openOutput(QString filename, bool directOutput, bool binary)
 {
 	Messenger::enter("LineParser::openOutput");
 
@@ -158,9 +182,10 @@ bool LineParser::openOutput(QString filename, bool directOutput)
 
 	// Open new file
 	directOutput_ = directOutput;
+	binaryOutput_ = binary;
 	if (directOutput_)
 	{
-		outputFile_ = new std::ofstream(qPrintable(filename), std::ios::out);
+		outputFile_ = new std::ofstream(qPrintable(filename), binaryOutput_ ? std::ios::out | std::ios::binary : std::ios::out);
 		if (!outputFile_->is_open())
 		{
 			closeFiles();
@@ -179,11 +204,8 @@ bool LineParser::openOutput(QString filename, bool directOutput)
 // Close file 
 void LineParser::closeFiles()
 {
-	if (inputFile_ != NULL)
-	{
-		inputFile_->close();
-		delete inputFile_;
-	}
+	if (inputFile_ != NULL) delete inputFile_;
+	if (mappedInput_ != NULL) delete mappedInput_;
 	if (outputFile_ != NULL)
 	{
 		// Commit any cached content...
@@ -197,9 +219,7 @@ void LineParser::closeFiles()
 // Return whether current file source is good for reading
 bool LineParser::isFileGoodForReading() const
 {
-	if (inputFile_ == NULL) return false;
-	else if (!inputFile_->is_open()) return false;
-	return true;
+	return (inputFile_ != NULL);
 }
 
 // Return whether current file source is good for writing
@@ -289,6 +309,37 @@ bool LineParser::eofOrBlank() const
 	return result;
 }
 
+// Read in the specified range of the input file in the background (if it is memory-mapped)
+void LineParser::prefetch(std::streampos start, std::streampos end)
+{
+	if (mappedInput_ != NULL) mappedInput_->prefetch(start, end);
+}
+
+// Check that a memory-mapped input file has not been truncated, reverting to reading it through a standard stream if it has
+bool LineParser::checkMappedInput()
+{
+	if ((mappedInput_ == NULL) || mappedInput_->isIntact()) return true;
+
+	Messenger::warn("File '%s' has been truncated since it was opened - reverting to standard file reading.", qPrintable(inputFilename_));
+
+	// Reopen the file at the same position
+	inputFile_->clear();
+	std::streampos pos = inputFile_->tellg();
+	delete inputFile_;
+	delete mappedInput_;
+	mappedInput_ = NULL;
+	std::ifstream* file = new std::ifstream(qPrintable(inputFilename_), std::ios::in | std::ios::binary);
+	inputFile_ = file;
+	if (!file->is_open())
+	{
+		Messenger::print("Error: Failed to reopen file '%s' for reading.", qPrintable(inputFilename_));
+		closeFiles();
+		return false;
+	}
+	inputFile_->seekg(pos);
+	return true;
+}
+
 /*
 // Read/Write Routines
 */
@@ -320,7 +371,22 @@ int LineParser::readNextLine(int optionMask)
 	do
 	{
 		char chr;
-		while(inputFile_->get(chr).good())
+		if (mappedInput_ != NULL)
+		{
+			// Take the whole line straight from the mapped file
+			const char* mappedLine;
+			if (mappedInput_->readLine(mappedLine, lineLength_))
+			{
+				if (lineLength_ >= MAXLINELENGTH)
+				{
+					Messenger::exit("LineParser::readNextLine");
+					return -1;
+				}
+				line_ = QString::fromLatin1(mappedLine, lineLength_);
+			}
+			else inputFile_->setstate(std::ios::eofbit | std::ios::failbit);
+		}
+		else while(inputFile_->get(chr).good())
 		{
 			if (chr == '\r')
 			{
@@ -976,6 +1042,15 @@ int LineParser::getDoubleArray(double* array, int count)
 	return 0;
 }
 
+// Read an array of float values from an (unformatted) input file
+int LineParser::getFloatArray(float* array, int count)
+{
+	inputFile_->read((char*) array, count*sizeof(float));
+	if (inputFile_->eof()) return -1;
+	if (inputFile_->fail()) return 1;
+	return 0;
+}
+
 // Write partial line to file
 bool LineParser::write(QString line)
 {
@@ -1104,6 +1179,19 @@ bool LineParser::writeLineF(const char* fmt, ...)
 	return true;
 }
 
+// Write raw (unformatted) data to file
+bool LineParser::writeRaw(const char* data, int nBytes)
+{
+	std::ostream* target = directOutput_ ? (std::ostream*) outputFile_ : (std::ostream*) cachedFile_;
+	if (target == NULL)
+	{
+		Messenger::print("Unable to write raw data - destination file is not open.");
+		return false;
+	}
+	target->write(data, nBytes);
+	return target->good();
+}
+
 // Commit cached output stream to actual output file
 bool LineParser::commitCache()
 {
@@ -1113,7 +1201,7 @@ bool LineParser::commitCache()
 		printf("Internal Error: Tried to commit cached writes when direct output was enabled.\n");
 		return false;
 	}
-	std::ofstream outputFile(qPrintable(outputFilename_));
+	std::ofstream outputFile(qPrintable(outputFilename_), binaryOutput_ ? std::ios::out | std::ios::binary : std::ios::out);
 	if (outputFile.is_open())
 	{
 		outputFile << cachedFile_->str();
@@ -1134,7 +1222,7 @@ int LineParser::skipLines(int nlines)
 	int result;
 	for (int n=0; n<nlines; n++)
 	{
-		result = readNextLine(0);
+		result = readNextLineFast();
 		if (result != 0)
 		{
 			Messenger::exit("LineParser::skipLines");
@@ -1223,3 +1311,215 @@ bool LineParser::hasArg(int i) const
 	if ((i < 0) || (i >= nArgs())) return false;
 	return true;
 }
+
+/*
+ * Fast Parsing
+ */
+
+// Read next line from internal source file without conversion to QString
+int LineParser::readNextLineFast()
+{
+	nFastArgs_ = 0;
+	fastLineLength_ = 0;
+	fastLine_ = fastBuffer_;
+
+	// Returns : 0=ok, 1=error, -1=eof
+	if (inputFile_ == NULL)
+	{
+		printf("Error: No input file open for LineParser::readNextLineFast.\n");
+		return 1;
+	}
+
+	if (mappedInput_ != NULL)
+	{
+		// Point directly at the line in the mapped file
+		if (!mappedInput_->readLine(fastLine_, fastLineLength_))
+		{
+			inputFile_->setstate(std::ios::eofbit | std::ios::failbit);
+			return -1;
+		}
+	}
+	else
+	{
+		if (inputFile_->eof()) return -1;
+
+		// Read line into the fallback buffer - failure means either nothing left to read or a line too long to fit (binary file?)
+		inputFile_->getline(fastBuffer_, MAXLINELENGTH);
+		if (inputFile_->fail()) return -1;
+		fastLineLength_ = inputFile_->eof() ? inputFile_->gcount() : inputFile_->gcount() - 1;
+		if ((fastLineLength_ > 0) && (fastBuffer_[fastLineLength_-1] == '\r')) --fastLineLength_;
+	}
+	++lastLineNo_;
+
+	return 0;
+}
+
+// Read next line and split it into whitespace / comma-delimited arguments without copying
+int LineParser::getArgsFast()
+{
+	int result = readNextLineFast();
+	if (result != 0) return result;
+
+	const char* c = fastLine_;
+	const char* end = fastLine_ + fastLineLength_;
+	const char* start;
+	while (c < end)
+	{
+		// Skip delimiters
+		while ((c < end) && ((*c == ' ') || (*c == '\t') || (*c == ','))) ++c;
+
+		// End of line, or start of comment?
+		if ((c == end) || (*c == '#')) break;
+
+		// Find end of argument
+		start = c;
+		while ((c < end) && (*c != ' ') && (*c != '\t') && (*c != ',') && (*c != '#')) ++c;
+		if (nFastArgs_ == MAXFASTARGS) break;
+		fastArgs_[nFastArgs_] = start;
+		fastArgLengths_[nFastArgs_] = c - start;
+		++nFastArgs_;
+	}
+
+	return 0;
+}
+
+// Return number of arguments grabbed from last fast parse
+int LineParser::nFastArgs() const
+{
+	return nFastArgs_;
+}
+
+// Return the specified fast argument as a character string
+QString LineParser::fastArgc(int i) const
+{
+	if ((i < 0) || (i >= nFastArgs_))
+	{
+		printf("Warning: Argument %i is out of range - returning \"NULL\"...\n", i);
+		return "NULL";
+	}
+	return QString::fromLatin1(fastArgs_[i], fastArgLengths_[i]);
+}
+
+// Return the specified fast argument as an integer
+int LineParser::fastArgi(int i) const
+{
+	if ((i < 0) || (i >= nFastArgs_))
+	{
+		printf("Warning: Argument %i is out of range - returning 0...\n", i);
+		return 0;
+	}
+	int value;
+	return (toInteger(fastArgs_[i], fastArgLengths_[i], value) ? value : 0);
+}
+
+// Return the specified fast argument as a double
+double LineParser::fastArgd(int i) const
+{
+	if ((i < 0) || (i >= nFastArgs_))
+	{
+		printf("Warning: Argument %i is out of range - returning 0.0...\n", i);
+		return 0.0;
+	}
+	double value;
+	return (toDouble(fastArgs_[i], fastArgLengths_[i], value) ? value : 0.0);
+}
+
+// Convert characters to an integer, returning false if they do not form one
+bool LineParser::toInteger(const char* s, int length, int& value)
+{
+	const char* c = s;
+	const char* end = s + length;
+	bool negative = false;
+	if ((c < end) && ((*c == '-') || (*c == '+'))) negative = (*c++ == '-');
+	if (c == end) return false;
+
+	long long result = 0;
+	for (; c < end; ++c)
+	{
+		if ((*c < '0') || (*c > '9')) return false;
+		result = result*10 + (*c - '0');
+		if (result > (long long) INT_MAX + 1) return false;
+	}
+	if (negative) result = -result;
+	if (result > INT_MAX) return false;
+
+	value = (int) result;
+	return true;
+}
+
+// Convert characters to a double, returning false if they do not form one
+bool LineParser::toDouble(const char* s, int length, double& value)
+{
+	// Powers of ten exactly representable as doubles
+	static const double powersOfTen[] = { 1.0e0, 1.0e1, 1.0e2, 1.0e3, 1.0e4, 1.0e5, 1.0e6, 1.0e7, 1.0e8, 1.0e9, 1.0e10, 1.0e11, 1.0e12, 1.0e13, 1.0e14, 1.0e15, 1.0e16, 1.0e17, 1.0e18, 1.0e19, 1.0e20, 1.0e21, 1.0e22 };
+
+	const char* c = s;
+	const char* end = s + length;
+	bool negative = false, hasDigits = false, exact = true;
+	unsigned long long mantissa = 0;
+	int exponent = 0, nDigits = 0;
+
+	// Sign
+	if ((c < end) && ((*c == '-') || (*c == '+'))) negative = (*c++ == '-');
+
+	// Integer part - digits beyond those that fit in the mantissa only affect the exponent (and the exactness of the result)
+	for (; (c < end) && (*c >= '0') && (*c <= '9'); ++c)
+	{
+		hasDigits = true;
+		if (nDigits < 19)
+		{
+			mantissa = mantissa*10 + (*c - '0');
+			if (mantissa > 0) ++nDigits;
+		}
+		else
+		{
+			++exponent;
+			if (*c != '0') exact = false;
+		}
+	}
+
+	// Fractional part
+	if ((c < end) && (*c == '.'))
+	{
+		for (++c; (c < end) && (*c >= '0') && (*c <= '9'); ++c)
+		{
+			hasDigits = true;
+			if (nDigits < 19)
+			{
+				mantissa = mantissa*10 + (*c - '0');
+				if (mantissa > 0) ++nDigits;
+				--exponent;
+			}
+			else if (*c != '0') exact = false;
+		}
+	}
+
+	// Exponent (allowing Fortran-style 'D')
+	if (hasDigits && (c < end) && ((*c == 'e') || (*c == 'E') || (*c == 'd') || (*c == 'D')))
+	{
+		++c;
+		bool negativeExponent = false;
+		if ((c < end) && ((*c == '-') || (*c == '+'))) negativeExponent = (*c++ == '-');
+		if (c == end) hasDigits = false;
+		int e = 0;
+		for (; (c < end) && (*c >= '0') && (*c <= '9'); ++c) if (e < 10000) e = e*10 + (*c - '0');
+		exponent += (negativeExponent ? -e : e);
+	}
+
+	// If we consumed everything and the result can be formed with a single correctly-rounded operation, we're done
+	if (hasDigits && (c == end) && exact && (mantissa <= 9007199254740992ULL) && (exponent >= -22) && (exponent <= 22))
+	{
+		value = (exponent < 0 ? double(mantissa) / powersOfTen[-exponent] : double(mantissa) * powersOfTen[exponent]);
+		if (negative) value = -value;
+		return true;
+	}
+
+	// Otherwise fall back to the standard library (long mantissae, large exponents, infinities, NaNs...)
+	char buffer[64];
+	if ((length <= 0) || (length >= 64)) return false;
+	for (int n=0; n<length; ++n) buffer[n] = ((s[n] == 'd') || (s[n] == 'D')) ? 'e' : s[n];
+	buffer[length] = '\0';
+	char* endPtr;
+	value = strtod(buffer, &endPtr);
+	return (endPtr == (buffer + length));
+}
@@ -33,9 +33,11 @@
 ATEN_BEGIN_NAMESPACE
 
 #define MAXLINELENGTH 1024
+#define MAXFASTARGS 64
 
 // Forward Declarations (Aten)
 class Format;
+class MappedFile;
 class ParseFormat;
 
 // Parser Options and Flags
@@ -72,8 +74,10 @@ class LineParser
 	int linePos_;
 	// Integer line number of last read line
 	int lastLineNo_;
+	// Memory-mapped source file (if the input file could be mapped)
+	MappedFile* mappedInput_;
 	// Source stream for reading
-	std::ifstream* inputFile_;
+	std::istream* inputFile_;
 	// Target stream for writing
 	std::ofstream* outputFile_;
 	// Target stream for cached writing
@@ -94,10 +98,10 @@ class LineParser
 	int lastLineNo() const;
 	// Return read-only status of file
 	bool isFileReadOnly() const;
-	// Open new file for reading
-	bool openInput(QString filename);
+	// Open new file for reading, mapping it (privately) into memory if requested
+	bool openInput(QString filename, bool mapFile = false);
 	// Open new stream for writing
-	bool openOutput(QString filename, bool directOutput = true);
+	bool openOutput(QString filename, bool directOutput = true, bool binary = false);
 	// Close file(s)
 	void closeFiles();
 	// Return whether current file source is good for reading
@@ -116,6 +120,10 @@ class LineParser
 	void rewind();
 	// Return whether the end of the input stream has been reached (or only whitespace remains)
 	bool eofOrBlank() const;
+	// Read in the specified range of the input file in the background (if it is memory-mapped)
+	void prefetch(std::streampos start, std::streampos end);
+	// Check that a memory-mapped input file has not been truncated, reverting to reading it through a standard stream if it has
+	bool checkMappedInput();
 
 
 	/*
@@ -124,6 +132,8 @@ class LineParser
 	private:
 	// Whether output is cached or direct
 	bool directOutput_;
+	// Whether output is binary (unformatted)
+	bool binaryOutput_;
 	// Gets all delimited args from internal line
 	void getAllArgsDelim(int optionMask);
 
@@ -164,6 +174,8 @@ class LineParser
 	double getDouble(double& value, int nbytes = 0);
 	// Fill an array of double values from reading of an (unformatted) input file
 	int getDoubleArray(double* array, int count);
+	// Fill an array of float values from reading of an (unformatted) input file
+	int getFloatArray(float* array, int count);
 	// Write partial line to file
 	bool write(QString line);
 	// Write formatted partial line to file
@@ -174,6 +186,8 @@ class LineParser
 	bool writeLine(QString line);
 	// Write formatted line to file (appending CR/LF automatically)
 	bool writeLineF(const char* fmt, ...);
+	// Write raw (unformatted) data to file
+	bool writeRaw(const char* data, int nBytes);
 	// Commit cached output stream to actual output file
 	bool commitCache();
 
@@ -202,6 +216,42 @@ class LineParser
 	float argf(int i);
 	// Returns whether the specified argument exists
 	bool hasArg(int i) const;
+
+
+	/*
+	 * Fast Parsing
+	 */
+	private:
+	// Current line read by fast routines (pointing into mapped file or fallback buffer)
+	const char* fastLine_;
+	// Length of current fast line
+	int fastLineLength_;
+	// Line buffer used when the input file is not mapped
+	char fastBuffer_[MAXLINELENGTH];
+	// Start of each argument in current fast line
+	const char* fastArgs_[MAXFASTARGS];
+	// Length of each argument in current fast line
+	int fastArgLengths_[MAXFASTARGS];
+	// Number of arguments in current fast line
+	int nFastArgs_;
+
+	public:
+	// Read next line from internal source file without conversion to QString
+	int readNextLineFast();
+	// Read next line and split it into whitespace / comma-delimited arguments without copying
+	int getArgsFast();
+	// Return number of arguments grabbed from last fast parse
+	int nFastArgs() const;
+	// Return the specified fast argument as a character string
+	QString fastArgc(int i) const;
+	// Return the specified fast argument as an integer
+	int fastArgi(int i) const;
+	// Return the specified fast argument as a double
+	double fastArgd(int i) const;
+	// Convert characters to an integer, returning false if they do not form one
+	static bool toInteger(const char* s, int length, int& value);
+	// Convert characters to a double, returning false if they do not form one
+	static bool toDouble(const char* s, int length, double& value);
 };
 
 ATEN_END_NAMESPACE
@@ -0,0 +1,245 @@
+/*
+	*** Memory-mapped file
+	*** src/base/mappedfile.cpp
+	Copyright T. Youngs 2007-2017
+
+	This file is part of Aten.
+
+	Aten is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Aten is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Aten.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "base/mappedfile.h"
+#include "base/messenger.h"
+
+ATEN_USING_NAMESPACE
+
+// Size of memory pages touched when prefetching
+#define PREFETCHPAGESIZE 4096
+
+/*
+ * Mapped Stream Buffer
+ */
+
+// Set block of memory to read from
+void MappedStreamBuffer::setData(char* data, qint64 size)
+{
+	setg(data, data, data + size);
+}
+
+// Return next line in the block (without line terminator), moving past it, or false if at the end of the block
+bool MappedStreamBuffer::readLine(const char*& line, int& length)
+{
+	char* start = gptr();
+	char* end = egptr();
+	if (start >= end) return false;
+
+	// Search for the line terminator (LF, CR, or CR/LF)
+	char* c = start;
+	while ((c < end) && (*c != '\n') && (*c != '\r')) ++c;
+	line = start;
+	length = c - start;
+
+	// Move past the terminator
+	if (c < end)
+	{
+		if ((*c == '\r') && ((c+1) < end) && (c[1] == '\n')) ++c;
+		++c;
+	}
+	setg(eback(), c, end);
+	return true;
+}
+
+// Seek to position relative to the start, current position, or end of the block
+MappedStreamBuffer::pos_type MappedStreamBuffer::seekoff(off_type offset, std::ios_base::seekdir direction, std::ios_base::openmode mode)
+{
+	char* target;
+	if (direction == std::ios_base::beg) target = eback() + offset;
+	else if (direction == std::ios_base::cur) target = gptr() + offset;
+	else target = egptr() + offset;
+
+	if ((target < eback()) || (target > egptr())) return pos_type(off_type(-1));
+	setg(eback(), target, egptr());
+	return pos_type(target - eback());
+}
+
+// Seek to absolute position in the block
+MappedStreamBuffer::pos_type MappedStreamBuffer::seekpos(pos_type position, std::ios_base::openmode mode)
+{
+	return seekoff(off_type(position), std::ios_base::beg, mode);
+}
+
+// Return number of characters remaining in the block
+std::streamsize MappedStreamBuffer::showmanyc()
+{
+	return (gptr() < egptr() ? egptr() - gptr() : -1);
+}
+
+/*
+ * Mapped File Prefetcher
+ */
+
+// Constructor
+MappedFilePrefetcher::MappedFilePrefetcher(const char* data, qint64 size) : QThread()
+{
+	data_ = data;
+	size_ = size;
+	requestStart_ = 0;
+	requestEnd_ = 0;
+	stop_ = false;
+}
+
+// Thread loop
+void MappedFilePrefetcher::run()
+{
+	qint64 start, end, pos;
+	volatile char sink = 0;
+	while (true)
+	{
+		mutex_.lock();
+		while ((!stop_) && (requestStart_ >= requestEnd_)) condition_.wait(&mutex_);
+		if (stop_)
+		{
+			mutex_.unlock();
+			return;
+		}
+		start = requestStart_;
+		end = requestEnd_;
+		requestStart_ = 0;
+		requestEnd_ = 0;
+		mutex_.unlock();
+
+		// Read one byte from each page in the range, faulting it in if it is not already resident
+		for (pos = start; pos < end; pos += PREFETCHPAGESIZE) sink = sink ^ data_[pos];
+	}
+}
+
+// Request that the specified range be read in
+void MappedFilePrefetcher::request(qint64 start, qint64 end)
+{
+	if (start < 0) start = 0;
+	if (end > size_) end = size_;
+	QMutexLocker locker(&mutex_);
+	requestStart_ = start;
+	requestEnd_ = end;
+	condition_.wakeOne();
+}
+
+// Stop the thread, waiting for it to finish
+void MappedFilePrefetcher::stop()
+{
+	mutex_.lock();
+	stop_ = true;
+	condition_.wakeOne();
+	mutex_.unlock();
+	wait();
+}
+
+/*
+ * Mapped File
+ */
+
+// Constructor
+MappedFile::MappedFile()
+{
+	data_ = NULL;
+	size_ = 0;
+	prefetcher_ = NULL;
+}
+
+// Destructor
+MappedFile::~MappedFile()
+{
+	close();
+}
+
+// Open and map the specified file (privately, so that changes are never written back, if requested), returning false if it could not be mapped
+bool MappedFile::open(QString filename, bool privateCopy)
+{
+	close();
+
+	file_.setFileName(filename);
+	if (!file_.open(QIODevice::ReadOnly)) return false;
+
+	// Empty files (and some special files) cannot be mapped
+	size_ = file_.size();
+	if (size_ > 0) data_ = file_.map(0, size_, privateCopy ? QFileDevice::MapPrivateOption : QFileDevice::NoOptions);
+	if (data_ == NULL)
+	{
+		Messenger::print(Messenger::Verbose, "Couldn't map file '%s' into memory.", qPrintable(filename));
+		close();
+		return false;
+	}
+
+	buffer_.setData((char*) data_, size_);
+	return true;
+}
+
+// Unmap and close the file
+void MappedFile::close()
+{
+	if (prefetcher_ != NULL)
+	{
+		prefetcher_->stop();
+		delete prefetcher_;
+		prefetcher_ = NULL;
+	}
+	buffer_.setData(NULL, 0);
+	if (data_ != NULL) file_.unmap(data_);
+	data_ = NULL;
+	size_ = 0;
+	if (file_.isOpen()) file_.close();
+}
+
+// Return stream buffer over mapped data
+std::streambuf* MappedFile::buffer()
+{
+	return &buffer_;
+}
+
+// Return next line in the mapped data (without line terminator), moving past it, or false if at the end of the data
+bool MappedFile::readLine(const char*& line, int& length)
+{
+	return buffer_.readLine(line, length);
+}
+
+// Return mapped data
+uchar* MappedFile::data()
+{
+	return data_;
+}
+
+// Return size of mapped data
+qint64 MappedFile::size() const
+{
+	return size_;
+}
+
+// Return whether the file is still at least as large as the mapped data (reading pages beyond the end of a truncated file raises SIGBUS)
+bool MappedFile::isIntact()
+{
+	if (data_ == NULL) return true;
+	return (file_.size() >= size_);
+}
+
+// Read in the specified range of the file on a background thread
+void MappedFile::prefetch(qint64 start, qint64 end)
+{
+	if ((data_ == NULL) || (!isIntact())) return;
+	if (prefetcher_ == NULL)
+	{
+		prefetcher_ = new MappedFilePrefetcher((const char*) data_, size_);
+		prefetcher_->start(QThread::LowPriority);
+	}
+	prefetcher_->request(start, end);
+}
@@ -0,0 +1,130 @@
+/*
+	*** Memory-mapped file
+	*** src/base/mappedfile.h
+	Copyright T. Youngs 2007-2017
+
+	This file is part of Aten.
+
+	Aten is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Aten is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Aten.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef ATEN_MAPPEDFILE_H
+#define ATEN_MAPPEDFILE_H
+
+#include <QFile>
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <streambuf>
+#include "base/namespace.h"
+
+ATEN_BEGIN_NAMESPACE
+
+// Mapped Stream Buffer
+// Read-only stream buffer over a block of memory, allowing the whole block to be read and seeked without any copying
+class MappedStreamBuffer : public std::streambuf
+{
+	public:
+	// Set block of memory to read from
+	void setData(char* data, qint64 size);
+	// Return next line in the block (without line terminator), moving past it, or false if at the end of the block
+	bool readLine(const char*& line, int& length);
+
+	protected:
+	// Seek to position relative to the start, current position, or end of the block
+	pos_type seekoff(off_type offset, std::ios_base::seekdir direction, std::ios_base::openmode mode);
+	// Seek to absolute position in the block
+	pos_type seekpos(pos_type position, std::ios_base::openmode mode);
+	// Return number of characters remaining in the block
+	std::streamsize showmanyc();
+};
+
+// Mapped File Prefetcher
+// Background thread which reads through requested ranges of a mapped file, so that its pages are resident before they are needed
+class MappedFilePrefetcher : public QThread
+{
+	public:
+	// Constructor
+	MappedFilePrefetcher(const char* data, qint64 size);
+
+	private:
+	// Mapped data and its size
+	const char* data_;
+	qint64 size_;
+	// Mutex and wait condition protecting requests
+	QMutex mutex_;
+	QWaitCondition condition_;
+	// Start and end of currently requested range
+	qint64 requestStart_, requestEnd_;
+	// Whether the thread should stop
+	bool stop_;
+
+	protected:
+	// Thread loop
+	void run();
+
+	public:
+	// Request that the specified range be read in
+	void request(qint64 start, qint64 end);
+	// Stop the thread, waiting for it to finish
+	void stop();
+};
+
+// Mapped File
+// File mapped into memory for reading, accessible as a stream buffer
+class MappedFile
+{
+	public:
+	// Constructor / Destructor
+	MappedFile();
+	~MappedFile();
+
+
+	/*
+	 * Data
+	 */
+	private:
+	// Source file
+	QFile file_;
+	// Mapped data
+	uchar* data_;
+	// Size of mapped data
+	qint64 size_;
+	// Stream buffer over mapped data
+	MappedStreamBuffer buffer_;
+	// Background prefetch thread (if started)
+	MappedFilePrefetcher* prefetcher_;
+
+	public:
+	// Open and map the specified file (privately, so that changes are never written back, if requested), returning false if it could not be mapped
+	bool open(QString filename, bool privateCopy = false);
+	// Unmap and close the file
+	void close();
+	// Return stream buffer over mapped data
+	std::streambuf* buffer();
+	// Return next line in the mapped data (without line terminator), moving past it, or false if at the end of the data
+	bool readLine(const char*& line, int& length);
+	// Return mapped data
+	uchar* data();
+	// Return size of mapped data
+	qint64 size() const;
+	// Return whether the file is still at least as large as the mapped data (reading pages beyond the end of a truncated file raises SIGBUS)
+	bool isIntact();
+	// Read in the specified range of the file on a background thread
+	void prefetch(qint64 start, qint64 end);
+};
+
+ATEN_END_NAMESPACE
+
+#endif
@@ -119,6 +119,10 @@ Neta::Neta() : ListItem<Neta>()
 	targetAtom_ = NULL;
 	targetRingList_ = NULL;
 	targetParent_ = NULL;
+	description_ = NULL;
+	compiled_ = false;
+	topological_ = true;
+	ringRequirement_ = 0;
 }
 
 // Destructors
@@ -222,6 +226,7 @@ void Neta::clear()
 {
 	description_ = NULL;
 	ownedNodes_.clear();
+	compiled_ = false;
 }
 
 // Return current atom target
@@ -258,15 +263,28 @@ int Neta::matchAtom(Atom* i, List<Ring>* rings, Model* parent)
 		Messenger::exit("Neta::matchAtom");
 		return 1;
 	}
+	// Reject the atom early if it fails any of the constraints which the description always requires
+	if (!compiled_) compile();
+	for (int n=0; n<nBondsValues_.nItems(); ++n)
+	{
+		if (netaValueCompare(i->nBonds(), (Neta::NetaValueComparison) nBondsComparisons_[n], nBondsValues_[n])) continue;
+		Messenger::exit("Neta::matchAtom");
+		return -1;
+	}
+	RefList<Ring,int> ringList;
+	if (rings) for (Ring* r = rings->first(); r != NULL; r = r->next) if (r->containsAtom(i)) ringList.add(r);
+	if (((ringRequirement_ == 1) && (ringList.nItems() == 0)) || ((ringRequirement_ == -1) && (ringList.nItems() != 0)))
+	{
+		Messenger::exit("Neta::matchAtom");
+		return -1;
+	}
 	// Store ring list and parent model of atom
 	targetRingList_ = rings;
 	targetParent_ = parent;
 	targetAtom_ = i;
-	// Create a bound list of atoms and a list of rings to pass to the head of the description
+	// Create a bound list of atoms to pass to the head of the description
 	RefList<Atom,int> boundList;
 	i->addBoundToRefList(&boundList);
-	RefList<Ring,int> ringList;
-	if (targetRingList_) for (Ring* r = targetRingList_->first(); r != NULL; r = r->next) if (r->containsAtom(i)) ringList.add(r);
 	RefList<Atom,int> path;
 	int score = description_->score(i, &boundList, &ringList, description_, path, 0);
 // 	printf("Score is %i\n", score);
@@ -361,6 +379,70 @@ bool Neta::createBasic(Atom* i, bool explicitBondType, double torsionTolerance)
 	return true;
 }
 
+/*
+ * Compiled Constraints
+ */
+
+// Extract constraints from the supplied node, if it must always be satisfied for a match
+void Neta::compile(NetaNode* node)
+{
+	// Nodes with reversed logic, or which are only one option of several, place no absolute constraint on the atom
+	if ((node == NULL) || node->reverseLogic()) return;
+	switch (node->nodeType())
+	{
+		case (NetaNode::LogicNode):
+			if (((NetaLogicNode*) node)->netaLogic() == Neta::NetaOrLogic) break;
+			compile(((NetaLogicNode*) node)->argument1());
+			if (((NetaLogicNode*) node)->netaLogic() == Neta::NetaAndLogic) compile(((NetaLogicNode*) node)->argument2());
+			break;
+		case (NetaNode::ValueNode):
+			if (((NetaValueNode*) node)->netaValue() != Neta::NBondsValue) break;
+			nBondsComparisons_.add(((NetaValueNode*) node)->netaComparison());
+			nBondsValues_.add(((NetaValueNode*) node)->value());
+			break;
+		case (NetaNode::KeywordNode):
+			if (((NetaKeywordNode*) node)->netaKeyword() == Neta::NoRingKeyword) ringRequirement_ = -1;
+			break;
+		case (NetaNode::RingNode):
+			ringRequirement_ = 1;
+			break;
+		default:
+			break;
+	}
+}
+
+// Extract constraints from the current description, used to reject atoms before scoring
+void Neta::compile()
+{
+	Messenger::enter("Neta::compile");
+
+	nBondsComparisons_.clear();
+	nBondsValues_.clear();
+	ringRequirement_ = 0;
+	topological_ = true;
+
+	// Only nodes in the top-level context apply to the target atom itself
+	if (description_ != NULL) compile(description_->innerNeta());
+
+	// Any geometric test makes the result depend on the coordinates of the atom, not just its connectivity
+	for (NetaNode* node = ownedNodes_.first(); node != NULL; node = node->next)
+	{
+		if ((node->nodeType() == NetaNode::GeometryNode) || (node->nodeType() == NetaNode::MeasurementNode)) topological_ = false;
+		else if ((node->nodeType() == NetaNode::KeywordNode) && (((NetaKeywordNode*) node)->netaKeyword() == Neta::PlanarKeyword)) topological_ = false;
+	}
+
+	compiled_ = true;
+
+	Messenger::exit("Neta::compile");
+}
+
+// Return whether the description depends only on connectivity
+bool Neta::isTopological()
+{
+	if (!compiled_) compile();
+	return topological_;
+}
+
 /*
  * NetaNode
  */
@@ -508,6 +590,24 @@ NetaLogicNode::~NetaLogicNode()
 {
 }
 
+// Return logic type
+Neta::NetaLogicType NetaLogicNode::netaLogic() const
+{
+	return netaLogic_;
+}
+
+// Return first argument
+NetaNode* NetaLogicNode::argument1()
+{
+	return argument1_;
+}
+
+// Return second argument
+NetaNode* NetaLogicNode::argument2()
+{
+	return argument2_;
+}
+
 // Validation function (virtual)
 int NetaLogicNode::score(Atom* target, RefList<Atom,int>* nbrs, RefList<Ring,int>* rings, NetaContextNode* context, RefList<Atom,int>& path, int level)
 {
@@ -892,6 +992,12 @@ NetaKeywordNode::~NetaKeywordNode()
 {
 }
 
+// Return keyword
+Neta::NetaKeyword NetaKeywordNode::netaKeyword() const
+{
+	return netaKeyword_;
+}
+
 // Validation function (virtual)
 int NetaKeywordNode::score(Atom* target, RefList<Atom,int>* nbrs, RefList<Ring,int>* rings, NetaContextNode* context, RefList<Atom,int>& path, int level)
 {
@@ -1078,6 +1184,24 @@ NetaValueNode::~NetaValueNode()
 {
 }
 
+// Return value to check
+Neta::NetaValue NetaValueNode::netaValue() const
+{
+	return netaValue_;
+}
+
+// Return comparison operator
+Neta::NetaValueComparison NetaValueNode::netaComparison() const
+{
+	return netaComparison_;
+}
+
+// Return value to compare against
+int NetaValueNode::value() const
+{
+	return value_;
+}
+
 // Validation function (virtual)
 int NetaValueNode::score(Atom* target, RefList<Atom,int>* nbrs, RefList<Ring,int>* rings, NetaContextNode* context, RefList<Atom,int>& path, int level)
 {
@@ -27,6 +27,7 @@
 #include "base/ring.h"
 #include "templates/list.h"
 #include "templates/reflist.h"
+#include "templates/array.h"
 #include "base/namespace.h"
 
 ATEN_BEGIN_NAMESPACE
@@ -146,6 +147,28 @@ class Neta : public ListItem<Neta>
 	void linkReferenceTypes();
 	// Create a basic description for the specified Atom
 	bool createBasic(Atom* i, bool explicitBondType = false, double torsionTolerance = -1.0);
+
+
+	/*
+	 * Compiled Constraints
+	 */
+	private:
+	// Whether constraints have been extracted from the current description
+	bool compiled_;
+	// Whether the description depends only on connectivity (and not on atomic coordinates)
+	bool topological_;
+	// Bond count comparisons and values which any matching atom must satisfy
+	Array<int> nBondsComparisons_, nBondsValues_;
+	// Ring membership which any matching atom must have (1 = in a ring, -1 = not in a ring, 0 = either)
+	int ringRequirement_;
+	// Extract constraints from the supplied node, if it must always be satisfied for a match
+	void compile(NetaNode* node);
+
+	public:
+	// Extract constraints from the current description, used to reject atoms before scoring
+	void compile();
+	// Return whether the description depends only on connectivity
+	bool isTopological();
 };
 
 // NETA Specification Node
@@ -241,6 +264,12 @@ class NetaLogicNode : public NetaNode
 	NetaNode* argument1_, *argument2_;
 
 	public:
+	// Return logic type
+	Neta::NetaLogicType netaLogic() const;
+	// Return first argument
+	NetaNode* argument1();
+	// Return second argument
+	NetaNode* argument2();
 	// Validation function (virtual)
 	int score(Atom* target, RefList<Atom,int>* nbrs, RefList<Ring,int>* rings, NetaContextNode* context, RefList<Atom,int>& path, int level);
 	// Print node contents
@@ -297,6 +326,8 @@ class NetaKeywordNode : public NetaNode
 	Neta::NetaKeyword netaKeyword_;
 
 	public:
+	// Return keyword
+	Neta::NetaKeyword netaKeyword() const;
 	// Validation function (virtual)
 	int score(Atom* target, RefList<Atom,int>* nbrs, RefList<Ring,int>* rings, NetaContextNode* context, RefList<Atom,int>& path, int level);
 	// Print node contents
@@ -347,6 +378,12 @@ class NetaValueNode : public NetaNode
 	int value_;
 
 	public:
+	// Return value to check
+	Neta::NetaValue netaValue() const;
+	// Return comparison operator
+	Neta::NetaValueComparison netaComparison() const;
+	// Return value to compare against
+	int value() const;
 	// Validation function (virtual)
 	int score(Atom* target, RefList<Atom,int>* nbrs, RefList<Ring,int>* rings, NetaContextNode* context, RefList<Atom,int>& path, int level);
 	// Print node contents
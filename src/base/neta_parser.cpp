@@ -219,6 +219,7 @@ void NetaParser::setDescription(NetaNode* desc)
 	rootnode->setInnerNeta(desc);
 	neta_->ownedNodes_.own(rootnode);
 	neta_->description_ = rootnode;
+	neta_->compiled_ = false;
 
 	Messenger::exit("NetaParser::setDescription");
 }
@@ -21,10 +21,12 @@
 
 #include "base/pattern.h"
 #include "base/ring.h"
+#include "base/ringperception.h"
 #include "model/model.h"
 #include "ff/forcefield.h"
 #include "base/forcefieldbound.h"
 #include "base/forcefieldatom.h"
+#include <algorithm>
 
 ATEN_USING_NAMESPACE
 
@@ -43,9 +45,6 @@ Pattern::Pattern() : ListItem<Pattern>()
 	lastAtom_ = NULL;
 	fixed_ = false;
 	forcefield_ = NULL;
-	conMatrix_ = NULL;
-	elecScaleMatrix_ = NULL;
-	vdwScaleMatrix_ = NULL;
 	incomplete_ = false;
 	testAtomLimit_ = false;
 	testElement_ = false;
@@ -301,6 +300,12 @@ PatternBound* Pattern::bonds()
 	return bonds_.first();
 }
 
+// Return first atom data of the pattern
+PatternAtom* Pattern::atoms()
+{
+	return atoms_.first();
+}
+
 // Return first angle of the pattern
 PatternBound* Pattern::angles()
 {
@@ -677,199 +682,37 @@ void Pattern::deleteExpression()
 	torsions_.clear();
 	uniqueForcefieldTypes_.clear();
 	allForcefieldTypes_.clear();
-	if (conMatrix_ != NULL)
-	{
-		for (int n=0; n<nAtoms_; n++) delete[] conMatrix_[n];
-		delete[] conMatrix_;
-	}
-	conMatrix_ = NULL;
-	if (vdwScaleMatrix_ != NULL)
-	{
-		for (int n=0; n<nAtoms_; n++) delete[] vdwScaleMatrix_[n];
-		delete[] vdwScaleMatrix_;
-	}
-	vdwScaleMatrix_ = NULL;
-	if (elecScaleMatrix_ != NULL)
-	{
-		for (int n=0; n<nAtoms_; n++) delete[] elecScaleMatrix_[n];
-		delete[] elecScaleMatrix_;
-	}
-	elecScaleMatrix_ = NULL;
+	exclusions_.clear();
 	Messenger::exit("Pattern::deleteExpression");
 }
 
-// Create connectivity and scaling matrices for molecules in pattern
-void Pattern::createMatrices(bool forceFull, bool quiet)
+// Create connectivity and scaling exclusion list for molecules in pattern
+void Pattern::createExclusions(bool full, bool quiet)
 {
-	Messenger::enter("Pattern::createMatrices");
-	int n, m, a1, a2;
-	PatternBound* pb;
-
-	if (conMatrix_ != NULL) Messenger::print("Pattern::createMatrices : Warning - connectivity matrix was already allocated.");
-	conMatrix_ = new int*[nAtoms_];
-	for (n=0; n<nAtoms_; n++) conMatrix_[n] = new int[nAtoms_];
-	if (vdwScaleMatrix_ != NULL) Messenger::print("Pattern::createMatrices : Warning - VDW scaling matrix was already allocated.");
-	vdwScaleMatrix_ = new double*[nAtoms_];
-	for (n=0; n<nAtoms_; n++) vdwScaleMatrix_[n] = new double[nAtoms_];
-	if (elecScaleMatrix_ != NULL) Messenger::print("Pattern::createMatrices : Warning - electrostatic scaling matrix was already allocated.");
-	elecScaleMatrix_ = new double*[nAtoms_];
-	for (n=0; n<nAtoms_; n++) elecScaleMatrix_[n] = new double[nAtoms_];
-
-	if (!quiet) Messenger::print("Connectivity matrix.....initialising....");
-	for (n=0; n<nAtoms_; ++n)
-		for (m=0; m<nAtoms_; ++m) conMatrix_[n][m] = 0;
-
-	// Since the full transformation to the connectivity matrix is quite intensive, we will only do this for patterns containing less than 1000 atoms
-	if (forceFull || (nAtoms_ < 1000))
-	{
-		if (!quiet) Messenger::print("seeding.....");
-		// First, build up the bond matrix
-		Atom* i = firstAtom_;
-		int ii = i->id();
-		for (n=0; n<nAtoms_; ++n)
-		{
-			for (RefListItem<Bond,int>* ri = i->bonds(); ri != NULL; ri = ri->next)
-			{
-				Atom* j = ri->item->partner(i);
-				conMatrix_[ i->id() - ii ] [ j->id() - ii ] = 1;
-			}
-			i = i->next;
-		}
-// 		for (pb = bonds_.first(); pb != NULL; pb = pb->next)
-// 		{
-// 			conMatrix_[ pb->atomId(0) ] [ pb->atomId(1) ] = 1;
-// 			conMatrix_[ pb->atomId(1) ] [ pb->atomId(0) ] = 1;
-// 		}
-
-		// Now, transform into the connectivity matrix.
-		if (!quiet) Messenger::print("transforming (full).....");
-		for (a1=0; a1<nAtoms_; a1++)
-		{
-			for (a2=0; a2<nAtoms_; a2++)
-			{
-				if (conMatrix_[a1][a2] != 0)
-				{
-					// A2 *is* bound directly to A1.
-					// So, we may increase the distance of A2 from all *other* atoms that A1 is bound to by one hop.
-					for (m=0; m<nAtoms_; m++)
-					{
-						// We only potentially increase the distance if :
-						//	1) The atom 'm' is *not equal* to a2 (i.e. is not itself)
-						//	2) The atom 'm' we're looking at is also bound to a1.
-						if ((m != a2) && (conMatrix_[a1][m] != 0))
-						if ((conMatrix_[a1][m] != 0))
-						{
-							// We only actually increase the distance if :
-							// 	1) Atom 'm' is not directly bound to a2 **OR**
-							//	2) The combined distances of m->a1 and a1->a2 is less than m->a2
-							// The last check means that only the minimum distance m->a2 persists at the end
-							if ((conMatrix_[m][a2] == 0) || (conMatrix_[a1][m]+conMatrix_[a1][a2] < conMatrix_[m][a2]))
-								conMatrix_[m][a2] = conMatrix_[a1][m] + conMatrix_[a1][a2];
-						}
-					}
-				}
-			}
-		}
-	}
-	else
-	{
-		// Create minimal transformation matrix, using only bond, angle, and torsion data
-		if (!quiet) Messenger::print("transforming (minimal).....");
-
-		// There may be more than one consecutive bound fragment in the pattern, so we must perform treeSelects in order to populate the initial matrix
-		Atom* i = firstAtom_;
-		int count = 100, ii, jj, diagii;
-		parent_->selectNone(true);
-		while (i != NULL)
-		{
-			// Check that we are still in the current pattern
-			if (i->id() > endAtom_) break;
-
-			// Treeselect from current atom
-			parent_->selectTree(i, true);
-
-			// For the current marked selection, set the diagonal matrix elements to the current 'count' value
-			for (RefListItem<Atom,int>* ri = parent_->selection(true); ri != NULL; ri = ri->next)
-			{
-				ii = ri->item->id() - startAtom_;
-				conMatrix_[ii][ii] = count;
-			}
+	Messenger::enter("Pattern::createExclusions");
 
-			// Find next unmarked atom
-			while (i && i->isSelected(true)) i = i->next;
+	if (exclusions_.isInitialised()) Messenger::print("Pattern::createExclusions : Warning - exclusion list was already created.");
 
-			// Deselect all atoms, and increase count
-			parent_->selectNone(true);
-			++count;
-		}
-
-		// The diagonal elements of conMatrix_ now indicate the parent fragments of each atom
-		// For all atoms within a given fragment, set the connectivity to the diagonal value to start with
-		for (ii = 0; ii < nAtoms_; ++ii)
-		{
-			diagii = conMatrix_[ii][ii];
-			for (jj = 0; jj < nAtoms_; ++jj)
-			{
-				if (diagii != conMatrix_[jj][jj]) continue;
-				conMatrix_[ii][jj] = diagii;
-				conMatrix_[jj][ii] = diagii;
-			}
-		}
+	// Only pairs up to 1-4 (torsion) separation need to be stored for the energy expression - all others interact fully.
+	// The exclusion list is built by a bounded search over the bonds of the first molecule, so its size scales with the number of atoms.
+	if (!quiet) Messenger::print("Exclusion list.....building (%s).....", full ? "full" : "1-4");
+	exclusions_.initialise(firstAtom_, nAtoms_, full ? nAtoms_ : 3);
+	if (!quiet) Messenger::print("done (%i pairs).", exclusions_.nEntries() / 2);
 
-		// Done with the diagonals now, so zero them
-		for (ii = 0; ii < nAtoms_; ++ii) conMatrix_[ii][ii] = 0;
+	// Update scale factors
+	updateScaleFactors();
 
-		// Now, add bonds to matrix
-		for (pb = bonds_.first(); pb != NULL; pb = pb->next)
-		{
-			conMatrix_[ pb->atomId(0) ] [ pb->atomId(1) ] = 1;
-			conMatrix_[ pb->atomId(1) ] [ pb->atomId(0) ] = 1;
-		}
-
-		// Angles (but don't overwrite bonds)
-		for (pb = angles_.first(); pb != NULL; pb = pb->next)
-		{
-			if (conMatrix_[pb->atomId(0)][pb->atomId(2)] == 1) continue;
-			conMatrix_[pb->atomId(0)][pb->atomId(2)] = 2;
-			conMatrix_[pb->atomId(2)][pb->atomId(0)] = 2;
-		}
-
-		// Torsions (but don't overwrite angles or bonds)
-		for (pb = torsions_.first(); pb != NULL; pb = pb->next)
-		{
-			if (conMatrix_[pb->atomId(0)][pb->atomId(3)] < 3) continue;
-			conMatrix_[pb->atomId(0)][pb->atomId(3)] = 3;
-			conMatrix_[pb->atomId(3)][pb->atomId(0)] = 3;
-		}
-	}
-	if (!quiet) Messenger::print("done.");
-
-// 	printf("Connectivity Matrix\n");
-// 	for (n=0; n<nAtoms_; n++)
-// 	{
-// 		for (m=0; m<nAtoms_; m++) printf ("%2i",conMatrix_[n][m]);
-// 		printf("\n"); 
-// 	} 
-
-	// Update contents of scale matrices
-	updateScaleMatrices();
-
-	Messenger::exit("Pattern::createMatrices");
+	Messenger::exit("Pattern::createExclusions");
 }
 
-// Update scale matrices in pattern
-void Pattern::updateScaleMatrices()
+// Update scale factors in exclusion list
+void Pattern::updateScaleFactors()
 {
-	Messenger::enter("Pattern::updateScaleMatrices");
+	Messenger::enter("Pattern::updateScaleFactors");
 	int i, j;
 	PatternBound* pb;
-	// Set all matrix elements to '1.0' initially. Then cycle over torsions, then angles, then bonds and set values accordingly.
-	for (i=0; i<nAtoms_; i++)
-		for (j=0; j<nAtoms_; j++)
-		{
-			vdwScaleMatrix_[i][j] = 1.0;
-			elecScaleMatrix_[i][j] = 1.0;
-		}
+	// Set all scale factors to '1.0' initially. Then cycle over torsions, then angles, then bonds and set values accordingly.
+	exclusions_.resetScales();
 	// Interactions at ends of torsion atoms are scaled by the factors stored in the torsion term
 	for (pb = torsions_.first(); pb != NULL; pb = pb->next)
 	{
@@ -880,13 +723,10 @@ void Pattern::updateScaleMatrices()
 			printf("Internal Error : One or both atom IDs (%i, %i) associated to torsion patternbound are invalid for pattern '%s'.\n", i, j, qPrintable(name_));
 			continue;
 		}
-		vdwScaleMatrix_[i][j] = pb->data()->vdwScale();
-		vdwScaleMatrix_[j][i] = pb->data()->vdwScale();
-		elecScaleMatrix_[i][j] = pb->data()->elecScale();
-		elecScaleMatrix_[j][i] = pb->data()->elecScale();
+		exclusions_.setScales(i, j, pb->data()->vdwScale(), pb->data()->elecScale());
 	}
 	// Atoms at end of angles are excluded from vdw/elec interactions.
-	// Note that these elements are zeroed in the matrices, but the connectivity matrix is used to determined whether they are calculated.
+	// Note that these scale factors are zeroed, but the connectivity is used to determined whether they are calculated.
 	for (pb = angles_.first(); pb != NULL; pb = pb->next)
 	{
 		i = pb->atomId(0);
@@ -896,10 +736,7 @@ void Pattern::updateScaleMatrices()
 			printf("Internal Error : One or both atom IDs (%i, %i) associated to angle patternbound are invalid for pattern '%s'.\n", i, j, qPrintable(name_));
 			continue;
 		}
-		vdwScaleMatrix_[i][j] = 0.0;
-		vdwScaleMatrix_[j][i] = 0.0;
-		elecScaleMatrix_[i][j] = 0.0;
-		elecScaleMatrix_[j][i] = 0.0;
+		exclusions_.setScales(i, j, 0.0, 0.0);
 	}
 	for (pb = bonds_.first(); pb != NULL; pb = pb->next)
 	{
@@ -907,46 +744,37 @@ void Pattern::updateScaleMatrices()
 		j = pb->atomId(1);
 		if ((i < 0) || (i >= nAtoms_) || (j < 0) || (j >= nAtoms_))
 		{
-			printf("Internal Error : One or both atom IDs (%i, %i) associated to torsion patternbound are invalid for pattern '%s'.\n", i, j, qPrintable(name_));
+			printf("Internal Error : One or both atom IDs (%i, %i) associated to bond patternbound are invalid for pattern '%s'.\n", i, j, qPrintable(name_));
 			continue;
 		}
-		vdwScaleMatrix_[i][j] = 0.0;
-		vdwScaleMatrix_[j][i] = 0.0;
-		elecScaleMatrix_[i][j] = 0.0;
-		elecScaleMatrix_[j][i] = 0.0;
+		exclusions_.setScales(i, j, 0.0, 0.0);
 	}
-// 	printf("VSCALE Matrix\n");
-// 	for (n=0; n<nAtoms_; n++)
-// 	{
-// 		for (m=0; m<nAtoms_; m++) printf ("%8.4f ",vdwScaleMatrix_[n][m]);
-// 		printf("\n"); 
-// 	}
 
-	Messenger::exit("Pattern::updateScaleMatrices");
+	Messenger::exit("Pattern::updateScaleFactors");
 }
 
 // Return connectivity distance between atom indices specified
 int Pattern::connectivity(int i, int j)
 {
-	if (conMatrix_ == NULL)
+	if (!exclusions_.isInitialised())
 	{
-		Messenger::error("Connectivity matrix not yet created.\n");
+		Messenger::error("Exclusion list not yet created.\n");
 		return 0;
 	}
 
 	if ((i < 0) || (i >= nAtoms_))
 	{
-		Messenger::error("Index i for connectivity matrix is out of range (%i)\n", i);
+		Messenger::error("Index i for connectivity is out of range (%i)\n", i);
 		return 0;
 	}
 
 	if ((j < 0) || (j >= nAtoms_))
 	{
-		Messenger::error("Index j for connectivity matrix is out of range (%i)\n", j);
+		Messenger::error("Index j for connectivity is out of range (%i)\n", j);
 		return 0;
 	}
 	
-	return conMatrix_[i][j];
+	return exclusions_.connectivity(i, j);
 }
 
 // Validate pattern
@@ -1131,6 +959,12 @@ Vec3<double> Pattern::calculateCom(int mol, Model* srcmodel)
 	return com;
 }
 
+// Make sure cached arrays are up to date before calculating energies / forces (which may be done from several threads)
+void Pattern::prepareArrays()
+{
+	atoms_.array();
+}
+
 /*
 // Data Propagation / Selector Routines
 */
@@ -1269,30 +1103,11 @@ void Pattern::findRings(int maxRingSize, int maxRings)
 {
 	Messenger::enter("Pattern::findRings");
 
-	int n, rsize;
-	bool okay = true;
-	Atom* i;
-	Ring path;
+	// Perceive the relevant cycles of the first molecule from a compact copy of its bonding
+	RingPerception perception;
+	perception.initialise(firstAtom_, nAtoms_);
+	bool okay = perception.findRings(maxRingSize, maxRings, this, rings_);
 
-	// Loop over atoms, searching for rings on each
-	i = firstAtom_;
-	for (n=0; n<nAtoms_; n++)
-	{
-		if (i->nBonds() > 1)
-		{
-			// Loop over searches for different ring sizes
-			for (rsize=3; rsize<=maxRingSize; ++rsize)
-			{
-				path.clear();
-				path.setRequestedSize(rsize);
-				// Call the recursive search to extend the path by this atom
-				okay = ringSearch(i, &path, maxRings);
-				if (!okay) break;
-			}
-		}
-		i = i->next;
-		if (!okay) break;
-	}
 	if ((!okay) && (rings_.nItems() == maxRings)) Messenger::print("Maximum number of rings (%i) reached for pattern '%s'...", maxRings, qPrintable(name_));
 	Messenger::print(Messenger::Verbose, "Pattern '%s' contains %i cycles of %i atoms or less.", qPrintable(name_), rings_.nItems(), maxRingSize);
 
@@ -1304,27 +1119,10 @@ void Pattern::findRingsFrom(int atomIndex, int maxRingSize, int maxRings)
 {
 	Messenger::enter("Pattern::findRings");
 
-	int n, rsize;
-	bool okay = true;
-	Atom* i;
-	Ring path;
-
 	// Search for rings involving the specified atom
-	i = firstAtom_;
-	for (n=0; n<atomIndex; ++n) i = i->next;
-
-	if (i->nBonds() > 1)
-	{
-		// Loop over searches for different ring sizes
-		for (rsize=3; rsize<=maxRingSize; ++rsize)
-		{
-			path.clear();
-			path.setRequestedSize(rsize);
-			// Call the recursive search to extend the path by this atom
-			okay = ringSearch(i, &path, maxRings);
-			if (!okay) break;
-		}
-	}
+	RingPerception perception;
+	perception.initialise(firstAtom_, nAtoms_);
+	bool okay = perception.findRings(maxRingSize, maxRings, this, rings_, atomIndex);
 
 	if ((!okay) && (rings_.nItems() == maxRings)) Messenger::print("Maximum number of rings (%i) reached for pattern '%s'...", maxRings, qPrintable(name_));
 	Messenger::print(Messenger::Verbose, "Pattern '%s' contains %i cycles of %i atoms or less.", qPrintable(name_), rings_.nItems(), maxRingSize);
@@ -1332,79 +1130,6 @@ void Pattern::findRingsFrom(int atomIndex, int maxRingSize, int maxRings)
 	Messenger::exit("Pattern::findRings");
 }
 
-// Ring search
-bool Pattern::ringSearch(Atom* i, Ring* currentpath, int maxRings)
-{
-	// Extend the path (ring) passed by the atom 'i', searching for a path length of 'ringsize'
-	Messenger::enter("Pattern::ringSearch");
-	RefListItem<Bond,int>* bref;
-	Ring* r;
-	RefListItem<Atom,int>* lastra;
-	bool done, maxreached = false;
-	// Otherwise, add it to the current path
-	lastra = currentpath->lastAtom();
-	if (currentpath->addAtom(i))
-	{
-// 		Messenger::print(Messenger::Verbose, " --- Atom i added to path :  ");
-// 		currentpath->print();
-		// Adding the atom did not exceed the requested ring size, and is not a duplicate
-		// Go through the list of atoms bound to 'i' and then:
-		//  -- If nAtoms_<=requestedsize && 'i' is bound to the first atom in the path, store the ring.
-		//  Otherwise, if nAtoms_<requestedsize then extend the ring by each of the bound atoms in turn.
-		done = false;
-		bref = i->bonds();
-		while (bref != NULL)
-		{
-			// Don't consider the atom we just came from...
-			if (lastra != NULL)
-				if (bref->item->partner(i) == lastra->item) { bref = bref->next; continue; }
-			// Depending on the size check, extend or store current path.
-			if (currentpath->nAtoms() == currentpath->requestedSize())
-			{
-				// The correct number of atoms is in the current path. Does it form a cycle?
-				if (i->findBond(currentpath->atoms()->item) != NULL)
-				{
-					// Check to see if this ring already exists in the rings_ list...
-					if (!isRingInList(currentpath))
-					{
-// 						Messenger::print(Messenger::Verbose, " --- Storing current ring.");
-						if (rings_.nItems() == maxRings) maxreached = true;
-						else
-						{
-							r = rings_.add();
-							r->setParent(this);
-							r->copy(currentpath);
-							r->finalise();
-							r->print();
-							done = true;
-						}
-					}
-				}
-			}
-			else
-			{
-				// Current path is not long enough, so extend it
-				if (!ringSearch(bref->item->partner(i), currentpath, maxRings)) maxreached = true;
-			}
-			bref = bref->next;
-			if (done || maxreached) break;
-		}
-		// Return the list to its original state
-// 		Messenger::print(Messenger::Verbose, " --- Removing atom %s[%p] from current path...", ElementMap::symbol(i), i);
-		currentpath->removeAtom(currentpath->lastAtom());
-	}
-// 	else printf(" --- Atom is already in list, or adding it exceeds specified ringsize.\n");
-	Messenger::exit("Pattern::ringSearch");
-	return (!maxreached);
-}
-
-// Search existing ring list for existence of supplied ring
-bool Pattern::isRingInList(Ring* source)
-{
-	for (Ring* r = rings_.first(); r != NULL; r = r->next) if (*r == *source) return true;
-	return false;
-}
-
 // Return total bond order penalty of atoms in one molecule of the pattern
 int Pattern::totalBondOrderPenalty()
 {
@@ -1737,6 +1462,150 @@ void Pattern::assignEnvironments()
 	Messenger::exit("Pattern::assignEnvironments");
 }
 
+// Assign classes to items from their signatures (stored consecutively), numbering distinct signatures in sorted order
+static int classifySignatures(const Array<int>& signatures, const Array<int>& offsets, Array<int>& classes)
+{
+	int n, nItems = offsets.nItems() - 1, nClasses = 0;
+	Array<int> order;
+	order.createEmpty(nItems, 0);
+	for (n=0; n<nItems; ++n) order[n] = n;
+
+	// Lexicographic comparison of signatures
+	auto lessThan = [&signatures, &offsets](int a, int b)
+	{
+		int lengthA = offsets.value(a+1) - offsets.value(a), lengthB = offsets.value(b+1) - offsets.value(b), x, y;
+		for (int k=0; (k < lengthA) && (k < lengthB); ++k)
+		{
+			x = signatures.value(offsets.value(a)+k);
+			y = signatures.value(offsets.value(b)+k);
+			if (x != y) return (x < y);
+		}
+		return (lengthA < lengthB);
+	};
+	std::sort(order.array(), order.array()+nItems, lessThan);
+
+	classes.createEmpty(nItems, 0);
+	for (n=0; n<nItems; ++n)
+	{
+		if ((n > 0) && lessThan(order[n-1], order[n])) ++nClasses;
+		classes[order[n]] = nClasses;
+	}
+	return (nItems == 0 ? 0 : nClasses+1);
+}
+
+// Partition atoms in one molecule into classes of equivalent environment, returning the number of classes
+int Pattern::environmentClasses(Array<int>& classes)
+{
+	Messenger::enter("Pattern::environmentClasses");
+
+	int n, k, local, nClasses, nPrevious, firstId = firstAtom_->id();
+	Array<Atom*> atoms;
+	atoms.createEmpty(nAtoms_, NULL);
+	Atom* i = firstAtom_;
+	for (n=0; n<nAtoms_; ++n)
+	{
+		atoms[n] = i;
+		i = i->next;
+	}
+
+	// Gather the members, sizes, and types of the rings in the molecule, and the rings each atom is in
+	Array<int> ringMembers, ringMemberOffsets, ringCodes, ringAtoms, ringIndices, atomRingOffsets, atomRings, cursor;
+	int nRings = 0;
+	for (Ring* r = rings_.first(); r != NULL; r = r->next)
+	{
+		ringMemberOffsets.add(ringMembers.nItems());
+		ringCodes.add(r->nAtoms()*Ring::nRingTypes + r->type());
+		for (RefListItem<Atom,int>* ra = r->atoms(); ra != NULL; ra = ra->next)
+		{
+			local = ra->item->id() - firstId;
+			if ((local < 0) || (local >= nAtoms_)) continue;
+			ringMembers.add(local);
+			ringAtoms.add(local);
+			ringIndices.add(nRings);
+		}
+		++nRings;
+	}
+	ringMemberOffsets.add(ringMembers.nItems());
+	atomRingOffsets.createEmpty(nAtoms_+1, 0);
+	for (n=0; n<ringAtoms.nItems(); ++n) ++atomRingOffsets[ringAtoms[n]+1];
+	cursor.createEmpty(nAtoms_, 0);
+	for (n=0; n<nAtoms_; ++n)
+	{
+		atomRingOffsets[n+1] += atomRingOffsets[n];
+		cursor[n] = atomRingOffsets[n];
+	}
+	atomRings.createEmpty(ringAtoms.nItems(), 0);
+	for (n=0; n<ringAtoms.nItems(); ++n) atomRings[cursor[ringAtoms[n]]++] = ringIndices[n];
+
+	// Initial signatures - element, number of bonds, environment, oxidation state, and sorted ring codes
+	Array<int> signatures, offsets, codes, ringClasses;
+	for (n=0; n<nAtoms_; ++n)
+	{
+		offsets.add(signatures.nItems());
+		signatures.add(atoms[n]->element());
+		signatures.add(atoms[n]->nBonds());
+		signatures.add(atoms[n]->environment());
+		signatures.add(atoms[n]->os());
+		codes.forgetData();
+		for (k=atomRingOffsets[n]; k<atomRingOffsets[n+1]; ++k) codes.add(ringCodes[atomRings[k]]);
+		std::sort(codes.array(), codes.array()+codes.nItems());
+		for (k=0; k<codes.nItems(); ++k) signatures.add(codes[k]);
+	}
+	offsets.add(signatures.nItems());
+	nClasses = classifySignatures(signatures, offsets, classes);
+
+	// Refine classes by the classes of bound neighbours (and the bonds to them), and by the contents of the rings each atom is in, until no more can be distinguished
+	// Rings are themselves classified by their size, type, and the classes of their members, so that atoms are only equivalent if their rings are too (NETA ring descriptions may test ring contents)
+	do
+	{
+		nPrevious = nClasses;
+
+		// Classify rings from their size, type, and sorted member classes
+		signatures.forgetData();
+		offsets.forgetData();
+		for (n=0; n<nRings; ++n)
+		{
+			offsets.add(signatures.nItems());
+			signatures.add(ringCodes[n]);
+			codes.forgetData();
+			for (k=ringMemberOffsets[n]; k<ringMemberOffsets[n+1]; ++k) codes.add(classes[ringMembers[k]]);
+			std::sort(codes.array(), codes.array()+codes.nItems());
+			for (k=0; k<codes.nItems(); ++k) signatures.add(codes[k]);
+		}
+		offsets.add(signatures.nItems());
+		classifySignatures(signatures, offsets, ringClasses);
+
+		// Now atoms, from their current class, bound neighbours, and ring classes
+		signatures.forgetData();
+		offsets.forgetData();
+		for (n=0; n<nAtoms_; ++n)
+		{
+			offsets.add(signatures.nItems());
+			signatures.add(classes[n]);
+			codes.forgetData();
+			for (RefListItem<Bond,int>* ri = atoms[n]->bonds(); ri != NULL; ri = ri->next)
+			{
+				local = ri->item->partner(atoms[n])->id() - firstId;
+				if ((local < 0) || (local >= nAtoms_)) continue;
+				codes.add(ri->item->type()*nAtoms_ + classes[local]);
+			}
+			std::sort(codes.array(), codes.array()+codes.nItems());
+			for (k=0; k<codes.nItems(); ++k) signatures.add(codes[k]);
+			codes.forgetData();
+			for (k=atomRingOffsets[n]; k<atomRingOffsets[n+1]; ++k) codes.add(ringClasses[atomRings[k]]);
+			std::sort(codes.array(), codes.array()+codes.nItems());
+			for (k=0; k<codes.nItems(); ++k) signatures.add(codes[k]);
+		}
+		offsets.add(signatures.nItems());
+		nClasses = classifySignatures(signatures, offsets, classes);
+	} while (nClasses > nPrevious);
+
+	Messenger::print(Messenger::Verbose, "Pattern '%s' contains %i distinct atomic environments.", qPrintable(name_), nClasses);
+
+	Messenger::exit("Pattern::environmentClasses");
+	return nClasses;
+}
+
 // Type atoms in pattern
 bool Pattern::typeAtoms()
 {
@@ -1747,7 +1616,7 @@ bool Pattern::typeAtoms()
 	// accept a different atom type if we manage to match a complete set containing more rules.
 	// Return false if one or more atoms could not be typed
 	Messenger::enter("Pattern::typeAtoms");
-	int a, newMatch, bestMatch, nFailed;
+	int a, n, newMatch, bestMatch, nFailed, el;
 	Neta* at;
 	Atom* i;
 	Forcefield* ff;
@@ -1776,6 +1645,37 @@ bool Pattern::typeAtoms()
 		Messenger::exit("Pattern::typeAtoms");
 		return false;
 	}
+
+	// Bucket the forcefield types by character element (preserving their order, since the first best match is kept)
+	int maxElement = 0;
+	for (ffa = ff->types(); ffa != NULL; ffa = ffa->next) if (ffa->neta()->characterElement() > maxElement) maxElement = ffa->neta()->characterElement();
+	Array<int> candidateOffsets, cursor;
+	Array<ForcefieldAtom*> candidates;
+	candidateOffsets.createEmpty(maxElement+2, 0);
+	for (ffa = ff->types(); ffa != NULL; ffa = ffa->next) if (ffa->neta()->characterElement() >= 0) ++candidateOffsets[ffa->neta()->characterElement()+1];
+	cursor.createEmpty(maxElement+1, 0);
+	for (el=0; el<=maxElement; ++el)
+	{
+		candidateOffsets[el+1] += candidateOffsets[el];
+		cursor[el] = candidateOffsets[el];
+	}
+	candidates.createEmpty(candidateOffsets[maxElement+1], NULL);
+	for (ffa = ff->types(); ffa != NULL; ffa = ffa->next) if (ffa->neta()->characterElement() >= 0) candidates[cursor[ffa->neta()->characterElement()]++] = ffa;
+
+	// If no type depends on atomic coordinates, atoms in identical environments must receive the same type, so only one of each needs to be matched
+	bool shareTypes = true;
+	for (ffa = ff->types(); ffa != NULL; ffa = ffa->next) if (!ffa->neta()->isTopological()) shareTypes = false;
+	Array<int> classes;
+	Array<ForcefieldAtom*> classTypes;
+	Array<bool> classTyped;
+	bool verifyShared = Messenger::isOutputActive(Messenger::Typing);
+	if (shareTypes)
+	{
+		int nClasses = environmentClasses(classes);
+		classTypes.createEmpty(nClasses, NULL);
+		classTyped.createEmpty(nClasses, false);
+	}
+
 	// Loop over atoms in the pattern's molecule
 	i = firstAtom_;
 	nFailed = 0;
@@ -1799,26 +1699,41 @@ bool Pattern::typeAtoms()
 			result = false;
 		}
 
-		// Loop over forcefield atom types
-		for (ffa = ff->types(); ffa != NULL; ffa = ffa->next)
+		// Has an atom in the same environment already been typed? (When debugging typing, match every atom anyway and check it against its class)
+		if (shareTypes && classTyped[classes[a]] && (!verifyShared))
 		{
-			// Grab next atomtype
-			at = ffa->neta();
-
-			// First, check element is the same, otherwise skip
-			if (i->element() != at->characterElement()) continue;
-			
-			// See how well this ff description matches the environment of our atom 'i'
-			Messenger::print(Messenger::Typing,"Pattern::typeAtoms : Matching type id %i", ffa->typeId());
-			newMatch = at->matchAtom(i, &rings_, parent_);
-			Messenger::print(Messenger::Typing,"Pattern::typeAtoms : ...Total match score for type %i = %i", ffa->typeId(), newMatch);
-			if (newMatch > bestMatch)
+			if (classTypes[classes[a]] != NULL) i->setType(classTypes[classes[a]]);
+		}
+		else if (i->element() <= maxElement)
+		{
+			// Loop over forcefield atom types with the same character element
+			for (n=candidateOffsets[i->element()]; n<candidateOffsets[i->element()+1]; ++n)
 			{
-				// Better match found...
-				bestMatch = newMatch;
-				i->setType(ffa);
+				// Grab next atomtype
+				ffa = candidates[n];
+				at = ffa->neta();
+
+				// See how well this ff description matches the environment of our atom 'i'
+				Messenger::print(Messenger::Typing,"Pattern::typeAtoms : Matching type id %i", ffa->typeId());
+				newMatch = at->matchAtom(i, &rings_, parent_);
+				Messenger::print(Messenger::Typing,"Pattern::typeAtoms : ...Total match score for type %i = %i", ffa->typeId(), newMatch);
+				if (newMatch > bestMatch)
+				{
+					// Better match found...
+					bestMatch = newMatch;
+					i->setType(ffa);
+				}
 			}
 		}
+		if (shareTypes && classTyped[classes[a]])
+		{
+			if (i->type() != classTypes[classes[a]]) Messenger::print("Warning - Atom %i typed as '%s' but shares an environment with an atom typed as '%s'.", i->id()+1, i->type() == NULL ? "NULL" : qPrintable(i->type()->name()), classTypes[classes[a]] == NULL ? "NULL" : qPrintable(classTypes[classes[a]]->name()));
+		}
+		else if (shareTypes)
+		{
+			classTyped[classes[a]] = true;
+			classTypes[classes[a]] = i->type();
+		}
 		if (i->type() == NULL)
 		{
 			Messenger::print("Failed to type atom - %s, id = %i, nbonds = %i.", ElementMap::name(i), i->id()+1, i->nBonds());
@@ -25,7 +25,9 @@
 #include "templates/vector3.h"
 #include "templates/list.h"
 #include "templates/reflist.h"
+#include "templates/array.h"
 #include "math/constants.h"
+#include "ff/exclusionlist.h"
 #include "base/namespace.h"
 
 ATEN_BEGIN_NAMESPACE
@@ -234,12 +236,8 @@ class Pattern : public ListItem<Pattern>
 	 * Expression
 	 */
 	private:
-	// Connectivity matrix of atoms in one molecule of the pattern
-	int **conMatrix_;
-	// Scaling matrix for VDW interactions between atoms in each molecule
-	double** vdwScaleMatrix_;
-	// Scaling matrix for electrostatic interactions between atoms in each molecule
-	double** elecScaleMatrix_;
+	// Connectivity and interaction scale factors of bound atom pairs in one molecule of the pattern
+	ExclusionList exclusions_;
 	// Flag for incomplete energy node
 	bool incomplete_;
 	// Flag for no intramolecular terms in expression
@@ -292,10 +290,10 @@ class Pattern : public ListItem<Pattern>
 	void deleteExpression();
 	// Create the shell of the energy expression
 	bool createExpression(bool vdwOnly = false, bool allowDummy = false, Forcefield* defaultForcefield = NULL);
-	// Create the connectivity and scaling matrices
-	void createMatrices(bool forceFull = false, bool quiet = false);
-	// Update scaling matrices
-	void updateScaleMatrices();
+	// Create the connectivity and scaling exclusion list (storing all connected pairs if full is true)
+	void createExclusions(bool full = false, bool quiet = false);
+	// Update scale factors in exclusion list
+	void updateScaleFactors();
 	// Return connectivity distance between atom indices specified
 	int connectivity(int i, int j);
 	// Return number of bonds in one molecule of the pattern
@@ -304,6 +302,8 @@ class Pattern : public ListItem<Pattern>
 	int nAngles() const;
 	// Return number of torsions in one molecule of the pattern
 	int nTorsions() const;
+	// Return first atom data of the pattern
+	PatternAtom* atoms();
 	// Return first bond of the pattern
 	PatternBound* bonds();
 	// Return first angle of the pattern
@@ -355,53 +355,62 @@ class Pattern : public ListItem<Pattern>
 	/*
 	 * Energy / Force Calculation
 	 */
+	// In the following, a range of molecules (firstMolecule to lastMolecule inclusive, where -1 means the last molecule in the
+	// pattern) may be given in order to split calculations into blocks. This is ignored if a specific molecule is supplied.
+	// Forces are accumulated into the supplied array, which must be large enough to hold forces for all atoms in the model.
 	public:
+	// Make sure cached arrays are up to date before calculating energies / forces (which may be done from several threads)
+	void prepareArrays();
 	// Calculate bond energy of pattern (or specific molecule)
-	void bondEnergy(Model* source, EnergyStore* estore, int molecule = -1);
+	void bondEnergy(Model* source, EnergyStore* estore, int molecule = -1, int firstMolecule = 0, int lastMolecule = -1);
 	// Calculate angle energy of pattern (or specific molecule)
-	void angleEnergy(Model* source, EnergyStore* estore, int molecule = -1);
+	void angleEnergy(Model* source, EnergyStore* estore, int molecule = -1, int firstMolecule = 0, int lastMolecule = -1);
 	// Calculate torsion energy (including impropers) of pattern (or specific molecule)
-	void torsionEnergy(Model* source, EnergyStore* estore, int molecule = -1);
+	void torsionEnergy(Model* source, EnergyStore* estore, int molecule = -1, int firstMolecule = 0, int lastMolecule = -1);
 	// Calculate intrapattern Vdw energy (or for specific molecule)
-	bool vdwIntraPatternEnergy(Model* source, EnergyStore* estore, int molecule = -1);
+	bool vdwIntraPatternEnergy(Model* source, EnergyStore* estore, int molecule = -1, int firstMolecule = 0, int lastMolecule = -1);
 	// Calculate interpattern Vdw energy (or for specific molecule)
-	bool vdwInterPatternEnergy(Model* source, Pattern* other, EnergyStore* estore, int molecule = -1);
+	bool vdwInterPatternEnergy(Model* source, Pattern* other, EnergyStore* estore, int molecule = -1, int firstMolecule = 0, int lastMolecule = -1);
 	// Calculate Vdw correction energy for pattern
 	bool vdwCorrectEnergy( AtenSpace::UnitCell& cell, AtenSpace::EnergyStore* estore );
 	// Calculate intrapattern coulomb energy (or for specific molecule)
-	void coulombIntraPatternEnergy(Model* source, EnergyStore* estore, int molecule = -1);
+	void coulombIntraPatternEnergy(Model* source, EnergyStore* estore, int molecule = -1, int firstMolecule = 0, int lastMolecule = -1);
 	// Calculate interpattern coulomb energy (or for specific molecule)
-	void coulombInterPatternEnergy(Model* source, Pattern* other, EnergyStore* estore, int molecule = -1);
+	void coulombInterPatternEnergy(Model* source, Pattern* other, EnergyStore* estore, int molecule = -1, int firstMolecule = 0, int lastMolecule = -1);
 	// Calculate intrapattern real-space Ewald energy (or for specific molecule)
-	void ewaldRealIntraPatternEnergy(Model* source, EnergyStore* estore, int molecule = -1);
+	void ewaldRealIntraPatternEnergy(Model* source, EnergyStore* estore, int molecule = -1, int firstMolecule = 0, int lastMolecule = -1);
 	// Calculate interpattern real-space Ewald energy (or for specific molecule)
-	void ewaldRealInterPatternEnergy(Model* source, Pattern* other, EnergyStore* estore, int molecule = -1);
+	void ewaldRealInterPatternEnergy(Model* source, Pattern* other, EnergyStore* estore, int molecule = -1, int firstMolecule = 0, int lastMolecule = -1);
 	// Calculate reciprocal-space Ewald energy (or for specific molecule)
 	void ewaldReciprocalEnergy(Model* source, Pattern* other, int, EnergyStore* estore, int molecule = -1);
 	// Calculate Ewald correction energy (or for specific molecule)
 	void ewaldCorrectEnergy(Model* source, EnergyStore* estore, int molecule = -1);
+	// Calculate SPME reciprocal energy of all atoms in model
+	void spmeReciprocalEnergy(Model* source, EnergyStore* estore);
 	// Calculate bond forces in pattern
-	void bondForces(Model* source);
+	void bondForces(Model* source, Vec3<double>* forces, int firstMolecule = 0, int lastMolecule = -1);
 	// Calculate angle forces in pattern
-	void angleForces(Model* source);
+	void angleForces(Model* source, Vec3<double>* forces, int firstMolecule = 0, int lastMolecule = -1);
 	// Calculate torsion forces (including impropers) in pattern
-	void torsionForces(Model* source);
+	void torsionForces(Model* source, Vec3<double>* forces, int firstMolecule = 0, int lastMolecule = -1);
 	// Calculate Vdw intrapattern forces
-	bool vdwIntraPatternForces(Model* source);
+	bool vdwIntraPatternForces(Model* source, Vec3<double>* forces, int firstMolecule = 0, int lastMolecule = -1);
 	// Calculate Vdw interpattern forces
-	bool vdwInterPatternForces(Model* source, Pattern* other);
+	bool vdwInterPatternForces(Model* source, Pattern* other, Vec3<double>* forces, int firstMolecule = 0, int lastMolecule = -1);
 	// Calculate Coulomb intrapattern forces
-	void coulombIntraPatternForces(Model* source);
+	void coulombIntraPatternForces(Model* source, Vec3<double>* forces, int firstMolecule = 0, int lastMolecule = -1);
 	// Calculate Coulomb interpattern forces
-	void coulombInterPatternForces(Model* source, Pattern* other);
+	void coulombInterPatternForces(Model* source, Pattern* other, Vec3<double>* forces, int firstMolecule = 0, int lastMolecule = -1);
 	// Calculate Ewald real-space intrapattern forces
-	void ewaldRealIntraPatternForces(Model* source);
+	void ewaldRealIntraPatternForces(Model* source, Vec3<double>* forces, int firstMolecule = 0, int lastMolecule = -1);
 	// Calculate Ewald real-space interpattern forces
-	void ewaldRealInterPatternForces(Model* source, Pattern* other);
+	void ewaldRealInterPatternForces(Model* source, Pattern* other, Vec3<double>* forces, int firstMolecule = 0, int lastMolecule = -1);
 	// Calculate Ewald reciprocal-space forces
-	void ewaldReciprocalForces(Model* source);
+	void ewaldReciprocalForces(Model* source, Vec3<double>* forces);
 	// Calculate Ewald force corrections
-	void ewaldCorrectForces(Model* source);
+	void ewaldCorrectForces(Model* source, Vec3<double>* forces);
+	// Calculate SPME reciprocal forces of all atoms in model
+	void spmeReciprocalForces(Model* source, Vec3<double>* forces);
 
 
 	/*
@@ -410,10 +419,8 @@ class Pattern : public ListItem<Pattern>
 	private:
 	// List of rings in one molecule of the pattern
 	List<Ring> rings_;
-	// Recursive ring-search routine
-	bool ringSearch(Atom* i, Ring* currentpath, int maxRings);
-	// Search existing ring list for existence of supplied ring
-	bool isRingInList(Ring* source);
+	// Partition atoms in one molecule into classes of equivalent environment, returning the number of classes
+	int environmentClasses(Array<int>& classes);
 
 	public:
 	// Returns a pointer to the ring list structure
@@ -21,6 +21,7 @@
 
 #include "base/prefs.h"
 #include "base/sysfunc.h"
+#include "base/threadpool.h"
 #include "methods/mc.h"
 
 ATEN_BEGIN_NAMESPACE
@@ -312,6 +313,9 @@ Prefs::Prefs()
 	readPipe_ = false;
 	allowDialogs_ = false;
 	dynamicPanels_ = true;
+	nThreads_ = 1;
+	singlePrecisionFrames_ = false;
+	trajectoryIndexFiles_ = true;
 	
 	// Energy unit conversion factors to J
 	energyConversions_[Prefs::Joules] = 1.0;
@@ -333,8 +337,11 @@ Prefs::Prefs()
 	ewaldKMax_.set(5,5,5);
 	ewaldAlpha_ = 0.5;
 	ewaldPrecision_.set(5.0, -6);
+	spmeOrder_ = 6;
 	vdwCutoff_ = 50.0;
 	elecCutoff_ = 50.0;
+	neighbourSkin_ = 0.0;
+	vdwTablePoints_ = 0;
 	validEwaldAuto_ = false;
 	partitionGridSize_.set(50,50,50);
 
@@ -1085,13 +1092,13 @@ void Prefs::setMaxRings(int i)
 	maxRings_ = i;
 }
 
-// Return maximum number of bonding cuboids in each direction
+// Return maximum number of cells in each direction when sorting atoms for bonding and neighbour lists
 int Prefs::maxCuboids() const
 {
 	return maxCuboids_;
 }
 
-// Set maximum number of bonding cuboids in each direction
+// Set maximum number of cells in each direction when sorting atoms for bonding and neighbour lists
 void Prefs::setMaxCuboids(int i)
 {
 	maxCuboids_ = i;
@@ -1181,6 +1188,48 @@ void Prefs::setAllowDialogs(bool b)
 	allowDialogs_ = b;
 }
 
+// Set number of threads to use in parallel calculations (0 for all available)
+void Prefs::setNThreads(int n)
+{
+	nThreads_ = (n < 0 ? 0 : n);
+}
+
+// Return number of threads requested for parallel calculations (0 for all available)
+int Prefs::nThreads() const
+{
+	return nThreads_;
+}
+
+// Return actual number of threads to use in parallel calculations
+int Prefs::nThreadsToUse() const
+{
+	return ThreadPool::threadCount(nThreads_);
+}
+
+// Set whether to store cached trajectory frames in single precision
+void Prefs::setSinglePrecisionFrames(bool b)
+{
+	singlePrecisionFrames_ = b;
+}
+
+// Return whether to store cached trajectory frames in single precision
+bool Prefs::singlePrecisionFrames() const
+{
+	return singlePrecisionFrames_;
+}
+
+// Set whether to read and write index files of frame offsets alongside trajectory files
+void Prefs::setTrajectoryIndexFiles(bool b)
+{
+	trajectoryIndexFiles_ = b;
+}
+
+// Return whether to read and write index files of frame offsets alongside trajectory files
+bool Prefs::trajectoryIndexFiles() const
+{
+	return trajectoryIndexFiles_;
+}
+
 // Set the maximum number of undo levels allowed
 void Prefs::setMaxUndoLevels(int n)
 {
@@ -1307,6 +1356,18 @@ double Prefs::ewaldAlpha() const
 	return ewaldAlpha_;
 }
 
+// Set the order of B-spline interpolation in the SPME method
+void Prefs::setSpmeOrder(int order)
+{
+	spmeOrder_ = (order < 3 ? 3 : order);
+}
+
+// Return the order of B-spline interpolation in the SPME method
+int Prefs::spmeOrder() const
+{
+	return spmeOrder_;
+}
+
 // Flag to indicate validity of automatic Ewald params (invalidated on cell change)
 bool Prefs::hasValidEwaldAuto() const
 {
@@ -1343,6 +1404,30 @@ double Prefs::elecCutoff() const
 	return elecCutoff_;
 }
 
+// Sets the neighbour list skin distance
+void Prefs::setNeighbourSkin(double d)
+{
+	neighbourSkin_ = d;
+}
+
+// Return the neighbour list skin distance
+double Prefs::neighbourSkin() const
+{
+	return neighbourSkin_;
+}
+
+// Set number of points in tabulated VDW interactions
+void Prefs::setVdwTablePoints(int n)
+{
+	vdwTablePoints_ = (n < 0 ? 0 : n);
+}
+
+// Return number of points in tabulated VDW interactions
+int Prefs::vdwTablePoints() const
+{
+	return vdwTablePoints_;
+}
+
 // Set grid size for PartitioningSchemes
 void Prefs::setPartitionGridSize(Vec3<int> newSize)
 {
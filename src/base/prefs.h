@@ -515,7 +515,7 @@ class Prefs
 	int maxRingSize_;
 	// Maximum number of rings to detect per pattern
 	int maxRings_;
-	// Maximum number of bonding cuboids in each direction
+	// Maximum number of cells in each direction when sorting atoms for bonding and neighbour lists (0 for no limit)
 	int maxCuboids_;
 	// Maximum number of undo levels (-1 for unlimited)
 	int maxUndoLevels_;
@@ -539,6 +539,12 @@ class Prefs
 	bool allowDialogs_;
 	// Whether dynamic layout management of panel buttons is enabled
 	bool dynamicPanels_;
+	// Number of threads to use in parallel calculations (0 for all available)
+	int nThreads_;
+	// Whether to store cached trajectory frames in single precision
+	bool singlePrecisionFrames_;
+	// Whether to read and write index files of frame offsets alongside trajectory files
+	bool trajectoryIndexFiles_;
 
 	public:
 	// Return the maximum ring size allowed
@@ -549,9 +555,9 @@ class Prefs
 	int maxRings() const;
 	// Set the maximum number of rings to detect per pattern
 	void setMaxRings(int i);
-	// Return maximum number of bonding cuboids in each direction
+	// Return maximum number of cells in each direction when sorting atoms for bonding and neighbour lists
 	int maxCuboids() const;
-	// Set maximum number of bonding cuboids in each direction
+	// Set maximum number of cells in each direction when sorting atoms for bonding and neighbour lists
 	void setMaxCuboids(int i);
 	// Set the maximum number of undo levels allowed
 	void setMaxUndoLevels(int n);
@@ -597,6 +603,20 @@ class Prefs
 	bool dynamicPanels();
 	// Set whether dynamic layout management of panel buttons is enabled
 	void setDynamicPanels(bool b);
+	// Set number of threads to use in parallel calculations (0 for all available)
+	void setNThreads(int n);
+	// Return number of threads requested for parallel calculations (0 for all available)
+	int nThreads() const;
+	// Return actual number of threads to use in parallel calculations
+	int nThreadsToUse() const;
+	// Set whether to store cached trajectory frames in single precision
+	void setSinglePrecisionFrames(bool b);
+	// Return whether to store cached trajectory frames in single precision
+	bool singlePrecisionFrames() const;
+	// Set whether to read and write index files of frame offsets alongside trajectory files
+	void setTrajectoryIndexFiles(bool b);
+	// Return whether to read and write index files of frame offsets alongside trajectory files
+	bool trajectoryIndexFiles() const;
 
 
 	/*
@@ -651,8 +671,14 @@ class Prefs
 	double ewaldAlpha_;
 	// Ewald sum precision for automatic parameter estimation
 	DoubleExp ewaldPrecision_;
+	// Order of B-spline interpolation in the SPME method
+	int spmeOrder_;
 	// Cutoff distances for VDW and electrostatics
 	double vdwCutoff_, elecCutoff_;
+	// Skin distance added to the cutoff when building Verlet neighbour lists (zero to use linked cells only)
+	double neighbourSkin_;
+	// Number of points in tabulated VDW interactions (zero to use analytic forms only)
+	int vdwTablePoints_;
 	// Whether the automatic Ewald setup is valid
 	bool validEwaldAuto_;
 	// Grid size for PartitioningSchemes
@@ -683,6 +709,10 @@ class Prefs
 	void setEwaldAlpha(double d);
 	// Return the Ewald alpha value
 	double ewaldAlpha() const;
+	// Set the order of B-spline interpolation in the SPME method
+	void setSpmeOrder(int order);
+	// Return the order of B-spline interpolation in the SPME method
+	int spmeOrder() const;
 	// Set the short-range and electrostatic cutoffs
 	void setCutoffs(double vcut, double ecut);
 	// Estimate Ewald sum parameters from the supplied unit cell
@@ -699,6 +729,14 @@ class Prefs
 	void setElecCutoff(double d);
 	// Return the electrostatic cutoff radius
 	double elecCutoff() const;
+	// Sets the neighbour list skin distance
+	void setNeighbourSkin(double d);
+	// Return the neighbour list skin distance
+	double neighbourSkin() const;
+	// Set number of points in tabulated VDW interactions
+	void setVdwTablePoints(int n);
+	// Return number of points in tabulated VDW interactions
+	int vdwTablePoints() const;
 	// Set grid size for PartitioningSchemes
 	void setPartitionGridSize(Vec3<int> newSize);
 	// Set grid size for PartitioningSchemes (element)
@@ -0,0 +1,509 @@
+/*
+	*** Ring perception
+	*** src/base/ringperception.cpp
+	Copyright T. Youngs 2007-2017
+
+	This file is part of Aten.
+
+	Aten is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Aten is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Aten.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "base/ringperception.h"
+#include "base/ring.h"
+#include "base/atom.h"
+#include "base/bond.h"
+#include "base/messenger.h"
+#include <algorithm>
+
+ATEN_USING_NAMESPACE
+
+// Constructor
+RingPerception::RingPerception()
+{
+	// Private variables
+	nAtoms_ = 0;
+	nBonds_ = 0;
+	currentStamp_ = -1;
+	currentMark_ = -1;
+}
+
+/*
+ * Graph
+ */
+
+// Return undirected bond index between the two vertices specified (or -1 if they are not bound)
+int RingPerception::bondIndex(int i, int j) const
+{
+	for (int e=offsets_.value(i); e<offsets_.value(i+1); ++e) if (neighbours_.value(e) == j) return bondIndices_.value(e);
+	return -1;
+}
+
+// Construct graph from the bonding of the atoms starting at the one supplied
+void RingPerception::initialise(Atom* firstAtom, int nAtoms)
+{
+	Messenger::enter("RingPerception::initialise");
+
+	nAtoms_ = nAtoms;
+	nBonds_ = 0;
+	atoms_.createEmpty(nAtoms_, NULL);
+	offsets_.createEmpty(nAtoms_+1, 0);
+	neighbours_.clear();
+	bondIndices_.clear();
+	if ((nAtoms_ == 0) || (firstAtom == NULL))
+	{
+		Messenger::exit("RingPerception::initialise");
+		return;
+	}
+
+	// Gather unique bonds between atoms in the range, counting the number of bonds to each atom
+	int n, b, firstId = firstAtom->id();
+	Array<int> bondI, bondJ, cursor;
+	cursor.createEmpty(nAtoms_, 0);
+	Atom* i = firstAtom;
+	for (n=0; n<nAtoms_; ++n)
+	{
+		if (i == NULL) break;
+		atoms_[n] = i;
+		for (RefListItem<Bond,int>* ri = i->bonds(); ri != NULL; ri = ri->next)
+		{
+			b = ri->item->partner(i)->id() - firstId;
+			if ((b <= n) || (b >= nAtoms_)) continue;
+			bondI.add(n);
+			bondJ.add(b);
+			++offsets_[n+1];
+			++offsets_[b+1];
+		}
+		i = i->next;
+	}
+	nBonds_ = bondI.nItems();
+
+	// Convert counts to offsets, and fill in the edges of each vertex
+	for (n=0; n<nAtoms_; ++n)
+	{
+		offsets_[n+1] += offsets_[n];
+		cursor[n] = offsets_[n];
+	}
+	neighbours_.createEmpty(nBonds_*2, -1);
+	bondIndices_.createEmpty(nBonds_*2, -1);
+	for (b=0; b<nBonds_; ++b)
+	{
+		neighbours_[cursor[bondI[b]]] = bondJ[b];
+		bondIndices_[cursor[bondI[b]]++] = b;
+		neighbours_[cursor[bondJ[b]]] = bondI[b];
+		bondIndices_[cursor[bondJ[b]]++] = b;
+	}
+
+	Messenger::exit("RingPerception::initialise");
+}
+
+/*
+ * Search
+ */
+
+// Search outwards from the specified root, up to the maximum distance given
+void RingPerception::search(int root, int maxDepth)
+{
+	int n = 0, u, v, e;
+	++currentStamp_;
+	stamp_[root] = currentStamp_;
+	distance_[root] = 0;
+	predecessor_[root] = -1;
+	restricted_[root] = false;
+	reached_.forgetData();
+	reached_.add(root);
+
+	// The list of reached vertices doubles as the search queue, so all predecessors of a vertex have been considered before it is expanded
+	while (n < reached_.nItems())
+	{
+		u = reached_[n++];
+		if (distance_[u] == maxDepth) continue;
+		for (e=offsets_[u]; e<offsets_[u+1]; ++e)
+		{
+			v = neighbours_[e];
+			if (stamp_[v] == currentStamp_)
+			{
+				// Already reached, but this may be a shortest path through lower-numbered vertices only
+				if ((distance_[v] == distance_[u]+1) && (!restricted_[v]) && (v < root) && ((u == root) || restricted_[u]))
+				{
+					restricted_[v] = true;
+					predecessor_[v] = u;
+				}
+				continue;
+			}
+			stamp_[v] = currentStamp_;
+			distance_[v] = distance_[u] + 1;
+			predecessor_[v] = u;
+			restricted_[v] = (v < root) && ((u == root) || restricted_[u]);
+			reached_.add(v);
+		}
+	}
+}
+
+// Return whether the stored shortest paths from the root to the two vertices share only the root
+bool RingPerception::pathsDisjoint(int root, int i, int j)
+{
+	++currentMark_;
+	for (int v = i; v != root; v = predecessor_[v]) marks_[v] = currentMark_;
+	for (int v = j; v != root; v = predecessor_[v]) if (marks_[v] == currentMark_) return false;
+	return true;
+}
+
+// Extend path backwards from the specified vertex towards the root, storing all completed paths
+void RingPerception::extendPath(int root, int vertex, Array<int>& path, Array<int>& paths)
+{
+	path[distance_[vertex]] = vertex;
+	if (vertex == root)
+	{
+		for (int n=0; n<path.nItems(); ++n) paths.add(path[n]);
+		return;
+	}
+
+	// Step to any neighbour one closer to the root, as long as it is the root or only reachable through lower-numbered vertices
+	int u;
+	for (int e=offsets_[vertex]; e<offsets_[vertex+1]; ++e)
+	{
+		u = neighbours_[e];
+		if ((stamp_[u] != currentStamp_) || (distance_[u] != distance_[vertex]-1)) continue;
+		if ((u != root) && (!restricted_[u])) continue;
+		extendPath(root, u, path, paths);
+	}
+}
+
+/*
+ * Cycles
+ */
+
+// Construct prototype cycle of the specified family (after searching from its root), returning the vertices in order
+void RingPerception::prototype(int family, Array<int>& vertices)
+{
+	int v, root = familyRoots_[family];
+	vertices.forgetData();
+
+	// Out along the stored path to the first end, then back from the second
+	for (v = familyFirst_[family]; v != root; v = predecessor_[v]) vertices.add(v);
+	vertices.add(root);
+	std::reverse(vertices.array(), vertices.array()+vertices.nItems());
+	if (familyApex_[family] != -1) vertices.add(familyApex_[family]);
+	for (v = familySecond_[family]; v != root; v = predecessor_[v]) vertices.add(v);
+}
+
+// Reduce bond incidence vector against the current cycle basis, returning whether anything remains
+bool RingPerception::reduce(unsigned long long* vector, const Array<unsigned long long>& basis, const Array<int>& pivots, int nWords) const
+{
+	// Each basis vector has a unique pivot (its lowest set bit), so eliminating the lowest set bit of the vector in turn only ever affects higher bits
+	int w, x, bit, row;
+	for (w=0; w<nWords; ++w)
+	{
+		while (vector[w] != 0)
+		{
+			bit = 0;
+			while (!(vector[w] & (1ULL << bit))) ++bit;
+			row = pivots.value(w*64+bit);
+			if (row == -1) return true;
+			for (x=w; x<nWords; ++x) vector[x] ^= basis.value(row*nWords+x);
+		}
+	}
+	return false;
+}
+
+// Extend simple path from the root through lower-numbered vertices, storing (once) each cycle it closes within the size given
+void RingPerception::extendCycle(int root, int vertex, int length, int maxRingSize, Array<int>& path, Array<int>& cycles, Array<int>& cycleSizes)
+{
+	path[length-1] = vertex;
+	int e, u, n;
+	for (e=offsets_[vertex]; e<offsets_[vertex+1]; ++e)
+	{
+		u = neighbours_[e];
+
+		// Returning to the root closes a cycle - each is found in both directions, so keep only one
+		if (u == root)
+		{
+			if ((length > 2) && (path[1] < vertex))
+			{
+				for (n=0; n<length; ++n) cycles.add(path[n]);
+				cycleSizes.add(length);
+			}
+			continue;
+		}
+
+		// The next vertex must be lower-numbered than the root, not already in the path, and near enough to the root to close a cycle in time
+		if ((u > root) || (stamp_[u] != currentStamp_) || (length + distance_[u] > maxRingSize)) continue;
+		for (n=1; n<length; ++n) if (path[n] == u) break;
+		if (n < length) continue;
+		extendCycle(root, u, length+1, maxRingSize, path, cycles, cycleSizes);
+	}
+}
+
+// Add ring with the specified vertices to the list (unless it is already present), returning false if the maximum number of rings has been reached
+bool RingPerception::addRing(const int* vertices, int nVertices, int maxRings, Pattern* parent, List<Ring>& rings, bool checkExisting)
+{
+	if (rings.nItems() == maxRings) return false;
+
+	Ring* ring = rings.add();
+	ring->setParent(parent);
+	ring->setRequestedSize(nVertices);
+	for (int n=0; n<nVertices; ++n) ring->addAtom(atoms_[vertices[n]]);
+	ring->finalise();
+
+	// If the list already contained rings, this one may be among them
+	if (checkExisting)
+	{
+		Ring* other;
+		for (other = rings.first(); other != ring; other = other->next) if (*other == *ring) break;
+		if (other != ring)
+		{
+			rings.remove(ring);
+			return true;
+		}
+	}
+	ring->print();
+	return true;
+}
+
+// Find all cycles of up to the size specified (relevant cycles first), adding them to the supplied list (optionally only those containing the given vertex)
+bool RingPerception::findRings(int maxRingSize, int maxRings, Pattern* parent, List<Ring>& rings, int vertex)
+{
+	Messenger::enter("RingPerception::findRings");
+
+	if ((nAtoms_ == 0) || (nBonds_ < 3) || (maxRingSize < 3))
+	{
+		Messenger::exit("RingPerception::findRings");
+		return true;
+	}
+
+	distance_.createEmpty(nAtoms_, 0);
+	predecessor_.createEmpty(nAtoms_, -1);
+	restricted_.createEmpty(nAtoms_, false);
+	stamp_.createEmpty(nAtoms_, -1);
+	marks_.createEmpty(nAtoms_, -1);
+	currentStamp_ = -1;
+	currentMark_ = -1;
+	familyRoots_.forgetData();
+	familyFirst_.forgetData();
+	familySecond_.forgetData();
+	familyApex_.forgetData();
+	familySizes_.forgetData();
+
+	/*
+	 * Generate candidate cycle families. Each cycle is generated only from its highest-numbered vertex (the root), and consists of two
+	 * shortest paths from the root through lower-numbered vertices which meet at a single vertex (even cycles) or at either end of a
+	 * bond (odd cycles).
+	 */
+	int maxDepth = maxRingSize/2, r, k, y, d, e, f, p, q;
+	Array<int> familyVertices, familyOffsets;
+	Array<int> vertices;
+	for (r=0; r<nAtoms_; ++r)
+	{
+		if (offsets_[r+1] - offsets_[r] < 2) continue;
+		search(r, maxDepth);
+		for (k=1; k<reached_.nItems(); ++k)
+		{
+			y = reached_[k];
+			if (!restricted_[y]) continue;
+			d = distance_[y];
+
+			// Even cycles - pairs of restricted neighbours of this vertex which are one step closer to the root
+			if ((d > 1) && (d*2 <= maxRingSize))
+			{
+				for (e=offsets_[y]; e<offsets_[y+1]; ++e)
+				{
+					p = neighbours_[e];
+					if ((stamp_[p] != currentStamp_) || (!restricted_[p]) || (distance_[p] != d-1)) continue;
+					for (f=e+1; f<offsets_[y+1]; ++f)
+					{
+						q = neighbours_[f];
+						if ((stamp_[q] != currentStamp_) || (!restricted_[q]) || (distance_[q] != d-1)) continue;
+						if (!pathsDisjoint(r, p, q)) continue;
+						familyRoots_.add(r);
+						familyFirst_.add(p);
+						familySecond_.add(q);
+						familyApex_.add(y);
+						familySizes_.add(d*2);
+					}
+				}
+			}
+
+			// Odd cycles - restricted neighbours of this vertex at the same distance from the root (considering each bond once)
+			if (d*2+1 > maxRingSize) continue;
+			for (e=offsets_[y]; e<offsets_[y+1]; ++e)
+			{
+				q = neighbours_[e];
+				if ((q >= y) || (stamp_[q] != currentStamp_) || (!restricted_[q]) || (distance_[q] != d)) continue;
+				if (!pathsDisjoint(r, y, q)) continue;
+				familyRoots_.add(r);
+				familyFirst_.add(y);
+				familySecond_.add(q);
+				familyApex_.add(-1);
+				familySizes_.add(d*2+1);
+			}
+		}
+
+		// Store prototype vertices now, while the search from this root is current
+		for (f=familyOffsets.nItems(); f<familyRoots_.nItems(); ++f)
+		{
+			familyOffsets.add(familyVertices.nItems());
+			prototype(f, vertices);
+			for (k=0; k<vertices.nItems(); ++k) familyVertices.add(vertices[k]);
+		}
+	}
+	int nFamilies = familyRoots_.nItems();
+	familyOffsets.add(familyVertices.nItems());
+
+	// Order families by size
+	Array<int> order;
+	order.createEmpty(nFamilies, 0);
+	for (f=0; f<nFamilies; ++f) order[f] = f;
+	std::sort(order.array(), order.array()+nFamilies, [this](int a, int b) { return (familySizes_.value(a) == familySizes_.value(b) ? a < b : familySizes_.value(a) < familySizes_.value(b)); });
+
+	/*
+	 * A family is relevant if its prototype is independent (over GF(2), considering the bonds it contains) of all strictly shorter
+	 * cycles. Test each group of families of the same size against the basis formed from smaller families, then add them to it.
+	 */
+	int nWords = (nBonds_ + 63) / 64, start = 0, end, w, bit, nPending;
+	Array<unsigned long long> basis, pending, incidence;
+	Array<int> pivots, relevant;
+	pivots.createEmpty(nBonds_, -1);
+	incidence.createEmpty(nWords, 0);
+	while (start < nFamilies)
+	{
+		for (end = start+1; end < nFamilies; ++end) if (familySizes_[order[end]] != familySizes_[order[start]]) break;
+
+		pending.forgetData();
+		for (k=start; k<end; ++k)
+		{
+			f = order[k];
+			for (w=0; w<nWords; ++w) incidence[w] = 0;
+			for (e=familyOffsets[f]; e<familyOffsets[f+1]; ++e)
+			{
+				p = familyVertices[e];
+				q = familyVertices[e+1 == familyOffsets[f+1] ? familyOffsets[f] : e+1];
+				bit = bondIndex(p, q);
+				incidence[bit/64] |= (1ULL << (bit%64));
+			}
+			if (!reduce(incidence.array(), basis, pivots, nWords)) continue;
+			relevant.add(f);
+			for (w=0; w<nWords; ++w) pending.add(incidence[w]);
+		}
+
+		// Add independent members of this group to the basis
+		nPending = pending.nItems() / nWords;
+		for (k=0; k<nPending; ++k)
+		{
+			for (w=0; w<nWords; ++w) incidence[w] = pending[k*nWords+w];
+			if (!reduce(incidence.array(), basis, pivots, nWords)) continue;
+			w = 0;
+			while (incidence[w] == 0) ++w;
+			bit = 0;
+			while (!(incidence[w] & (1ULL << bit))) ++bit;
+			pivots[w*64+bit] = basis.nItems() / nWords;
+			for (w=0; w<nWords; ++w) basis.add(incidence[w]);
+		}
+
+		start = end;
+	}
+
+	/*
+	 * Expand each relevant family into its member cycles, formed from all pairs of disjoint shortest paths (through lower-numbered
+	 * vertices) from the root to either end.
+	 */
+	bool checkExisting = (rings.nItems() > 0), maxReached = false, found;
+	int nInitialRings = rings.nItems(), a, b, nFirst, nSecond, lengthFirst, lengthSecond, n;
+	Array<int> path, firstPaths, secondPaths;
+	for (k=0; k<relevant.nItems(); ++k)
+	{
+		f = relevant[k];
+		r = familyRoots_[f];
+		search(r, maxDepth);
+
+		lengthFirst = distance_[familyFirst_[f]] + 1;
+		path.createEmpty(lengthFirst, -1);
+		firstPaths.forgetData();
+		extendPath(r, familyFirst_[f], path, firstPaths);
+		nFirst = firstPaths.nItems() / lengthFirst;
+
+		lengthSecond = distance_[familySecond_[f]] + 1;
+		path.createEmpty(lengthSecond, -1);
+		secondPaths.forgetData();
+		extendPath(r, familySecond_[f], path, secondPaths);
+		nSecond = secondPaths.nItems() / lengthSecond;
+
+		for (a=0; a<nFirst; ++a)
+		{
+			for (b=0; b<nSecond; ++b)
+			{
+				// Paths must share only the root
+				++currentMark_;
+				for (n=1; n<lengthFirst; ++n) marks_[firstPaths[a*lengthFirst+n]] = currentMark_;
+				for (n=1; n<lengthSecond; ++n) if (marks_[secondPaths[b*lengthSecond+n]] == currentMark_) break;
+				if (n < lengthSecond) continue;
+
+				vertices.forgetData();
+				for (n=0; n<lengthFirst; ++n) vertices.add(firstPaths[a*lengthFirst+n]);
+				if (familyApex_[f] != -1) vertices.add(familyApex_[f]);
+				for (n=lengthSecond-1; n>0; --n) vertices.add(secondPaths[b*lengthSecond+n]);
+
+				if (vertex != -1)
+				{
+					found = false;
+					for (n=0; n<vertices.nItems(); ++n) if (vertices[n] == vertex) found = true;
+					if (!found) continue;
+				}
+
+				if (!addRing(vertices.array(), vertices.nItems(), maxRings, parent, rings, checkExisting))
+				{
+					maxReached = true;
+					break;
+				}
+			}
+			if (maxReached) break;
+		}
+		if (maxReached) break;
+	}
+	int nRelevantRings = rings.nItems() - nInitialRings;
+
+	/*
+	 * Relevant cycles alone omit envelope rings (e.g. the 6-ring of norbornane, or the non-relevant 6-rings of cubane), but atom typing
+	 * expects every simple cycle within the size limit. Search for the remaining ones from each root through lower-numbered vertices only,
+	 * so each cycle is found from its highest-numbered vertex, pruning paths which could no longer return to the root in time.
+	 */
+	Array<int> cycles, cycleSizes;
+	path.createEmpty(maxRingSize, -1);
+	for (r=0; (r<nAtoms_) && (!maxReached); ++r)
+	{
+		if (offsets_[r+1] - offsets_[r] < 2) continue;
+		search(r, maxDepth);
+		cycles.forgetData();
+		cycleSizes.forgetData();
+		extendCycle(r, r, 1, maxRingSize, path, cycles, cycleSizes);
+
+		for (k=0, e=0; k<cycleSizes.nItems(); e += cycleSizes[k++])
+		{
+			if (vertex != -1)
+			{
+				for (n=0; n<cycleSizes[k]; ++n) if (cycles[e+n] == vertex) break;
+				if (n == cycleSizes[k]) continue;
+			}
+			if (!addRing(cycles.array()+e, cycleSizes[k], maxRings, parent, rings, true))
+			{
+				maxReached = true;
+				break;
+			}
+		}
+	}
+
+	Messenger::print(Messenger::Verbose, "Ring perception found %i candidate cycle families, of which %i are relevant, giving %i relevant and %i other rings.", nFamilies, relevant.nItems(), nRelevantRings, rings.nItems()-nInitialRings-nRelevantRings);
+
+	Messenger::exit("RingPerception::findRings");
+	return (!maxReached);
+}
@@ -0,0 +1,124 @@
+/*
+	*** Ring perception
+	*** src/base/ringperception.h
+	Copyright T. Youngs 2007-2017
+
+	This file is part of Aten.
+
+	Aten is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Aten is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Aten.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef ATEN_RINGPERCEPTION_H
+#define ATEN_RINGPERCEPTION_H
+
+#include "templates/array.h"
+#include "templates/list.h"
+#include "base/namespace.h"
+
+ATEN_BEGIN_NAMESPACE
+
+// Forward Declarations (Aten)
+class Atom;
+class Pattern;
+class Ring;
+
+// Ring Perception
+// Finds the relevant cycles of a molecule (the union of all its minimum cycle bases) from a compact adjacency of its
+// bonds, following Vismara (Electron. J. Combin. 1997, 4, R9). Candidate cycles are generated from shortest paths
+// through each atom, and are kept only if they are independent of all shorter cycles, so the cost is polynomial in
+// the number of atoms rather than exponential in the number of fused rings. The remaining simple cycles within the
+// size limit (envelope rings such as the 6-ring of norbornane) are then found by a depth-limited search, so that the
+// complete set of rings expected by atom typing is returned.
+class RingPerception
+{
+	public:
+	// Constructor
+	RingPerception();
+
+
+	/*
+	 * Graph
+	 */
+	private:
+	// Number of atoms in the graph
+	int nAtoms_;
+	// Atom corresponding to each vertex
+	Array<Atom*> atoms_;
+	// Index of first edge of each vertex (plus one extra marking the end of the last vertex's edges)
+	Array<int> offsets_;
+	// Vertex at the other end of each (directed) edge
+	Array<int> neighbours_;
+	// Undirected bond index of each (directed) edge
+	Array<int> bondIndices_;
+	// Number of undirected bonds in the graph
+	int nBonds_;
+	// Return undirected bond index between the two vertices specified (or -1 if they are not bound)
+	int bondIndex(int i, int j) const;
+
+	public:
+	// Construct graph from the bonding of the atoms starting at the one supplied
+	void initialise(Atom* firstAtom, int nAtoms);
+
+
+	/*
+	 * Search
+	 */
+	private:
+	// Distance of each vertex from the current root, and its predecessor on one shortest path from the root
+	Array<int> distance_, predecessor_;
+	// Whether each vertex can be reached from the current root along a shortest path through lower-numbered vertices only
+	Array<bool> restricted_;
+	// Index of the search which last reached each vertex
+	Array<int> stamp_;
+	// Index of current search
+	int currentStamp_;
+	// Vertices reached by the current search, in order of increasing distance
+	Array<int> reached_;
+	// Marker array used when checking that paths are disjoint
+	Array<int> marks_;
+	// Index of current marker
+	int currentMark_;
+	// Search outwards from the specified root, up to the maximum distance given
+	void search(int root, int maxDepth);
+	// Return whether the stored shortest paths from the root to the two vertices share only the root
+	bool pathsDisjoint(int root, int i, int j);
+	// Extend path backwards from the specified vertex towards the root, storing all completed paths
+	void extendPath(int root, int vertex, Array<int>& path, Array<int>& paths);
+
+
+	/*
+	 * Cycles
+	 */
+	private:
+	// Root, path ends, and apex (-1 for odd cycles) of each candidate cycle family
+	Array<int> familyRoots_, familyFirst_, familySecond_, familyApex_;
+	// Size of each candidate cycle family
+	Array<int> familySizes_;
+	// Construct prototype cycle of the specified family (after searching from its root), returning the vertices in order
+	void prototype(int family, Array<int>& vertices);
+	// Reduce bond incidence vector against the current cycle basis, returning whether anything remains
+	bool reduce(unsigned long long* vector, const Array<unsigned long long>& basis, const Array<int>& pivots, int nWords) const;
+	// Extend simple path from the root through lower-numbered vertices, storing (once) each cycle it closes within the size given
+	void extendCycle(int root, int vertex, int length, int maxRingSize, Array<int>& path, Array<int>& cycles, Array<int>& cycleSizes);
+	// Add ring with the specified vertices to the list (unless it is already present), returning false if the maximum number of rings has been reached
+	bool addRing(const int* vertices, int nVertices, int maxRings, Pattern* parent, List<Ring>& rings, bool checkExisting);
+
+	public:
+	// Find all cycles of up to the size specified (relevant cycles first), adding them to the supplied list (optionally only those containing the given vertex)
+	bool findRings(int maxRingSize, int maxRings, Pattern* parent, List<Ring>& rings, int vertex = -1);
+};
+
+ATEN_END_NAMESPACE
+
+#endif
@@ -0,0 +1,380 @@
+/*
+	*** Smooth Particle Mesh Ewald data
+	*** src/base/spmedata.cpp
+	Copyright T. Youngs 2007-2017
+
+	This file is part of Aten.
+
+	Aten is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Aten is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Aten.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// Ref: "A smooth particle mesh Ewald method", U. Essmann, L. Perera, M. L. Berkowitz, T. Darden, H. Lee and L. G. Pedersen
+//	J. Chem. Phys. 103, 8577 (1995).
+
+#include "base/spmedata.h"
+#include "base/prefs.h"
+#include "model/model.h"
+
+ATEN_USING_NAMESPACE
+
+// Constructor
+SpmeData::SpmeData()
+{
+	order_ = 0;
+	nAtoms_ = 0;
+}
+
+// Destructor
+SpmeData::~SpmeData()
+{
+}
+
+/*
+ * Mesh
+ */
+
+// Calculate B-spline coefficients (and derivatives) for supplied fractional offset
+void SpmeData::fillBSpline(double w, double* theta, double* dTheta) const
+{
+	// Start with linear (order 2) splines, and build up to the requested order by recursion
+	int j, k;
+	double div;
+	theta[order_-1] = 0.0;
+	theta[1] = w;
+	theta[0] = 1.0 - w;
+	for (k=3; k<order_; ++k)
+	{
+		div = 1.0 / (k-1);
+		theta[k-1] = div * w * theta[k-2];
+		for (j=1; j<k-1; ++j) theta[k-j-1] = div * ((w+j)*theta[k-j-2] + (k-j-w)*theta[k-j-1]);
+		theta[0] = div * (1.0-w) * theta[0];
+	}
+
+	// Derivatives are obtained from the splines of order one less
+	dTheta[0] = -theta[0];
+	for (j=1; j<order_; ++j) dTheta[j] = theta[j-1] - theta[j];
+
+	// One final recursion to get the requested order
+	div = 1.0 / (order_-1);
+	theta[order_-1] = div * w * theta[order_-2];
+	for (j=1; j<order_-1; ++j) theta[order_-j-1] = div * ((w+j)*theta[order_-j-2] + (order_-j-w)*theta[order_-j-1]);
+	theta[0] = div * (1.0-w) * theta[0];
+}
+
+// Calculate squared moduli of B-spline Fourier coefficients for current mesh
+void SpmeData::calculateBSplineModuli()
+{
+	int axis, k, j, nPoints;
+	double* theta = new double[order_];
+	double* dTheta = new double[order_];
+	double sumCos, sumSin, arg, *moduli;
+
+	// Spline values at integer points
+	fillBSpline(0.0, theta, dTheta);
+
+	for (axis=0; axis<3; ++axis)
+	{
+		nPoints = meshSize_[axis];
+		bSplineModuli_[axis].createEmpty(nPoints);
+		moduli = bSplineModuli_[axis].array();
+		for (k=0; k<nPoints; ++k)
+		{
+			sumCos = 0.0;
+			sumSin = 0.0;
+			for (j=0; j<order_; ++j)
+			{
+				arg = TWOPI * k * j / nPoints;
+				sumCos += theta[j] * cos(arg);
+				sumSin += theta[j] * sin(arg);
+			}
+			moduli[k] = sumCos*sumCos + sumSin*sumSin;
+		}
+
+		// Moduli may be zero for odd-order splines - interpolate from neighbouring values when this happens
+		for (k=0; k<nPoints; ++k) if (moduli[k] < 1.0e-7) moduli[k] = 0.5 * (moduli[(k-1+nPoints)%nPoints] + moduli[(k+1)%nPoints]);
+	}
+
+	delete[] theta;
+	delete[] dTheta;
+}
+
+// Perform in-place 1D FFT on the strided data supplied
+void SpmeData::transform(std::complex<double>* data, int n, int stride, bool inverse)
+{
+	// Copy data to contiguous temporary storage, in bit-reversed order
+	int i, j, bit, length, k;
+	std::complex<double>* line = line_.array();
+	for (i=0, j=0; i<n; ++i)
+	{
+		line[j] = data[i*stride];
+		for (bit = n>>1; j&bit; bit >>= 1) j ^= bit;
+		j |= bit;
+	}
+
+	// Iterative radix-2 Cooley-Tukey butterflies
+	double theta;
+	std::complex<double> wLength, w, u, v;
+	for (length=2; length<=n; length <<= 1)
+	{
+		theta = (inverse ? -TWOPI : TWOPI) / length;
+		wLength = std::complex<double>(cos(theta), sin(theta));
+		for (i=0; i<n; i+=length)
+		{
+			w = 1.0;
+			for (k=0; k<length/2; ++k)
+			{
+				u = line[i+k];
+				v = line[i+k+length/2] * w;
+				line[i+k] = u + v;
+				line[i+k+length/2] = u - v;
+				w *= wLength;
+			}
+		}
+	}
+
+	// Copy data back
+	for (i=0; i<n; ++i) data[i*stride] = line[i];
+}
+
+// Perform in-place 3D FFT on the mesh
+void SpmeData::transformMesh(bool inverse)
+{
+	int i, j, k;
+	std::complex<double>* mesh = mesh_.array();
+	const int nx = meshSize_.x, ny = meshSize_.y, nz = meshSize_.z;
+	for (i=0; i<nx; ++i) for (j=0; j<ny; ++j) transform(&mesh[(i*ny+j)*nz], nz, 1, inverse);
+	for (i=0; i<nx; ++i) for (k=0; k<nz; ++k) transform(&mesh[i*ny*nz+k], ny, nz, inverse);
+	for (j=0; j<ny; ++j) for (k=0; k<nz; ++k) transform(&mesh[j*nz+k], nx, ny*nz, inverse);
+}
+
+// Return number of mesh points along each cell axis
+Vec3<int> SpmeData::meshSize() const
+{
+	return meshSize_;
+}
+
+// Return order of B-spline interpolation
+int SpmeData::order() const
+{
+	return order_;
+}
+
+// Prepare mesh for the supplied model, choosing a mesh size able to represent the supplied reciprocal vector extents
+void SpmeData::prepare(Model* sourceModel, Vec3<int> kVec, int order)
+{
+	Messenger::enter("SpmeData::prepare");
+
+	// Mesh must contain all reciprocal vectors up to kVec in each direction, and must be a power of two for the FFT
+	Vec3<int> newMeshSize;
+	int axis;
+	if (order < 3) order = 3;
+	for (axis=0; axis<3; ++axis)
+	{
+		newMeshSize[axis] = 2;
+		while ((newMeshSize[axis] < 2*kVec[axis]+1) || (newMeshSize[axis] < order)) newMeshSize[axis] *= 2;
+	}
+
+	// Recreate mesh and B-spline moduli only if the mesh size or spline order has changed
+	if ((newMeshSize.x != meshSize_.x) || (newMeshSize.y != meshSize_.y) || (newMeshSize.z != meshSize_.z) || (order != order_))
+	{
+		meshSize_ = newMeshSize;
+		order_ = order;
+		mesh_.createEmpty(meshSize_.x*meshSize_.y*meshSize_.z);
+		line_.createEmpty(meshSize_.max());
+		calculateBSplineModuli();
+		Messenger::print(Messenger::Verbose, "Created SPME mesh of %i x %i x %i points, spline order = %i", meshSize_.x, meshSize_.y, meshSize_.z, order_);
+	}
+
+	// Resize atom arrays if necessary
+	if (nAtoms_ != sourceModel->nAtoms())
+	{
+		nAtoms_ = sourceModel->nAtoms();
+		meshOrigin_.createEmpty(nAtoms_);
+	}
+	for (axis=0; axis<3; ++axis)
+	{
+		theta_[axis].createEmpty(nAtoms_*order_);
+		dTheta_[axis].createEmpty(nAtoms_*order_);
+	}
+
+	Messenger::exit("SpmeData::prepare");
+}
+
+/*
+ * Atom Data
+ */
+
+// Calculate mesh positions and B-spline coefficients of all atoms, and spread charges onto the mesh
+void SpmeData::spreadCharges(Model* sourceModel)
+{
+	int i, axis, j, k, l, mx, my, mz;
+	double u, frac, charge, thetaXY;
+	Vec3<double> r;
+	Matrix rcell = sourceModel->cell().reciprocal();
+	Atom** modelAtoms = sourceModel->atomArray();
+	const int ny = meshSize_.y, nz = meshSize_.z;
+
+	// Clear mesh
+	std::complex<double>* mesh = mesh_.array();
+	for (i=0; i<mesh_.nItems(); ++i) mesh[i] = 0.0;
+
+	Vec3<int>* origin = meshOrigin_.array();
+	double* theta[3] = { theta_[0].array(), theta_[1].array(), theta_[2].array() };
+	double* dTheta[3] = { dTheta_[0].array(), dTheta_[1].array(), dTheta_[2].array() };
+	double* tx, *ty, *tz;
+	for (i=0; i<nAtoms_; ++i)
+	{
+		r = modelAtoms[i]->r();
+
+		// Determine scaled fractional coordinates of atom, and the spline coefficients along each axis
+		for (axis=0; axis<3; ++axis)
+		{
+			frac = rcell.columnAsVec3(axis).dp(r);
+			frac -= floor(frac);
+			u = frac * meshSize_[axis];
+			if (u >= meshSize_[axis]) u -= meshSize_[axis];
+			origin[i][axis] = int(u) - order_ + 1;
+			fillBSpline(u - int(u), &theta[axis][i*order_], &dTheta[axis][i*order_]);
+		}
+
+		// Spread charge over mesh points
+		charge = modelAtoms[i]->charge();
+		if (fabs(charge) < 1.0e-8) continue;
+		tx = &theta[0][i*order_];
+		ty = &theta[1][i*order_];
+		tz = &theta[2][i*order_];
+		for (j=0; j<order_; ++j)
+		{
+			mx = origin[i].x + j;
+			if (mx < 0) mx += meshSize_.x;
+			for (k=0; k<order_; ++k)
+			{
+				my = origin[i].y + k;
+				if (my < 0) my += ny;
+				thetaXY = charge * tx[j] * ty[k];
+				for (l=0; l<order_; ++l)
+				{
+					mz = origin[i].z + l;
+					if (mz < 0) mz += nz;
+					mesh[(mx*ny+my)*nz+mz] += thetaXY * tz[l];
+				}
+			}
+		}
+	}
+}
+
+// Calculate reciprocal space energy (and, if an array is supplied, forces) for the supplied model
+double SpmeData::calculate(Model* sourceModel, Vec3<double>* forces)
+{
+	Messenger::enter("SpmeData::calculate");
+
+	if (sourceModel->nAtoms() != nAtoms_)
+	{
+		printf("Internal Error: SpmeData has not been prepared for the supplied config.\n");
+		Messenger::exit("SpmeData::calculate");
+		return 0.0;
+	}
+
+	// Spread atomic charges onto mesh and transform it
+	spreadCharges(sourceModel);
+	transformMesh(false);
+
+	// Multiply transformed mesh by reciprocal space kernel, summing energy as we go
+	// The kernel is B(m) * exp(-pi**2 m**2 / alpha**2) / (pi * V * m**2), where m = m1 a1* + m2 a2* + m3 a3*
+	int i, j, k, mi, mj, mk;
+	double alpha = prefs.ewaldAlpha(), factor, msq, eterm, energy = 0.0;
+	Matrix rcell = sourceModel->cell().reciprocal();
+	Vec3<double> m;
+	std::complex<double>* mesh = mesh_.array();
+	const int nx = meshSize_.x, ny = meshSize_.y, nz = meshSize_.z;
+	double* moduliX = bSplineModuli_[0].array(), *moduliY = bSplineModuli_[1].array(), *moduliZ = bSplineModuli_[2].array();
+	factor = PI * sourceModel->cell().volume();
+	for (i=0; i<nx; ++i)
+	{
+		mi = (i > nx/2 ? i - nx : i);
+		for (j=0; j<ny; ++j)
+		{
+			mj = (j > ny/2 ? j - ny : j);
+			for (k=0; k<nz; ++k)
+			{
+				std::complex<double>& q = mesh[(i*ny+j)*nz+k];
+				if ((i == 0) && (j == 0) && (k == 0))
+				{
+					q = 0.0;
+					continue;
+				}
+				mk = (k > nz/2 ? k - nz : k);
+				m = rcell.columnAsVec3(0) * mi + rcell.columnAsVec3(1) * mj + rcell.columnAsVec3(2) * mk;
+				msq = m.magnitudeSq();
+				eterm = exp(-PI*PI*msq/(alpha*alpha)) / (factor * msq * moduliX[i] * moduliY[j] * moduliZ[k]);
+				energy += eterm * std::norm(q);
+				q *= eterm;
+			}
+		}
+	}
+	energy *= 0.5 * prefs.elecConvert();
+
+	// Calculate forces if requested
+	if (forces != NULL)
+	{
+		// Back-transform to get the convolution of the kernel with the charge mesh
+		transformMesh(true);
+
+		// Force on each atom is its charge multiplied by the gradient of its splines over the convoluted mesh
+		int axis, mx, my, mz;
+		double* theta[3] = { theta_[0].array(), theta_[1].array(), theta_[2].array() };
+		double* dTheta[3] = { dTheta_[0].array(), dTheta_[1].array(), dTheta_[2].array() };
+		double* tx, *ty, *tz, *dtx, *dty, *dtz, charge, conv;
+		Vec3<double> dEdu;
+		Vec3<int>* origin = meshOrigin_.array();
+		Atom** modelAtoms = sourceModel->atomArray();
+		for (int n=0; n<nAtoms_; ++n)
+		{
+			charge = modelAtoms[n]->charge();
+			if (fabs(charge) < 1.0e-8) continue;
+			tx = &theta[0][n*order_];
+			ty = &theta[1][n*order_];
+			tz = &theta[2][n*order_];
+			dtx = &dTheta[0][n*order_];
+			dty = &dTheta[1][n*order_];
+			dtz = &dTheta[2][n*order_];
+			dEdu.zero();
+			for (i=0; i<order_; ++i)
+			{
+				mx = origin[n].x + i;
+				if (mx < 0) mx += nx;
+				for (j=0; j<order_; ++j)
+				{
+					my = origin[n].y + j;
+					if (my < 0) my += ny;
+					for (k=0; k<order_; ++k)
+					{
+						mz = origin[n].z + k;
+						if (mz < 0) mz += nz;
+						conv = mesh[(mx*ny+my)*nz+mz].real();
+						dEdu.x += dtx[i] * ty[j] * tz[k] * conv;
+						dEdu.y += tx[i] * dty[j] * tz[k] * conv;
+						dEdu.z += tx[i] * ty[j] * dtz[k] * conv;
+					}
+				}
+			}
+
+			// Convert from derivatives w.r.t. scaled fractional coordinates to Cartesian forces
+			for (axis=0; axis<3; ++axis) forces[n] -= rcell.columnAsVec3(axis) * (dEdu[axis] * meshSize_[axis] * charge * prefs.elecConvert());
+		}
+	}
+
+	Messenger::exit("SpmeData::calculate");
+	return energy;
+}
@@ -0,0 +1,98 @@
+/*
+	*** Smooth Particle Mesh Ewald data
+	*** src/base/spmedata.h
+	Copyright T. Youngs 2007-2017
+
+	This file is part of Aten.
+
+	Aten is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Aten is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Aten.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef ATEN_SPMEDATA_H
+#define ATEN_SPMEDATA_H
+
+#include "templates/vector3.h"
+#include "templates/array.h"
+#include "base/namespace.h"
+#include <complex>
+
+ATEN_BEGIN_NAMESPACE
+
+// Forward Declarations (Aten)
+class Model;
+
+// Smooth Particle Mesh Ewald Data
+class SpmeData
+{
+	public:
+	// Constructor / Destructor
+	SpmeData();
+	~SpmeData();
+
+
+	/*
+	 * Mesh
+	 */
+	private:
+	// Number of mesh points along each cell axis
+	Vec3<int> meshSize_;
+	// Order of B-spline interpolation
+	int order_;
+	// Charge mesh (and, after transformation, its convolution with the reciprocal space kernel)
+	Array< std::complex<double> > mesh_;
+	// Squared moduli of the B-spline Fourier coefficients along each axis
+	Array<double> bSplineModuli_[3];
+	// Temporary storage for 1D transforms
+	Array< std::complex<double> > line_;
+
+	private:
+	// Calculate B-spline coefficients (and derivatives) for supplied fractional offset
+	void fillBSpline(double w, double* theta, double* dTheta) const;
+	// Calculate squared moduli of B-spline Fourier coefficients for current mesh
+	void calculateBSplineModuli();
+	// Perform in-place 1D FFT on the strided data supplied
+	void transform(std::complex<double>* data, int n, int stride, bool inverse);
+	// Perform in-place 3D FFT on the mesh
+	void transformMesh(bool inverse);
+
+	public:
+	// Return number of mesh points along each cell axis
+	Vec3<int> meshSize() const;
+	// Return order of B-spline interpolation
+	int order() const;
+	// Prepare mesh for the supplied model, choosing a mesh size able to represent the supplied reciprocal vector extents
+	void prepare(Model* sourceModel, Vec3<int> kVec, int order);
+
+
+	/*
+	 * Atom Data
+	 */
+	private:
+	// Number of atoms for which data is stored
+	int nAtoms_;
+	// Index of first mesh point along each axis covered by each atom's splines
+	Array< Vec3<int> > meshOrigin_;
+	// B-spline coefficients and derivatives for each atom (order_ values per atom per axis)
+	Array<double> theta_[3], dTheta_[3];
+	// Calculate mesh positions and B-spline coefficients of all atoms, and spread charges onto the mesh
+	void spreadCharges(Model* sourceModel);
+
+	public:
+	// Calculate reciprocal space energy (and, if an array is supplied, forces) for the supplied model
+	double calculate(Model* sourceModel, Vec3<double>* forces = NULL);
+};
+
+ATEN_END_NAMESPACE
+
+#endif
@@ -0,0 +1,115 @@
+/*
+	*** Thread pool
+	*** src/base/threadpool.cpp
+	Copyright T. Youngs 2007-2017
+
+	This file is part of Aten.
+
+	Aten is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Aten is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Aten.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "base/threadpool.h"
+#include <QThreadPool>
+#include <QThread>
+#include <QRunnable>
+
+ATEN_USING_NAMESPACE
+
+// Worker, which takes task indices from a shared counter until none remain
+class ThreadPoolWorker : public QRunnable
+{
+	public:
+	// Constructor
+	ThreadPoolWorker(QAtomicInt* nextTask, int nTasks, int thread, ThreadPool::TaskFunction* function) : nextTask_(nextTask), nTasks_(nTasks), thread_(thread), function_(function)
+	{
+		setAutoDelete(true);
+	}
+
+	private:
+	// Next task index to run
+	QAtomicInt* nextTask_;
+	// Total number of tasks
+	int nTasks_;
+	// Index of this thread
+	int thread_;
+	// Function to call for each task
+	ThreadPool::TaskFunction* function_;
+
+	public:
+	// Run tasks
+	void run()
+	{
+		int task;
+		while ((task = nextTask_->fetchAndAddOrdered(1)) < nTasks_) (*function_)(task, thread_);
+	}
+};
+
+// Static members
+QThreadPool* ThreadPool::pool_ = NULL;
+QAtomicInt ThreadPool::active_(0);
+
+/*
+ * Threads
+ */
+
+// Return ideal number of threads for this machine
+int ThreadPool::idealThreadCount()
+{
+	int nThreads = QThread::idealThreadCount();
+	return (nThreads < 1 ? 1 : nThreads);
+}
+
+// Return number of threads to use for supplied request (where zero or less means 'all available')
+int ThreadPool::threadCount(int nRequested)
+{
+	return (nRequested < 1 ? idealThreadCount() : nRequested);
+}
+
+/*
+ * Execution
+ */
+
+// Run tasks 0 to nTasks-1 over the specified number of threads, returning when all are complete
+void ThreadPool::run(int nTasks, int nThreads, ThreadPool::TaskFunction function)
+{
+	if (nTasks < 1) return;
+
+	// Run serially if only one thread is requested, if there is only a single task, or if another parallel region is already active
+	if (nThreads > nTasks) nThreads = nTasks;
+	if ((nThreads < 2) || (!active_.testAndSetOrdered(0, 1)))
+	{
+		for (int task = 0; task < nTasks; ++task) function(task, 0);
+		return;
+	}
+
+	// Create the pool if it doesn't already exist, and make sure it is big enough
+	if (pool_ == NULL) pool_ = new QThreadPool;
+	if (pool_->maxThreadCount() < nThreads-1) pool_->setMaxThreadCount(nThreads-1);
+
+	// Start workers for threads 1 to nThreads-1 - the calling thread acts as thread 0
+	QAtomicInt nextTask(0);
+	for (int thread = 1; thread < nThreads; ++thread) pool_->start(new ThreadPoolWorker(&nextTask, nTasks, thread, &function));
+	ThreadPoolWorker mainWorker(&nextTask, nTasks, 0, &function);
+	mainWorker.setAutoDelete(false);
+	mainWorker.run();
+	pool_->waitForDone();
+
+	active_.storeRelease(0);
+}
+
+// Return whether a parallel region is currently active
+bool ThreadPool::isActive()
+{
+	return (active_.loadAcquire() == 1);
+}
@@ -0,0 +1,68 @@
+/*
+	*** Thread pool
+	*** src/base/threadpool.h
+	Copyright T. Youngs 2007-2017
+
+	This file is part of Aten.
+
+	Aten is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Aten is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Aten.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef ATEN_THREADPOOL_H
+#define ATEN_THREADPOOL_H
+
+#include "base/namespace.h"
+#include <functional>
+
+#include <QAtomicInt>
+
+// Forward Declarations (Qt)
+class QThreadPool;
+
+ATEN_BEGIN_NAMESPACE
+
+// Thread Pool
+class ThreadPool
+{
+	/*
+	 * Threads
+	 */
+	private:
+	// Pool of worker threads
+	static QThreadPool* pool_;
+	// Flag indicating whether a parallel region is currently active
+	static QAtomicInt active_;
+
+	public:
+	// Return ideal number of threads for this machine
+	static int idealThreadCount();
+	// Return number of threads to use for supplied request (where zero or less means 'all available')
+	static int threadCount(int nRequested);
+
+
+	/*
+	 * Execution
+	 */
+	public:
+	// Task function, taking the task index and the index of the thread running it (0 to nThreads-1)
+	typedef std::function<void(int task, int thread)> TaskFunction;
+	// Run tasks 0 to nTasks-1 over the specified number of threads, returning when all are complete
+	static void run(int nTasks, int nThreads, TaskFunction function);
+	// Return whether a parallel region is currently active
+	static bool isActive();
+};
+
+ATEN_END_NAMESPACE
+
+#endif
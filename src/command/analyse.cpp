@@ -22,6 +22,7 @@
 #include "command/commands.h"
 #include "parser/commandnode.h"
 #include "base/messenger.h"
+#include "base/prefs.h"
 #include "methods/rdf.h"
 #include "methods/pdens.h"
 #include "methods/geometry.h"
@@ -81,7 +82,7 @@ bool Commands::function_ModelAnalyse(CommandNode* c, Bundle& obj, ReturnValue& r
 	return true;
 }
 
-// Request calculation of a 3Ddens ('analyse pdens <name> <grid> <nsteps> <filename> <site1> <site2>')
+// Request calculation of a 3Ddens ('analyse pdens <name> <grid> <nsteps> <filename> <site1> <site2> [binary]')
 bool Commands::function_PDens(CommandNode* c, Bundle& obj, ReturnValue& rv)
 {
 	if (obj.notifyNull(Bundle::ModelPointer)) return false;
@@ -96,6 +97,7 @@ bool Commands::function_PDens(CommandNode* c, Bundle& obj, ReturnValue& rv)
 	newPDens->setSite(0, obj.m->findSite(c->argc(4)));
 	newPDens->setSite(1, obj.m->findSite(c->argc(5)));
 	newPDens->setRange(c->argd(1), c->argi(2));
+	if (c->hasArg(6)) newPDens->setBinary(c->argb(6));
 
 	rv.reset();
 	return (newPDens->initialise());
@@ -107,7 +109,7 @@ bool Commands::function_PrintJobs(CommandNode* c, Bundle& obj, ReturnValue& rv)
 	return false;
 }
 
-// Request calculation of an RDF ('rdf <name> <rmin> <binwidth> <nbins> <filename> <site1> <site2>')
+// Request calculation of an RDF ('rdf <name> <rmin> <binwidth> <nbins> <filename> <site1> <site2> [partials]')
 bool Commands::function_RDF(CommandNode* c, Bundle& obj, ReturnValue& rv)
 {
 	if (obj.notifyNull(Bundle::ModelPointer)) return false;
@@ -123,6 +125,14 @@ bool Commands::function_RDF(CommandNode* c, Bundle& obj, ReturnValue& rv)
 	newRdf->setSite(1, obj.m->findSite(c->argc(6)));
 	newRdf->setRange(c->argd(1), c->argd(2), c->argi(3));
 
+	// Partial RDFs (by element or type)
+	if (c->hasArg(7))
+	{
+		Rdf::PartialType pt = Rdf::partialType(c->argc(7), true);
+		if (pt == Rdf::nPartialTypes) return false;
+		newRdf->setPartialType(pt);
+	}
+
 	rv.reset();
 	return (newRdf->initialise());
 }
@@ -141,9 +151,7 @@ bool Commands::function_TrajAnalyse(CommandNode* c, Bundle& obj, ReturnValue& rv
 {
 	if (obj.notifyNull(Bundle::ModelPointer)) return false;
 	int n, startframe, totalframes, frameskip, framestodo, framesdone;
-	bool calculate;
-	Model* frame;
-	Calculable* calc;
+	Array<int> frames;
 	// Check that the model has a trajectory associated to it
 	totalframes = obj.m->nTrajectoryFrames();
 	if (totalframes == 0)
@@ -158,32 +166,21 @@ bool Commands::function_TrajAnalyse(CommandNode* c, Bundle& obj, ReturnValue& rv
 	frameskip = c->argi(1);
 	framestodo = (c->hasArg(2) ? c->argi(2) : -1);
 
-	// Rewind trajectory to first frame and begin
-	obj.m->seekFirstTrajectoryFrame();
-	framesdone = 0;
+	// Work out which frames to calculate quantities from
 	for (n=1; n <= totalframes; n++)
 	{
-		// Work out whether to calculate quantities from this frame
-		calculate = true;
-		if (n < startframe) calculate = false;
-		else if ((n-startframe)%frameskip != 0) calculate = false;
-		// Calculate quantities
-		if (calculate)
-		{
-			frame = obj.m->trajectoryCurrentFrame();
-			for (calc = obj.m->pendingQuantities.first(); calc != NULL; calc = calc->next) calc->accumulate(frame);
-			framesdone ++;
-		}
-
-		// Check for required number of frames completed
-		if (framesdone == framestodo) break;
-
-		// Move to next frame
-		if (n != totalframes) obj.m->seekNextTrajectoryFrame();
+		if (n < startframe) continue;
+		else if ((n-startframe)%frameskip != 0) continue;
+		frames.add(n-1);
+
+		// Check for required number of frames
+		if (frames.nItems() == framestodo) break;
 	}
+
+	// Calculate quantities - frames are read and analysed in parallel where possible
+	framesdone = obj.m->analyseTrajectory(frames, prefs.nThreadsToUse());
 	Messenger::print("Finished calculating properties - used %i frames from trajectory.", framesdone);
 
 	rv.reset();
 	return true;
 }
-
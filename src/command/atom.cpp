@@ -261,7 +261,9 @@ bool Commands::function_SetRX(CommandNode* c, Bundle& obj, ReturnValue& rv)
 	if (obj.notifyNull(Bundle::ModelPointer)) return false;
 	if (c->hasArg(1)) obj.i = c->argType(1) == VTypes::AtomData ? (Atom*) c->argp(1,VTypes::AtomData) : obj.rs()->atom(c->argi(1)-1);
 	if (obj.notifyNull(Bundle::AtomPointer)) return false;
-	obj.i->r().set(0,c->argd(0));
+	Vec3<double> newr = obj.i->r();
+	newr.set(0,c->argd(0));
+	obj.rs()->positionAtom(obj.i, newr);
 	rv.reset();
 	return true;
 }
@@ -272,7 +274,9 @@ bool Commands::function_SetRY(CommandNode* c, Bundle& obj, ReturnValue& rv)
 	if (obj.notifyNull(Bundle::ModelPointer)) return false;
 	if (c->hasArg(1)) obj.i = c->argType(1) == VTypes::AtomData ? (Atom*) c->argp(1,VTypes::AtomData) : obj.rs()->atom(c->argi(1)-1);
 	if (obj.notifyNull(Bundle::AtomPointer)) return false;
-	obj.i->r().set(1,c->argd(0));
+	Vec3<double> newr = obj.i->r();
+	newr.set(1,c->argd(0));
+	obj.rs()->positionAtom(obj.i, newr);
 	rv.reset();
 	return true;
 }
@@ -283,7 +287,9 @@ bool Commands::function_SetRZ(CommandNode* c, Bundle& obj, ReturnValue& rv)
 	if (obj.notifyNull(Bundle::ModelPointer)) return false;
 	if (c->hasArg(1)) obj.i = c->argType(1) == VTypes::AtomData ? (Atom*) c->argp(1,VTypes::AtomData) : obj.rs()->atom(c->argi(1)-1);
 	if (obj.notifyNull(Bundle::AtomPointer)) return false;
-	obj.i->r().set(2,c->argd(0));
+	Vec3<double> newr = obj.i->r();
+	newr.set(2,c->argd(0));
+	obj.rs()->positionAtom(obj.i, newr);
 	rv.reset();
 	return true;
 }
@@ -139,14 +139,14 @@ CommandData Commands::data_[Commands::nCommands] = {
 	{ "modelAnalyse",	"",		VTypes::NoData,
 		"",
 		"Analyse quantities for the current model" },
-	{ "pdens",		"CNNCNN",	VTypes::NoData,
-		"string name, double griddelta, int nstep, string filename, int site1, int site2",
+	{ "pdens",		"CNNCNNb",	VTypes::NoData,
+		"string name, double griddelta, int nstep, string filename, int site1, int site2, bool binary = true",
 		"Request calculation of a probability density between sites" },
 	{ "listJobs",		"",		VTypes::NoData,
 		"",
 		"Print the current list of quantities to calculate" },
-	{ "rdf",		"CNNNCNN",	VTypes::NoData,
-		"string name, double rmin, double binwidth, int nbins, string filename, int site, int site2",
+	{ "rdf",		"CNNNCNNc",	VTypes::NoData,
+		"string name, double rmin, double binwidth, int nbins, string filename, int site, int site2, string partials = none|element|type",
 		"Request calculation of radial distribution function between sites" },
 	{ "saveQuantities",	"",		VTypes::NoData,
 		"",
@@ -464,7 +464,7 @@ CommandData Commands::data_[Commands::nCommands] = {
 
 	// Energy commands
 	{ "elec",		"Cnnnn",	VTypes::NoData,
-		"string type = none|coulomb|ewald|ewaldauto. [ double precision, | double alpha, int kx, int ky, int kz ]",
+		"string type = none|coulomb|ewald|ewaldauto|spme. [ double precision, | double alpha, int kx, int ky, int kz ]",
 		"Set the style of electrostatic energy calculation" },
 	{ "frameEnergy",	"",		VTypes::DoubleData,
 		"",
@@ -746,6 +746,9 @@ CommandData Commands::data_[Commands::nCommands] = {
 	{ "gridSecondary",	"B",		VTypes::IntegerData,
 		"bool on",
 		"Set whether to draw the surface defined by the secondary cutoffs" },
+	{ "gridStorage",	"c",		VTypes::StringData,
+		"string type",
+		"Set (or return) the storage type ('double' or 'float') of the current grid's 3D data" },
 	{ "gridStyle",		"C",		VTypes::NoData,
 		"string style",
 		"Set the drawing style of the primary surface of the current grid" },
@@ -1244,6 +1247,9 @@ CommandData Commands::data_[Commands::nCommands] = {
 	{ "prevFrame",		"",		VTypes::NoData,
 		"",
 		"Go to the previous frame in the current trajectory" },
+	{ "saveTrajectory",	"CC",		VTypes::IntegerData,
+		"string format, string filename",
+		"Save all frames of the current trajectory in the specified trajectory format" },
 	{ "seekFrame",		"N",		VTypes::NoData,
 		"int frameno",
 		"Jump to the specified frame in the current trajectory" },
@@ -335,6 +335,7 @@ class Commands
 		GridOutline,
 		GridPeriodic,
 		GridSecondary,
+		GridStorage,
 		GridStyle,
 		GridStyleSecondary,
 		GridUseZ,
@@ -526,6 +527,7 @@ class Commands
 		LoadTrajectory,
 		NextFrame,
 		PrevFrame,
+		SaveTrajectory,
 		SeekFrame,
 
 		// Transformation Commands
@@ -793,6 +795,7 @@ class Commands
 	bool function_GridPeriodic(CommandNode* c, Bundle& obj, ReturnValue& rv);
 	bool function_GridSecondary(CommandNode* c, Bundle& obj, ReturnValue& rv);
 	bool function_GridStyle(CommandNode* c, Bundle& obj, ReturnValue& rv);
+	bool function_GridStorage(CommandNode* c, Bundle& obj, ReturnValue& rv);
 	bool function_GridStyleSecondary(CommandNode* c, Bundle& obj, ReturnValue& rv);
 	bool function_GridUseZ(CommandNode* c, Bundle& obj, ReturnValue& rv);
 	bool function_GridViewPercentage(CommandNode* c, Bundle& obj, ReturnValue& rv);
@@ -966,6 +969,7 @@ class Commands
 	bool function_LoadTrajectory(CommandNode* c, Bundle& obj, ReturnValue& rv);
 	bool function_NextFrame(CommandNode* c, Bundle& obj, ReturnValue& rv);
 	bool function_PrevFrame(CommandNode* c, Bundle& obj, ReturnValue& rv);
+	bool function_SaveTrajectory(CommandNode* c, Bundle& obj, ReturnValue& rv);
 	bool function_SeekFrame(CommandNode* c, Bundle& obj, ReturnValue& rv);
 	// Transform Commands
 	bool function_AxisRotate(CommandNode* c, Bundle& obj, ReturnValue& rv);
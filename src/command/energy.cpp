@@ -27,7 +27,7 @@
 
 ATEN_USING_NAMESPACE
 
-// Set electrostatic method to use ('elec none|coulomb|ewald|ewaldauto')
+// Set electrostatic method to use ('elec none|coulomb|ewald|ewaldauto|spme')
 bool Commands::function_Electrostatics(CommandNode* c, Bundle& obj, ReturnValue& rv)
 {
 	rv.reset();
@@ -54,6 +54,10 @@ bool Commands::function_Electrostatics(CommandNode* c, Bundle& obj, ReturnValue&
 			}
 			prefs.ewaldPrecision().set(c->argd(1));
 			break;
+		// Set (optional) precision for smooth particle mesh Ewald
+		case (Electrostatics::Spme):
+			if (c->hasArg(1)) prefs.ewaldPrecision().set(c->argd(1));
+			break;
 		default:
 			break;
 	}
@@ -295,6 +295,7 @@ void Commands::initPointers()
 	pointers_[GridPeriodic] = &AtenSpace::Commands::function_GridPeriodic;
 	pointers_[InitialiseGrid] = &AtenSpace::Commands::function_InitialiseGrid;
 	pointers_[GridSecondary] = &AtenSpace::Commands::function_GridSecondary;
+	pointers_[GridStorage] = &AtenSpace::Commands::function_GridStorage;
 	pointers_[GridStyle] = &AtenSpace::Commands::function_GridStyle;
 	pointers_[GridStyleSecondary] = &AtenSpace::Commands::function_GridStyle;
 	pointers_[GridUseZ] = &AtenSpace::Commands::function_GridUseZ;
@@ -485,6 +486,7 @@ void Commands::initPointers()
 	pointers_[LoadTrajectory] = &AtenSpace::Commands::function_LoadTrajectory;
 	pointers_[NextFrame] = &AtenSpace::Commands::function_NextFrame;
 	pointers_[PrevFrame] = &AtenSpace::Commands::function_PrevFrame;
+	pointers_[SaveTrajectory] = &AtenSpace::Commands::function_SaveTrajectory;
 	pointers_[SeekFrame] = &AtenSpace::Commands::function_SeekFrame;
 
 	// Transform Commands
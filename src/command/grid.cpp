@@ -248,6 +248,20 @@ bool Commands::function_GridSecondary(CommandNode* c, Bundle& obj, ReturnValue&
 	return true;
 }
 
+// Set (or return) storage type of 3D data
+bool Commands::function_GridStorage(CommandNode* c, Bundle& obj, ReturnValue& rv)
+{
+	if (obj.notifyNull(Bundle::GridPointer)) return false;
+	if (c->hasArg(0))
+	{
+		Grid::StorageType st = Grid::storageType(c->argc(0), true);
+		if (st == Grid::nStorageTypes) return false;
+		obj.g->setStorageType(st);
+	}
+	rv.set(Grid::storageType(obj.g->storageType()));
+	return true;
+}
+
 // Set drawing style of primary surface
 bool Commands::function_GridStyle(CommandNode* c, Bundle& obj, ReturnValue& rv)
 {
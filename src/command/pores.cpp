@@ -100,6 +100,7 @@ bool Commands::function_CreateScheme(CommandNode* c, Bundle& obj, ReturnValue& r
 			}
 		}
 	}
+	schemeGrid.logDataChange();
 
 	// The Grid data now contains 1.0 in each position which is free from any atoms
 	// Partition this data up by finding an element which is -1.0 and selecting its encompassing region
@@ -120,6 +120,43 @@ bool Commands::function_PrevFrame(CommandNode* c, Bundle& obj, ReturnValue& rv)
 	return true;
 }
 
+// Save current trajectory in specified format ('savetrajectory <format> <filename>')
+bool Commands::function_SaveTrajectory(CommandNode* c, Bundle& obj, ReturnValue& rv)
+{
+	if (obj.notifyNull(Bundle::ModelPointer)) return false;
+	if (obj.m->nTrajectoryFrames() == 0)
+	{
+		Messenger::print("No trajectory associated to model '%s'.", qPrintable(obj.m->name()));
+		return false;
+	}
+
+	// Parse the first option so we can get the plugin nickname and any plugin options
+	LineParser parser;
+	parser.getArgsDelim(Parser::UseQuotes, c->argc(0));
+
+	// First part of argument zero is nickname (followed by options)
+	const FilePluginInterface* plugin = aten_.pluginStore().findFilePluginByNickname(PluginTypes::TrajectoryFilePlugin, PluginTypes::ExportPlugin, parser.argc(0));
+
+	// Check that a suitable plugin was found
+	if (plugin == NULL)
+	{
+		// Print list of valid plugin nicknames
+		aten_.pluginStore().showFilePluginNicknames(PluginTypes::TrajectoryFilePlugin, PluginTypes::ExportPlugin);
+		Messenger::print("Not saved.");
+		return false;
+	}
+
+	// Loop over remaining arguments which are option assignments
+	KVMap pluginOptions;
+	for (int n = 1; n < parser.nArgs(); ++n) pluginOptions.add(parser.argc(n));
+
+	bool result = aten_.exportTrajectory(obj.m, c->argc(1), plugin, pluginOptions);
+
+	rv.set(result);
+
+	return true;
+}
+
 // Seek to specified frame ('seekframe <n>')
 bool Commands::function_SeekFrame(CommandNode* c, Bundle& obj, ReturnValue& rv)
 {
@@ -26,18 +26,20 @@
 ATEN_USING_NAMESPACE
 
 // Calculate angle energy of pattern (or individual molecule if 'molecule' != -1)
-void Pattern::angleEnergy(Model* srcmodel, EnergyStore* estore, int molecule)
+void Pattern::angleEnergy(Model* srcmodel, EnergyStore* estore, int molecule, int firstMolecule, int lastMolecule)
 {
 	Messenger::enter("Pattern::angleEnergy");
-	static int i,j,k,aoff,m1;
-	static double forcek, n, s, eq, rij, theta, energy, c0, c1, c2;
-	static double coseq, delta;
-	static ForcefieldBound* ffb;
-	static PatternBound* pb;
-	static Vec3<double> vecij, veckj;
+	int i,j,k,aoff,m1;
+	double forcek, n, s, eq, rij, theta, energy, c0, c1, c2;
+	double coseq, delta;
+	ForcefieldBound* ffb;
+	PatternBound* pb;
+	Vec3<double> vecij, veckj;
 	energy = 0.0;
-	aoff = (molecule == -1 ? startAtom_ : startAtom_ + molecule*nAtoms_);
-	for (m1=(molecule == -1 ? 0 : molecule); m1<(molecule == -1 ? nMolecules_ : molecule+1); m1++)
+	if (molecule != -1) firstMolecule = lastMolecule = molecule;
+	else if (lastMolecule == -1) lastMolecule = nMolecules_-1;
+	aoff = startAtom_ + firstMolecule*nAtoms_;
+	for (m1=firstMolecule; m1<=lastMolecule; m1++)
 	{
 		for (pb = angles_.first(); pb != NULL; pb = pb->next)
 		{
@@ -106,7 +108,7 @@ void Pattern::angleEnergy(Model* srcmodel, EnergyStore* estore, int molecule)
 }
 
 // Calculate angle forces in pattern
-void Pattern::angleForces(Model* srcmodel)
+void Pattern::angleForces(Model* srcmodel, Vec3<double>* forces, int firstMolecule, int lastMolecule)
 {
 	Messenger::enter("Pattern::angleForcess");
 	int i,j,k,aoff,m1;
@@ -117,8 +119,9 @@ void Pattern::angleForces(Model* srcmodel)
 	PatternBound* pb;
 	Atom** modelatoms = srcmodel->atomArray();
 	UnitCell& cell = srcmodel->cell();
-	aoff = startAtom_;
-	for (m1=0; m1<nMolecules_; m1++)
+	if (lastMolecule == -1) lastMolecule = nMolecules_-1;
+	aoff = startAtom_ + firstMolecule*nAtoms_;
+	for (m1=firstMolecule; m1<=lastMolecule; m1++)
 	{
 		for (pb = angles_.first(); pb != NULL; pb = pb->next)
 		{
@@ -204,9 +207,9 @@ void Pattern::angleForces(Model* srcmodel)
 			}
 
 			// Add contributions into force arrays
-			modelatoms[i]->f() += fi;
-			modelatoms[j]->f() -= fj;
-			modelatoms[k]->f() += fk;
+			forces[i] += fi;
+			forces[j] -= fj;
+			forces[k] += fk;
 		}
 		aoff += nAtoms_;
 	}
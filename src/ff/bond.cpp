@@ -26,7 +26,7 @@
 ATEN_USING_NAMESPACE
 
 // Calculate bond energy of pattern (or molecule in pattern)
-void Pattern::bondEnergy(Model* srcmodel, EnergyStore* estore, int molecule)
+void Pattern::bondEnergy(Model* srcmodel, EnergyStore* estore, int molecule, int firstMolecule, int lastMolecule)
 {
 	Messenger::enter("Pattern::bondEnergy");
 	int i, j, m1, aoff;
@@ -36,11 +36,13 @@ void Pattern::bondEnergy(Model* srcmodel, EnergyStore* estore, int molecule)
 	Atom** modelatoms = srcmodel->atomArray();
 	UnitCell& cell = srcmodel->cell();
 	energy = 0.0;
-	aoff = (molecule == -1 ? startAtom_ : startAtom_ + molecule*nAtoms_);
+	if (molecule != -1) firstMolecule = lastMolecule = molecule;
+	else if (lastMolecule == -1) lastMolecule = nMolecules_-1;
+	aoff = startAtom_ + firstMolecule*nAtoms_;
 	//printf("BOND NRG: NAME=%s, START %i, NMOLS %i, NATOMS %i, NBONDS %3i\n",name,startAtom_,nMolecules_,nAtoms_,nbonds);
 	bondenergy = 0.0;
 	ubenergy = 0.0;
-	for (m1=(molecule == -1 ? 0 : molecule); m1<(molecule == -1 ? nMolecules_ : molecule+1); m1++)
+	for (m1=firstMolecule; m1<=lastMolecule; m1++)
 	{
 		for (pb = bonds_.first(); pb != NULL; pb = pb->next)
 		{
@@ -96,18 +98,19 @@ void Pattern::bondEnergy(Model* srcmodel, EnergyStore* estore, int molecule)
 }
 
 // Calculate bond forces in pattern
-void Pattern::bondForces(Model* srcmodel)
+void Pattern::bondForces(Model* srcmodel, Vec3<double>* forces, int firstMolecule, int lastMolecule)
 {
 	Messenger::enter("Pattern::bondForcess");
 	int i, j, m1, aoff;
-	static Vec3<double> vec_ij, fi;
-	static double forcek, eq, rij, d, expo, du_dr, beta;
-	static ForcefieldBound* ffb;;
+	Vec3<double> vec_ij, fi;
+	double forcek, eq, rij, d, expo, du_dr, beta;
+	ForcefieldBound* ffb;
 	PatternBound* pb;
 	Atom** modelatoms = srcmodel->atomArray();
 	UnitCell& cell = srcmodel->cell();
-	aoff = startAtom_;
-	for (m1=0; m1<nMolecules_; m1++)
+	if (lastMolecule == -1) lastMolecule = nMolecules_-1;
+	aoff = startAtom_ + firstMolecule*nAtoms_;
+	for (m1=firstMolecule; m1<=lastMolecule; m1++)
 	{
 		for (pb = bonds_.first(); pb != NULL; pb = pb->next)
 		{
@@ -146,13 +149,14 @@ void Pattern::bondForces(Model* srcmodel)
 					du_dr = 2.0 * beta * d * (1.0 - expo) * expo;
 					break;
 				default:
-					Messenger::print("No equation coded for bond forces of type '%s'.", BondFunctions::functionData[pb->data()->bondForm()].name);;
+					Messenger::print("No equation coded for bond forces of type '%s'.", BondFunctions::functionData[pb->data()->bondForm()].name);
+					du_dr = 0.0;
 					break;
 			}
 			// Calculate forces
 			fi = (vec_ij / rij) * -du_dr;
-			modelatoms[i]->f() -= fi;
-			modelatoms[j]->f() += fi;
+			forces[i] -= fi;
+			forces[j] += fi;
 		}
 		aoff += nAtoms_;
 	}
@@ -23,47 +23,51 @@
 #include "base/pattern.h"
 #include "model/model.h"
 #include "base/prefs.h"
+#include "ff/neighbourlist.h"
 
 ATEN_USING_NAMESPACE
 
 // Calculate the internal coulomb energy of the pattern.
 // Consider only the intrapattern interactions of individual molecules  within this pattern.
-void Pattern::coulombIntraPatternEnergy(Model* srcmodel, EnergyStore* estore, int lonemolecule)
+void Pattern::coulombIntraPatternEnergy(Model* srcmodel, EnergyStore* estore, int lonemolecule, int firstMolecule, int lastMolecule)
 {
 	Messenger::enter("Pattern::coulombIntraPatternEnergy");
-	static int i,j,aoff,m1,start1, finish1, con;;
-	static Vec3<double> vec_ij;
-	static double rij, energy_inter, energy_intra, energy, cutoff;
-	PatternAtom* pai, *paj;
+	int i, j, n, aoff, m1, start1, finish1, con;
+	Vec3<double> vec_ij;
+	double rij, energy_inter, energy_intra, energy, cutoff;
+	Array<int> candidates;
+	candidates.setChunkIncrement(SMALLCHUNKSIZE);
 	cutoff = prefs.elecCutoff();
-	Atom** modelatoms = srcmodel->atomArray();
+	AtomStore& store = srcmodel->atomStore();
+	double* x = store.x(), *y = store.y(), *z = store.z(), *q = store.charges();
 	UnitCell& cell = srcmodel->cell();
+	NeighbourList& neighbourList = srcmodel->neighbourList();
 	energy_inter = 0.0;
 	energy_intra = 0.0;
 
-	start1 = (lonemolecule == -1 ? 0 : lonemolecule);
-	finish1 = (lonemolecule == -1 ? nMolecules_ : lonemolecule+1);
+	start1 = (lonemolecule == -1 ? firstMolecule : lonemolecule);
+	finish1 = (lonemolecule == -1 ? (lastMolecule == -1 ? nMolecules_ : lastMolecule+1) : lonemolecule+1);
 	aoff = startAtom_ + start1*nAtoms_;
 	for (m1=start1; m1<finish1; m1++)
 	{
 		// Calculate energies of atom pairs that are unbound or separated by more than two bonds
 		// I.E. bound interactions up to and including angles are excluded. Torsions are scaled by the scale matrix.
-		i = -1;
-		for (pai = atoms_.first(); pai != atoms_.last(); pai = pai->next)
+		for (i=0; i<nAtoms_-1; ++i)
 		{
-			i++;
-			j = i;
-			for (paj = pai->next; paj != NULL; paj = paj->next)
+			// Only consider neighbours of i which lie later in the same molecule
+			candidates.clear();
+			neighbourList.neighbours(i+aoff, i+aoff+1, aoff+nAtoms_-1, candidates);
+			for (n=0; n<candidates.nItems(); ++n)
 			{
-				j++;
-				con = conMatrix_[i][j];
+				j = candidates[n] - aoff;
+				con = exclusions_.connectivity(i, j);
 				if ((con > 2) || (con == 0))
 				{
-					vec_ij = cell.mimVector(modelatoms[i+aoff]->r(), modelatoms[j+aoff]->r());
+					vec_ij = cell.mimVector(Vec3<double>(x[i+aoff], y[i+aoff], z[i+aoff]), Vec3<double>(x[j+aoff], y[j+aoff], z[j+aoff]));
 					rij = vec_ij.magnitude();
 					if (rij > cutoff) continue;
-					energy  = (modelatoms[i+aoff]->charge() * modelatoms[j+aoff]->charge()) / rij;
-					con == 0 ? energy_inter += energy : energy_intra += (con == 3 ? energy * elecScaleMatrix_[i][j] : energy);
+					energy  = (q[i+aoff] * q[j+aoff]) / rij;
+					con == 0 ? energy_inter += energy : energy_intra += (con == 3 ? energy * exclusions_.elecScale(i, j) : energy);
 				}
 			}
 		}
@@ -78,24 +82,29 @@ void Pattern::coulombIntraPatternEnergy(Model* srcmodel, EnergyStore* estore, in
 }
 
 // Calculate the coulomb contribution to the energy from interactions between different molecules of this pattern and the one supplied
-void Pattern::coulombInterPatternEnergy(Model* srcmodel, Pattern* otherPattern, EnergyStore* estore, int molId)
+void Pattern::coulombInterPatternEnergy(Model* srcmodel, Pattern* otherPattern, EnergyStore* estore, int molId, int firstMolecule, int lastMolecule)
 {
 	Messenger::enter("Pattern::coulombInterPatternEnergy");
-	static int i,j,aoff1,aoff2,m1,m2,finish1,start1,start2,finish2;
-	static Vec3<double> vec_ij;
-	static double rij, energy_inter, energy, cutoff;
-	PatternAtom* pai, *paj;
+	int i, j, n, aoff1, m1, m2, finish1, start1;
+	Vec3<double> vec_ij;
+	double rij, energy_inter, energy, cutoff;
+	Array<int> candidates;
+	candidates.setChunkIncrement(SMALLCHUNKSIZE);
 	cutoff = prefs.elecCutoff();
-	Atom** modelatoms = srcmodel->atomArray();
+	AtomStore& store = srcmodel->atomStore();
+	double* x = store.x(), *y = store.y(), *z = store.z(), *q = store.charges();
 	UnitCell& cell = srcmodel->cell();
+	NeighbourList& neighbourList = srcmodel->neighbourList();
+	int otherStart = otherPattern->startAtom_, otherEnd = otherPattern->startAtom_ + otherPattern->totalAtoms_ - 1;
 	energy_inter = 0.0;
 
 	// Outer loop over molecules in *this* pattern
 	// When we are considering the same node with itself, calculate for "m1=1,T-1 m2=2,T"
 	if (molId == -1)
 	{
-		start1 = 0;
-		finish1 = (this == otherPattern ? nMolecules_ - 1 : nMolecules_);
+		start1 = firstMolecule;
+		finish1 = (lastMolecule == -1 ? nMolecules_ : lastMolecule+1);
+		if ((this == otherPattern) && (finish1 == nMolecules_)) finish1 = nMolecules_ - 1;
 	}
 	else
 	{
@@ -105,52 +114,28 @@ void Pattern::coulombInterPatternEnergy(Model* srcmodel, Pattern* otherPattern,
 	aoff1 = startAtom_ + start1 * nAtoms_;
 	for (m1=start1; m1<finish1; m1++)
 	{
-		// Inner loop - over *all* molecules in 'otherPattern'
-		if (this == otherPattern)
+		for (i=0; i<nAtoms_; ++i)
 		{
-			// Same pattern - if a specific molecule was given then we loop over all molecules.
-			// If not, loop over m1+1 to nMolecules_.
-			if (molId == -1)
+			candidates.clear();
+			neighbourList.neighbours(i+aoff1, otherStart, otherEnd, candidates);
+			for (n=0; n<candidates.nItems(); ++n)
 			{
-				start2 = m1 + 1;
-				finish2 = nMolecules_;
-			}
-			else
-			{
-				start2 = 0;
-				finish2 = nMolecules_;
-			}
-		}
-		else
-		{
-			// Simple - go over all molecules in the dissimilar pattern
-			start2 = 0;
-			finish2 = otherPattern->nMolecules_;
-		}
-
-		//if (m1 == 0) printf("IPE - finish1 = %i, start2 = %i, finish2 = %i\n",finish1,start2,finish2);
-		aoff2 = otherPattern->startAtom_ + start2*otherPattern->nAtoms_;
-		//printf("  VDWINTER2 %i %i %i\n",start2,finish2,aoff2);
-		for (m2=start2; m2<finish2; m2++)
-		{
-			if ((this == otherPattern) && (molId == m2)) { aoff2 += nAtoms_; continue; }
-			//printf("      m1/m2=%i/%i  aoff1/aoff2=%i/%i \n",m1,m2,aoff1,aoff2);
-			i = -1;
-			for (pai = atoms_.first(); pai != NULL; pai = pai->next)
-			{
-				i++;
-				j = -1;
-				for (paj = otherPattern->atoms_.first(); paj != NULL; paj = paj->next)
+				// Same pattern - if a specific molecule was given then we consider all other molecules.
+				// If not, consider only molecules m1+1 to nMolecules_.
+				if (this == otherPattern)
 				{
-					j++;
-					vec_ij = cell.mimVector(modelatoms[i+aoff1]->r(), modelatoms[j+aoff2]->r());
-					rij = vec_ij.magnitude();
-					if (rij > cutoff) continue;
-					energy  = (modelatoms[i+aoff1]->charge() * modelatoms[j+aoff2]->charge()) / rij;
-					energy_inter += energy;
+					m2 = (candidates[n] - otherStart) / nAtoms_;
+					if ((molId == -1) && (m2 <= m1)) continue;
+					if (m2 == molId) continue;
 				}
+
+				j = candidates[n];
+				vec_ij = cell.mimVector(Vec3<double>(x[i+aoff1], y[i+aoff1], z[i+aoff1]), Vec3<double>(x[j], y[j], z[j]));
+				rij = vec_ij.magnitude();
+				if (rij > cutoff) continue;
+				energy  = (q[i+aoff1] * q[j]) / rij;
+				energy_inter += energy;
 			}
-			aoff2 += otherPattern->nAtoms_;
 		}
 		aoff1 += nAtoms_;
 	}
@@ -162,144 +147,107 @@ void Pattern::coulombInterPatternEnergy(Model* srcmodel, Pattern* otherPattern,
 
 // Calculate the internal coulomb forces in the pattern.
 // Consider only the intrapattern interactions of individual molecules within this pattern.
-void Pattern::coulombIntraPatternForces(Model* srcmodel)
+void Pattern::coulombIntraPatternForces(Model* srcmodel, Vec3<double>* forces, int firstMolecule, int lastMolecule)
 {
 	Messenger::enter("Pattern::coulombIntraPatternForces");
-	static int i, j, aoff, m1, con;
-	static Vec3<double> vec_ij, f_i, tempf;
-	static double rij, factor, cutoff;
-	PatternAtom* pai, *paj;
+	int i, j, n, aoff, m1, con;
+	Vec3<double> vec_ij, f_i, tempf;
+	double rij, factor, cutoff;
+	Array<int> candidates;
+	candidates.setChunkIncrement(SMALLCHUNKSIZE);
 	cutoff = prefs.elecCutoff();
-	Atom** modelatoms = srcmodel->atomArray();
+	AtomStore& store = srcmodel->atomStore();
+	double* x = store.x(), *y = store.y(), *z = store.z(), *q = store.charges();
 	UnitCell& cell = srcmodel->cell();
-	aoff = startAtom_;
-	for (m1=0; m1<nMolecules_; m1++)
+	NeighbourList& neighbourList = srcmodel->neighbourList();
+	if (lastMolecule == -1) lastMolecule = nMolecules_-1;
+	aoff = startAtom_ + firstMolecule*nAtoms_;
+	for (m1=firstMolecule; m1<=lastMolecule; m1++)
 	{
 		// Add contributions from atom pairs that are unbound or separated by more than three bonds
-		i = -1;
-		for (pai = atoms_.first(); pai != atoms_.last(); pai = pai->next)
+		for (i=0; i<nAtoms_-1; ++i)
 		{
-			i++;
 			// Store temporary forces to avoid unnecessary array lookups
-			f_i = modelatoms[i+aoff]->f();
-			j = i;
-			for (paj = pai->next; paj != NULL; paj = paj->next)
+			f_i = forces[i+aoff];
+			candidates.clear();
+			neighbourList.neighbours(i+aoff, i+aoff+1, aoff+nAtoms_-1, candidates);
+			for (n=0; n<candidates.nItems(); ++n)
 			{
-				j++;
-				con = conMatrix_[i][j];
+				j = candidates[n] - aoff;
+				con = exclusions_.connectivity(i, j);
 				if ((con > 2) || (con == 0))
 				{
-					vec_ij = cell.mimVector(modelatoms[i+aoff]->r(), modelatoms[j+aoff]->r());
+					vec_ij = cell.mimVector(Vec3<double>(x[i+aoff], y[i+aoff], z[i+aoff]), Vec3<double>(x[j+aoff], y[j+aoff], z[j+aoff]));
 					rij = vec_ij.magnitude();
 					if (rij > cutoff) continue;
 					// Calculate force contribution
-					factor = (modelatoms[i+aoff]->charge() * modelatoms[j+aoff]->charge()) / (rij*rij);
-					if (con == 3) factor *= elecScaleMatrix_[i][j];
+					factor = (q[i+aoff] * q[j+aoff]) / (rij*rij);
+					if (con == 3) factor *= exclusions_.elecScale(i, j);
 					tempf = vec_ij * factor;
 					f_i -= tempf;
-					modelatoms[j+aoff]->f() += tempf;
+					forces[j+aoff] += tempf;
 				}
 			}
 			// Put the temporary forces back into the main array
-			modelatoms[i+aoff]->f() = f_i;
+			forces[i+aoff] = f_i;
 		}
 		aoff += nAtoms_;
 	}
-/*
-	aoff = startAtom_;
-	for (m1=0; m1<nMolecules_; m1++)
-	{
-		// Add on contributions for connectivities of 0 (unbound) or > 3
-		for (i=0; i<nAtoms_; i++)
-		{
-			// Copy forces for atom i
-			f_i = modelatoms[i+aoff]->f();
-			for (j=i+1; j<nAtoms_; j++)
-			{
-				con = conMatrix_[i][j];
-				if ((con > 2) || (con == 0))
-				{
-					mim_i = cell->mimd(modelatoms[i+aoff]->r(), modelatoms[j+aoff]->r());
-					rij = mim_i.magnitude();
-					if (rij > cutoff) continue;
-					factor = (modelatoms[i]->charge() * modelatoms[j]->charge()) / (rij*rij*rij);
-					if (con == 3) factor *= elecScaleMatrix_[i][j];
-					tempf = mim_i * factor;
-					f_i += tempf;
-					modelatoms[j+aoff]->f() -= tempf;
-				}
-			}
-			// Re-load forces back into main array
-			modelatoms[i+aoff]->f() = f_i;
-		}
-		aoff += nAtoms_;
-	}*/
 	Messenger::exit("Pattern::coulombIntraPatternForces");
 }
 
 // Calculate the coulomb forces from interactions between different molecules of this pattern and the one supplied
-void Pattern::coulombInterPatternForces(Model* srcmodel, Pattern* otherPattern)
+void Pattern::coulombInterPatternForces(Model* srcmodel, Pattern* otherPattern, Vec3<double>* forces, int firstMolecule, int lastMolecule)
 {
 	Messenger::enter("Pattern::coulombInterPatternForces");
-	int i,j,aoff1,aoff2,m1,m2,finish1,start1,start2,finish2;
+	int i, j, n, aoff1, m1, m2, finish1;
 	Vec3<double> vec_ij, f_i, tempf;
-	double rij, energy_inter, cutoff, factor;
-	PatternAtom* pai, *paj;
+	double rij, cutoff, factor;
+	Array<int> candidates;
+	candidates.setChunkIncrement(SMALLCHUNKSIZE);
 	cutoff = prefs.elecCutoff();
-	Atom** modelatoms = srcmodel->atomArray();
+	AtomStore& store = srcmodel->atomStore();
+	double* x = store.x(), *y = store.y(), *z = store.z(), *q = store.charges();
 	UnitCell& cell = srcmodel->cell();
-	energy_inter = 0.0;
+	NeighbourList& neighbourList = srcmodel->neighbourList();
+	int otherStart = otherPattern->startAtom_, otherEnd = otherPattern->startAtom_ + otherPattern->totalAtoms_ - 1;
 
 	// Outer loop over molecules in *this* pattern
 	// When we are considering the same node with itself, calculate for "m1=1,T-1 m2=2,T"
-	start1 = 0;
-	finish1 = (this == otherPattern ? nMolecules_ - 1 : nMolecules_);
-	aoff1 = startAtom_ + start1 * nAtoms_;
-	for (m1=start1; m1<finish1; m1++)
+	finish1 = (lastMolecule == -1 ? nMolecules_ : lastMolecule+1);
+	if ((this == otherPattern) && (finish1 == nMolecules_)) finish1 = nMolecules_ - 1;
+	aoff1 = startAtom_ + firstMolecule*nAtoms_;
+	for (m1=firstMolecule; m1<finish1; m1++)
 	{
-		// Inner loop - over *all* molecules in 'otherPattern'
-		if (this == otherPattern)
-		{
-			// Same pattern - if a specific molecule was given then we loop over all molecules.
-			start2 = m1 + 1;
-			finish2 = nMolecules_;
-		}
-		else
-		{
-			// Simple - go over all molecules in the dissimilar pattern
-			start2 = 0;
-			finish2 = otherPattern->nMolecules_;
-		}
-
-		//if (m1 == 0) printf("IPE - finish1 = %i, start2 = %i, finish2 = %i\n",finish1,start2,finish2);
-		aoff2 = otherPattern->startAtom_ + start2*otherPattern->nAtoms_;
-		//printf("  VDWINTER2 %i %i %i\n",start2,finish2,aoff2);
-		for (m2=start2; m2<finish2; m2++)
+		for (i=0; i<nAtoms_; ++i)
 		{
-			//printf("      m1/m2=%i/%i  aoff1/aoff2=%i/%i \n",m1,m2,aoff1,aoff2);
-			i = -1;
-			for (pai = atoms_.first(); pai != NULL; pai = pai->next)
+			// Store temporary forces to avoid unnecessary array lookups
+			f_i = forces[i+aoff1];
+			candidates.clear();
+			neighbourList.neighbours(i+aoff1, otherStart, otherEnd, candidates);
+			for (n=0; n<candidates.nItems(); ++n)
 			{
-				++i;
-				j = -1;
-				for (paj = otherPattern->atoms_.first(); paj != NULL; paj = paj->next)
+				if (this == otherPattern)
 				{
-					++j;
-					vec_ij = cell.mimVector(modelatoms[i+aoff1]->r(), modelatoms[j+aoff2]->r());
-					rij = vec_ij.magnitude();
-					if (rij > cutoff) continue;
-					// Calculate force contribution
-					factor = (modelatoms[i+aoff1]->charge() * modelatoms[j+aoff2]->charge()) / (rij*rij);
-					tempf = vec_ij * factor;
-					f_i -= tempf;
-					modelatoms[j+aoff2]->f() += tempf;
+					m2 = (candidates[n] - otherStart) / nAtoms_;
+					if (m2 <= m1) continue;
 				}
+
+				j = candidates[n];
+				vec_ij = cell.mimVector(Vec3<double>(x[i+aoff1], y[i+aoff1], z[i+aoff1]), Vec3<double>(x[j], y[j], z[j]));
+				rij = vec_ij.magnitude();
+				if (rij > cutoff) continue;
+				// Calculate force contribution
+				factor = (q[i+aoff1] * q[j]) / (rij*rij);
+				tempf = vec_ij * factor;
+				f_i -= tempf;
+				forces[j] += tempf;
 			}
-			aoff2 += otherPattern->nAtoms_;
+			// Put the temporary forces back into the main array
+			forces[i+aoff1] = f_i;
 		}
 		aoff1 += nAtoms_;
 	}
 
 	Messenger::exit("Pattern::coulombInterPatternForces");
 }
-
@@ -299,6 +299,41 @@ void EnergyStore::add(EnergyStore::EnergyType type, double value, int p1, int p2
 	Messenger::exit("EnergyStore::add");
 }
 
+// Add all energy components from another store of the same size
+void EnergyStore::add(const EnergyStore& source)
+{
+	Messenger::enter("EnergyStore::add");
+	if (source.size_ != size_)
+	{
+		printf("EnergyStore::add <<<< Source store has different size - %i %i - Ignored >>>>\n", source.size_, size_);
+		Messenger::exit("EnergyStore::add");
+		return;
+	}
+	int n, m;
+	for (n=0; n<size_; n++)
+	{
+		bond_[n] += source.bond_[n];
+		angle_[n] += source.angle_[n];
+		torsion_[n] += source.torsion_[n];
+		ureyBradley_[n] += source.ureyBradley_[n];
+		vdwIntra_[n] += source.vdwIntra_[n];
+		coulombIntra_[n] += source.coulombIntra_[n];
+		ewaldRealIntra_[n] += source.ewaldRealIntra_[n];
+		ewaldRecipIntra_[n] += source.ewaldRecipIntra_[n];
+		for (m=0; m<size_; m++)
+		{
+			vdwInter_[n][m] += source.vdwInter_[n][m];
+			coulombInter_[n][m] += source.coulombInter_[n][m];
+			ewaldRealInter_[n][m] += source.ewaldRealInter_[n][m];
+			ewaldRecipInter_[n][m] += source.ewaldRecipInter_[n][m];
+		}
+		ewaldSelfCorrect_[n] += source.ewaldSelfCorrect_[n];
+		ewaldMolCorrect_[n] += source.ewaldMolCorrect_[n];
+	}
+	vdwTail_ += source.vdwTail_;
+	Messenger::exit("EnergyStore::add");
+}
+
 // Returns the total energy in the store
 double EnergyStore::total()
 {
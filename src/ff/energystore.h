@@ -108,6 +108,8 @@ class EnergyStore
 	void totalise();
 	// Add to energy
 	void add(EnergyType type, double value, int p1, int p2 = -1);
+	// Add all energy components from another store of the same size
+	void add(const EnergyStore& source);
 	// Returns the total energy in the store
 	double total();
 	// Returns the total bond energy in the store
@@ -28,6 +28,7 @@
 #include "base/fourierdata.h"
 #include "base/pattern.h"
 #include "base/prefs.h"
+#include "ff/neighbourlist.h"
 #include "model/model.h"
 
 ATEN_USING_NAMESPACE
@@ -61,36 +62,46 @@ void Prefs::estimateEwaldParameters(UnitCell& cell)
 // 'n' is box vector - here we only consider the minimimum image coordinates of the atoms in the central box (n=0)
 // Factor of 1/2 is not required in the summation since the sums go from i=0,N-1 and j=i,N
 
-void Pattern::ewaldRealIntraPatternEnergy(Model* srcModel, EnergyStore* estore, int molecule)
+void Pattern::ewaldRealIntraPatternEnergy(Model* srcModel, EnergyStore* estore, int molecule, int firstMolecule, int lastMolecule)
 {
 	// Calculate a real-space contribution to the Ewald sum.
 	// Internal interaction of atoms in individual molecules within the pattern is considered.
 	Messenger::enter("Pattern::ewaldRealIntraPatternEnergy");
-	int i,j,aoff,m1,con;
+	int i, j, n, aoff, m1, con;
 	Vec3<double> vec_ij;
 	double rij, energy_inter, energy_intra, energy, cutoff, alpha;
+	Array<int> candidates;
+	candidates.setChunkIncrement(SMALLCHUNKSIZE);
 	cutoff = prefs.elecCutoff();
 	alpha = prefs.ewaldAlpha();
 	energy_inter = 0.0;
 	energy_intra = 0.0;
-	Atom** modelatoms = srcModel->atomArray();
+	AtomStore& store = srcModel->atomStore();
+	double* x = store.x(), *y = store.y(), *z = store.z(), *q = store.charges();
 	UnitCell& cell = srcModel->cell();
-	aoff = startAtom_;
-	for (m1=(molecule == -1 ? 0 : molecule); m1<(molecule == -1 ? nMolecules_ : molecule+1); m1++)
+	NeighbourList& neighbourList = srcModel->neighbourList();
+	if (molecule != -1) firstMolecule = lastMolecule = molecule;
+	else if (lastMolecule == -1) lastMolecule = nMolecules_-1;
+	aoff = startAtom_ + firstMolecule*nAtoms_;
+	for (m1=firstMolecule; m1<=lastMolecule; m1++)
 	{
 		// Loop over atom pairs that are either unbound or separated by more than two bonds
 		for (i=0; i<nAtoms_-1; i++)
 		{
-			for (j=i+1; j<nAtoms_; j++)
+			// Only consider neighbours of i which lie later in the same molecule
+			candidates.clear();
+			neighbourList.neighbours(i+aoff, i+aoff+1, aoff+nAtoms_-1, candidates);
+			for (n=0; n<candidates.nItems(); ++n)
 			{
-				con = conMatrix_[i][j];
+				j = candidates[n] - aoff;
+				con = exclusions_.connectivity(i, j);
 				if ((con > 2) || (con == 0))
 				{
-					vec_ij = cell.mimVector(modelatoms[i+aoff]->r(), modelatoms[j+aoff]->r());
+					vec_ij = cell.mimVector(Vec3<double>(x[i+aoff], y[i+aoff], z[i+aoff]), Vec3<double>(x[j+aoff], y[j+aoff], z[j+aoff]));
 					rij = vec_ij.magnitude();
 					if (rij > cutoff) continue;
-					energy  = (modelatoms[i+aoff]->charge() * modelatoms[j+aoff]->charge()) * AtenMath::erfc(alpha*rij) / rij;
-					con == 0 ? energy_inter += energy : energy_intra += (con == 3 ? energy * elecScaleMatrix_[i][j] : energy);
+					energy  = (q[i+aoff] * q[j+aoff]) * AtenMath::erfc(alpha*rij) / rij;
+					con == 0 ? energy_inter += energy : energy_intra += (con == 3 ? energy * exclusions_.elecScale(i, j) : energy);
 				}
 			}
 		}
@@ -103,56 +114,64 @@ void Pattern::ewaldRealIntraPatternEnergy(Model* srcModel, EnergyStore* estore,
 	Messenger::exit("Pattern::ewaldRealIntraPatternEnergy");
 }
 
-void Pattern::ewaldRealInterPatternEnergy(Model* srcModel, Pattern* xpnode, EnergyStore* estore, int molecule)
+void Pattern::ewaldRealInterPatternEnergy(Model* srcModel, Pattern* xpnode, EnergyStore* estore, int molecule, int firstMolecule, int lastMolecule)
 {
 	// Calculate the real-space Ewald contribution to the energy from interactions between different molecules
 	// of this pnode and the one supplied. Contributions to the sum from the inner loop of atoms (a2) is summed into
 	// 'energy; before multiplication by the charge of the second atom (a1)
+	// If a molecule is specified, only interactions with that molecule of 'xpnode' are considered.
 	Messenger::enter("Pattern::ewaldRealInterPatternEnergy");
-	static int i,j,aoff1,aoff2,m1,m2,finish1,start2,finish2,atomi,atomj;
-	static Vec3<double> vec_ij;
-	static double rij, energy_inter, energy, cutoff, alpha;
+	int i, n, aoff1, m1, m2, finish1, atomi, atomj, firstj, lastj;
+	Vec3<double> vec_ij;
+	double rij, energy_inter, energy, cutoff, alpha;
+	Array<int> candidates;
+	candidates.setChunkIncrement(SMALLCHUNKSIZE);
 	cutoff = prefs.elecCutoff();
 	alpha = prefs.ewaldAlpha();
-	Atom** modelatoms = srcModel->atomArray();
+	AtomStore& store = srcModel->atomStore();
+	double* x = store.x(), *y = store.y(), *z = store.z(), *q = store.charges();
 	UnitCell& cell = srcModel->cell();
+	NeighbourList& neighbourList = srcModel->neighbourList();
 	energy_inter = 0.0;
-	aoff1 = startAtom_;
+	aoff1 = startAtom_ + firstMolecule*nAtoms_;
 	// When we are considering the same node with itself, calculate for "m1=1,T-1 m2=2,T"
-	if ((this == xpnode) && (molecule == -1)) finish1 = nMolecules_ - 1;
-	else finish1 = nMolecules_;
-	for (m1=0; m1<finish1; m1++)
+	finish1 = (lastMolecule == -1 ? nMolecules_ : lastMolecule+1);
+	if ((this == xpnode) && (molecule == -1) && (finish1 == nMolecules_)) finish1 = nMolecules_ - 1;
+	// Determine range of atoms in 'xpnode' to consider
+	if (molecule == -1)
 	{
-		if (molecule == -1)
-		{
-			start2 = (this == xpnode ? m1 + 1 : 0);
-			finish2 = xpnode->nMolecules_;
-		}
-		else
-		{
-			start2 = molecule;
-			finish2 = molecule + 1;
-			// If the patterns are the same we must exclude molecule == m1
-			if ((this == xpnode) && (molecule == m1)) { aoff1 += nAtoms_; continue; }
-		}
-		aoff2 = xpnode->startAtom_ + start2*xpnode->nAtoms_;
-		for (m2=start2; m2<finish2; m2++)
+		firstj = xpnode->startAtom_;
+		lastj = xpnode->startAtom_ + xpnode->totalAtoms_ - 1;
+	}
+	else
+	{
+		firstj = xpnode->startAtom_ + molecule*xpnode->nAtoms_;
+		lastj = firstj + xpnode->nAtoms_ - 1;
+	}
+	for (m1=firstMolecule; m1<finish1; m1++)
+	{
+		// If the patterns are the same we must exclude molecule == m1
+		if ((this == xpnode) && (molecule == m1)) { aoff1 += nAtoms_; continue; }
+		for (i=0; i<nAtoms_; i++)
 		{
-			for (i=0; i<nAtoms_; i++)
+			atomi = i + aoff1;
+			energy = 0.0;
+			candidates.clear();
+			neighbourList.neighbours(atomi, firstj, lastj, candidates);
+			for (n=0; n<candidates.nItems(); ++n)
 			{
-				atomi = i + aoff1;
-				energy = 0.0;
-				for (j=0; j<xpnode->nAtoms_; j++)
+				atomj = candidates[n];
+				if ((this == xpnode) && (molecule == -1))
 				{
-					atomj = j + aoff2;
-					vec_ij = cell.mimVector(modelatoms[atomi]->r(), modelatoms[atomj]->r());
-					rij = vec_ij.magnitude();
-					if (rij < cutoff) energy  += (modelatoms[atomj]->charge() * AtenMath::erfc(alpha*rij) / rij);
+					m2 = (atomj - xpnode->startAtom_) / nAtoms_;
+					if (m2 <= m1) continue;
 				}
-				energy *= modelatoms[atomi]->charge();
-				energy_inter += energy;
+				vec_ij = cell.mimVector(Vec3<double>(x[atomi], y[atomi], z[atomi]), Vec3<double>(x[atomj], y[atomj], z[atomj]));
+				rij = vec_ij.magnitude();
+				if (rij < cutoff) energy  += (q[atomj] * AtenMath::erfc(alpha*rij) / rij);
 			}
-			aoff2 += xpnode->nAtoms_;
+			energy *= q[atomi];
+			energy_inter += energy;
 		}
 		aoff1 += nAtoms_;
 	}
@@ -185,7 +204,8 @@ void Pattern::ewaldReciprocalEnergy(Model* srcModel, Pattern* firstp, int npats,
 	const Array2D< Vec3<double> >& rSin = srcModel->fourierData().rSin();
 
 	alpha = prefs.ewaldAlpha();
-	Atom** modelatoms = srcModel->atomArray();
+	AtomStore& store = srcModel->atomStore();
+	double* q = store.charges();
 	sumcos = new double[npats];
 	sumsin = new double[npats];
 
@@ -245,8 +265,8 @@ void Pattern::ewaldReciprocalEnergy(Model* srcModel, Pattern* firstp, int npats,
 				// Calculate k-vector (xy*z);
 				xyzcos = xycos * rCos.constRef(abs(kz),i).z - xysin * rSin.constRef(kmax+kz,i).z;
 				xyzsin = xycos * rSin.constRef(kmax+kz,i).z + xysin * rCos.constRef(abs(kz),i).z;
-				sumcos[p->id_] += modelatoms[i]->charge() * xyzcos;
-				sumsin[p->id_] += modelatoms[i]->charge() * xyzsin;
+				sumcos[p->id_] += q[i] * xyzcos;
+				sumsin[p->id_] += q[i] * xyzsin;
 			}
 			p = p->next;
 		}
@@ -278,11 +298,12 @@ void Pattern::ewaldCorrectEnergy(Model* srcModel, EnergyStore* estore, int molec
 {
 	// Calculate corrections to the Ewald sum energy
 	Messenger::enter("Pattern::ewaldCorrectEnergy");
-	static int aoff, m1, i, j, con;
-	static double molcorrect, energy, qprod, rij, chargesum, alpha;
+	int aoff, m1, i, j, k, con;
+	double molcorrect, energy, qprod, rij, chargesum, alpha;
 	alpha = prefs.ewaldAlpha();
-	static Vec3<double> vec_ij;
-	Atom** modelatoms = srcModel->atomArray();
+	Vec3<double> vec_ij;
+	AtomStore& store = srcModel->atomStore();
+	double* x = store.x(), *y = store.y(), *z = store.z(), *q = store.charges();
 	UnitCell& cell = srcModel->cell();
 
 	// TODO
@@ -293,7 +314,7 @@ void Pattern::ewaldCorrectEnergy(Model* srcModel, EnergyStore* estore, int molec
 	aoff = startAtom_;
 	for (m1=0; m1<nMolecules_; m1++)
 	{
-		for (i=0; i<nAtoms_; i++) chargesum += (modelatoms[i+aoff]->charge() * modelatoms[i+aoff]->charge());
+		for (i=0; i<nAtoms_; i++) chargesum += (q[i+aoff] * q[i+aoff]);
 		aoff += nAtoms_;
 	}
 	energy = (alpha/SQRTPI) * chargesum * prefs.elecConvert();
@@ -304,17 +325,20 @@ void Pattern::ewaldCorrectEnergy(Model* srcModel, EnergyStore* estore, int molec
 	aoff = startAtom_;
 	for (m1=0; m1<nMolecules_; m1++)
 	{
+		// Only pairs in the exclusion list can need correcting, so loop over those (taking each pair once)
 		for (i=0; i<nAtoms_-1; i++)
-			for (j=i+1; j<nAtoms_; j++)
+			for (k=exclusions_.firstEntry(i); k<exclusions_.endEntry(i); ++k)
 			{
-				con = conMatrix_[i][j];
-				if ((con < 4) && (con != 0))
+				j = exclusions_.entryPartner(k);
+				if (j < i) continue;
+				con = exclusions_.entryDistance(k);
+				if (con < 4)
 				{
 					// A molecular correction is needed for this atom pair.
-					// Take values from scaling matrix to determine degree of subtraction...
-					qprod = modelatoms[i+aoff]->charge() * modelatoms[j+aoff]->charge();
-					qprod *= (1.0 - elecScaleMatrix_[i][j]);
-					vec_ij = cell.mimVector(modelatoms[i+aoff]->r(), modelatoms[j+aoff]->r());
+					// Take values from scale factors to determine degree of subtraction...
+					qprod = q[i+aoff] * q[j+aoff];
+					qprod *= (1.0 - exclusions_.entryElecScale(k));
+					vec_ij = cell.mimVector(Vec3<double>(x[i+aoff], y[i+aoff], z[i+aoff]), Vec3<double>(x[j+aoff], y[j+aoff], z[j+aoff]));
 					rij = vec_ij.magnitude();
 					molcorrect += qprod *( AtenMath::erf(alpha*rij)/rij );
 				}
@@ -331,104 +355,121 @@ void Pattern::ewaldCorrectEnergy(Model* srcModel, EnergyStore* estore, int molec
 //		F(real) = E' E   E  ----------- * ( erfc(alpha * rij) + ----------- * exp(-(alpha*rij)**2) ) * rij
 //			  n i=1 j>i   rij**3				   sqrtpi
  
-void Pattern::ewaldRealIntraPatternForces(Model* srcModel)
+void Pattern::ewaldRealIntraPatternForces(Model* srcModel, Vec3<double>* forces, int firstMolecule, int lastMolecule)
 {
 	// Calculate real-space forces in the Ewald sum.
 	// Internal interaction of atoms in individual molecules within the pattern is considered.
 	Messenger::enter("Pattern::ewaldRealIntraPatternForces");
-	int i, j, aoff, m1, atomi, atomj, con;
+	int i, j, n, aoff, m1, atomi, atomj, con;
 	Vec3<double> vec_ij, tempf, f_i;
 	double rij, factor, qqrij3, alpharij, cutoff, alpha;
+	Array<int> candidates;
+	candidates.setChunkIncrement(SMALLCHUNKSIZE);
 	cutoff = prefs.elecCutoff();
 	alpha = prefs.ewaldAlpha();
-	Atom** modelatoms = srcModel->atomArray();
+	AtomStore& store = srcModel->atomStore();
+	double* x = store.x(), *y = store.y(), *z = store.z(), *q = store.charges();
 	UnitCell& cell = srcModel->cell();
+	NeighbourList& neighbourList = srcModel->neighbourList();
 
-	aoff = startAtom_;
-	for (m1=0; m1<nMolecules_; m1++)
+	if (lastMolecule == -1) lastMolecule = nMolecules_-1;
+	aoff = startAtom_ + firstMolecule*nAtoms_;
+	for (m1=firstMolecule; m1<=lastMolecule; m1++)
 	{
 		// Add force contributions for atom pairs that are unbond or separated by at least three bonds
-		for (i=0; i<nAtoms_; i++)
+		for (i=0; i<nAtoms_-1; i++)
 		{
 			atomi = i+aoff;
 			// Copy i's forces from the main array into a temporary array
-			f_i = modelatoms[atomi]->f();
-			for (j=i+1; j<nAtoms_; j++)
+			f_i = forces[atomi];
+			// Only consider neighbours of i which lie later in the same molecule
+			candidates.clear();
+			neighbourList.neighbours(atomi, atomi+1, aoff+nAtoms_-1, candidates);
+			for (n=0; n<candidates.nItems(); ++n)
 			{
-				atomj = j+aoff;
-				con = conMatrix_[i][j];
+				atomj = candidates[n];
+				j = atomj - aoff;
+				con = exclusions_.connectivity(i, j);
 				if ((con > 2) || (con == 0))
 				{
-					vec_ij = cell.mimVector(modelatoms[atomi]->r(), modelatoms[atomj]->r());
+					vec_ij = cell.mimVector(Vec3<double>(x[atomi], y[atomi], z[atomi]), Vec3<double>(x[atomj], y[atomj], z[atomj]));
 					rij = vec_ij.magnitude();
 					if (rij > cutoff) continue;
 					alpharij = alpha * rij;
 					factor = AtenMath::erfc(alpharij) + 2.0*alpharij/SQRTPI * exp(-(alpharij*alpharij));
-					qqrij3 = (modelatoms[atomi]->charge() * modelatoms[atomj]->charge()) / (rij * rij * rij);
+					qqrij3 = (q[atomi] * q[atomj]) / (rij * rij * rij);
 					factor = factor * qqrij3 * prefs.elecConvert();
-					if (con == 3) factor *= elecScaleMatrix_[i][j];
+					if (con == 3) factor *= exclusions_.elecScale(i, j);
 					// Sum forces
 					tempf = vec_ij * factor;
 					f_i -= tempf;
-					modelatoms[atomj]->f() += tempf;
+					forces[atomj] += tempf;
 				}
 			}
 			// Re-store forces on atom i
-			modelatoms[atomi]->f() = f_i;
+			forces[atomi] = f_i;
 		}
 		aoff += nAtoms_;
 	}
 	Messenger::exit("Pattern::ewaldRealIntraPatternForces");
 }
 
-void Pattern::ewaldRealInterPatternForces(Model* srcModel, Pattern* xpnode)
+void Pattern::ewaldRealInterPatternForces(Model* srcModel, Pattern* xpnode, Vec3<double>* forces, int firstMolecule, int lastMolecule)
 {
 	// Calculate the real-space Ewald forces from interactions between different molecules
 	// of this pattern and the one supplied. 
 	Messenger::enter("Pattern::ewaldRealInterPatternForces");
-	int i, j, aoff1, aoff2, m1, m2, start, finish, atomi, atomj;
+	int i, n, aoff1, m1, m2, finish, atomi, atomj, firstj, lastj;
 	Vec3<double> vec_ij, f_i, tempf;
 	double rij, factor, alpharij, qqrij3, cutoff, alpha;
+	Array<int> candidates;
+	candidates.setChunkIncrement(SMALLCHUNKSIZE);
 	cutoff = prefs.elecCutoff();
 	alpha = prefs.ewaldAlpha();
-	Atom** modelatoms = srcModel->atomArray();
+	AtomStore& store = srcModel->atomStore();
+	double* x = store.x(), *y = store.y(), *z = store.z(), *q = store.charges();
 	UnitCell& cell = srcModel->cell();
+	NeighbourList& neighbourList = srcModel->neighbourList();
+	firstj = xpnode->startAtom_;
+	lastj = xpnode->startAtom_ + xpnode->totalAtoms_ - 1;
 
-	aoff1 = startAtom_;
-	 // When we are considering the same node with itself, calculate for "m1=1,T-1 m2=2,T"
-	this == xpnode ? finish = nMolecules_ - 1 : finish = nMolecules_;
-	for (m1=0; m1<finish; m1++)
+	aoff1 = startAtom_ + firstMolecule*nAtoms_;
+	// When we are considering the same node with itself, calculate for "m1=1,T-1 m2=2,T"
+	finish = (lastMolecule == -1 ? nMolecules_ : lastMolecule+1);
+	if ((this == xpnode) && (finish == nMolecules_)) finish = nMolecules_ - 1;
+	for (m1=firstMolecule; m1<finish; m1++)
 	{
-		this == xpnode ? start = m1 + 1 : start = 0;
-		aoff2 = xpnode->startAtom_ + start*xpnode->nAtoms_;
-		for (m2=start; m2<xpnode->nMolecules_; m2++)
+		for (i=0; i<nAtoms_; i++)
 		{
-			for (i=0; i<nAtoms_; i++)
+			atomi = i + aoff1;
+			// Copy the current forces on i
+			f_i = forces[atomi];
+			candidates.clear();
+			neighbourList.neighbours(atomi, firstj, lastj, candidates);
+			for (n=0; n<candidates.nItems(); ++n)
 			{
-				atomi = i + aoff1;
-				// Copy the current forces on i
-				f_i = modelatoms[atomi]->f();
-				for (j=0; j<xpnode->nAtoms_; j++)
+				atomj = candidates[n];
+				if (this == xpnode)
 				{
-					atomj = j + aoff2;
-					vec_ij = cell.mimVector(modelatoms[atomi]->r() ,modelatoms[atomj]->r());
-					rij = vec_ij.magnitude();
-					if (rij < cutoff)
-					{
-						alpharij = alpha * rij;
-						factor = AtenMath::erfc(alpharij) + 2.0*alpharij/SQRTPI * exp(-(alpharij*alpharij));
-						qqrij3 = (modelatoms[atomi]->charge() * modelatoms[atomj]->charge()) / (rij * rij * rij);
-						factor = factor * qqrij3 * prefs.elecConvert();
-						// Sum forces
-						tempf = vec_ij * factor;
-						f_i -= tempf;
-						modelatoms[atomj]->f() += tempf;
-					}
+					m2 = (atomj - xpnode->startAtom_) / nAtoms_;
+					if (m2 <= m1) continue;
+				}
+				vec_ij = cell.mimVector(Vec3<double>(x[atomi], y[atomi], z[atomi]) ,Vec3<double>(x[atomj], y[atomj], z[atomj]));
+				rij = vec_ij.magnitude();
+				if (rij < cutoff)
+				{
+					alpharij = alpha * rij;
+					factor = AtenMath::erfc(alpharij) + 2.0*alpharij/SQRTPI * exp(-(alpharij*alpharij));
+					qqrij3 = (q[atomi] * q[atomj]) / (rij * rij * rij);
+					factor = factor * qqrij3 * prefs.elecConvert();
+					// Sum forces
+					tempf = vec_ij * factor;
+					f_i -= tempf;
+					forces[atomj] += tempf;
 				}
-				// Store the new forces on atom i
-				modelatoms[atomi]->f() = f_i;
 			}
-			aoff2 += xpnode->nAtoms_;
+			// Store the new forces on atom i
+			forces[atomi] = f_i;
 		}
 		aoff1 += nAtoms_;
 	}
@@ -441,7 +482,7 @@ void Pattern::ewaldRealInterPatternForces(Model* srcModel, Pattern* xpnode)
 //		  F(recip) = E   E q(j) 
 //			    k/=0 j
 
-void Pattern::ewaldReciprocalForces(Model* srcModel)
+void Pattern::ewaldReciprocalForces(Model* srcModel, Vec3<double>* forces)
 {
 	// Calculate the reciprocal-space force contribution to the Ewald sum.
 	// Must be called for the first pattern in the list only!
@@ -460,7 +501,8 @@ void Pattern::ewaldReciprocalForces(Model* srcModel)
 	const Array2D< Vec3<double> >& rSin = srcModel->fourierData().rSin();
 
 	alpha = prefs.ewaldAlpha();
-	Atom** modelatoms = srcModel->atomArray();
+	AtomStore& store = srcModel->atomStore();
+	double* q = store.charges();
 	xyzcos = new double[srcModel->nAtoms()];
 	xyzsin = new double[srcModel->nAtoms()];
 
@@ -503,8 +545,8 @@ void Pattern::ewaldReciprocalForces(Model* srcModel)
 			xysin = rCos.constRef(abs(kx),i).x * rSin.constRef(kmax+ky,i).y +
 				rSin.constRef(kmax+kx,i).x * rCos.constRef(abs(ky),i).y;
 			// Calculate k-vector (xy*z);
-			xyzcos[i] = (xycos * rCos.constRef(abs(kz),i).z - xysin * rSin.constRef(kmax+kz,i).z) * modelatoms[i]->charge();
-			xyzsin[i] = (xycos * rSin.constRef(kmax+kz,i).z + xysin * rCos.constRef(abs(kz),i).z) * modelatoms[i]->charge();
+			xyzcos[i] = (xycos * rCos.constRef(abs(kz),i).z - xysin * rSin.constRef(kmax+kz,i).z) * q[i];
+			xyzsin[i] = (xycos * rSin.constRef(kmax+kz,i).z + xysin * rCos.constRef(abs(kz),i).z) * q[i];
 			sumcos += xyzcos[i];
 			sumsin += xyzsin[i];
 		}
@@ -515,7 +557,7 @@ void Pattern::ewaldReciprocalForces(Model* srcModel)
 		{
 			force = exp1 * (xyzsin[i]*sumcos - xyzcos[i]*sumsin) * factor;
 	//printf("force = %20.14e\n",force);
-			modelatoms[i]->f() += k * force;
+			forces[i] += k * force;
 	//if (i == 0) printf("%i %i %i  %8.4f %8.4f %8.4f %8.4f\n",kx,ky,kz,force,kvec.x,kvec.y,kvec.z);
 		}
 	}
@@ -523,16 +565,17 @@ void Pattern::ewaldReciprocalForces(Model* srcModel)
 	Messenger::exit("Pattern::ewaldReciprocalForces");
 }
 
-void Pattern::ewaldCorrectForces(Model* srcModel)
+void Pattern::ewaldCorrectForces(Model* srcModel, Vec3<double>* forces)
 {
 	// Correct the Ewald forces due to bond / angle / torsion exclusions
 	Messenger::enter("Pattern::ewaldCorrectForces");
-	static int i, j, aoff, m1, atomi, atomj, con;
-	static Vec3<double> vec_ij, tempf, f_i;
-	static double rij, factor, qqrij3, alpharij, cutoff, alpha;
+	int i, j, k, aoff, m1, atomi, atomj, con;
+	Vec3<double> vec_ij, tempf, f_i;
+	double rij, factor, qqrij3, alpharij, cutoff, alpha;
 	cutoff = prefs.elecCutoff();
 	alpha = prefs.ewaldAlpha();
-	Atom** modelatoms = srcModel->atomArray();
+	AtomStore& store = srcModel->atomStore();
+	double* x = store.x(), *y = store.y(), *z = store.z(), *q = store.charges();
 	UnitCell& cell = srcModel->cell();
 
 	aoff = startAtom_;
@@ -543,32 +586,55 @@ void Pattern::ewaldCorrectForces(Model* srcModel)
 		{
 			atomi = i+aoff;
 			// Copy i's forces from the main array into a temporary array
-			f_i = modelatoms[atomi]->f();
-			for (j=i+1; j<nAtoms_; j++)
+			f_i = forces[atomi];
+			for (k=exclusions_.firstEntry(i); k<exclusions_.endEntry(i); ++k)
 			{
+				j = exclusions_.entryPartner(k);
+				if (j < i) continue;
 				atomj = j+aoff;
-				con = conMatrix_[i][j];
-				if ((con < 4) && (con > 0))
+				con = exclusions_.entryDistance(k);
+				if (con < 4)
 				{
-					vec_ij = cell.mimVector(modelatoms[atomi]->r(), modelatoms[atomj]->r());
+					vec_ij = cell.mimVector(Vec3<double>(x[atomi], y[atomi], z[atomi]), Vec3<double>(x[atomj], y[atomj], z[atomj]));
 					rij = vec_ij.magnitude();
 					if (rij > cutoff) continue;
 					// Calculate force to subtract
 					alpharij = alpha * rij;
 					factor = AtenMath::erf(alpharij) - 2.0*alpharij/SQRTPI * exp(-(alpharij*alpharij));
-					qqrij3 = (modelatoms[atomi]->charge() * modelatoms[atomj]->charge()) / (rij * rij * rij);
+					qqrij3 = (q[atomi] * q[atomj]) / (rij * rij * rij);
 					factor = factor * qqrij3 * prefs.elecConvert();
-					factor *= (1.0 - elecScaleMatrix_[i][j]);
+					factor *= (1.0 - exclusions_.entryElecScale(k));
 					// Sum forces (correcting force, so adding to f_i and subtracting from f_j)
 					tempf = vec_ij * factor;
 					f_i += tempf;
-					modelatoms[atomj]->f() -= tempf;
+					forces[atomj] -= tempf;
 				}
 			}
 			// Re-store forces on atom i
-			modelatoms[atomi]->f() = f_i;
+			forces[atomi] = f_i;
 		}
 		aoff += nAtoms_;
 	}
 	Messenger::exit("Pattern::ewaldCorrectForces");
 }
+
+// Smooth Particle Mesh Ewald reciprocal-space energy
+// Charges are spread onto a mesh with B-splines and the reciprocal sum evaluated by FFT (see base/spmedata.cpp).
+// The total cannot be decomposed by pattern, so it is stored entirely as the self-interaction of this pattern.
+// Must be called for the first pattern in the list only!
+void Pattern::spmeReciprocalEnergy(Model* srcModel, EnergyStore* estore)
+{
+	Messenger::enter("Pattern::spmeReciprocalEnergy");
+	double energy = srcModel->spmeData().calculate(srcModel);
+	estore->add(EnergyStore::EwaldRecipInterEnergy,energy,id_,id_);
+	Messenger::exit("Pattern::spmeReciprocalEnergy");
+}
+
+// Smooth Particle Mesh Ewald reciprocal-space forces
+// Must be called for the first pattern in the list only!
+void Pattern::spmeReciprocalForces(Model* srcModel, Vec3<double>* forces)
+{
+	Messenger::enter("Pattern::spmeReciprocalForces");
+	srcModel->spmeData().calculate(srcModel, forces);
+	Messenger::exit("Pattern::spmeReciprocalForces");
+}
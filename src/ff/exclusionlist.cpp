@@ -0,0 +1,274 @@
+/*
+	*** Sparse exclusion list
+	*** src/ff/exclusionlist.cpp
+	Copyright T. Youngs 2007-2017
+
+	This file is part of Aten.
+
+	Aten is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Aten is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Aten.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "ff/exclusionlist.h"
+#include "base/atom.h"
+#include "base/bond.h"
+#include "base/messenger.h"
+#include <algorithm>
+
+ATEN_USING_NAMESPACE
+
+// Constructor
+ExclusionList::ExclusionList()
+{
+	// Private variables
+	initialised_ = false;
+	nAtoms_ = 0;
+	maxDistance_ = 0;
+}
+
+/*
+ * Data
+ */
+
+// Return entry for the specified pair, or -1 if it is not in the list
+int ExclusionList::entry(int i, int j) const
+{
+	// Entries for each atom are sorted by partner, so bisect
+	int low = offsets_.value(i), high = offsets_.value(i+1) - 1, mid;
+	while (low <= high)
+	{
+		mid = (low + high) / 2;
+		if (partners_.value(mid) < j) low = mid + 1;
+		else if (partners_.value(mid) > j) high = mid - 1;
+		else return mid;
+	}
+	return -1;
+}
+
+// Clear the list
+void ExclusionList::clear()
+{
+	initialised_ = false;
+	nAtoms_ = 0;
+	maxDistance_ = 0;
+	fragments_.clear();
+	offsets_.clear();
+	partners_.clear();
+	distances_.clear();
+	vdwScales_.clear();
+	elecScales_.clear();
+}
+
+// Build the list from the bonding of the atoms starting at the one supplied, storing pairs up to the distance specified
+void ExclusionList::initialise(Atom* firstAtom, int nAtoms, int maxDistance)
+{
+	Messenger::enter("ExclusionList::initialise");
+
+	clear();
+	initialised_ = true;
+	nAtoms_ = nAtoms;
+	maxDistance_ = maxDistance;
+	offsets_.createEmpty(nAtoms_+1, 0);
+	if ((nAtoms_ == 0) || (firstAtom == NULL))
+	{
+		Messenger::exit("ExclusionList::initialise");
+		return;
+	}
+
+	// Construct adjacency lists from the bonds of the atoms, ignoring any which lead outside the range
+	int n, k, a, b, head, tail, firstId = firstAtom->id();
+	Array<int> bondOffsets, bondPartners;
+	bondOffsets.createEmpty(nAtoms_+1, 0);
+	bondPartners.setChunkIncrement(nAtoms_);
+	Atom* i = firstAtom;
+	for (n=0; n<nAtoms_; ++n)
+	{
+		bondOffsets[n] = bondPartners.nItems();
+		if (i == NULL) continue;
+		for (RefListItem<Bond,int>* ri = i->bonds(); ri != NULL; ri = ri->next)
+		{
+			b = ri->item->partner(i)->id() - firstId;
+			if ((b >= 0) && (b < nAtoms_)) bondPartners.add(b);
+		}
+		i = i->next;
+	}
+	bondOffsets[nAtoms_] = bondPartners.nItems();
+
+	// Assign atoms to bound fragments
+	Array<int> queue;
+	queue.createEmpty(nAtoms_, 0);
+	fragments_.createEmpty(nAtoms_, -1);
+	int nFragments = 0;
+	for (n=0; n<nAtoms_; ++n)
+	{
+		if (fragments_[n] != -1) continue;
+		fragments_[n] = nFragments;
+		queue[0] = n;
+		head = 0;
+		tail = 1;
+		while (head < tail)
+		{
+			a = queue[head++];
+			for (k = bondOffsets[a]; k < bondOffsets[a+1]; ++k)
+			{
+				b = bondPartners[k];
+				if (fragments_[b] != -1) continue;
+				fragments_[b] = nFragments;
+				queue[tail++] = b;
+			}
+		}
+		++nFragments;
+	}
+
+	// Search outwards from each atom in turn, stopping at the maximum distance
+	// Atoms are stamped with the index of the search which last reached them, so the markers never need resetting
+	Array<int> reachedBy, depth;
+	reachedBy.createEmpty(nAtoms_, -1);
+	depth.createEmpty(nAtoms_, 0);
+	partners_.setChunkIncrement(8*nAtoms_);
+	distances_.setChunkIncrement(8*nAtoms_);
+	for (n=0; n<nAtoms_; ++n)
+	{
+		offsets_[n] = partners_.nItems();
+		reachedBy[n] = n;
+		depth[n] = 0;
+		queue[0] = n;
+		head = 0;
+		tail = 1;
+		while (head < tail)
+		{
+			a = queue[head++];
+			if (depth[a] == maxDistance_) continue;
+			for (k = bondOffsets[a]; k < bondOffsets[a+1]; ++k)
+			{
+				b = bondPartners[k];
+				if (reachedBy[b] == n) continue;
+				reachedBy[b] = n;
+				depth[b] = depth[a] + 1;
+				queue[tail++] = b;
+			}
+		}
+
+		// Store the atoms reached (excluding the central one) in order of index
+		std::sort(queue.array()+1, queue.array()+tail);
+		for (k=1; k<tail; ++k)
+		{
+			partners_.add(queue[k]);
+			distances_.add(depth[queue[k]]);
+		}
+	}
+	offsets_[nAtoms_] = partners_.nItems();
+	vdwScales_.createEmpty(partners_.nItems(), 1.0);
+	elecScales_.createEmpty(partners_.nItems(), 1.0);
+
+	Messenger::print(Messenger::Verbose, "Exclusion list for %i atoms (%i fragments) contains %i entries (%f per atom).", nAtoms_, nFragments, partners_.nItems(), double(partners_.nItems()) / nAtoms_);
+
+	Messenger::exit("ExclusionList::initialise");
+}
+
+// Return whether the list has been initialised
+bool ExclusionList::isInitialised() const
+{
+	return initialised_;
+}
+
+// Return number of atoms covered by the list
+int ExclusionList::nAtoms() const
+{
+	return nAtoms_;
+}
+
+// Return number of entries in the list
+int ExclusionList::nEntries() const
+{
+	return partners_.nItems();
+}
+
+// Return connectivity distance between atoms (0 if they are not bound, maximum distance + 1 if beyond the list)
+int ExclusionList::connectivity(int i, int j) const
+{
+	if ((i == j) || (fragments_.value(i) != fragments_.value(j))) return 0;
+	int index = entry(i, j);
+	return (index == -1 ? maxDistance_+1 : distances_.value(index));
+}
+
+// Reset all scale factors to 1.0
+void ExclusionList::resetScales()
+{
+	for (int n=0; n<vdwScales_.nItems(); ++n)
+	{
+		vdwScales_[n] = 1.0;
+		elecScales_[n] = 1.0;
+	}
+}
+
+// Set scale factors for the specified pair (if it is in the list)
+void ExclusionList::setScales(int i, int j, double vdwScale, double elecScale)
+{
+	int index = entry(i, j);
+	if (index != -1)
+	{
+		vdwScales_[index] = vdwScale;
+		elecScales_[index] = elecScale;
+	}
+	index = entry(j, i);
+	if (index != -1)
+	{
+		vdwScales_[index] = vdwScale;
+		elecScales_[index] = elecScale;
+	}
+}
+
+// Return VDW scale factor for the specified pair
+double ExclusionList::vdwScale(int i, int j) const
+{
+	int index = entry(i, j);
+	return (index == -1 ? 1.0 : vdwScales_.value(index));
+}
+
+// Return electrostatic scale factor for the specified pair
+double ExclusionList::elecScale(int i, int j) const
+{
+	int index = entry(i, j);
+	return (index == -1 ? 1.0 : elecScales_.value(index));
+}
+
+// Return index of the first entry for the specified atom
+int ExclusionList::firstEntry(int i) const
+{
+	return offsets_.value(i);
+}
+
+// Return index after the last entry for the specified atom
+int ExclusionList::endEntry(int i) const
+{
+	return offsets_.value(i+1);
+}
+
+// Return partner atom of specified entry
+int ExclusionList::entryPartner(int index) const
+{
+	return partners_.value(index);
+}
+
+// Return connectivity distance of specified entry
+int ExclusionList::entryDistance(int index) const
+{
+	return distances_.value(index);
+}
+
+// Return electrostatic scale factor of specified entry
+double ExclusionList::entryElecScale(int index) const
+{
+	return elecScales_.value(index);
+}
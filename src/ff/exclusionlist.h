@@ -0,0 +1,100 @@
+/*
+	*** Sparse exclusion list
+	*** src/ff/exclusionlist.h
+	Copyright T. Youngs 2007-2017
+
+	This file is part of Aten.
+
+	Aten is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Aten is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Aten.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef ATEN_EXCLUSIONLIST_H
+#define ATEN_EXCLUSIONLIST_H
+
+#include "templates/array.h"
+#include "base/namespace.h"
+
+ATEN_BEGIN_NAMESPACE
+
+// Forward Declarations (Aten)
+class Atom;
+
+// Exclusion List
+// Stores, for each atom in a molecule, the other atoms within a limited number of bonds of it, along with their
+// connectivity distance and the factors by which their VDW and electrostatic interactions are scaled. Pairs which are
+// further apart are not stored, so memory use grows with the number of atoms rather than its square.
+class ExclusionList
+{
+	public:
+	// Constructor
+	ExclusionList();
+
+
+	/*
+	 * Data
+	 */
+	private:
+	// Whether the list has been initialised
+	bool initialised_;
+	// Number of atoms covered by the list
+	int nAtoms_;
+	// Maximum connectivity distance stored
+	int maxDistance_;
+	// Bound fragment to which each atom belongs
+	Array<int> fragments_;
+	// Index of the first entry for each atom (plus one extra marking the end of the last atom's entries)
+	Array<int> offsets_;
+	// Partner atom and connectivity distance of each entry, sorted by partner within each atom
+	Array<int> partners_, distances_;
+	// VDW and electrostatic scale factors of each entry
+	Array<double> vdwScales_, elecScales_;
+	// Return entry for the specified pair, or -1 if it is not in the list
+	int entry(int i, int j) const;
+
+	public:
+	// Clear the list
+	void clear();
+	// Build the list from the bonding of the atoms starting at the one supplied, storing pairs up to the distance specified
+	void initialise(Atom* firstAtom, int nAtoms, int maxDistance);
+	// Return whether the list has been initialised
+	bool isInitialised() const;
+	// Return number of atoms covered by the list
+	int nAtoms() const;
+	// Return number of entries in the list
+	int nEntries() const;
+	// Return connectivity distance between atoms (0 if they are not bound, maximum distance + 1 if beyond the list)
+	int connectivity(int i, int j) const;
+	// Reset all scale factors to 1.0
+	void resetScales();
+	// Set scale factors for the specified pair (if it is in the list)
+	void setScales(int i, int j, double vdwScale, double elecScale);
+	// Return VDW scale factor for the specified pair
+	double vdwScale(int i, int j) const;
+	// Return electrostatic scale factor for the specified pair
+	double elecScale(int i, int j) const;
+	// Return index of the first entry for the specified atom
+	int firstEntry(int i) const;
+	// Return index after the last entry for the specified atom
+	int endEntry(int i) const;
+	// Return partner atom of specified entry
+	int entryPartner(int index) const;
+	// Return connectivity distance of specified entry
+	int entryDistance(int index) const;
+	// Return electrostatic scale factor of specified entry
+	double entryElecScale(int index) const;
+};
+
+ATEN_END_NAMESPACE
+
+#endif
@@ -26,7 +26,7 @@
 ATEN_USING_NAMESPACE
 
 // Electrostatic model
-const char* ElecMethodKeywords[Electrostatics::nElectrostatics] = { "none", "coulomb", "ewald", "ewaldauto" };
+const char* ElecMethodKeywords[Electrostatics::nElectrostatics] = { "none", "coulomb", "ewald", "ewaldauto", "spme" };
 const char* Electrostatics::elecMethod(Electrostatics::ElecMethod em)
 {
 	return ElecMethodKeywords[em];
@@ -139,7 +139,7 @@ class TorsionFunctions
 namespace Electrostatics
 {
 	// Electrostatic model
-	enum ElecMethod { None, Coulomb, Ewald, EwaldAuto, nElectrostatics };
+	enum ElecMethod { None, Coulomb, Ewald, EwaldAuto, Spme, nElectrostatics };
 	const char* elecMethod(ElecMethod em);
 	ElecMethod elecMethod(QString s, bool reportError = false);
 }
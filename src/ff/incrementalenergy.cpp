@@ -0,0 +1,521 @@
+/*
+	*** Incremental molecule energy
+	*** src/ff/incrementalenergy.cpp
+	Copyright T. Youngs 2007-2017
+
+	This file is part of Aten.
+
+	Aten is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Aten is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Aten.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "ff/incrementalenergy.h"
+#include "base/forcefieldatom.h"
+#include "base/pattern.h"
+#include "base/prefs.h"
+#include "math/mathfunc.h"
+#include "model/model.h"
+
+ATEN_USING_NAMESPACE
+
+// Calculate energy for specified interaction (defined in ff/vdw.cpp)
+double VdwEnergy(VdwFunctions::VdwFunction type, double rij, double* params, int i, int j);
+
+// Constructor
+IncrementalEnergy::IncrementalEnergy()
+{
+	sourceModel_ = NULL;
+	nAtoms_ = 0;
+	nMolecules_ = 0;
+	elecMethod_ = Electrostatics::None;
+	calculateVdw_ = false;
+	vdwCutoff_ = 0.0;
+	elecCutoff_ = 0.0;
+	alpha_ = 0.0;
+	trialMolecule_ = -1;
+	trialVdw_ = 0.0;
+	trialElec_ = 0.0;
+	trialReciprocal_ = 0.0;
+}
+
+// Destructor
+IncrementalEnergy::~IncrementalEnergy()
+{
+}
+
+/*
+ * System Data
+ */
+
+// Initialise data for supplied model, which must already have a valid energy expression
+bool IncrementalEnergy::initialise(Model* sourceModel)
+{
+	Messenger::enter("IncrementalEnergy::initialise");
+
+	sourceModel_ = sourceModel;
+	nAtoms_ = sourceModel_->nAtoms();
+	calculateVdw_ = prefs.calculateVdw();
+	vdwCutoff_ = prefs.vdwCutoff();
+	elecCutoff_ = prefs.elecCutoff();
+	elecMethod_ = prefs.electrostaticsMethod();
+	if ((elecMethod_ == Electrostatics::Ewald) || (elecMethod_ == Electrostatics::EwaldAuto) || (elecMethod_ == Electrostatics::Spme))
+	{
+		// Only valid for a periodic system...
+		if (sourceModel_->cell().type() == UnitCell::NoCell)
+		{
+			Messenger::print("Error: Ewald sum is not applicable to non-periodic models.");
+			Messenger::exit("IncrementalEnergy::initialise");
+			return false;
+		}
+		if (elecMethod_ != Electrostatics::Ewald) prefs.estimateEwaldParameters(sourceModel_->cell());
+		alpha_ = prefs.ewaldAlpha();
+	}
+
+	// Store atom data
+	Atom** modelAtoms = sourceModel_->atomArray();
+	positions_.createEmpty(nAtoms_);
+	charges_.createEmpty(nAtoms_);
+	types_.createEmpty(nAtoms_, NULL);
+	atomMolecule_.createEmpty(nAtoms_, -1);
+	moleculeStart_.clear();
+	int i, m, offset;
+	for (i=0; i<nAtoms_; ++i)
+	{
+		positions_[i] = modelAtoms[i]->r();
+		charges_[i] = modelAtoms[i]->charge();
+	}
+	for (Pattern* p = sourceModel_->patterns(); p != NULL; p = p->next)
+	{
+		for (m=0; m<p->nMolecules(); ++m)
+		{
+			offset = p->offset(m);
+			i = 0;
+			for (PatternAtom* pa = p->atoms(); pa != NULL; pa = pa->next)
+			{
+				types_[offset+i] = pa->data();
+				atomMolecule_[offset+i] = moleculeStart_.nItems();
+				++i;
+			}
+			moleculeStart_.add(offset);
+		}
+	}
+	nMolecules_ = moleculeStart_.nItems();
+	moleculeStart_.add(nAtoms_);
+
+	// Check that all atoms belong to a molecule
+	for (i=0; i<nAtoms_; ++i) if (atomMolecule_[i] == -1)
+	{
+		Messenger::print("Error: Atom %i is not covered by any pattern.", i+1);
+		Messenger::exit("IncrementalEnergy::initialise");
+		return false;
+	}
+
+	// Setup cells and reciprocal space data
+	initialiseCells();
+	kVectors_.clear();
+	kFactors_.clear();
+	if ((elecMethod_ == Electrostatics::Ewald) || (elecMethod_ == Electrostatics::EwaldAuto) || (elecMethod_ == Electrostatics::Spme)) initialiseReciprocal();
+
+	// Calculate initial energies of all molecules
+	partnerVdw_.createEmpty(nMolecules_, 0.0);
+	partnerElec_.createEmpty(nMolecules_, 0.0);
+	partnerTouched_.createEmpty(nMolecules_, false);
+	partners_.clear();
+	moleculeVdw_.createEmpty(nMolecules_, 0.0);
+	moleculeElec_.createEmpty(nMolecules_, 0.0);
+	for (m=0; m<nMolecules_; ++m)
+	{
+		trialMolecule_ = m;
+		pairEnergy(true, 0.0, moleculeVdw_[m], moleculeElec_[m]);
+	}
+	trialMolecule_ = -1;
+
+	Messenger::print(Messenger::Verbose, "Incremental energy initialised for %i molecules, %i x %i x %i cells, %i reciprocal vectors.", nMolecules_, nCells_.x, nCells_.y, nCells_.z, kVectors_.nItems());
+
+	Messenger::exit("IncrementalEnergy::initialise");
+	return true;
+}
+
+// Return cached intermolecular (VDW + electrostatic) energy of specified molecule in pattern
+double IncrementalEnergy::moleculeEnergy(Pattern* p, int molecule) const
+{
+	int m = atomMolecule_.value(p->offset(molecule));
+	return moleculeVdw_.value(m) + moleculeElec_.value(m);
+}
+
+/*
+ * Linked Cells
+ */
+
+// Return cell index for supplied position
+int IncrementalEnergy::cellIndex(const Vec3<double>& r) const
+{
+	Vec3<int> index;
+
+	// Non-periodic system - positions outside the cells are placed in the nearest one along each axis
+	if (sourceModel_->cell().type() == UnitCell::NoCell)
+	{
+		for (int axis=0; axis<3; ++axis)
+		{
+			index[axis] = int(floor((r.get(axis) - cellOrigin_.get(axis)) / cellWidth_.get(axis)));
+			if (index[axis] < 0) index[axis] = 0;
+			else if (index[axis] >= nCells_.get(axis)) index[axis] = nCells_.get(axis) - 1;
+		}
+		return (index.x*nCells_.y + index.y)*nCells_.z + index.z;
+	}
+
+	Matrix rcell = sourceModel_->cell().reciprocal();
+	double frac;
+	for (int axis=0; axis<3; ++axis)
+	{
+		frac = rcell.columnAsVec3(axis).dp(r);
+		frac -= floor(frac);
+		index[axis] = int(frac * nCells_.get(axis));
+		if (index[axis] >= nCells_.get(axis)) index[axis] = nCells_.get(axis) - 1;
+	}
+	return (index.x*nCells_.y + index.y)*nCells_.z + index.z;
+}
+
+// Return whether supplied position lies within the cells (always true for periodic systems)
+bool IncrementalEnergy::isInsideCells(const Vec3<double>& r) const
+{
+	if (sourceModel_->cell().type() != UnitCell::NoCell) return true;
+	for (int axis=0; axis<3; ++axis)
+	{
+		if (r.get(axis) < cellOrigin_.get(axis)) return false;
+		if (r.get(axis) > cellOrigin_.get(axis) + nCells_.get(axis)*cellWidth_.get(axis)) return false;
+	}
+	return true;
+}
+
+// Add atom to specified cell
+void IncrementalEnergy::addToCell(int i, int cell)
+{
+	cellNext_[i] = cellHead_[cell];
+	cellHead_[cell] = i;
+	atomCell_[i] = cell;
+}
+
+// Remove atom from its current cell
+void IncrementalEnergy::removeFromCell(int i)
+{
+	int cell = atomCell_[i];
+	if (cellHead_[cell] == i) cellHead_[cell] = cellNext_[i];
+	else
+	{
+		int j = cellHead_[cell];
+		while (cellNext_[j] != i) j = cellNext_[j];
+		cellNext_[j] = cellNext_[i];
+	}
+	cellNext_[i] = -1;
+	atomCell_[i] = -1;
+}
+
+// Setup cells and bin all atoms
+void IncrementalEnergy::initialiseCells()
+{
+	// Determine number of cells along each axis - each must be at least as wide as the largest cutoff in use
+	nCells_.set(1,1,1);
+	double cutoff = 0.0;
+	if (calculateVdw_) cutoff = vdwCutoff_;
+	if ((elecMethod_ != Electrostatics::None) && (elecCutoff_ > cutoff)) cutoff = elecCutoff_;
+	if (sourceModel_->cell().type() == UnitCell::NoCell)
+	{
+		// No unit cell, so cover the bounding box of the atoms, plus a margin of one cutoff on each side so that molecules may move a little before the cells must be recreated
+		Vec3<double> minimum, maximum, extent;
+		if (nAtoms_ > 0) minimum = maximum = positions_[0];
+		for (int i=1; i<nAtoms_; ++i)
+		{
+			for (int axis=0; axis<3; ++axis)
+			{
+				if (positions_[i].get(axis) < minimum[axis]) minimum[axis] = positions_[i].get(axis);
+				else if (positions_[i].get(axis) > maximum[axis]) maximum[axis] = positions_[i].get(axis);
+			}
+		}
+		for (int axis=0; axis<3; ++axis)
+		{
+			cellOrigin_[axis] = minimum[axis] - cutoff;
+			extent[axis] = (maximum[axis] - minimum[axis]) + 2.0*cutoff;
+			if (cutoff > 0.0) nCells_[axis] = int(extent[axis] / cutoff);
+			if (nCells_[axis] < 1) nCells_[axis] = 1;
+		}
+
+		// Sparse systems could need far more cells than atoms, so limit the total number by making the cells wider
+		double nCellsMax = 8.0*nAtoms_ + 27.0, nCellsTotal = double(nCells_.x)*nCells_.y*nCells_.z;
+		if (nCellsTotal > nCellsMax)
+		{
+			double scale = pow(nCellsTotal / nCellsMax, 1.0/3.0);
+			for (int axis=0; axis<3; ++axis)
+			{
+				nCells_[axis] = int(nCells_[axis] / scale);
+				if (nCells_[axis] < 1) nCells_[axis] = 1;
+			}
+		}
+		for (int axis=0; axis<3; ++axis) cellWidth_[axis] = (extent[axis] > 0.0 ? extent[axis] / nCells_[axis] : 1.0);
+	}
+	else
+	{
+		Matrix rcell = sourceModel_->cell().reciprocal();
+		for (int axis=0; axis<3; ++axis)
+		{
+			// Perpendicular width of the cell along this axis is the reciprocal of the reciprocal vector length
+			if (cutoff > 0.0) nCells_[axis] = int( (1.0 / rcell.columnAsVec3(axis).magnitude()) / cutoff);
+			if (nCells_[axis] < 1) nCells_[axis] = 1;
+		}
+	}
+
+	// Construct list of neighbouring cell offsets - if there are fewer than three cells along an axis, search all cells along it (once)
+	int x, y, z;
+	Vec3<int> minOffset, maxOffset;
+	for (int axis=0; axis<3; ++axis)
+	{
+		minOffset[axis] = (nCells_[axis] < 3 ? 0 : -1);
+		maxOffset[axis] = (nCells_[axis] < 3 ? nCells_[axis]-1 : 1);
+	}
+	cellOffsets_.clear();
+	for (x=minOffset.x; x<=maxOffset.x; ++x)
+		for (y=minOffset.y; y<=maxOffset.y; ++y)
+			for (z=minOffset.z; z<=maxOffset.z; ++z) cellOffsets_.add(Vec3<int>(x,y,z));
+
+	// Bin atoms
+	cellHead_.createEmpty(nCells_.x*nCells_.y*nCells_.z, -1);
+	cellNext_.createEmpty(nAtoms_, -1);
+	atomCell_.createEmpty(nAtoms_, -1);
+	for (int i=nAtoms_-1; i>=0; --i) addToCell(i, cellIndex(positions_[i]));
+}
+
+/*
+ * Reciprocal Space
+ */
+
+// Setup reciprocal vectors and calculate structure factors
+void IncrementalEnergy::initialiseReciprocal()
+{
+	// Determine reciprocal vector cutoff in the same way as the standard Ewald sum
+	UnitCell& cell = sourceModel_->cell();
+	Matrix rcell = cell.reciprocal();
+	Vec3<int> kVec = prefs.ewaldKMax();
+	double rvolume = cell.reciprocalVolume();
+	Vec3<double> cross_ab = rcell.columnAsVec3(0) * rcell.columnAsVec3(1);
+	Vec3<double> cross_bc = rcell.columnAsVec3(1) * rcell.columnAsVec3(2);
+	Vec3<double> cross_ca = rcell.columnAsVec3(2) * rcell.columnAsVec3(0);
+	Vec3<double> perpl(rvolume / cross_ab.magnitude(), rvolume / cross_bc.magnitude(), rvolume / cross_ca.magnitude());
+	perpl.x *= kVec.x;
+	perpl.y *= kVec.y;
+	perpl.z *= kVec.z;
+	double cutoffsq = perpl.min() * 1.05 * TWOPI;
+	cutoffsq *= cutoffsq;
+
+	// Generate half-space of reciprocal vectors (the other half is accounted for by doubling the prefactor)
+	int kx, ky, kz, i, n;
+	double magsq, factor = 2.0 * rvolume * TWOPI * prefs.elecConvert();
+	Vec3<double> k;
+	for (kx=0; kx<=kVec.x; ++kx)
+	for (ky=-kVec.y; ky<=kVec.y; ++ky)
+	for (kz=-kVec.z; kz<=kVec.z; ++kz)
+	{
+		if ((kx == 0) && ((ky < 0) || ((ky == 0) && (kz <= 0)))) continue;
+		k.set(kx,ky,kz);
+		k = (rcell * TWOPI) * k;
+		magsq = k.magnitudeSq();
+		if (magsq > cutoffsq) continue;
+		kVectors_.add(k);
+		kFactors_.add(factor * exp(-magsq/(4.0*alpha_*alpha_)) / magsq);
+	}
+
+	// Calculate structure factors
+	double kr;
+	sumCos_.createEmpty(kVectors_.nItems(), 0.0);
+	sumSin_.createEmpty(kVectors_.nItems(), 0.0);
+	deltaCos_.createEmpty(kVectors_.nItems(), 0.0);
+	deltaSin_.createEmpty(kVectors_.nItems(), 0.0);
+	for (n=0; n<kVectors_.nItems(); ++n)
+	{
+		for (i=0; i<nAtoms_; ++i)
+		{
+			if (charges_[i] == 0.0) continue;
+			kr = kVectors_[n].dp(positions_[i]);
+			sumCos_[n] += charges_[i] * cos(kr);
+			sumSin_[n] += charges_[i] * sin(kr);
+		}
+	}
+}
+
+// Calculate change in reciprocal energy for moving atoms of the trial molecule from their stored positions to those in the model
+double IncrementalEnergy::reciprocalDelta()
+{
+	int i, n;
+	double delta = 0.0, krOld, krNew;
+	Atom** modelAtoms = sourceModel_->atomArray();
+	const int start = moleculeStart_[trialMolecule_], finish = moleculeStart_[trialMolecule_+1];
+	for (n=0; n<kVectors_.nItems(); ++n)
+	{
+		deltaCos_[n] = 0.0;
+		deltaSin_[n] = 0.0;
+		for (i=start; i<finish; ++i)
+		{
+			if (charges_[i] == 0.0) continue;
+			krOld = kVectors_[n].dp(positions_[i]);
+			krNew = kVectors_[n].dp(modelAtoms[i]->r());
+			deltaCos_[n] += charges_[i] * (cos(krNew) - cos(krOld));
+			deltaSin_[n] += charges_[i] * (sin(krNew) - sin(krOld));
+		}
+		// |S + dS|**2 - |S|**2
+		delta += kFactors_[n] * (deltaCos_[n]*(2.0*sumCos_[n] + deltaCos_[n]) + deltaSin_[n]*(2.0*sumSin_[n] + deltaSin_[n]));
+	}
+	return delta;
+}
+
+/*
+ * Trial Moves
+ */
+
+// Calculate pair energies between the trial molecule (at stored or current model positions) and all other molecules, accumulating per partner (multiplied by the supplied weight) if it is non-zero
+void IncrementalEnergy::pairEnergy(bool useStoredPositions, double partnerWeight, double& vdw, double& elec)
+{
+	int i, j, n, partner, centralCell, cell;
+	Vec3<int> cellPos, neighbourPos;
+	Vec3<double> ri;
+	double rij, U, qq;
+	PointerPair<ForcefieldAtom,double>* pp;
+	UnitCell& unitCell = sourceModel_->cell();
+	Atom** modelAtoms = sourceModel_->atomArray();
+	bool ewald = ((elecMethod_ == Electrostatics::Ewald) || (elecMethod_ == Electrostatics::EwaldAuto) || (elecMethod_ == Electrostatics::Spme));
+	bool periodic = (unitCell.type() != UnitCell::NoCell);
+	const int start = moleculeStart_[trialMolecule_], finish = moleculeStart_[trialMolecule_+1];
+
+	vdw = 0.0;
+	elec = 0.0;
+	for (i=start; i<finish; ++i)
+	{
+		ri = (useStoredPositions ? positions_[i] : modelAtoms[i]->r());
+		centralCell = cellIndex(ri);
+		cellPos.set(centralCell / (nCells_.y*nCells_.z), (centralCell / nCells_.z) % nCells_.y, centralCell % nCells_.z);
+		for (n=0; n<cellOffsets_.nItems(); ++n)
+		{
+			// Cells wrap around in periodic systems, but there is nothing beyond the outermost cells otherwise (offsets along axes with fewer than three cells always wrap, since they cover every cell)
+			neighbourPos = cellPos + cellOffsets_[n];
+			if (!periodic)
+			{
+				if ((nCells_.x > 2) && ((neighbourPos.x < 0) || (neighbourPos.x >= nCells_.x))) continue;
+				if ((nCells_.y > 2) && ((neighbourPos.y < 0) || (neighbourPos.y >= nCells_.y))) continue;
+				if ((nCells_.z > 2) && ((neighbourPos.z < 0) || (neighbourPos.z >= nCells_.z))) continue;
+			}
+			cell = ((neighbourPos.x + nCells_.x) % nCells_.x) * nCells_.y;
+			cell = (cell + (neighbourPos.y + nCells_.y) % nCells_.y) * nCells_.z;
+			cell += (neighbourPos.z + nCells_.z) % nCells_.z;
+			for (j = cellHead_[cell]; j != -1; j = cellNext_[j])
+			{
+				partner = atomMolecule_[j];
+				if (partner == trialMolecule_) continue;
+				rij = unitCell.mimVector(ri, positions_[j]).magnitude();
+
+				// VDW
+				U = 0.0;
+				if (calculateVdw_ && (rij <= vdwCutoff_))
+				{
+					pp = sourceModel_->combinedParameters(types_[i], types_[j]);
+					if (pp != NULL) U = VdwEnergy(types_[i]->vdwForm(), rij, pp->data(), i, j);
+				}
+
+				// Electrostatics (real-space only, for Ewald-based methods)
+				qq = 0.0;
+				if ((elecMethod_ != Electrostatics::None) && (rij <= elecCutoff_))
+				{
+					qq = charges_[i] * charges_[j] / rij;
+					if (ewald) qq *= AtenMath::erfc(alpha_*rij);
+					qq *= prefs.elecConvert();
+				}
+
+				vdw += U;
+				elec += qq;
+
+				// Accumulate per-partner energies
+				if (partnerWeight != 0.0)
+				{
+					if (!partnerTouched_[partner])
+					{
+						partnerTouched_[partner] = true;
+						partners_.add(partner);
+					}
+					partnerVdw_[partner] += partnerWeight * U;
+					partnerElec_[partner] += partnerWeight * qq;
+				}
+			}
+		}
+	}
+}
+
+// Calculate change in energy if the specified molecule were moved to its current position in the model, returning the VDW and electrostatic components
+double IncrementalEnergy::trialMove(Pattern* p, int molecule, double& deltaVdw, double& deltaElec)
+{
+	trialMolecule_ = atomMolecule_[p->offset(molecule)];
+
+	// Pair interactions of molecule at its new position
+	pairEnergy(false, 0.0, trialVdw_, trialElec_);
+
+	// Change in reciprocal space energy
+	trialReciprocal_ = (kVectors_.nItems() > 0 ? reciprocalDelta() : 0.0);
+
+	deltaVdw = trialVdw_ - moleculeVdw_[trialMolecule_];
+	deltaElec = trialElec_ - moleculeElec_[trialMolecule_] + trialReciprocal_;
+	return deltaVdw + deltaElec;
+}
+
+// Accept the last trial move, updating all stored data
+void IncrementalEnergy::acceptMove()
+{
+	if (trialMolecule_ == -1) return;
+
+	// Update cached energies of partner molecules - remove interactions at the old position, and add those at the new
+	int n, partner;
+	double vdw, elec;
+	pairEnergy(true, -1.0, vdw, elec);
+	pairEnergy(false, 1.0, vdw, elec);
+	for (n=0; n<partners_.nItems(); ++n)
+	{
+		partner = partners_[n];
+		moleculeVdw_[partner] += partnerVdw_[partner];
+		moleculeElec_[partner] += partnerElec_[partner];
+		partnerVdw_[partner] = 0.0;
+		partnerElec_[partner] = 0.0;
+		partnerTouched_[partner] = false;
+	}
+	partners_.clear();
+	moleculeVdw_[trialMolecule_] = trialVdw_;
+	moleculeElec_[trialMolecule_] = trialElec_;
+
+	// Update structure factors
+	for (n=0; n<kVectors_.nItems(); ++n)
+	{
+		sumCos_[n] += deltaCos_[n];
+		sumSin_[n] += deltaSin_[n];
+	}
+
+	// Store new positions and move atoms between cells as necessary - if any atom has left the region covered by the cells (non-periodic systems only) recreate them
+	Atom** modelAtoms = sourceModel_->atomArray();
+	int cell;
+	bool outside = false;
+	for (int i=moleculeStart_[trialMolecule_]; i<moleculeStart_[trialMolecule_+1]; ++i)
+	{
+		positions_[i] = modelAtoms[i]->r();
+		if (!isInsideCells(positions_[i])) outside = true;
+		cell = cellIndex(positions_[i]);
+		if (cell == atomCell_[i]) continue;
+		removeFromCell(i);
+		addToCell(i, cell);
+	}
+	if (outside) initialiseCells();
+
+	trialMolecule_ = -1;
+}
@@ -0,0 +1,156 @@
+/*
+	*** Incremental molecule energy
+	*** src/ff/incrementalenergy.h
+	Copyright T. Youngs 2007-2017
+
+	This file is part of Aten.
+
+	Aten is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Aten is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Aten.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef ATEN_INCREMENTALENERGY_H
+#define ATEN_INCREMENTALENERGY_H
+
+#include "templates/vector3.h"
+#include "templates/array.h"
+#include "ff/forms.h"
+#include "base/namespace.h"
+
+ATEN_BEGIN_NAMESPACE
+
+// Forward Declarations (Aten)
+class Model;
+class Pattern;
+class ForcefieldAtom;
+
+// Incremental Molecule Energy
+// Maintains the intermolecular energy of every molecule in a model, along with the reciprocal-space structure factors
+// for Ewald-based electrostatics, so that the energy change arising from a rigid move of a single molecule may be
+// calculated without reference to the rest of the system.
+class IncrementalEnergy
+{
+	public:
+	// Constructor / Destructor
+	IncrementalEnergy();
+	~IncrementalEnergy();
+
+
+	/*
+	 * System Data
+	 */
+	private:
+	// Model for which the data was initialised
+	Model* sourceModel_;
+	// Number of atoms and molecules in the model
+	int nAtoms_, nMolecules_;
+	// Electrostatic method in use
+	Electrostatics::ElecMethod elecMethod_;
+	// Whether to calculate VDW interactions
+	bool calculateVdw_;
+	// Cutoffs, and Ewald convergence parameter
+	double vdwCutoff_, elecCutoff_, alpha_;
+	// Current (accepted) atomic positions
+	Array< Vec3<double> > positions_;
+	// Charges of atoms
+	Array<double> charges_;
+	// Forcefield types of atoms
+	Array<ForcefieldAtom*> types_;
+	// Global molecule index of each atom
+	Array<int> atomMolecule_;
+	// Index of first atom of each molecule
+	Array<int> moleculeStart_;
+	// Cached intermolecular energy of each molecule (VDW and electrostatic components)
+	Array<double> moleculeVdw_, moleculeElec_;
+
+	public:
+	// Initialise data for supplied model, which must already have a valid energy expression
+	bool initialise(Model* sourceModel);
+	// Return cached intermolecular (VDW + electrostatic) energy of specified molecule in pattern
+	double moleculeEnergy(Pattern* p, int molecule) const;
+
+
+	/*
+	 * Linked Cells
+	 */
+	private:
+	// Number of cells along each cell axis
+	Vec3<int> nCells_;
+	// Origin and width of cells along each Cartesian axis (non-periodic systems only)
+	Vec3<double> cellOrigin_, cellWidth_;
+	// Cell offsets to search around a central cell
+	Array< Vec3<int> > cellOffsets_;
+	// First atom in each cell (or -1)
+	Array<int> cellHead_;
+	// Next atom in the same cell as each atom (or -1)
+	Array<int> cellNext_;
+	// Cell in which each atom currently resides
+	Array<int> atomCell_;
+	// Return cell index for supplied position
+	int cellIndex(const Vec3<double>& r) const;
+	// Return whether supplied position lies within the cells (always true for periodic systems)
+	bool isInsideCells(const Vec3<double>& r) const;
+	// Add atom to specified cell
+	void addToCell(int i, int cell);
+	// Remove atom from its current cell
+	void removeFromCell(int i);
+	// Setup cells and bin all atoms
+	void initialiseCells();
+
+
+	/*
+	 * Reciprocal Space
+	 */
+	private:
+	// Reciprocal vectors (half-space) included in the sum
+	Array< Vec3<double> > kVectors_;
+	// Prefactors for each reciprocal vector
+	Array<double> kFactors_;
+	// Current structure factors (cos and sin parts) for each reciprocal vector
+	Array<double> sumCos_, sumSin_;
+	// Change in structure factors for the current trial move
+	Array<double> deltaCos_, deltaSin_;
+	// Setup reciprocal vectors and calculate structure factors
+	void initialiseReciprocal();
+	// Calculate change in reciprocal energy for moving atoms of the trial molecule from their stored positions to those in the model
+	double reciprocalDelta();
+
+
+	/*
+	 * Trial Moves
+	 */
+	private:
+	// Molecule subject to the current trial move
+	int trialMolecule_;
+	// New intermolecular energy of the trial molecule (VDW and electrostatic components)
+	double trialVdw_, trialElec_;
+	// Change in reciprocal energy for the trial move
+	double trialReciprocal_;
+	// Per-molecule energies accumulated in pair sums
+	Array<double> partnerVdw_, partnerElec_;
+	// Whether each molecule has been touched in pair sums, and list of those touched
+	Array<bool> partnerTouched_;
+	Array<int> partners_;
+	// Calculate pair energies between the trial molecule (at stored or current model positions) and all other molecules, accumulating per partner (multiplied by the supplied weight) if it is non-zero
+	void pairEnergy(bool useStoredPositions, double partnerWeight, double& vdw, double& elec);
+
+	public:
+	// Calculate change in energy if the specified molecule were moved to its current position in the model, returning the VDW and electrostatic components
+	double trialMove(Pattern* p, int molecule, double& deltaVdw, double& deltaElec);
+	// Accept the last trial move, updating all stored data
+	void acceptMove();
+};
+
+ATEN_END_NAMESPACE
+
+#endif
@@ -0,0 +1,401 @@
+/*
+	*** Neighbour list
+	*** src/ff/neighbourlist.cpp
+	Copyright T. Youngs 2007-2017
+
+	This file is part of Aten.
+
+	Aten is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Aten is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Aten.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "ff/neighbourlist.h"
+#include "model/model.h"
+#include "base/prefs.h"
+
+ATEN_USING_NAMESPACE
+
+// Constructor
+NeighbourList::NeighbourList()
+{
+	// Private variables
+	periodic_ = false;
+	nCellsTotal_ = 0;
+	skin_ = 0.0;
+	verletListValid_ = false;
+	sourceModel_ = NULL;
+	nAtoms_ = 0;
+	cutoff_ = 0.0;
+	nBuilds_ = 0;
+
+	// Scratch arrays grow in modest increments
+	cellOffsets_.setChunkIncrement(SMALLCHUNKSIZE);
+}
+
+// Destructor
+NeighbourList::~NeighbourList()
+{
+}
+
+/*
+ * Linked Cells
+ */
+
+// Setup cell structure for supplied model and list radius
+void NeighbourList::initialiseCells(Model* sourceModel, double radius)
+{
+	Messenger::enter("NeighbourList::initialiseCells");
+
+	UnitCell& cell = sourceModel->cell();
+	AtomStore& store = sourceModel->atomStore();
+	int n, x, y, z;
+	Vec3<int> lower, upper;
+	Vec3<double> width;
+
+	periodic_ = (cell.type() != UnitCell::NoCell);
+	if (periodic_)
+	{
+		// Work in fractional coordinates, dividing each axis into cells whose perpendicular width is at least 'radius'
+		axes_ = cell.axes();
+		inverse_ = cell.inverse();
+		for (n=0; n<3; ++n)
+		{
+			// Perpendicular width of the cell along this axis is the reciprocal of the length of the corresponding row of the inverse
+			width[n] = 1.0 / inverse_.rowAsVec3(n).magnitude();
+			nCells_[n] = (int) floor(width[n] / radius);
+			if (nCells_[n] < 1) nCells_[n] = 1;
+		}
+	}
+	else
+	{
+		// Determine extent of atoms and divide into cells with sides no smaller than 'radius'
+		Vec3<double> minima, maxima;
+		if (store.nAtoms() > 0) minima = maxima = store.r(0);
+		for (n=1; n<store.nAtoms(); ++n)
+		{
+			Vec3<double> r = store.r(n);
+			for (x=0; x<3; ++x)
+			{
+				if (r.get(x) < minima.get(x)) minima[x] = r.get(x);
+				else if (r.get(x) > maxima.get(x)) maxima[x] = r.get(x);
+			}
+		}
+		origin_ = minima;
+		for (n=0; n<3; ++n)
+		{
+			width[n] = maxima[n] - minima[n];
+			nCells_[n] = (int) floor(width[n] / radius);
+			if (nCells_[n] < 1) nCells_[n] = 1;
+		}
+	}
+
+	// In large, sparse systems (e.g. slabs with a lot of vacuum) limit the number of cells to a small multiple of the number of atoms.
+	// Larger cells remain valid, since the search reach is determined from the actual cell widths below.
+	double maxCells = 8.0 * store.nAtoms() + 27.0, nCells = double(nCells_.x) * nCells_.y * nCells_.z;
+	if (nCells > maxCells)
+	{
+		double scale = cbrt(nCells / maxCells);
+		for (n=0; n<3; ++n)
+		{
+			nCells_[n] = (int) (nCells_[n] / scale);
+			if (nCells_[n] < 1) nCells_[n] = 1;
+		}
+	}
+
+	// Apply user limit on the number of cells along each axis (if any)
+	int maxCellsPerAxis = prefs.maxCuboids();
+	if (maxCellsPerAxis > 0) for (n=0; n<3; ++n) if (nCells_[n] > maxCellsPerAxis) nCells_[n] = maxCellsPerAxis;
+
+	for (n=0; n<3; ++n)
+	{
+		if (periodic_)
+		{
+			cellReach_[n] = (int) ceil(radius * nCells_[n] / width[n] - 1.0e-8);
+			if (cellReach_[n] < 1) cellReach_[n] = 1;
+		}
+		else
+		{
+			cellSize_[n] = width[n] / nCells_[n];
+			if (cellSize_[n] < radius) cellSize_[n] = radius;
+			cellReach_[n] = 1;
+		}
+	}
+	nCellsTotal_ = nCells_.x * nCells_.y * nCells_.z;
+
+	// Store grid positions of cells
+	cellPosition_.createEmpty(nCellsTotal_);
+	n = 0;
+	for (x=0; x<nCells_.x; ++x)
+		for (y=0; y<nCells_.y; ++y)
+			for (z=0; z<nCells_.z; ++z) cellPosition_[n++].set(x, y, z);
+
+	// Construct list of integer cell offsets to search around each cell.
+	// If the reach along an axis would wrap round onto itself, search every cell along that axis exactly once instead.
+	for (n=0; n<3; ++n)
+	{
+		if (periodic_ && ((2*cellReach_[n]+1) >= nCells_[n]))
+		{
+			lower[n] = 0;
+			upper[n] = nCells_[n] - 1;
+		}
+		else
+		{
+			lower[n] = -cellReach_[n];
+			upper[n] = cellReach_[n];
+		}
+	}
+	cellOffsets_.forgetData();
+	for (x=lower.x; x<=upper.x; ++x)
+		for (y=lower.y; y<=upper.y; ++y)
+			for (z=lower.z; z<=upper.z; ++z) cellOffsets_.add(Vec3<int>(x, y, z));
+
+	Messenger::print(Messenger::Verbose, "Neighbour list uses %i x %i x %i cells (%i offsets searched per cell).", nCells_.x, nCells_.y, nCells_.z, cellOffsets_.nItems());
+
+	Messenger::exit("NeighbourList::initialiseCells");
+}
+
+// Return cell index of supplied coordinates
+int NeighbourList::cellIndex(const Vec3<double>& r) const
+{
+	Vec3<double> s;
+	Vec3<int> gridPos;
+	if (periodic_)
+	{
+		s = inverse_.transform(r);
+		s.x -= floor(s.x);
+		s.y -= floor(s.y);
+		s.z -= floor(s.z);
+		gridPos.set(int(s.x*nCells_.x), int(s.y*nCells_.y), int(s.z*nCells_.z));
+	}
+	else
+	{
+		s = r - origin_;
+		gridPos.set(int(s.x/cellSize_.x), int(s.y/cellSize_.y), int(s.z/cellSize_.z));
+	}
+
+	// Guard against rounding at the upper edges
+	for (int n=0; n<3; ++n)
+	{
+		if (gridPos[n] >= nCells_.get(n)) gridPos[n] = nCells_.get(n) - 1;
+		else if (gridPos[n] < 0) gridPos[n] = 0;
+	}
+
+	return (gridPos.x*nCells_.y + gridPos.y)*nCells_.z + gridPos.z;
+}
+
+// Return cell index of supplied grid position, or -1 if it is outside a non-periodic grid
+int NeighbourList::cellIndex(int x, int y, int z) const
+{
+	if (periodic_)
+	{
+		x %= nCells_.x;
+		if (x < 0) x += nCells_.x;
+		y %= nCells_.y;
+		if (y < 0) y += nCells_.y;
+		z %= nCells_.z;
+		if (z < 0) z += nCells_.z;
+	}
+	else if ((x < 0) || (x >= nCells_.x) || (y < 0) || (y >= nCells_.y) || (z < 0) || (z >= nCells_.z)) return -1;
+
+	return (x*nCells_.y + y)*nCells_.z + z;
+}
+
+// Sort atoms into cells
+void NeighbourList::binAtoms(Model* sourceModel)
+{
+	Messenger::enter("NeighbourList::binAtoms");
+
+	AtomStore& store = sourceModel->atomStore();
+	double* x = store.x(), *y = store.y(), *z = store.z();
+	int n, cell;
+
+	// Counting sort of atoms by cell index
+	atomCell_.createEmpty(nAtoms_);
+	cellStart_.createEmpty(nCellsTotal_+1, 0);
+	cellAtoms_.createEmpty(nAtoms_);
+	int* atomCell = atomCell_.array();
+	int* cellStart = cellStart_.array();
+	for (n=0; n<nAtoms_; ++n)
+	{
+		atomCell[n] = cellIndex(Vec3<double>(x[n], y[n], z[n]));
+		++cellStart[atomCell[n]+1];
+	}
+	for (cell=0; cell<nCellsTotal_; ++cell) cellStart[cell+1] += cellStart[cell];
+	Array<int> position(cellStart_);
+	for (n=0; n<nAtoms_; ++n) cellAtoms_[position[atomCell[n]]++] = n;
+
+	Messenger::exit("NeighbourList::binAtoms");
+}
+
+/*
+ * Verlet List
+ */
+
+// Build Verlet list from current cell structure
+void NeighbourList::buildVerletList(Model* sourceModel)
+{
+	Messenger::enter("NeighbourList::buildVerletList");
+
+	AtomStore& store = sourceModel->atomStore();
+	double* x = store.x(), *y = store.y(), *z = store.z();
+	UnitCell& cell = sourceModel->cell();
+	double radiusSq = (cutoff_ + skin_) * (cutoff_ + skin_);
+	Vec3<double> ri;
+	Array<int> candidates;
+	candidates.setChunkIncrement(MEDIUMCHUNKSIZE);
+	int i, n, j;
+
+	verletListValid_ = false;
+	verletStart_.createEmpty(nAtoms_+1, 0);
+	verletNeighbours_.forgetData();
+	referencePositions_.createEmpty(nAtoms_);
+	for (i=0; i<nAtoms_; ++i)
+	{
+		ri.set(x[i], y[i], z[i]);
+		referencePositions_[i] = ri;
+		candidates.forgetData();
+		neighbours(i, candidates);
+		for (n=0; n<candidates.nItems(); ++n)
+		{
+			j = candidates[n];
+			if (cell.mimVector(ri, Vec3<double>(x[j], y[j], z[j])).magnitudeSq() <= radiusSq) verletNeighbours_.add(j);
+		}
+		verletStart_[i+1] = verletNeighbours_.nItems();
+	}
+	verletListValid_ = true;
+
+	Messenger::print(Messenger::Verbose, "Verlet list contains %i neighbours (%f per atom).", verletNeighbours_.nItems(), nAtoms_ > 0 ? double(verletNeighbours_.nItems()) / nAtoms_ : 0.0);
+
+	Messenger::exit("NeighbourList::buildVerletList");
+}
+
+// Return whether any atom has moved far enough to require a rebuild of the Verlet list
+bool NeighbourList::atomsMovedTooFar(Model* sourceModel) const
+{
+	AtomStore& store = sourceModel->atomStore();
+	double* x = store.x(), *y = store.y(), *z = store.z();
+	UnitCell& cell = sourceModel->cell();
+	double limitSq = 0.25 * skin_ * skin_;
+	for (int i=0; i<nAtoms_; ++i) if (cell.mimVector(referencePositions_.value(i), Vec3<double>(x[i], y[i], z[i])).magnitudeSq() > limitSq) return true;
+	return false;
+}
+
+/*
+ * Definition
+ */
+
+// Prepare list for the supplied model, rebuilding if required
+void NeighbourList::prepare(Model* sourceModel, double cutoff, double skin)
+{
+	Messenger::enter("NeighbourList::prepare");
+
+	if (skin < 0.0) skin = 0.0;
+
+	// If a Verlet list is in use and nothing important has changed, we only rebuild if atoms have moved more than half the skin
+	bool rebuild = true;
+	if ((skin > 0.0) && (skin == skin_) && (sourceModel == sourceModel_) && (sourceModel->nAtoms() == nAtoms_) && (cutoff == cutoff_))
+	{
+		Matrix axes = sourceModel->cell().axes();
+		bool sameCell = true;
+		for (int n=0; n<16; ++n) if (axes[n] != cellAxes_[n]) sameCell = false;
+		if (sameCell && (!atomsMovedTooFar(sourceModel))) rebuild = false;
+	}
+
+	if (rebuild)
+	{
+		sourceModel_ = sourceModel;
+		nAtoms_ = sourceModel->nAtoms();
+		cutoff_ = cutoff;
+		skin_ = skin;
+		cellAxes_ = sourceModel->cell().axes();
+		verletListValid_ = false;
+		initialiseCells(sourceModel, cutoff_ + skin_);
+		binAtoms(sourceModel);
+		if (skin_ > 0.0) buildVerletList(sourceModel);
+		++nBuilds_;
+	}
+
+	Messenger::exit("NeighbourList::prepare");
+}
+
+// Invalidate list, forcing a rebuild on the next call to prepare()
+void NeighbourList::invalidate()
+{
+	sourceModel_ = NULL;
+	nAtoms_ = 0;
+}
+
+// Return whether a Verlet list is in use
+bool NeighbourList::usesVerletList() const
+{
+	return verletListValid_;
+}
+
+// Return number of times the list has been (re)built
+int NeighbourList::nBuilds() const
+{
+	return nBuilds_;
+}
+
+// Return number of atoms in the list
+int NeighbourList::nAtoms() const
+{
+	return nAtoms_;
+}
+
+// Return cell index in which specified atom resides
+int NeighbourList::atomCell(int i) const
+{
+	return atomCell_.value(i);
+}
+
+// Get candidate neighbours of atom i (not including i itself), appending to supplied array
+void NeighbourList::neighbours(int i, Array<int>& result) const
+{
+	neighbours(i, 0, nAtoms_-1, result);
+}
+
+// Get candidate neighbours of atom i whose indices lie within the range specified (inclusive), appending to supplied array
+void NeighbourList::neighbours(int i, int firstAtom, int lastAtom, Array<int>& result) const
+{
+	int n, m, cell, j, last;
+
+	// Use Verlet list if it is available
+	if (verletListValid_)
+	{
+		last = verletStart_.value(i+1);
+		for (n=verletStart_.value(i); n<last; ++n)
+		{
+			j = verletNeighbours_.value(n);
+			if ((j >= firstAtom) && (j <= lastAtom)) result.add(j);
+		}
+		return;
+	}
+
+	// Loop over neighbouring cells of atom i
+	Vec3<int> centre = cellPosition_.value(atomCell_.value(i));
+	Vec3<int> offset;
+	for (m=0; m<cellOffsets_.nItems(); ++m)
+	{
+		offset = cellOffsets_.value(m);
+		cell = cellIndex(centre.x + offset.x, centre.y + offset.y, centre.z + offset.z);
+		if (cell == -1) continue;
+		last = cellStart_.value(cell+1);
+		for (n=cellStart_.value(cell); n<last; ++n)
+		{
+			j = cellAtoms_.value(n);
+			if ((j == i) || (j < firstAtom) || (j > lastAtom)) continue;
+			result.add(j);
+		}
+	}
+}
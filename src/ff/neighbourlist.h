@@ -0,0 +1,136 @@
+/*
+	*** Neighbour list
+	*** src/ff/neighbourlist.h
+	Copyright T. Youngs 2007-2017
+
+	This file is part of Aten.
+
+	Aten is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Aten is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Aten.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef ATEN_NEIGHBOURLIST_H
+#define ATEN_NEIGHBOURLIST_H
+
+#include "templates/vector3.h"
+#include "templates/array.h"
+#include "math/matrix.h"
+#include "base/namespace.h"
+
+ATEN_BEGIN_NAMESPACE
+
+// Forward Declarations (Aten)
+class Model;
+
+// Neighbour List
+class NeighbourList
+{
+	public:
+	// Constructor / Destructor
+	NeighbourList();
+	~NeighbourList();
+
+
+	/*
+	 * Linked Cells
+	 */
+	private:
+	// Whether the cell structure was built for a periodic system
+	bool periodic_;
+	// Number of cells along each (cell) axis
+	Vec3<int> nCells_;
+	// Total number of cells
+	int nCellsTotal_;
+	// Number of cells to search either side of a cell along each axis
+	Vec3<int> cellReach_;
+	// Axes and inverse used to convert positions into cell coordinates
+	Matrix axes_, inverse_;
+	// Origin and size of cells (non-periodic systems only)
+	Vec3<double> origin_, cellSize_;
+	// Integer offsets of neighbouring cells (including the central cell) to search
+	Array< Vec3<int> > cellOffsets_;
+	// Index of first atom of each cell in cellAtoms_ (nCellsTotal_+1 entries)
+	Array<int> cellStart_;
+	// Atom indices, sorted by cell
+	Array<int> cellAtoms_;
+	// Cell index of each atom
+	Array<int> atomCell_;
+	// Grid position of each cell
+	Array< Vec3<int> > cellPosition_;
+	// Setup cell structure for supplied model and list radius
+	void initialiseCells(Model* sourceModel, double radius);
+	// Sort atoms into cells
+	void binAtoms(Model* sourceModel);
+	// Return cell index of supplied coordinates
+	int cellIndex(const Vec3<double>& r) const;
+	// Return cell index of supplied grid position, or -1 if it is outside a non-periodic grid
+	int cellIndex(int x, int y, int z) const;
+
+
+	/*
+	 * Verlet List
+	 */
+	private:
+	// Skin distance applied to the cutoff radius (zero for a pure cell list)
+	double skin_;
+	// Whether the Verlet list is complete and may be used
+	bool verletListValid_;
+	// Index of first neighbour of each atom in verletNeighbours_ (nAtoms_+1 entries)
+	Array<int> verletStart_;
+	// Neighbours of all atoms, listed consecutively
+	Array<int> verletNeighbours_;
+	// Atomic positions at which the Verlet list was last built
+	Array< Vec3<double> > referencePositions_;
+	// Build Verlet list from current cell structure
+	void buildVerletList(Model* sourceModel);
+	// Return whether any atom has moved far enough to require a rebuild of the Verlet list
+	bool atomsMovedTooFar(Model* sourceModel) const;
+
+
+	/*
+	 * Definition
+	 */
+	private:
+	// Model for which the list was last built
+	Model* sourceModel_;
+	// Number of atoms in the list
+	int nAtoms_;
+	// Cutoff radius for which the list was built
+	double cutoff_;
+	// Cell axes for which the list was built
+	Matrix cellAxes_;
+	// Number of times the list has been (re)built
+	int nBuilds_;
+
+	public:
+	// Prepare list for the supplied model, rebuilding if required
+	void prepare(Model* sourceModel, double cutoff, double skin);
+	// Invalidate list, forcing a rebuild on the next call to prepare()
+	void invalidate();
+	// Return whether a Verlet list is in use
+	bool usesVerletList() const;
+	// Return number of times the list has been (re)built
+	int nBuilds() const;
+	// Return number of atoms in the list
+	int nAtoms() const;
+	// Return cell index in which specified atom resides
+	int atomCell(int i) const;
+	// Get candidate neighbours of atom i (not including i itself), appending to supplied array
+	void neighbours(int i, Array<int>& result) const;
+	// Get candidate neighbours of atom i whose indices lie within the range specified (inclusive), appending to supplied array
+	void neighbours(int i, int firstAtom, int lastAtom, Array<int>& result) const;
+};
+
+ATEN_END_NAMESPACE
+
+#endif
@@ -27,18 +27,20 @@
 ATEN_USING_NAMESPACE
 
 // Torsion energy
-void Pattern::torsionEnergy(Model* srcmodel, EnergyStore* estore, int molecule)
+void Pattern::torsionEnergy(Model* srcmodel, EnergyStore* estore, int molecule, int firstMolecule, int lastMolecule)
 {
 	// Calculate the energy of the torsions in this pattern with coordinates from *xcfg
 	Messenger::enter("Pattern::torsionEnergy");
 	int i,j,k,l,aoff,m1;
-	static double k0, k1, k2, k3, k4, k5, k6, k7, k8, k9, eq, phi, energy, period, s, chi;
+	double k0, k1, k2, k3, k4, k5, k6, k7, k8, k9, eq, phi, energy, period, s, chi;
 	PatternBound* pb;
 	ForcefieldBound* ffb;
 	Vec3<double> vecij, veckj;
 	energy = 0.0;
-	aoff = (molecule == -1 ? startAtom_ : startAtom_ + molecule*nAtoms_);
-	for (m1=(molecule == -1 ? 0 : molecule); m1<(molecule == -1 ? nMolecules_ : molecule + 1); m1++)
+	if (molecule != -1) firstMolecule = lastMolecule = molecule;
+	else if (lastMolecule == -1) lastMolecule = nMolecules_-1;
+	aoff = startAtom_ + firstMolecule*nAtoms_;
+	for (m1=firstMolecule; m1<=lastMolecule; m1++)
 	{
 		for (pb = torsions_.first(); pb != NULL; pb = pb->next)
 		{
@@ -156,22 +158,23 @@ Matrix make_cp_mat(Vec3<double>& v)
 }
 
 // Torsion forces
-void Pattern::torsionForces(Model* srcmodel)
+void Pattern::torsionForces(Model* srcmodel, Vec3<double>* forces, int firstMolecule, int lastMolecule)
 {
 	// Calculate force contributions from the torsions in this pattern with coordinates from *xcfg
 	Messenger::enter("Pattern::torsionForces");
 	int i,j,k,l,aoff,m1;
-	static Vec3<double> vec_ji, vec_jk, vec_kl, xpj, xpk, dcos_dxpj, dcos_dxpk, temp;
+	Vec3<double> vec_ji, vec_jk, vec_kl, xpj, xpk, dcos_dxpj, dcos_dxpk, temp;
 	Matrix dxpj_dij, dxpj_dkj, dxpk_dkj, dxpk_dlk;
-	static double phi, dp, forcek, period, eq, mag_ji, mag_jk, mag_kl, mag_xpj, mag_xpk, du_dphi, dphi_dcosphi;
-	static Vec3<double> fi, fj, fk, fl;
+	double phi, dp, forcek, period, eq, mag_ji, mag_jk, mag_kl, mag_xpj, mag_xpk, du_dphi, dphi_dcosphi;
+	Vec3<double> fi, fj, fk, fl;
 	ForcefieldBound* ffb;
-	static double k1, k2, k3, k4, s;
+	double k1, k2, k3, k4, s;
 	PatternBound* pb;
 	Atom** modelatoms = srcmodel->atomArray();
 	UnitCell& cell = srcmodel->cell();
-	aoff = startAtom_;
-	for (m1=0; m1<nMolecules_; m1++)
+	if (lastMolecule == -1) lastMolecule = nMolecules_-1;
+	aoff = startAtom_ + firstMolecule*nAtoms_;
+	for (m1=firstMolecule; m1<=lastMolecule; m1++)
 	{
 		for (pb = torsions_.first(); pb != NULL; pb = pb->next)
 		{
@@ -291,6 +294,7 @@ void Pattern::torsionForces(Model* srcmodel)
 					break;
 				default:
 					printf("No equation coded for torsion force of type '%s'.\n",  TorsionFunctions::functionData[ffb->torsionForm()].name);
+					du_dphi = 0.0;
 					break;
 			}
 // 			printf("i-j-k-l %i-%i-%i-%i %f %f %f\n",i,j,k,l, phi, dphi_dcosphi, du_dphi);
@@ -311,10 +315,10 @@ void Pattern::torsionForces(Model* srcmodel)
 			fl.y = -du_dphi * dcos_dxpk.dp(dxpk_dlk.columnAsVec3(1));
 			fl.z = -du_dphi * dcos_dxpk.dp(dxpk_dlk.columnAsVec3(2));
 
-			modelatoms[i]->f() -= fi;
-			modelatoms[j]->f() -= fj;
-			modelatoms[k]->f() -= fk;
-			modelatoms[l]->f() -= fl;
+			forces[i] -= fi;
+			forces[j] -= fj;
+			forces[k] -= fk;
+			forces[l] -= fl;
 
 		}
 		aoff += nAtoms_;
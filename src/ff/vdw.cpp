@@ -25,180 +25,127 @@
 #include "ff/forms.h"
 #include "ff/forcefield.h"
 #include "base/pattern.h"
+#include "ff/neighbourlist.h"
+#include "ff/vdwkernels.h"
 
 ATEN_USING_NAMESPACE
 
 // Calculate energy for specified interaction
 double VdwEnergy(VdwFunctions::VdwFunction type, double rij, double* params, int i, int j)
 {
-	static double U, epsilon, sigma, sigmar2, sigmar6, r6, ar12, br6, pwr, a, b, c, d, forcek, eq, expo;
-	switch (type)
+	if (type == VdwFunctions::None)
 	{
-		case (VdwFunctions::None):
-			Messenger::print("Warning: No function is specified for vdW energy %i-%i.", i, j);
-			U = 0.0;
-			break;
-		case (VdwFunctions::InversePower):
-			// U = epsilon * (r / rij) ** n
-			epsilon = params[VdwFunctions::InversePowerEpsilon];
-			sigma = params[VdwFunctions::InversePowerR];
-			pwr = params[VdwFunctions::InversePowerN];
-			U = epsilon * pow(sigma / rij, pwr);
-			break;
-		case (VdwFunctions::Lj):
-		case (VdwFunctions::LjGeometric):
-			// U = 4 * epsilon * [ (s/rij)**12 - (s/rij)**6 ]
-			epsilon = params[VdwFunctions::LjEpsilon];
-			sigma = params[VdwFunctions::LjSigma];
-			sigmar2 = sigma / rij;
-			sigmar2 *= sigmar2;
-			sigmar6 = sigmar2 * sigmar2 * sigmar2;
-			U = 4.0 * epsilon * (sigmar6*sigmar6 - sigmar6);
-			break;
-		case (VdwFunctions::LjAB):
-			// U = A/r**12 - B/r**6
-			a = params[VdwFunctions::LjA];
-			b = params[VdwFunctions::LjB];
-			r6 = rij * rij * rij;
-			r6 *= r6;
-			ar12 = a / (r6 * r6);
-			br6 = b / r6;
-			U = ar12 - br6;
-			break;
-		case (VdwFunctions::Buckingham):
-			// U = A * exp(-rij/B) - C/(rij**6)
-			a = params[VdwFunctions::BuckinghamA];
-			b = params[VdwFunctions::BuckinghamB];
-			c = params[VdwFunctions::BuckinghamC];
-			r6 = rij * rij * rij;
-			r6 *= r6;
-			U = a * exp(-rij/b) - c/r6;
-			break;
-		case (VdwFunctions::Morse):
-			// U = E0 * ( (1 - exp( -k(rij - r0) ) )**2 - 1)
-			d = params[VdwFunctions::MorseD];
-			forcek = params[VdwFunctions::MorseK];
-			eq = params[VdwFunctions::MorseEq];
-			expo = 1.0 - exp( -forcek * (rij-eq) );
-			U = d * ( expo*expo - 1.0);
-			break;
-		default:
-			Messenger::print("Internal Error: Energy calculation for VDW form '%s' not present.", VdwFunctions::functionData[type].keyword);
-			break;
+		Messenger::print("Warning: No function is specified for vdW energy %i-%i.", i, j);
+		return 0.0;
 	}
-	return U;
+	else if (!VdwKernels::hasKernel(type))
+	{
+		Messenger::print("Internal Error: Energy calculation for VDW form '%s' not present.", VdwFunctions::functionData[type].keyword);
+		return 0.0;
+	}
+	return VdwKernels::energy(type, rij, params);
 }
 
 // Calculate forces for specified interaction (return force on atom i)
 Vec3<double> VdwForces(VdwFunctions::VdwFunction type, Vec3<double> vecij, double rij, double* params, int i, int j)
 {
-	static double du_dr, epsilon, sigma, sigmar2, sigmar6, r2, r6, ar12, br6, a, b, c, d, pwr, forcek, expo, eq;
-	static Vec3<double> fi;
-	switch (type)
+	if (type == VdwFunctions::None)
+	{
+		Messenger::print("Warning: No function is specified for vdW forces %i-%i.", i, j);
+		return Vec3<double>();
+	}
+	else if (!VdwKernels::hasKernel(type))
 	{
-		case (VdwFunctions::None):
-			Messenger::print("Warning: No function is specified for vdW forces %i-%i.", i, j);
-			du_dr = 0.0;
-			break;
-		case (VdwFunctions::InversePower):
-			// dU/dr = -n * epsilon * (sigma / r)**(n-1) * (sigma/ r**2)
-			epsilon = params[VdwFunctions::InversePowerEpsilon];
-			sigma = params[VdwFunctions::InversePowerR];
-			pwr = params[VdwFunctions::InversePowerN];
-			du_dr = -pwr * epsilon * pow(sigma / rij, (pwr - 1.0)) * (sigma / (rij*rij));
-			break;
-		case (VdwFunctions::Lj):
-		case (VdwFunctions::LjGeometric):
-			// dU/dr = 48 * epsilon * ( sigma**12/r**13 - 0.5 * sigma**6/r**7)
-			epsilon = params[VdwFunctions::LjEpsilon];
-			sigma = params[VdwFunctions::LjSigma];
-			sigmar2 = (sigma / rij);
-			sigmar2 *= sigmar2;
-			sigmar6 = sigmar2 * sigmar2 * sigmar2;
-			du_dr = 48.0*epsilon * sigmar6 * (-sigmar6 + 0.5) / rij;
-			break;
-		case (VdwFunctions::LjAB):
-			// dU/dr = -12*(A/r**13) + 6*(B/r**7)
-			a = params[VdwFunctions::LjA];
-			b = params[VdwFunctions::LjB];
-			r6 = rij * rij * rij;
-			r6 *= r6;
-			ar12 = a / (r6 * r6);
-			br6 = b / r6;
-			du_dr = (6.0 * br6 - 12.0 * ar12) / rij;
-			break;
-		case (VdwFunctions::Buckingham):
-			// dU/dr = A * exp(-rij/B) / B + 6.0 * C/(rij**7)
-			a = params[VdwFunctions::BuckinghamA];
-			b = params[VdwFunctions::BuckinghamB];
-			c = params[VdwFunctions::BuckinghamC];
-			r2 = rij * rij;
-			r6 = r2 * r2 * r2;
-			du_dr = -a * exp(-rij/b) / b + 6.0 * c/(r6 * rij);
-			break;
-		case (VdwFunctions::Morse):
-			// dU/dr = 2.0 * k * E0 * (1 - exp( -k(rij - r0) ) ) * exp( -k*(rij - r0) )
-			d = params[VdwFunctions::MorseD];
-			forcek = params[VdwFunctions::MorseK];
-			eq = params[VdwFunctions::MorseEq];
-			expo = exp( -forcek * (rij - eq) );
-			du_dr = 2.0 * forcek * d * (1.0 - expo) * expo;
-			break;
-		default:
-			Messenger::print("Internal Error: Force calculation for VDW form '%s' not present.", VdwFunctions::functionData[type].keyword);
-			break;
+		Messenger::print("Internal Error: Force calculation for VDW form '%s' not present.", VdwFunctions::functionData[type].keyword);
+		return Vec3<double>();
 	}
 	// Calculate final forces (vecij contains dx, dy, dz between target atoms)
-	du_dr = -du_dr;
+	double du_dr = -VdwKernels::derivative(type, rij, params);
 	return (vecij * du_dr / rij);
 }
 
+// Prepare batch for the interactions of atom i, returning whether pairs should be added with tables rather than parameters
+bool prepareVdwBatch(VdwBatch& batch, ForcefieldAtom* ffi, Model* parent)
+{
+	VdwFunctions::VdwFunction form = ffi->vdwForm();
+	bool tabulated = parent->hasVdwTables() && VdwTable::isTabulated(form);
+	batch.clear(form, tabulated);
+	return tabulated;
+}
+
+// Add pair to batch, finding the relevant (pre-combined) parameters or table for the types involved
+void addVdwPair(VdwBatch& batch, bool tabulated, Model* parent, ForcefieldAtom* ffi, ForcefieldAtom* ffj, double rij, const Vec3<double>& vecij, int j, double scale = 1.0)
+{
+	if (tabulated)
+	{
+		VdwTable* table = parent->vdwTable(ffi, ffj);
+		if (table != NULL) batch.add(rij, vecij, NULL, table, j, scale);
+	}
+	else
+	{
+		PointerPair<ForcefieldAtom,double>* pp = parent->combinedParameters(ffi, ffj);
+		if (pp != NULL) batch.add(rij, vecij, pp->data(), NULL, j, scale);
+	}
+}
+
 // Intrapattern VDW energy
-bool Pattern::vdwIntraPatternEnergy(Model* srcmodel, EnergyStore* estore, int lonemolecule)
+bool Pattern::vdwIntraPatternEnergy(Model* srcmodel, EnergyStore* estore, int lonemolecule, int firstMolecule, int lastMolecule)
 {
 	// Calculate the internal VDW contributions with coordinates from *xcfg
 	// Consider only the intrapattern interactions between atoms in individual molecules within the pattern.
+	// Candidate pairs are taken from the source model's neighbour list, restricted to the molecule containing atom i.
+	// Pairs within the cutoff are collected for each atom i and passed to the kernel for its functional form in one go.
 	Messenger::enter("Pattern::vdwIntraPatternEnergy");
-	int aoff, m1, i, j, start1, finish1, con;
+	int aoff, m1, i, j, n, start1, finish1, con;
 	Vec3<double> vec_ij;
 	double U, rij, energy_inter, energy_intra, cutoff;
-	PatternAtom* pai, *paj;
-	PointerPair<ForcefieldAtom,double>* pp;
+	bool tabulated;
+	VdwBatch batch;
+	Array<int> candidates;
+	candidates.setChunkIncrement(SMALLCHUNKSIZE);
 	cutoff = prefs.vdwCutoff();
-	Atom** modelatoms = srcmodel->atomArray();
+	AtomStore& store = srcmodel->atomStore();
+	double* x = store.x(), *y = store.y(), *z = store.z();
 	UnitCell& cell = srcmodel->cell();
+	NeighbourList& neighbourList = srcmodel->neighbourList();
+	PatternAtom** patoms = atoms_.array();
 	energy_inter = 0.0;
 	energy_intra = 0.0;
-	start1 = (lonemolecule == -1 ? 0 : lonemolecule);
-	finish1 = (lonemolecule == -1 ? nMolecules_ : lonemolecule+1);
+	start1 = (lonemolecule == -1 ? firstMolecule : lonemolecule);
+	finish1 = (lonemolecule == -1 ? (lastMolecule == -1 ? nMolecules_ : lastMolecule+1) : lonemolecule+1);
 	aoff = startAtom_ + start1*nAtoms_;
 	for (m1=start1; m1<finish1; m1++)
 	{
 		// Calculate energies of atom pairs that are unbound or separated by more than two bonds
 		// I.E. bound interactions up to and including angles are excluded. Torsions are scaled by the scale matrix.
-		i = -1;
-		for (pai = atoms_.first(); pai != atoms_.last(); pai = pai->next)
+		for (i=0; i<nAtoms_-1; ++i)
 		{
-			++i;
-			j = i;
-			for (paj = pai->next; paj != NULL; paj = paj->next)
+			// Only consider neighbours of i which lie later in the same molecule
+			candidates.forgetData();
+			neighbourList.neighbours(i+aoff, i+aoff+1, aoff+nAtoms_-1, candidates);
+			tabulated = prepareVdwBatch(batch, patoms[i]->data(), parent_);
+			for (n=0; n<candidates.nItems(); ++n)
 			{
-				++j;
-				con = conMatrix_[i][j];
+				j = candidates[n] - aoff;
+				con = exclusions_.connectivity(i, j);
 				if ((con > 2) || (con == 0))
 				{
 					// Check distance
-					vec_ij = cell.mimVector(modelatoms[i+aoff]->r(), modelatoms[j+aoff]->r());
+					vec_ij = cell.mimVector(Vec3<double>(x[i+aoff], y[i+aoff], z[i+aoff]), Vec3<double>(x[j+aoff], y[j+aoff], z[j+aoff]));
 					rij = vec_ij.magnitude();
 					if (rij > cutoff) continue;
-					// Find relevant (pre-combined) parameters
-					pp = parent_->combinedParameters(atoms_[i]->data(), atoms_[j]->data());
-					if (pp == NULL) break;
-					// Calculate the energy contribution
-					U = VdwEnergy(atoms_[i]->data()->vdwForm(), rij, pp->data(), i, j);
-					con == 0 ? energy_inter += U : energy_intra += (con == 3 ? U * vdwScaleMatrix_[i][j] : U);
+					addVdwPair(batch, tabulated, parent_, patoms[i]->data(), patoms[j]->data(), rij, vec_ij, j, con == 3 ? exclusions_.vdwScale(i, j) : 1.0);
 				}
 			}
+			if (batch.nPairs() == 0) continue;
+
+			// Calculate the energy contributions
+			batch.calculateEnergies();
+			for (n=0; n<batch.nPairs(); ++n)
+			{
+				U = batch.result(n) * batch.scale(n);
+				exclusions_.connectivity(i, batch.index(n)) == 0 ? energy_inter += U : energy_intra += U;
+			}
 		}
 		aoff += nAtoms_;
 	}
@@ -210,25 +157,34 @@ bool Pattern::vdwIntraPatternEnergy(Model* srcmodel, EnergyStore* estore, int lo
 }
 
 // Interpattern VDW energy
-bool Pattern::vdwInterPatternEnergy(Model* srcmodel, Pattern* otherPattern, EnergyStore* estore, int molId)
+bool Pattern::vdwInterPatternEnergy(Model* srcmodel, Pattern* otherPattern, EnergyStore* estore, int molId, int firstMolecule, int lastMolecule)
 {
 	// Calculate the VDW contribution to the energy from interactions between molecules of this pattern and the one supplied
+	// Candidate pairs are taken from the source model's neighbour list, restricted to atoms in 'otherPattern'.
 	Messenger::enter("Pattern::vdwInterPatternEnergy");
-	static int i,j,aoff1,aoff2,m1,m2,finish1,start1,start2,finish2;
-	static Vec3<double> vec_ij;
-	static double rij, energy_inter, cutoff, U;
-	PatternAtom* pai, *paj;
-	PointerPair<ForcefieldAtom,double>* pp;
+	int i, j, n, aoff1, m1, m2, finish1, start1;
+	Vec3<double> vec_ij;
+	double rij, energy_inter, cutoff;
+	bool tabulated;
+	VdwBatch batch;
+	Array<int> candidates;
+	candidates.setChunkIncrement(SMALLCHUNKSIZE);
 	cutoff = prefs.vdwCutoff();
-	Atom** modelatoms = srcmodel->atomArray();
+	AtomStore& store = srcmodel->atomStore();
+	double* x = store.x(), *y = store.y(), *z = store.z();
 	UnitCell& cell = srcmodel->cell();
+	NeighbourList& neighbourList = srcmodel->neighbourList();
+	PatternAtom** patoms = atoms_.array();
+	PatternAtom** otherpatoms = otherPattern->atoms_.array();
+	int otherStart = otherPattern->startAtom_, otherEnd = otherPattern->startAtom_ + otherPattern->totalAtoms_ - 1;
 	energy_inter = 0.0;
 	// Outer loop over molecules in *this* pattern
 	// When we are considering the same node with itself, calculate for "m1=1,T-1 m2=2,T"
 	if (molId == -1)
 	{
-		start1 = 0;
-		finish1 = (this == otherPattern ? nMolecules_ - 1 : nMolecules_);
+		start1 = firstMolecule;
+		finish1 = (lastMolecule == -1 ? nMolecules_ : lastMolecule+1);
+		if ((this == otherPattern) && (finish1 == nMolecules_)) finish1 = nMolecules_ - 1;
 	}
 	else
 	{
@@ -238,57 +194,36 @@ bool Pattern::vdwInterPatternEnergy(Model* srcmodel, Pattern* otherPattern, Ener
 	aoff1 = startAtom_ + start1 * nAtoms_;
 	for (m1=start1; m1<finish1; m1++)
 	{
-		// Inner loop - over *all* molecules in 'otherPattern'
-		if (this == otherPattern)
+		for (i=0; i<nAtoms_; ++i)
 		{
-			// Same pattern - if a specific molecule was given then we loop over all molecules.
-			// If not, loop over m1+1 to nMolecules_.
-			if (molId == -1)
-			{
-				start2 = m1 + 1;
-				finish2 = nMolecules_;
-			}
-			else
+			candidates.forgetData();
+			neighbourList.neighbours(i+aoff1, otherStart, otherEnd, candidates);
+			tabulated = prepareVdwBatch(batch, patoms[i]->data(), parent_);
+			for (n=0; n<candidates.nItems(); ++n)
 			{
-				start2 = 0;
-				finish2 = nMolecules_;
-			}
-		}
-		else
-		{
-			// Simple - go over all molecules in the dissimilar pattern
-			start2 = 0;
-			finish2 = otherPattern->nMolecules_;
-		}
+				// Determine molecule and local atom index in 'otherPattern'
+				j = candidates[n] - otherStart;
+				m2 = j / otherPattern->nAtoms_;
+				j -= m2 * otherPattern->nAtoms_;
 
-		//if (m1 == 0) printf("IPE - finish1 = %i, start2 = %i, finish2 = %i\n",finish1,start2,finish2);
-		aoff2 = otherPattern->startAtom_ + start2*otherPattern->nAtoms_;
-		//printf("  VDWINTER2 %i %i %i\n",start2,finish2,aoff2);
-		for (m2=start2; m2<finish2; m2++)
-		{
-			if ((this == otherPattern) && (molId == m2)) { aoff2 += nAtoms_; continue; }
-			//printf("      m1/m2=%i/%i  aoff1/aoff2=%i/%i \n",m1,m2,aoff1,aoff2);
-			i = -1;
-			for (pai = atoms_.first(); pai != NULL; pai = pai->next)
-			{
-				++i;
-				j = -1;
-				for (paj = otherPattern->atoms_.first(); paj != NULL; paj = paj->next)
+				// Same pattern - if a specific molecule was given then we consider all other molecules.
+				// If not, consider only molecules m1+1 to nMolecules_.
+				if (this == otherPattern)
 				{
-					++j;
-
-					vec_ij = cell.mimVector(modelatoms[i+aoff1]->r(), modelatoms[j+aoff2]->r());
-					rij = vec_ij.magnitude();
-					if (rij > cutoff) continue;
-					// Find relevant (pre-combined) parameters
-					pp = parent_->combinedParameters(atoms_[i]->data(), otherPattern->atoms_[j]->data());
-					if (pp == NULL) break;
-					// Calculate the energy contribution
-					U = VdwEnergy(atoms_[i]->data()->vdwForm(), rij, pp->data(), i, j);
-					energy_inter += U;
+					if ((molId == -1) && (m2 <= m1)) continue;
+					if (m2 == molId) continue;
 				}
+
+				vec_ij = cell.mimVector(Vec3<double>(x[i+aoff1], y[i+aoff1], z[i+aoff1]), Vec3<double>(x[candidates[n]], y[candidates[n]], z[candidates[n]]));
+				rij = vec_ij.magnitude();
+				if (rij > cutoff) continue;
+				addVdwPair(batch, tabulated, parent_, patoms[i]->data(), otherpatoms[j]->data(), rij, vec_ij, candidates[n]);
 			}
-			aoff2 += otherPattern->nAtoms_;
+			if (batch.nPairs() == 0) continue;
+
+			// Calculate the energy contributions
+			batch.calculateEnergies();
+			for (n=0; n<batch.nPairs(); ++n) energy_inter += batch.result(n);
 		}
 		aoff1 += nAtoms_;
 	}
@@ -298,7 +233,7 @@ bool Pattern::vdwInterPatternEnergy(Model* srcmodel, Pattern* otherPattern, Ener
 }
 
 // Intrapattern VDW forces
-bool Pattern::vdwIntraPatternForces(Model* srcmodel)
+bool Pattern::vdwIntraPatternForces(Model* srcmodel, Vec3<double>* forces, int firstMolecule, int lastMolecule)
 {
 	// Calculate the internal VDW contributions with coordinates from *xcfg
 	// Consider only the intrapattern interactions between atoms in individual molecules within the pattern.
@@ -306,49 +241,55 @@ bool Pattern::vdwIntraPatternForces(Model* srcmodel)
 	// arrays since assuming the pattern definition is correct then the sigmas/epsilons in molecule 0 represent
 	// those of all molecules.
 	Messenger::enter("Pattern::vdwIntraPatternForces");
-	int i,j,aoff,m1,con;
+	int i, j, n, aoff, m1, con;
 	Vec3<double> vec_ij, f_i, tempf;
 	double cutoff, rij;
-	PatternAtom* pai, *paj;
-	PointerPair<ForcefieldAtom,double>* pp;
+	bool tabulated;
+	VdwBatch batch;
+	Array<int> candidates;
+	candidates.setChunkIncrement(SMALLCHUNKSIZE);
 	cutoff = prefs.vdwCutoff();
-	Atom** modelatoms = srcmodel->atomArray();
+	AtomStore& store = srcmodel->atomStore();
+	double* x = store.x(), *y = store.y(), *z = store.z();
 	UnitCell& cell = srcmodel->cell();
-	aoff = startAtom_;
-	for (m1=0; m1<nMolecules_; m1++)
+	NeighbourList& neighbourList = srcmodel->neighbourList();
+	PatternAtom** patoms = atoms_.array();
+	if (lastMolecule == -1) lastMolecule = nMolecules_-1;
+	aoff = startAtom_ + firstMolecule*nAtoms_;
+	for (m1=firstMolecule; m1<=lastMolecule; m1++)
 	{
 		// Add contributions from atom pairs that are unbound or separated by more than three bonds
-		i = -1;
-		for (pai = atoms_.first(); pai != atoms_.last(); pai = pai->next)
+		for (i=0; i<nAtoms_-1; ++i)
 		{
-			i++;
-			// Store temporary forces to avoid unnecessary array lookups
-			f_i = modelatoms[i+aoff]->f();
-			j = i;
-			for (paj = pai->next; paj != NULL; paj = paj->next)
+			candidates.forgetData();
+			neighbourList.neighbours(i+aoff, i+aoff+1, aoff+nAtoms_-1, candidates);
+			tabulated = prepareVdwBatch(batch, patoms[i]->data(), parent_);
+			for (n=0; n<candidates.nItems(); ++n)
 			{
-				j++;
-				con = conMatrix_[i][j];
+				j = candidates[n] - aoff;
+				con = exclusions_.connectivity(i, j);
 				if ((con > 2) || (con == 0))
 				{
 					// Check distance
-					vec_ij = cell.mimVector(modelatoms[i+aoff]->r(), modelatoms[j+aoff]->r());
+					vec_ij = cell.mimVector(Vec3<double>(x[i+aoff], y[i+aoff], z[i+aoff]), Vec3<double>(x[j+aoff], y[j+aoff], z[j+aoff]));
 					rij = vec_ij.magnitude();
 					if (rij > cutoff) continue;
-
-					// Find relevant (pre-combined) parameters
-					pp = parent_->combinedParameters(atoms_[i]->data(), atoms_[j]->data());
-					if (pp == NULL) break;
-
-					// Calculate force contribution
-					tempf = VdwForces(atoms_[i]->data()->vdwForm(), vec_ij, rij, pp->data(), i, j);
-					if (con == 3) tempf *= vdwScaleMatrix_[i][j];
-					f_i -= tempf;
-					modelatoms[j+aoff]->f() += tempf;
+					addVdwPair(batch, tabulated, parent_, patoms[i]->data(), patoms[j]->data(), rij, vec_ij, j+aoff, con == 3 ? exclusions_.vdwScale(i, j) : 1.0);
 				}
 			}
+			if (batch.nPairs() == 0) continue;
+
+			// Calculate force contributions, storing temporary forces on i to avoid unnecessary array lookups
+			batch.calculateForceFactors();
+			f_i = forces[i+aoff];
+			for (n=0; n<batch.nPairs(); ++n)
+			{
+				tempf = batch.vector(n) * (batch.result(n) * batch.scale(n));
+				f_i -= tempf;
+				forces[batch.index(n)] += tempf;
+			}
 			// Put the temporary forces back into the main array
-			modelatoms[i+aoff]->f() = f_i;
+			forces[i+aoff] = f_i;
 		}
 		aoff += nAtoms_;
 	}
@@ -357,58 +298,65 @@ bool Pattern::vdwIntraPatternForces(Model* srcmodel)
 }
 
 // Interpattern VDW forces
-bool Pattern::vdwInterPatternForces(Model* srcmodel, Pattern* otherPattern)
+bool Pattern::vdwInterPatternForces(Model* srcmodel, Pattern* otherPattern, Vec3<double>* forces, int firstMolecule, int lastMolecule)
 {
 	// Calculate the VDW forces from interactions between different molecules
 	// of this pnode and the one supplied
 	Messenger::enter("Pattern::vdwInterPatternForces");
-	int i,j,aoff1,aoff2,m1,m2,start,finish;
+	int i, j, n, aoff1, m1, m2, finish;
 	Vec3<double> vec_ij, f_i, tempf;
 	double rij, cutoff;
-	PatternAtom* pai, *paj;
-	PointerPair<ForcefieldAtom,double>* pp;
+	bool tabulated;
+	VdwBatch batch;
+	Array<int> candidates;
+	candidates.setChunkIncrement(SMALLCHUNKSIZE);
 	cutoff = prefs.vdwCutoff();
-	Atom** modelatoms = srcmodel->atomArray();
+	AtomStore& store = srcmodel->atomStore();
+	double* x = store.x(), *y = store.y(), *z = store.z();
 	UnitCell& cell = srcmodel->cell();
-	aoff1 = startAtom_;
-	//printf("Pattern IDs are %i (this) and %i\n",id_, otherPattern->id_);
+	NeighbourList& neighbourList = srcmodel->neighbourList();
+	PatternAtom** patoms = atoms_.array();
+	PatternAtom** otherpatoms = otherPattern->atoms_.array();
+	int otherStart = otherPattern->startAtom_, otherEnd = otherPattern->startAtom_ + otherPattern->totalAtoms_ - 1;
+	aoff1 = startAtom_ + firstMolecule*nAtoms_;
 
-	// TODO Move loops so that we can load temporary forces for i then calculate all other forces on it in one go.
-	 // When we are considering the same node with itself, calculate for "m1=1,T-1 m2=2,T"
-        this == otherPattern ? finish = nMolecules_ - 1 : finish = nMolecules_;
-	for (m1=0; m1<finish; m1++)
+	// When we are considering the same node with itself, calculate for "m1=1,T-1 m2=2,T"
+	finish = (lastMolecule == -1 ? nMolecules_ : lastMolecule+1);
+	if ((this == otherPattern) && (finish == nMolecules_)) finish = nMolecules_ - 1;
+	for (m1=firstMolecule; m1<finish; m1++)
 	{
-		this == otherPattern ? start = m1 + 1 : start = 0;
-		aoff2 = otherPattern->startAtom_ + start*nAtoms_;
-		for (m2=start; m2<otherPattern->nMolecules_; m2++)
+		for (i=0; i<nAtoms_; ++i)
 		{
-			i = -1;
-			for (pai = atoms_.first(); pai != NULL; pai = pai->next)
+			candidates.forgetData();
+			neighbourList.neighbours(i+aoff1, otherStart, otherEnd, candidates);
+			tabulated = prepareVdwBatch(batch, patoms[i]->data(), parent_);
+			for (n=0; n<candidates.nItems(); ++n)
 			{
-				++i;
-				f_i = modelatoms[i+aoff1]->f();
-				j = -1;
-				for (paj = otherPattern->atoms_.first(); paj != NULL; paj = paj->next)
-				{
-					++j;
-					// Check distance and get vector j->i
-					vec_ij = cell.mimVector(modelatoms[i+aoff1]->r(), modelatoms[j+aoff2]->r());
-					rij = vec_ij.magnitude();
-					if (rij > cutoff) continue;
+				// Determine molecule and local atom index in 'otherPattern'
+				j = candidates[n] - otherStart;
+				m2 = j / otherPattern->nAtoms_;
+				j -= m2 * otherPattern->nAtoms_;
+				if ((this == otherPattern) && (m2 <= m1)) continue;
 
-					// Find relevant (pre-combined) parameters
-					pp = parent_->combinedParameters(atoms_[i]->data(), otherPattern->atoms_[j]->data());
-					if (pp == NULL) break;
+				// Check distance and get vector j->i
+				vec_ij = cell.mimVector(Vec3<double>(x[i+aoff1], y[i+aoff1], z[i+aoff1]), Vec3<double>(x[candidates[n]], y[candidates[n]], z[candidates[n]]));
+				rij = vec_ij.magnitude();
+				if (rij > cutoff) continue;
+				addVdwPair(batch, tabulated, parent_, patoms[i]->data(), otherpatoms[j]->data(), rij, vec_ij, candidates[n]);
+			}
+			if (batch.nPairs() == 0) continue;
 
-					// Calculate force contribution
-					tempf = VdwForces(atoms_[i]->data()->vdwForm(), vec_ij, rij, pp->data(), i, j);
-					f_i -= tempf;
-					modelatoms[j+aoff2]->f() += tempf;
-				}
-				// Store temporary force array back into main force array
-				modelatoms[i+aoff1]->f() = f_i;
+			// Load temporary forces for i then calculate all forces on it in one go
+			batch.calculateForceFactors();
+			f_i = forces[i+aoff1];
+			for (n=0; n<batch.nPairs(); ++n)
+			{
+				tempf = batch.vector(n) * batch.result(n);
+				f_i -= tempf;
+				forces[batch.index(n)] += tempf;
 			}
-			aoff2 += otherPattern->nAtoms_;
+			// Store temporary force array back into main force array
+			forces[i+aoff1] = f_i;
 		}
 		aoff1 += nAtoms_;
 	}
@@ -430,9 +378,9 @@ bool Pattern::vdwCorrectEnergy(UnitCell& cell, EnergyStore* estore)
 {
 	// Calculate the long-range correction to the VDW energy
 	Messenger::enter("Pattern::vdwCorrectEnergy");
-	static int i, j;
-	static Pattern* p1, *p2;
-	static double energy, rho, cutoff, du_dr, sigma, epsilon, sigmar3, sigmar9, volume, vrs;
+	int i, j;
+	Pattern* p1, *p2;
+	double energy, rho, cutoff, du_dr, sigma, epsilon, sigmar3, sigmar9, volume;
 	PatternAtom* pai, *paj;
 	double* paramsi, *paramsj;
 	PointerPair<ForcefieldAtom,double>* pp;
@@ -459,6 +407,7 @@ bool Pattern::vdwCorrectEnergy(UnitCell& cell, EnergyStore* estore)
 					j++;
 					paramsj = paj->data()->parameters();
 // 					CombinationRules::CombinationRule *crflags = VdwFunctions::functionData[p2->atoms_[j]->data()->vdwForm()].combinationRules;
+					du_dr = 0.0;
 					switch (p2->atoms_[j]->data()->vdwForm())
 					{
 						case (VdwFunctions::None):
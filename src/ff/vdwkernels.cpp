@@ -0,0 +1,438 @@
+/*
+	*** VDW pair kernels
+	*** src/ff/vdwkernels.cpp
+	Copyright T. Youngs 2007-2017
+
+	This file is part of Aten.
+
+	Aten is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Aten is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Aten.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "ff/vdwkernels.h"
+#include "base/messenger.h"
+#include <math.h>
+
+ATEN_USING_NAMESPACE
+
+/*
+ * Functional Forms
+ */
+
+// Each form provides the energy and derivative of a single pair as static members, which are inlined into the batch loops below
+
+// U = epsilon * (r / rij) ** n
+class InversePowerKernel
+{
+	public:
+	static double energy(double rij, const double* params)
+	{
+		return params[VdwFunctions::InversePowerEpsilon] * pow(params[VdwFunctions::InversePowerR] / rij, params[VdwFunctions::InversePowerN]);
+	}
+	// dU/dr = -n * U / rij
+	static double derivative(double rij, const double* params)
+	{
+		return -params[VdwFunctions::InversePowerN] * energy(rij, params) / rij;
+	}
+};
+
+// U = 4 * epsilon * [ (s/rij)**12 - (s/rij)**6 ]
+class LjKernel
+{
+	public:
+	static double energy(double rij, const double* params)
+	{
+		double sigmar2 = params[VdwFunctions::LjSigma] / rij;
+		sigmar2 *= sigmar2;
+		double sigmar6 = sigmar2 * sigmar2 * sigmar2;
+		return 4.0 * params[VdwFunctions::LjEpsilon] * (sigmar6*sigmar6 - sigmar6);
+	}
+	// dU/dr = 48 * epsilon * ( sigma**12/r**13 - 0.5 * sigma**6/r**7)
+	static double derivative(double rij, const double* params)
+	{
+		double sigmar2 = params[VdwFunctions::LjSigma] / rij;
+		sigmar2 *= sigmar2;
+		double sigmar6 = sigmar2 * sigmar2 * sigmar2;
+		return 48.0 * params[VdwFunctions::LjEpsilon] * sigmar6 * (0.5 - sigmar6) / rij;
+	}
+};
+
+// U = A/r**12 - B/r**6
+class LjABKernel
+{
+	public:
+	static double energy(double rij, const double* params)
+	{
+		double r6 = rij * rij * rij;
+		r6 *= r6;
+		return (params[VdwFunctions::LjA] / r6 - params[VdwFunctions::LjB]) / r6;
+	}
+	// dU/dr = -12*(A/r**13) + 6*(B/r**7)
+	static double derivative(double rij, const double* params)
+	{
+		double r6 = rij * rij * rij;
+		r6 *= r6;
+		return (6.0 * params[VdwFunctions::LjB] - 12.0 * params[VdwFunctions::LjA] / r6) / (r6 * rij);
+	}
+};
+
+// U = A * exp(-rij/B) - C/(rij**6)
+class BuckinghamKernel
+{
+	public:
+	static double energy(double rij, const double* params)
+	{
+		double r6 = rij * rij * rij;
+		r6 *= r6;
+		return params[VdwFunctions::BuckinghamA] * exp(-rij / params[VdwFunctions::BuckinghamB]) - params[VdwFunctions::BuckinghamC] / r6;
+	}
+	// dU/dr = -A * exp(-rij/B) / B + 6.0 * C/(rij**7)
+	static double derivative(double rij, const double* params)
+	{
+		double r6 = rij * rij * rij;
+		r6 *= r6;
+		return -params[VdwFunctions::BuckinghamA] * exp(-rij / params[VdwFunctions::BuckinghamB]) / params[VdwFunctions::BuckinghamB] + 6.0 * params[VdwFunctions::BuckinghamC] / (r6 * rij);
+	}
+};
+
+// U = E0 * ( (1 - exp( -k(rij - r0) ) )**2 - 1)
+class MorseKernel
+{
+	public:
+	static double energy(double rij, const double* params)
+	{
+		double expo = 1.0 - exp(-params[VdwFunctions::MorseK] * (rij - params[VdwFunctions::MorseEq]));
+		return params[VdwFunctions::MorseD] * (expo*expo - 1.0);
+	}
+	// dU/dr = 2.0 * k * E0 * (1 - exp( -k(rij - r0) ) ) * exp( -k*(rij - r0) )
+	static double derivative(double rij, const double* params)
+	{
+		double expo = exp(-params[VdwFunctions::MorseK] * (rij - params[VdwFunctions::MorseEq]));
+		return 2.0 * params[VdwFunctions::MorseK] * params[VdwFunctions::MorseD] * (1.0 - expo) * expo;
+	}
+};
+
+// Batch energy loop for specified kernel
+template <class K> void energyLoop(int nPairs, const double* rij, double* const* params, double* energies)
+{
+	for (int n=0; n<nPairs; ++n) energies[n] = K::energy(rij[n], params[n]);
+}
+
+// Batch derivative loop for specified kernel
+template <class K> void derivativeLoop(int nPairs, const double* rij, double* const* params, double* derivatives)
+{
+	for (int n=0; n<nPairs; ++n) derivatives[n] = K::derivative(rij[n], params[n]);
+}
+
+/*
+ * VdwKernels
+ */
+
+// Return whether the specified form has a kernel
+bool VdwKernels::hasKernel(VdwFunctions::VdwFunction form)
+{
+	return ((form > VdwFunctions::None) && (form < VdwFunctions::nVdwFunctions));
+}
+
+// Calculate energy of a single pair
+double VdwKernels::energy(VdwFunctions::VdwFunction form, double rij, const double* params)
+{
+	switch (form)
+	{
+		case (VdwFunctions::InversePower):
+			return InversePowerKernel::energy(rij, params);
+		case (VdwFunctions::Lj):
+		case (VdwFunctions::LjGeometric):
+			return LjKernel::energy(rij, params);
+		case (VdwFunctions::LjAB):
+			return LjABKernel::energy(rij, params);
+		case (VdwFunctions::Buckingham):
+			return BuckinghamKernel::energy(rij, params);
+		case (VdwFunctions::Morse):
+			return MorseKernel::energy(rij, params);
+		default:
+			break;
+	}
+	return 0.0;
+}
+
+// Calculate derivative (dU/dr) of a single pair
+double VdwKernels::derivative(VdwFunctions::VdwFunction form, double rij, const double* params)
+{
+	switch (form)
+	{
+		case (VdwFunctions::InversePower):
+			return InversePowerKernel::derivative(rij, params);
+		case (VdwFunctions::Lj):
+		case (VdwFunctions::LjGeometric):
+			return LjKernel::derivative(rij, params);
+		case (VdwFunctions::LjAB):
+			return LjABKernel::derivative(rij, params);
+		case (VdwFunctions::Buckingham):
+			return BuckinghamKernel::derivative(rij, params);
+		case (VdwFunctions::Morse):
+			return MorseKernel::derivative(rij, params);
+		default:
+			break;
+	}
+	return 0.0;
+}
+
+// Calculate energies of a batch of pairs
+void VdwKernels::energies(VdwFunctions::VdwFunction form, int nPairs, const double* rij, double* const* params, double* energies)
+{
+	switch (form)
+	{
+		case (VdwFunctions::InversePower):
+			energyLoop<InversePowerKernel>(nPairs, rij, params, energies);
+			break;
+		case (VdwFunctions::Lj):
+		case (VdwFunctions::LjGeometric):
+			energyLoop<LjKernel>(nPairs, rij, params, energies);
+			break;
+		case (VdwFunctions::LjAB):
+			energyLoop<LjABKernel>(nPairs, rij, params, energies);
+			break;
+		case (VdwFunctions::Buckingham):
+			energyLoop<BuckinghamKernel>(nPairs, rij, params, energies);
+			break;
+		case (VdwFunctions::Morse):
+			energyLoop<MorseKernel>(nPairs, rij, params, energies);
+			break;
+		default:
+			for (int n=0; n<nPairs; ++n) energies[n] = 0.0;
+			break;
+	}
+}
+
+// Calculate derivatives (dU/dr) of a batch of pairs
+void VdwKernels::derivatives(VdwFunctions::VdwFunction form, int nPairs, const double* rij, double* const* params, double* derivatives)
+{
+	switch (form)
+	{
+		case (VdwFunctions::InversePower):
+			derivativeLoop<InversePowerKernel>(nPairs, rij, params, derivatives);
+			break;
+		case (VdwFunctions::Lj):
+		case (VdwFunctions::LjGeometric):
+			derivativeLoop<LjKernel>(nPairs, rij, params, derivatives);
+			break;
+		case (VdwFunctions::LjAB):
+			derivativeLoop<LjABKernel>(nPairs, rij, params, derivatives);
+			break;
+		case (VdwFunctions::Buckingham):
+			derivativeLoop<BuckinghamKernel>(nPairs, rij, params, derivatives);
+			break;
+		case (VdwFunctions::Morse):
+			derivativeLoop<MorseKernel>(nPairs, rij, params, derivatives);
+			break;
+		default:
+			for (int n=0; n<nPairs; ++n) derivatives[n] = 0.0;
+			break;
+	}
+}
+
+/*
+ * VdwTable
+ */
+
+// Constructor
+VdwTable::VdwTable()
+{
+	// Private variables
+	form_ = VdwFunctions::None;
+	for (int n=0; n<MAXFFPARAMDATA; ++n) params_[n] = 0.0;
+	rMin_ = 0.0;
+	rMax_ = 0.0;
+	delta_ = 1.0;
+	rDelta_ = 1.0;
+	nPoints_ = 0;
+}
+
+// Return whether the specified form is worth tabulating
+bool VdwTable::isTabulated(VdwFunctions::VdwFunction form)
+{
+	// Only forms requiring exp() or pow() are more expensive to evaluate than the spline
+	return ((form == VdwFunctions::InversePower) || (form == VdwFunctions::Buckingham) || (form == VdwFunctions::Morse));
+}
+
+// Initialise table for the specified form and parameters, up to the maximum distance given
+void VdwTable::initialise(VdwFunctions::VdwFunction form, const double* params, double rMax, int nPoints)
+{
+	form_ = form;
+	for (int n=0; n<VdwFunctions::functionData[form].nParameters; ++n) params_[n] = params[n];
+
+	// Pairs closer than 0.5 Angstroms are rare enough (and the potentials steep enough) that they are left to the analytic form
+	if (nPoints < 2) nPoints = 2;
+	nPoints_ = nPoints;
+	rMin_ = 0.5;
+	rMax_ = rMax > rMin_ ? rMax : rMin_ + 1.0;
+	delta_ = (rMax_ - rMin_) / (nPoints_ - 1);
+	rDelta_ = 1.0 / delta_;
+
+	u_.createEmpty(nPoints_, 0.0);
+	dU_.createEmpty(nPoints_, 0.0);
+	double r;
+	for (int n=0; n<nPoints_; ++n)
+	{
+		r = rMin_ + n*delta_;
+		u_[n] = VdwKernels::energy(form_, r, params_);
+		dU_[n] = VdwKernels::derivative(form_, r, params_);
+	}
+}
+
+// Return maximum distance in table
+double VdwTable::rMax() const
+{
+	return rMax_;
+}
+
+// Return number of points in table
+int VdwTable::nPoints() const
+{
+	return nPoints_;
+}
+
+// Return interpolated energy at specified distance
+double VdwTable::energy(double rij)
+{
+	double t = (rij - rMin_) * rDelta_;
+	int n = int(t);
+	if ((t < 0.0) || (n >= nPoints_-1)) return VdwKernels::energy(form_, rij, params_);
+
+	// Cubic Hermite basis functions
+	double s = t - n, s2 = s*s, s3 = s2*s;
+	double* u = u_.array(), *dU = dU_.array();
+	return (2.0*s3 - 3.0*s2 + 1.0) * u[n] + (s3 - 2.0*s2 + s) * delta_ * dU[n] + (3.0*s2 - 2.0*s3) * u[n+1] + (s3 - s2) * delta_ * dU[n+1];
+}
+
+// Return interpolated derivative (dU/dr) at specified distance
+double VdwTable::derivative(double rij)
+{
+	double t = (rij - rMin_) * rDelta_;
+	int n = int(t);
+	if ((t < 0.0) || (n >= nPoints_-1)) return VdwKernels::derivative(form_, rij, params_);
+
+	// Derivatives of the cubic Hermite basis functions
+	double s = t - n, s2 = s*s;
+	double* u = u_.array(), *dU = dU_.array();
+	return (6.0*s2 - 6.0*s) * (u[n] - u[n+1]) * rDelta_ + (3.0*s2 - 4.0*s + 1.0) * dU[n] + (3.0*s2 - 2.0*s) * dU[n+1];
+}
+
+// Calculate energies of a batch of pairs, each with its own table
+void VdwTable::energies(int nPairs, const double* rij, VdwTable* const* tables, double* energies)
+{
+	for (int n=0; n<nPairs; ++n) energies[n] = tables[n]->energy(rij[n]);
+}
+
+// Calculate derivatives (dU/dr) of a batch of pairs, each with its own table
+void VdwTable::derivatives(int nPairs, const double* rij, VdwTable* const* tables, double* derivatives)
+{
+	for (int n=0; n<nPairs; ++n) derivatives[n] = tables[n]->derivative(rij[n]);
+}
+
+/*
+ * VdwBatch
+ */
+
+// Constructor
+VdwBatch::VdwBatch()
+{
+	// Private variables
+	form_ = VdwFunctions::None;
+	tabulated_ = false;
+}
+
+// Clear batch, preparing for pairs of the specified form
+void VdwBatch::clear(VdwFunctions::VdwFunction form, bool tabulated)
+{
+	form_ = form;
+	tabulated_ = tabulated;
+	rij_.forgetData();
+	vectors_.forgetData();
+	params_.forgetData();
+	tables_.forgetData();
+	indices_.forgetData();
+	scales_.forgetData();
+}
+
+// Add pair to batch
+void VdwBatch::add(double rij, const Vec3<double>& vecij, double* params, VdwTable* table, int index, double scale)
+{
+	rij_.add(rij);
+	vectors_.add(vecij);
+	params_.add(params);
+	tables_.add(table);
+	indices_.add(index);
+	scales_.add(scale);
+}
+
+// Return number of pairs in batch
+int VdwBatch::nPairs() const
+{
+	return rij_.nItems();
+}
+
+// Calculate energies of all pairs in the batch
+void VdwBatch::calculateEnergies()
+{
+	int nPairs = rij_.nItems();
+	results_.createEmpty(nPairs, 0.0);
+	if (!VdwKernels::hasKernel(form_))
+	{
+		Messenger::print("Warning: No function is specified for vdW interactions - %i pairs ignored.", nPairs);
+		return;
+	}
+	if (tabulated_) VdwTable::energies(nPairs, rij_.array(), tables_.array(), results_.array());
+	else VdwKernels::energies(form_, nPairs, rij_.array(), params_.array(), results_.array());
+}
+
+// Calculate force factors of all pairs in the batch (to be multiplied by the pair vector to give the force on the first atom)
+void VdwBatch::calculateForceFactors()
+{
+	int nPairs = rij_.nItems();
+	results_.createEmpty(nPairs, 0.0);
+	if (!VdwKernels::hasKernel(form_))
+	{
+		Messenger::print("Warning: No function is specified for vdW interactions - %i pairs ignored.", nPairs);
+		return;
+	}
+	double* factors = results_.array(), *rij = rij_.array();
+	if (tabulated_) VdwTable::derivatives(nPairs, rij, tables_.array(), factors);
+	else VdwKernels::derivatives(form_, nPairs, rij, params_.array(), factors);
+	for (int n=0; n<nPairs; ++n) factors[n] = -factors[n] / rij[n];
+}
+
+// Return index of second atom in specified pair
+int VdwBatch::index(int n) const
+{
+	return indices_.value(n);
+}
+
+// Return scaling factor of specified pair
+double VdwBatch::scale(int n) const
+{
+	return scales_.value(n);
+}
+
+// Return vector of specified pair
+Vec3<double> VdwBatch::vector(int n) const
+{
+	return vectors_.value(n);
+}
+
+// Return calculated result for specified pair
+double VdwBatch::result(int n) const
+{
+	return results_.value(n);
+}
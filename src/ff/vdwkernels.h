@@ -0,0 +1,148 @@
+/*
+	*** VDW pair kernels
+	*** src/ff/vdwkernels.h
+	Copyright T. Youngs 2007-2017
+
+	This file is part of Aten.
+
+	Aten is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Aten is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Aten.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef ATEN_VDWKERNELS_H
+#define ATEN_VDWKERNELS_H
+
+#include "ff/forms.h"
+#include "templates/vector3.h"
+#include "templates/array.h"
+#include "base/namespace.h"
+
+ATEN_BEGIN_NAMESPACE
+
+// VDW Kernels
+// Evaluates VDW energies and derivatives for batches of pairs sharing the same functional form. Each form has its own
+// specialised loop, so the choice of form is made once per batch rather than once per pair.
+class VdwKernels
+{
+	public:
+	// Return whether the specified form has a kernel
+	static bool hasKernel(VdwFunctions::VdwFunction form);
+	// Calculate energy of a single pair
+	static double energy(VdwFunctions::VdwFunction form, double rij, const double* params);
+	// Calculate derivative (dU/dr) of a single pair
+	static double derivative(VdwFunctions::VdwFunction form, double rij, const double* params);
+	// Calculate energies of a batch of pairs
+	static void energies(VdwFunctions::VdwFunction form, int nPairs, const double* rij, double* const* params, double* energies);
+	// Calculate derivatives (dU/dr) of a batch of pairs
+	static void derivatives(VdwFunctions::VdwFunction form, int nPairs, const double* rij, double* const* params, double* derivatives);
+};
+
+// Tabulated VDW Interaction
+// Cubic (Hermite) spline of the energy of a single pair of types, built from the analytic energy and derivative at
+// regularly-spaced points up to the cutoff. Outside the tabulated range the analytic form is used.
+class VdwTable
+{
+	public:
+	// Constructor
+	VdwTable();
+
+
+	/*
+	 * Data
+	 */
+	private:
+	// Functional form and parameters of the interaction
+	VdwFunctions::VdwFunction form_;
+	double params_[MAXFFPARAMDATA];
+	// Range of the table
+	double rMin_, rMax_;
+	// Spacing between points, and its reciprocal
+	double delta_, rDelta_;
+	// Number of points in the table
+	int nPoints_;
+	// Energy and derivative at each point
+	Array<double> u_, dU_;
+
+	public:
+	// Return whether the specified form is worth tabulating
+	static bool isTabulated(VdwFunctions::VdwFunction form);
+	// Initialise table for the specified form and parameters, up to the maximum distance given
+	void initialise(VdwFunctions::VdwFunction form, const double* params, double rMax, int nPoints);
+	// Return maximum distance in table
+	double rMax() const;
+	// Return number of points in table
+	int nPoints() const;
+	// Return interpolated energy at specified distance
+	double energy(double rij);
+	// Return interpolated derivative (dU/dr) at specified distance
+	double derivative(double rij);
+	// Calculate energies of a batch of pairs, each with its own table
+	static void energies(int nPairs, const double* rij, VdwTable* const* tables, double* energies);
+	// Calculate derivatives (dU/dr) of a batch of pairs, each with its own table
+	static void derivatives(int nPairs, const double* rij, VdwTable* const* tables, double* derivatives);
+};
+
+// VDW Pair Batch
+// Collects the pairs of a single atom whose interaction must be calculated, so that they may be passed to the kernels
+// in one go. Storage is retained between uses to avoid reallocation.
+class VdwBatch
+{
+	public:
+	// Constructor
+	VdwBatch();
+
+
+	/*
+	 * Pairs
+	 */
+	private:
+	// Functional form of the interactions in the batch
+	VdwFunctions::VdwFunction form_;
+	// Whether tabulated interactions are being used
+	bool tabulated_;
+	// Pair distances and vectors
+	Array<double> rij_;
+	Array< Vec3<double> > vectors_;
+	// Pair parameters, or tables if tabulated
+	Array<double*> params_;
+	Array<VdwTable*> tables_;
+	// Index of the second atom in each pair, and the scaling factor to apply to the interaction
+	Array<int> indices_;
+	Array<double> scales_;
+	// Calculated energies or force factors
+	Array<double> results_;
+
+	public:
+	// Clear batch, preparing for pairs of the specified form
+	void clear(VdwFunctions::VdwFunction form, bool tabulated);
+	// Add pair to batch
+	void add(double rij, const Vec3<double>& vecij, double* params, VdwTable* table, int index, double scale = 1.0);
+	// Return number of pairs in batch
+	int nPairs() const;
+	// Calculate energies of all pairs in the batch
+	void calculateEnergies();
+	// Calculate force factors of all pairs in the batch (to be multiplied by the pair vector to give the force on the first atom)
+	void calculateForceFactors();
+	// Return index of second atom in specified pair
+	int index(int n) const;
+	// Return scaling factor of specified pair
+	double scale(int n) const;
+	// Return vector of specified pair
+	Vec3<double> vector(int n) const;
+	// Return calculated result for specified pair
+	double result(int n) const;
+};
+
+ATEN_END_NAMESPACE
+
+#endif
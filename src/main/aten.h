@@ -537,6 +537,8 @@ class Aten
 	bool importGrid(Model* targetModel, QString filename, const FilePluginInterface* plugin = NULL, FilePluginStandardImportOptions standardOptions = FilePluginStandardImportOptions(), KVMap pluginOptions = KVMap());
 	// Import trajectory
 	bool importTrajectory(Model* targetModel, QString filename, const FilePluginInterface* plugin = NULL, FilePluginStandardImportOptions standardOptions = FilePluginStandardImportOptions(), KVMap pluginOptions = KVMap());
+	// Export trajectory
+	bool exportTrajectory(Model* sourceModel, QString filename, const FilePluginInterface* plugin, KVMap pluginOptions = KVMap());
 	// Import expression
 	bool importExpression(QString filename, const FilePluginInterface* plugin = NULL, FilePluginStandardImportOptions standardOptions = FilePluginStandardImportOptions(), KVMap pluginOptions = KVMap());
 	// Export expression
@@ -146,6 +146,9 @@ Cli cliSwitches[] = {
 	{ Cli::NoQtSettingsSwitch,	'\0',"noqtsettings",	0,
 		"",
 		"Don't load in Qt window/toolbar settings on startup" },
+	{ Cli::NThreadsSwitch,		'\0',"nthreads",		1,
+		"<n>",
+		"Set the number of threads to use in parallel calculations (0 = all available)" },
 	{ Cli::PipeSwitch,		'p',"pipe",		0,
 		"",
 		"Read and execute commands from piped input" },
@@ -763,6 +766,10 @@ int Aten::parseCli(int argc, char *argv[])
 				case (Cli::NoQtSettingsSwitch):
 					prefs.setLoadQtSettings(false);
 					break;
+				// Set number of threads to use in parallel calculations
+				case (Cli::NThreadsSwitch):
+					prefs.setNThreads(argText.toInt());
+					break;
 				// Read and execute commads from pipe
 				case (Cli::PipeSwitch):
 					prefs.setReadPipe(true);
@@ -378,6 +378,39 @@ bool Aten::importTrajectory(Model* targetModel, QString filename, const FilePlug
 	return result;
 }
 
+// Export trajectory
+bool Aten::exportTrajectory(Model* sourceModel, QString filename, const FilePluginInterface* plugin, KVMap pluginOptions)
+{
+	Messenger::enter("Aten::exportTrajectory");
+
+	if (filename.isEmpty() || (plugin == NULL) || (plugin->category() != PluginTypes::TrajectoryFilePlugin) || (!plugin->canExport()))
+	{
+		Messenger::error("A valid filename and trajectory plugin must be supplied in order to save a trajectory.");
+		Messenger::exit("Aten::exportTrajectory");
+		return false;
+	}
+
+	// Create an instance of the plugin, and set options and the output file
+	FilePluginInterface* pluginInterface = (FilePluginInterface*) plugin->duplicate();
+	if (!pluginInterface->openOutput(filename))
+	{
+		delete pluginInterface;
+		Messenger::exit("Aten::exportTrajectory");
+		return false;
+	}
+	pluginInterface->setOptions(pluginOptions);
+	pluginInterface->setParentModel(sourceModel);
+	bool result = pluginInterface->exportData();
+	pluginInterface->closeFiles();
+	delete pluginInterface;
+
+	if (result) Messenger::print("Trajectory for model '%s' saved to file '%s' (%s)", qPrintable(sourceModel->name()), qPrintable(filename), qPrintable(plugin->name()));
+	else Messenger::print("Failed to save trajectory for model '%s'.", qPrintable(sourceModel->name()));
+
+	Messenger::exit("Aten::exportTrajectory");
+	return result;
+}
+
 // Import expression
 bool Aten::importExpression(QString filename, const FilePluginInterface* plugin, FilePluginStandardImportOptions standardOptions, KVMap pluginOptions)
 {
@@ -26,6 +26,7 @@ ATEN_USING_NAMESPACE
 // Constructor
 Calculable::Calculable() : ListItem<Calculable>()
 {
+	nThreads_ = 1;
 }
 
 // Destructor
@@ -56,3 +57,19 @@ QString Calculable::filename() const
 {
 	return filename_;
 }
+
+/*
+ * Parallel Accumulation
+ */
+
+// Prepare separate accumulators for the specified number of threads
+void Calculable::prepareThreads(int nThreads)
+{
+	nThreads_ = (nThreads < 1 ? 1 : nThreads);
+}
+
+// Return number of threads for which accumulators have been prepared
+int Calculable::nThreads() const
+{
+	return nThreads_;
+}
@@ -63,14 +63,28 @@ class Calculable : public ListItem<Calculable>
 	 * Methods
 	 */
 	public:
-	// Accumulate quantity data from supplied config
-	virtual void accumulate(Model* sourceModel)=0;
+	// Accumulate quantity data from supplied config, using the accumulators of the specified thread
+	virtual void accumulate(Model* sourceModel, int thread = 0)=0;
 	// Initialise - check sites, create arrays etc.
 	virtual bool initialise()=0;
 	// Finalise data
 	virtual void finalise(Model* sourceModel)=0;
 	// Save data
 	virtual bool save()=0;
+
+
+	/*
+	 * Parallel Accumulation
+	 */
+	protected:
+	// Number of threads for which accumulators have been prepared
+	int nThreads_;
+
+	public:
+	// Prepare separate accumulators for the specified number of threads
+	virtual void prepareThreads(int nThreads);
+	// Return number of threads for which accumulators have been prepared
+	int nThreads() const;
 };
 
 ATEN_END_NAMESPACE
@@ -0,0 +1,168 @@
+/*
+	*** Cell list of site centres
+	*** src/methods/centrecelllist.cpp
+	Copyright T. Youngs 2007-2017
+
+	This file is part of Aten.
+
+	Aten is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Aten is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Aten.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "methods/centrecelllist.h"
+#include "base/cell.h"
+#include <math.h>
+
+ATEN_USING_NAMESPACE
+
+// Constructor
+CentreCellList::CentreCellList()
+{
+	// Private variables
+	cell_ = NULL;
+	periodic_ = false;
+	for (int n=0; n<3; ++n) offsets_[n].setChunkIncrement(SMALLCHUNKSIZE);
+}
+
+/*
+ * Cells
+ */
+
+// Sort supplied centres into cells, also enclosing the other centres supplied (for non-periodic systems)
+void CentreCellList::create(UnitCell& cell, const Array< Vec3<double> >& centres, const Array< Vec3<double> >& otherCentres, double cutoff)
+{
+	int i, n, k, nCentres = centres.nItems(), nOtherCentres = otherCentres.nItems();
+	cell_ = &cell;
+	periodic_ = (cell.type() != UnitCell::NoCell);
+
+	// Divide space into cells no narrower than the cutoff, so that only neighbouring cells need be searched
+	if (periodic_)
+	{
+		// Perpendicular width of the cell along each axis is the reciprocal of the length of the corresponding row of the inverse
+		Matrix inverse = cell.inverse();
+		for (n=0; n<3; ++n) width_[n] = 1.0 / inverse.rowAsVec3(n).magnitude();
+	}
+	else
+	{
+		Vec3<double> minima, maxima;
+		if (nCentres > 0) minima = maxima = centres.value(0);
+		else if (nOtherCentres > 0) minima = maxima = otherCentres.value(0);
+		for (i=0; i<nCentres; ++i) for (n=0; n<3; ++n)
+		{
+			if (centres.value(i).get(n) < minima[n]) minima[n] = centres.value(i).get(n);
+			else if (centres.value(i).get(n) > maxima[n]) maxima[n] = centres.value(i).get(n);
+		}
+		for (i=0; i<nOtherCentres; ++i) for (n=0; n<3; ++n)
+		{
+			if (otherCentres.value(i).get(n) < minima[n]) minima[n] = otherCentres.value(i).get(n);
+			else if (otherCentres.value(i).get(n) > maxima[n]) maxima[n] = otherCentres.value(i).get(n);
+		}
+		origin_ = minima;
+		width_ = maxima - minima;
+	}
+	for (n=0; n<3; ++n)
+	{
+		nCells_[n] = (int) floor(width_[n] / cutoff);
+		if (nCells_[n] < 1) nCells_[n] = 1;
+	}
+
+	// In sparse systems limit the number of cells to a small multiple of the number of centres (larger cells remain valid)
+	double maxCells = 8.0 * nCentres + 27.0, totalCells = double(nCells_.x) * nCells_.y * nCells_.z;
+	if (totalCells > maxCells)
+	{
+		double scale = cbrt(totalCells / maxCells);
+		for (n=0; n<3; ++n)
+		{
+			nCells_[n] = (int) (nCells_[n] / scale);
+			if (nCells_[n] < 1) nCells_[n] = 1;
+		}
+	}
+	int nCellsTotal = nCells_.x * nCells_.y * nCells_.z;
+
+	// Sort centres into cells
+	Array<int> centreCell(nCentres), cellFill;
+	cellStart_.createEmpty(nCellsTotal+1, 0);
+	for (i=0; i<nCentres; ++i)
+	{
+		Vec3<int> pos = position(centres.value(i));
+		centreCell[i] = (pos.x*nCells_.y + pos.y)*nCells_.z + pos.z;
+		++cellStart_[centreCell[i]+1];
+	}
+	for (n=0; n<nCellsTotal; ++n) cellStart_[n+1] += cellStart_[n];
+	cellFill = cellStart_;
+	cellCentres_.createEmpty(nCentres, 0);
+	for (i=0; i<nCentres; ++i) cellCentres_[cellFill[centreCell[i]]++] = i;
+
+	// Construct offsets of neighbouring cells to search along each axis.
+	// If the search would wrap round onto itself, search every cell along that axis exactly once instead.
+	for (n=0; n<3; ++n)
+	{
+		offsets_[n].clear();
+		if (periodic_ && (nCells_[n] < 3)) for (k=0; k<nCells_[n]; ++k) offsets_[n].add(k);
+		else for (k=-1; k<2; ++k) offsets_[n].add(k);
+	}
+}
+
+// Return cell position of supplied coordinates
+Vec3<int> CentreCellList::position(const Vec3<double>& r)
+{
+	Vec3<int> pos;
+	Vec3<double> frac = (periodic_ ? cell_->realToFrac(r) : r - origin_);
+	for (int n=0; n<3; ++n)
+	{
+		if (periodic_) pos[n] = int((frac[n] - floor(frac[n])) * nCells_[n]);
+		else pos[n] = (width_[n] > 0.0 ? int(frac[n] / width_[n] * nCells_[n]) : 0);
+		if (pos[n] >= nCells_[n]) pos[n] = nCells_[n]-1;
+		else if (pos[n] < 0) pos[n] = 0;
+	}
+	return pos;
+}
+
+// Find cells neighbouring (and including) that containing the supplied coordinates, returning their number
+int CentreCellList::neighbourCells(const Vec3<double>& r, int cells[27])
+{
+	int dx, dy, dz, x, y, z, nNeighbours = 0;
+	Vec3<int> pos = position(r);
+	for (dx=0; dx<offsets_[0].nItems(); ++dx)
+	{
+		x = pos.x + offsets_[0].value(dx);
+		if (periodic_) x = (x + nCells_.x) % nCells_.x;
+		else if ((x < 0) || (x >= nCells_.x)) continue;
+		for (dy=0; dy<offsets_[1].nItems(); ++dy)
+		{
+			y = pos.y + offsets_[1].value(dy);
+			if (periodic_) y = (y + nCells_.y) % nCells_.y;
+			else if ((y < 0) || (y >= nCells_.y)) continue;
+			for (dz=0; dz<offsets_[2].nItems(); ++dz)
+			{
+				z = pos.z + offsets_[2].value(dz);
+				if (periodic_) z = (z + nCells_.z) % nCells_.z;
+				else if ((z < 0) || (z >= nCells_.z)) continue;
+				cells[nNeighbours++] = (x*nCells_.y + y)*nCells_.z + z;
+			}
+		}
+	}
+	return nNeighbours;
+}
+
+// Return number of centres in specified cell
+int CentreCellList::nCentres(int cell) const
+{
+	return cellStart_.value(cell+1) - cellStart_.value(cell);
+}
+
+// Return indices of centres in specified cell
+const int* CentreCellList::centres(int cell)
+{
+	return cellCentres_.array() + cellStart_.value(cell);
+}
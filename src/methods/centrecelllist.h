@@ -0,0 +1,78 @@
+/*
+	*** Cell list of site centres
+	*** src/methods/centrecelllist.h
+	Copyright T. Youngs 2007-2017
+
+	This file is part of Aten.
+
+	Aten is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Aten is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Aten.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef ATEN_CENTRECELLLIST_H
+#define ATEN_CENTRECELLLIST_H
+
+#include "templates/array.h"
+#include "templates/vector3.h"
+#include "base/namespace.h"
+
+ATEN_BEGIN_NAMESPACE
+
+// Forward Declarations (Aten)
+class UnitCell;
+
+// Centre Cell List
+// Sorts a set of centres into cells no narrower than a cutoff, so that all centres within the cutoff of any point can be
+// found by searching only the cells neighbouring it. Works for both periodic and non-periodic systems.
+class CentreCellList
+{
+	public:
+	// Constructor
+	CentreCellList();
+
+
+	/*
+	 * Cells
+	 */
+	private:
+	// Unit cell of source model
+	UnitCell* cell_;
+	// Whether the source model is periodic
+	bool periodic_;
+	// Number of cells along each axis
+	Vec3<int> nCells_;
+	// Origin and width of region covered by cells (for non-periodic systems), or perpendicular widths of the unit cell
+	Vec3<double> origin_, width_;
+	// Index of first centre in each cell within the sorted list (with an extra entry marking the end of the list)
+	Array<int> cellStart_;
+	// Sorted list of centres
+	Array<int> cellCentres_;
+	// Offsets of neighbouring cells to search along each axis
+	Array<int> offsets_[3];
+
+	public:
+	// Sort supplied centres into cells, also enclosing the other centres supplied (for non-periodic systems)
+	void create(UnitCell& cell, const Array< Vec3<double> >& centres, const Array< Vec3<double> >& otherCentres, double cutoff);
+	// Return cell position of supplied coordinates
+	Vec3<int> position(const Vec3<double>& r);
+	// Find cells neighbouring (and including) that containing the supplied coordinates, returning their number
+	int neighbourCells(const Vec3<double>& r, int cells[27]);
+	// Return number of centres in specified cell
+	int nCentres(int cell) const;
+	// Return indices of centres in specified cell
+	const int* centres(int cell);
+};
+
+ATEN_END_NAMESPACE
+
+#endif
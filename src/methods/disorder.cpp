@@ -23,10 +23,12 @@
 #include "methods/mc.h"
 #include "model/model.h"
 #include "methods/disorderdata.h"
+#include "methods/disordergrid.h"
 #include "methods/partitiondata.h"
 #include "model/clipboard.h"
 #include "base/sysfunc.h"
 #include "base/pattern.h"
+#include "base/threadpool.h"
 
 ATEN_USING_NAMESPACE
 
@@ -41,6 +43,7 @@ bool MonteCarlo::disorder(Model* allModels, Model* destmodel, PartitioningScheme
 	int n, m, id, cycle, nSatisfied, nInsertions, nRelative = 0, totalToAdd = 0;
 	Vec3<double> r;
 	double delta, firstRelative, firstActual, expectedPop;
+	int nThreads = prefs.nThreadsToUse();
 	bool isRelative;
 	
 	// Step 1 - Update cell lists in scheme (if required)
@@ -66,6 +69,7 @@ bool MonteCarlo::disorder(Model* allModels, Model* destmodel, PartitioningScheme
 	UnitCell& cell = targetModel_->cell();
 	List<DisorderData> components_;
 	RefList<DisorderData, int> componentsOrder_;
+	DisorderGrid overlapGrid;
 	for (Model* m = allModels; m != NULL; m = m->next)
 	{
 		if (m->componentInsertionPolicy() == Model::NoPolicy) continue;
@@ -117,7 +121,7 @@ bool MonteCarlo::disorder(Model* allModels, Model* destmodel, PartitioningScheme
 		}
 		component = (m->componentInsertionPolicy() == Model::RelativePolicy ? components_.prepend() : components_.add());
 		Messenger::print("Initialising component model '%s' for partition '%s'...", qPrintable(m->name()), qPrintable(scheme->partitionName(id)));
-		if (!component->initialise(m, scheme->partition(id)))
+		if (!component->initialise(m, scheme->partition(id), &overlapGrid))
 		{
 			Messenger::exit("MonteCarlo::disorder");
 			return false;
@@ -178,7 +182,17 @@ bool MonteCarlo::disorder(Model* allModels, Model* destmodel, PartitioningScheme
 		targetModel_->cell().print();
 	}
 	
-	// Step 4 - Determine partition volumes and current partition densities (arising from existing model contents)
+	// Step 4 - Set up overlap grid (cells are wide enough to require only neighbouring cells be searched at the maximum scale factor) and add existing atoms to it
+	double maximumRadius = 0.0;
+	for (i = targetModel_->atoms(); i != NULL; i = i->next) if (ElementMap::atomicRadius(i) > maximumRadius) maximumRadius = ElementMap::atomicRadius(i);
+	for (component = components_.first(); component != NULL; component = component->next)
+	{
+		for (i = component->sourceModel().atoms(); i != NULL; i = i->next) if (ElementMap::atomicRadius(i) > maximumRadius) maximumRadius = ElementMap::atomicRadius(i);
+	}
+	overlapGrid.initialise(cell, 2.0 * maximumRadius * disorderMaximumScaleFactor_);
+	for (i = targetModel_->atoms(); i != NULL; i = i->next) overlapGrid.add(i->r(), ElementMap::atomicRadius(i), NULL, i->id());
+
+	// Step 5 - Determine partition volumes and current partition densities (arising from existing model contents)
 	Messenger::print("Determining partition volumes and starting densities...");
 	Matrix volumeElement = targetModel_->cell().axes();
 	Vec3<int> gridSize = scheme->gridSize();
@@ -215,6 +229,7 @@ bool MonteCarlo::disorder(Model* allModels, Model* destmodel, PartitioningScheme
 	
 	// All set up and ready - do the build
 	Task* task = Messenger::initialiseTask("Performing Disorder build", disorderMaxCycles_);
+	if (disorderBatchSize_ > 1) Messenger::print("Batch insertion mode is active - %i candidates will be screened at once over %i thread(s).", disorderBatchSize_, nThreads);
 	Messenger::print("Cycle   Component       Region      Pop   (Req)     Density  (Req)        RSF");
 	for (cycle = 1; cycle <= disorderMaxCycles_; ++cycle)
 	{
@@ -291,16 +306,29 @@ bool MonteCarlo::disorder(Model* allModels, Model* destmodel, PartitioningScheme
 
 			// Prepare/select nTrial candidates and do some test insertions or deletions
 			if (nInsertions == 0) continue;
+			else if ((nInsertions > 0) && (disorderBatchSize_ > 1))
+			{
+				/*
+				// Batch Insertion
+				*/
+				// Screen a whole batch of candidates in parallel against the current system, then accept non-conflicting candidates serially
+				if (component->insertionPolicy() != Model::RelativePolicy)
+				{
+					nInsertions = component->nRequired();
+					if (nInsertions < 1) nInsertions = 1;
+				}
+				component->prepareBatch(volumeElement, disorderBatchSize_);
+				ThreadPool::run(disorderBatchSize_, nThreads, [component](int task, int thread) { component->screenBatchCandidate(task); });
+				component->acceptBatch(nInsertions);
+			}
 			else if (nInsertions > 0) for (n=0; n<nInsertions; ++n)
 			{
 				/*
 				// Insertion
 				*/
 				component->prepareCandidate(volumeElement);
-				// Test component against its own population...
-				if (component->selfOverlaps(cell)) component->rejectCandidate();
-				else if (component->modelOverlaps(targetModel_, cell)) component->rejectCandidate();
-				else if (component->otherOverlaps(components_.first(), cell)) component->rejectCandidate();
+				// Test component against the rest of the system...
+				if (component->overlaps()) component->rejectCandidate();
 				else
 				{
 					// Happy days! This position is fine, so insert the molecule and continue the loop
@@ -333,10 +361,8 @@ bool MonteCarlo::disorder(Model* allModels, Model* destmodel, PartitioningScheme
 // 				printf("Tweak %i on component %s\n", n, component->modelName());
 				if (!component->selectCandidate()) break;
 				component->tweakCandidate(disorderDeltaDistance_, disorderDeltaAngle_, scheme);
-				// Test component against its own population...
-				if (component->selfOverlaps(cell)) continue;
-				else if (component->modelOverlaps(targetModel_, cell)) continue;
-				else if (component->otherOverlaps(components_.first(), cell)) continue;
+				// Test component against the rest of the system...
+				if (component->overlaps()) continue;
 				else
 				{
 					// Happy days! This position is fine, so store new coordinates and continue the loop
@@ -427,16 +453,14 @@ bool MonteCarlo::disorder(Model* allModels, Model* destmodel, PartitioningScheme
 			for (n = 0; n < component->nAdded(); ++n)
 			{
 				if (!component->selectCandidate(n)) continue;
-				if (component->selfOverlaps(cell) || component->modelOverlaps(targetModel_, cell) || component->otherOverlaps(components_.first(), cell))
+				if (component->overlaps())
 				{
 					// Run a number of tweaks to try and remove overlaps
 					for (m=0; m<disorderRecoveryMaxTweaks_; ++m)
 					{
 						component->tweakCandidate(disorderDeltaDistance_, disorderDeltaAngle_, scheme);
 						// Test candidate molecule for overlaps
-						if (component->selfOverlaps(cell)) continue;
-						else if (component->modelOverlaps(targetModel_, cell)) continue;
-						else if (component->otherOverlaps(components_.first(), cell)) continue;
+						if (component->overlaps()) continue;
 						else
 						{
 							// Happy days! This position is fine, so store new coordinates and continue the loop
@@ -498,6 +522,7 @@ bool MonteCarlo::disorder(Model* allModels, Model* destmodel, PartitioningScheme
 		}
 	}
 	Messenger::terminateTask(task);
+	overlapGrid.printStatistics();
 	
 	// Copy component model contents across to targetModel_, in the order they were originally listed
 	targetModel_->beginUndoState("Disorder build");
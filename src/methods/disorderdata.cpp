@@ -20,9 +20,11 @@
 */
 
 #include "methods/disorderdata.h"
+#include "methods/disordergrid.h"
 #include "methods/partitiondata.h"
 #include "methods/partitioningscheme.h"
 #include "methods/mc.h"
+#include <QElapsedTimer>
 
 ATEN_USING_NAMESPACE
 
@@ -34,8 +36,12 @@ DisorderData::DisorderData() : ListItem<DisorderData>()
 	nFailed_ = 0;
 	nDeleted_ = 0;
 	partitionData_ = NULL;
+	grid_ = NULL;
 	scaleFactor_ = mc.disorderMaximumScaleFactor();
 	moleculeId_ = -1;
+	referenceExtent_ = 0.0;
+	referenceMaximumRadius_ = 0.0;
+	nBatch_ = 0;
 }
 
 /*
@@ -43,7 +49,7 @@ DisorderData::DisorderData() : ListItem<DisorderData>()
 */
 
 // Initialise structure
-bool DisorderData::initialise(Model* sourceModel, PartitionData* partitionData)
+bool DisorderData::initialise(Model* sourceModel, PartitionData* partitionData, DisorderGrid* grid)
 {
 	if (sourceModel == NULL)
 	{
@@ -61,6 +67,12 @@ bool DisorderData::initialise(Model* sourceModel, PartitionData* partitionData)
 		Messenger::print("Error: DisorderData::initialise() - NULL partition data pointer passed.");
 		return false;
 	}
+	grid_ = grid;
+	if (grid_ == NULL)
+	{
+		Messenger::print("Error: DisorderData::initialise() - NULL overlap grid pointer passed.");
+		return false;
+	}
 	
 	// Make copy of source model and centre it at zero, remove any labels, measurements etc., and leave selected
 	sourceModel_.copy(sourceModel);
@@ -68,8 +80,22 @@ bool DisorderData::initialise(Model* sourceModel, PartitionData* partitionData)
 	sourceModel_.centre(0.0, 0.0, 0.0);
 	sourceModel_.clearAllLabels();
 	nAdded_ = 0;
+
+	// Store reference coordinates and radii for batch insertion
+	referenceCoordinates_.clear();
+	referenceRadii_.clear();
+	referenceExtent_ = 0.0;
+	referenceMaximumRadius_ = 0.0;
+	for (Atom* i = sourceModel_.atoms(); i != NULL; i = i->next)
+	{
+		referenceCoordinates_.add(i->r());
+		referenceRadii_.add(ElementMap::atomicRadius(i));
+		if (i->r().magnitude() > referenceExtent_) referenceExtent_ = i->r().magnitude();
+		if (referenceRadii_.last() > referenceMaximumRadius_) referenceMaximumRadius_ = referenceRadii_.last();
+	}
 	nFailed_ = 0;
 	nDeleted_ = 0;
+	gridEntries_.clear();
 	return true;
 }
 
@@ -160,11 +186,20 @@ void DisorderData::prepareCandidate(const Matrix& volumeElement)
 // Accept candidate model into rest of population
 void DisorderData::acceptCandidate()
 {
+	int n, index, nAtoms = sourceModel_.nAtoms();
+	Atom** ii = sourceModel_.atomArray();
 	if (moleculeId_ == -1)
 	{
 		// Copy sourcemodel to targetModel_
 		clipboard_.copyAll(&sourceModel_, true);
 		clipboard_.pasteToModel(&targetModel_, false);
+		// Add new atoms to the overlap grid
+		for (n=0; n<nAtoms; ++n)
+		{
+			index = nAdded_*nAtoms + n;
+			if (index < gridEntries_.nItems()) gridEntries_[index] = grid_->add(ii[n]->r(), ElementMap::atomicRadius(ii[n]), this, index);
+			else gridEntries_.add(grid_->add(ii[n]->r(), ElementMap::atomicRadius(ii[n]), this, index));
+		}
 		// Update density of target partition
 		partitionData_->adjustReducedMass(&sourceModel_);
 		++nAdded_;
@@ -173,8 +208,13 @@ void DisorderData::acceptCandidate()
 	}
 	else
 	{
-		// Overwrite old atomic coordinates with those currently in sourceModel_
-		for (int i=0; i<sourceModel_.nAtoms(); ++i) targetModel_.atom(moleculeId_*sourceModel_.nAtoms()+i)->r() = sourceModel_.atom(i)->r();
+		// Overwrite old atomic coordinates with those currently in sourceModel_, and move the corresponding grid entries
+		for (n=0; n<nAtoms; ++n)
+		{
+			index = moleculeId_*nAtoms + n;
+			targetModel_.atom(index)->r() = ii[n]->r();
+			grid_->move(gridEntries_[index], ii[n]->r());
+		}
 	}
 }
 
@@ -223,6 +263,14 @@ void DisorderData::deleteCandidate()
 		targetModel_.selectNone();
 		for (int i=moleculeId_*sourceModel_.nAtoms(); i < (moleculeId_+1)*sourceModel_.nAtoms(); ++i) targetModel_.selectAtom(i);
 		targetModel_.selectionDelete();
+		// Remove molecule's atoms from the overlap grid, and shift the entries of all subsequent molecules down
+		int n, nAtoms = sourceModel_.nAtoms();
+		for (n=moleculeId_*nAtoms; n < (moleculeId_+1)*nAtoms; ++n) grid_->remove(gridEntries_[n]);
+		for (n=moleculeId_*nAtoms; n < (nAdded_-1)*nAtoms; ++n)
+		{
+			gridEntries_[n] = gridEntries_[n+nAtoms];
+			grid_->setIndex(gridEntries_[n], n);
+		}
 		partitionData_->adjustReducedMass(&sourceModel_, true);
 		--nAdded_;
 		moleculeId_ = -1;
@@ -256,47 +304,28 @@ void DisorderData::tweakCandidate(double maxDistance, double maxAngle, Partition
 	}
 }
 
-// Determine whether candidate molecule overlaps with supplied model
-bool DisorderData::modelOverlaps(Model* other, UnitCell& globalCell)
+// Determine whether candidate molecule overlaps any other atom in the system
+bool DisorderData::overlaps()
 {
-	double rij, ri;
-	Atom** ii = other->atomArray(), **jj = sourceModel_.atomArray();
-	int i, j;
-	// Perform double loop over candidate molecule atoms and supplied model atoms
-	for (i = 0; i < other->nAtoms(); ++i)
+	QElapsedTimer timer;
+	timer.start();
+
+	// If the candidate is an existing molecule, its own atoms must be excluded from the test
+	int nAtoms = sourceModel_.nAtoms(), nPairs = 0;
+	int excludeFirst = (moleculeId_ == -1 ? -1 : moleculeId_*nAtoms);
+	int excludeLast = (moleculeId_ == -1 ? -1 : (moleculeId_+1)*nAtoms - 1);
+	bool result = false;
+	for (Atom* i = sourceModel_.atoms(); i != NULL; i = i->next)
 	{
-		// Disregard current selected molecule, if 'other == sourceModel_'
-		if ((other == &targetModel_) && (i >= moleculeId_*sourceModel_.nAtoms()) && (i < (moleculeId_+1)*sourceModel_.nAtoms())) continue;
-		
-		ri = scaleFactor_*ElementMap::atomicRadius(ii[i]);
-		for (j = 0; j < sourceModel_.nAtoms(); ++j)
+		if (grid_->overlaps(i->r(), ElementMap::atomicRadius(i), scaleFactor_, this, excludeFirst, excludeLast, nPairs))
 		{
-			// Determine distance using supplied cell conditions
-			rij = globalCell.distance(ii[i], jj[j], true);
-			// Simple penalty function - subtract off some multiple of the atomic radius of each atom...
-			rij -= ri + scaleFactor_*ElementMap::atomicRadius(jj[j]);
-			if (rij < 0.0) return true;
+			result = true;
+			break;
 		}
 	}
-	return false;
-}
 
-// Determine whether candidate molecule overlaps rest of population
-bool DisorderData::selfOverlaps(UnitCell& globalCell)
-{
-	return modelOverlaps(&targetModel_, globalCell);
-}
-
-// Determine whether candidate molecule overlaps with all other insertion models
-bool DisorderData::otherOverlaps(DisorderData* first, UnitCell& globalCell)
-{
-	// Go through list of DisorderedData
-	for (DisorderData* dd = first; dd != NULL; dd = dd->next)
-	{
-		if (dd == this) continue;
-		if (modelOverlaps(&dd->targetModel_, globalCell)) return true;
-	}
-	return false;
+	grid_->registerTest(nAtoms, timer.nsecsElapsed(), nPairs);
+	return result;
 }
 
 // Return number of copies added
@@ -344,3 +373,139 @@ int DisorderData::count()
 {
 	return count_;
 }
+
+// Return number of molecules still required to satisfy the requested population or density
+int DisorderData::nRequired()
+{
+	switch (insertionPolicy())
+	{
+		case (Model::NumberPolicy):
+		case (Model::NumberAndDensityPolicy):
+			return requestedPopulation() - nAdded_;
+		case (Model::DensityPolicy):
+		case (Model::RelativePolicy):
+			// Estimate from the mass deficit in the target partition
+			return int(ceil( ((requestedDensity() - partitionDensity()) * partitionData_->volume() * 1.0E-24) / (sourceModel_.mass() / AVOGADRO) ));
+		default:
+			break;
+	}
+	return 0;
+}
+
+/*
+ * Batch Insertion
+ */
+
+// Return whether specified batch candidate overlaps any candidate already accepted from the batch
+bool DisorderData::batchConflicts(int n)
+{
+	const UnitCell& cell = grid_->cell();
+	int i, j, m, other, nAtoms = referenceCoordinates_.nItems();
+	double rij, cutoff = 2.0 * (referenceExtent_ + scaleFactor_*referenceMaximumRadius_);
+	for (m=0; m<batchAccepted_.nItems(); ++m)
+	{
+		other = batchAccepted_[m];
+
+		// Check enclosing spheres first
+		if (cell.mimVector(batchCentres_[n], batchCentres_[other]).magnitudeSq() >= cutoff*cutoff) continue;
+
+		for (i=0; i<nAtoms; ++i)
+		{
+			for (j=0; j<nAtoms; ++j)
+			{
+				rij = scaleFactor_ * (referenceRadii_[i] + referenceRadii_[j]);
+				if (cell.mimVector(batchCoordinates_[n*nAtoms+i], batchCoordinates_[other*nAtoms+j]).magnitudeSq() < rij*rij) return true;
+			}
+		}
+	}
+	return false;
+}
+
+// Prepare batch of candidates in random positions (and orientations) in assigned partition
+void DisorderData::prepareBatch(const Matrix& volumeElement, int nCandidates)
+{
+	nBatch_ = nCandidates;
+	moleculeId_ = -1;
+	batchCentres_.createEmpty(nBatch_);
+	batchRotations_.createEmpty(nBatch_);
+	batchCoordinates_.createEmpty(nBatch_*referenceCoordinates_.nItems());
+	batchClear_.createEmpty(nBatch_, false);
+	batchTime_.createEmpty(nBatch_, 0.0);
+	batchPairs_.createEmpty(nBatch_, 0);
+	batchAccepted_.clear();
+
+	// All random numbers are drawn here, in a fixed order, so that the batch (and hence the final result) is reproducible for a given seed
+	int* ijk;
+	Vec3<double> pos;
+	double anglex, angley;
+	for (int n=0; n<nBatch_; ++n)
+	{
+		ijk = partitionData_->randomCell();
+		pos.x = AtenMath::random();
+		pos.y = AtenMath::random();
+		pos.z = AtenMath::random();
+		pos.add(ijk[0], ijk[1], ijk[2]);
+		batchCentres_[n] = volumeElement * pos;
+		if (sourceModel_.componentRotatable())
+		{
+			anglex = AtenMath::random()*360.0;
+			angley = AtenMath::random()*360.0;
+			batchRotations_[n].createRotationXY(anglex, angley);
+		}
+		else batchRotations_[n].setIdentity();
+	}
+}
+
+// Screen specified batch candidate for overlaps with the rest of the system (may be called from several threads at once)
+void DisorderData::screenBatchCandidate(int n)
+{
+	QElapsedTimer timer;
+	timer.start();
+
+	// The grid is not modified while screening takes place, so may be safely read by all threads
+	int nAtoms = referenceCoordinates_.nItems(), nPairs = 0;
+	Vec3<double> r;
+	bool clear = true;
+	for (int i=0; i<nAtoms; ++i)
+	{
+		r = batchRotations_[n] * referenceCoordinates_[i] + batchCentres_[n];
+		batchCoordinates_[n*nAtoms+i] = r;
+		if (grid_->overlaps(r, referenceRadii_[i], scaleFactor_, NULL, -1, -1, nPairs))
+		{
+			clear = false;
+			break;
+		}
+	}
+
+	batchClear_[n] = clear;
+	batchTime_[n] = timer.nsecsElapsed();
+	batchPairs_[n] = nPairs;
+}
+
+// Accept screened candidates which do not conflict with those accepted before them (in order), up to the maximum number specified
+int DisorderData::acceptBatch(int maxAccepted)
+{
+	int i, nAtoms = referenceCoordinates_.nItems();
+	Atom** ii;
+	for (int n=0; n<nBatch_; ++n)
+	{
+		grid_->registerTest(nAtoms, batchTime_[n], batchPairs_[n]);
+		if (batchAccepted_.nItems() >= maxAccepted) continue;
+
+		// Candidate must have passed screening, and must not overlap any candidate accepted from the batch so far (which weren't in the grid at the time of screening)
+		if ((!batchClear_[n]) || batchConflicts(n))
+		{
+			rejectCandidate();
+			if (nFailed_ >= mc.disorderMaxFailures()) adjustScaleFactor(mc.disorderReductionFactor(), mc.disorderMinimumScaleFactor());
+			continue;
+		}
+
+		// Place candidate coordinates in sourceModel_ and accept it
+		ii = sourceModel_.atomArray();
+		for (i=0; i<nAtoms; ++i) ii[i]->r() = batchCoordinates_[n*nAtoms+i];
+		moleculeId_ = -1;
+		acceptCandidate();
+		batchAccepted_.add(n);
+	}
+	return batchAccepted_.nItems();
+}
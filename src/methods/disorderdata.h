@@ -31,6 +31,7 @@ ATEN_BEGIN_NAMESPACE
 // Forward Declarations (Aten)
 class PartitionData;
 class PartitioningScheme;
+class DisorderGrid;
 
 // Insertion Data Class for Disorder builder
 class DisorderData : public ListItem<DisorderData>
@@ -50,10 +51,12 @@ class DisorderData : public ListItem<DisorderData>
 	Model targetModel_;
 	// Target partition data
 	PartitionData* partitionData_;
+	// Overlap grid containing all atoms in the system
+	DisorderGrid* grid_;
 	
 	public:
 	// Initialise structure
-	bool initialise(Model* sourceModel, PartitionData* partitionData);
+	bool initialise(Model* sourceModel, PartitionData* partitionData, DisorderGrid* grid);
 	// Return insertion policy of source model
 	Model::InsertionPolicy insertionPolicy();
 	// Return requested component population
@@ -92,6 +95,8 @@ class DisorderData : public ListItem<DisorderData>
 	int moleculeId_;
 	// Counting variable
 	int count_;
+	// Overlap grid entries of atoms in targetModel_
+	Array<int> gridEntries_;
 	
 	public:
 	// Prepare copy of sourcemodel in random position (and orientation) in assigned partition
@@ -106,12 +111,8 @@ class DisorderData : public ListItem<DisorderData>
 	void deleteCandidate();
 	// Tweak molecule position / rotation, and place in sourceModel_
 	void tweakCandidate(double maxDistance, double maxAngle, PartitioningScheme* scheme);
-	// Determine whether candidate molecule overlaps with supplied model
-	bool modelOverlaps(Model* other, UnitCell& globalCell);
-	// Determine whether candidate molecule overlaps rest of population
-	bool selfOverlaps(UnitCell& globalCell);
-	// Determine whether candidate molecule overlaps with all other insertion models
-	bool otherOverlaps(DisorderData* first, UnitCell& globalCell);
+	// Determine whether candidate molecule overlaps any other atom in the system
+	bool overlaps();
 	// Return number of copies added
 	int nAdded();
 	// Return number of successive failures since last successful insertion
@@ -126,6 +127,42 @@ class DisorderData : public ListItem<DisorderData>
 	void increaseCount(int delta = 1);
 	// Return counting variable
 	int count();
+	// Return number of molecules still required to satisfy the requested population or density
+	int nRequired();
+
+
+	/*
+	 * Batch Insertion
+	 */
+	private:
+	// Atomic coordinates (centred at the origin) and radii of the source model
+	Array< Vec3<double> > referenceCoordinates_;
+	Array<double> referenceRadii_;
+	// Largest distance of any reference atom from the origin, and largest radius of any reference atom
+	double referenceExtent_, referenceMaximumRadius_;
+	// Number of candidates in current batch
+	int nBatch_;
+	// Centre and rotation of each candidate in the batch
+	Array< Vec3<double> > batchCentres_;
+	Array<Matrix> batchRotations_;
+	// Atomic coordinates of all candidates in the batch
+	Array< Vec3<double> > batchCoordinates_;
+	// Whether each candidate passed screening, the time taken to screen it (in nanoseconds), and the number of pair distances calculated
+	Array<bool> batchClear_;
+	Array<double> batchTime_;
+	Array<int> batchPairs_;
+	// Candidates accepted from the current batch
+	Array<int> batchAccepted_;
+	// Return whether specified batch candidate overlaps any candidate already accepted from the batch
+	bool batchConflicts(int n);
+
+	public:
+	// Prepare batch of candidates in random positions (and orientations) in assigned partition
+	void prepareBatch(const Matrix& volumeElement, int nCandidates);
+	// Screen specified batch candidate for overlaps with the rest of the system (may be called from several threads at once)
+	void screenBatchCandidate(int n);
+	// Accept screened candidates which do not conflict with those accepted before them (in order), up to the maximum number specified
+	int acceptBatch(int maxAccepted);
 };
 
 ATEN_END_NAMESPACE
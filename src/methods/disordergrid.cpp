@@ -0,0 +1,291 @@
+/*
+	*** Disorder Overlap Grid
+	*** src/methods/disordergrid.cpp
+	Copyright T. Youngs 2007-2017
+
+	This file is part of Aten.
+
+	Aten is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Aten is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Aten.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "methods/disordergrid.h"
+#include "base/cell.h"
+#include "base/messenger.h"
+#include <math.h>
+
+ATEN_USING_NAMESPACE
+
+// Constructor
+DisorderGrid::DisorderGrid()
+{
+	// Private variables
+	cell_ = NULL;
+	nCells_.set(1,1,1);
+	nFreeEntries_ = 0;
+	nEntries_ = 0;
+	maximumRadius_ = 0.0;
+	resetStatistics();
+}
+
+/*
+ * Cells
+ */
+
+// Return grid position of supplied coordinates
+Vec3<int> DisorderGrid::gridPosition(const Vec3<double>& r) const
+{
+	Vec3<int> pos(0,0,0);
+	if (cell_->type() == UnitCell::NoCell) return pos;
+
+	double frac;
+	for (int axis=0; axis<3; ++axis)
+	{
+		frac = reciprocal_.columnAsVec3(axis).dp(r);
+		frac -= floor(frac);
+		pos[axis] = int(frac * nCells_.get(axis));
+		if (pos[axis] >= nCells_.get(axis)) pos[axis] = nCells_.get(axis) - 1;
+	}
+	return pos;
+}
+
+// Return cell index of supplied grid position (folded into the grid)
+int DisorderGrid::cellIndex(int x, int y, int z) const
+{
+	x %= nCells_.x;
+	if (x < 0) x += nCells_.x;
+	y %= nCells_.y;
+	if (y < 0) y += nCells_.y;
+	z %= nCells_.z;
+	if (z < 0) z += nCells_.z;
+	return (x*nCells_.y + y)*nCells_.z + z;
+}
+
+// Initialise grid in the supplied unit cell, with cells no narrower than the width specified
+void DisorderGrid::initialise(const UnitCell& cell, double minimumWidth)
+{
+	cell_ = &cell;
+	reciprocal_ = cell_->reciprocal();
+
+	// Determine number of cells along each axis
+	nCells_.set(1,1,1);
+	cellWidth_.set(0.0,0.0,0.0);
+	if (cell_->type() != UnitCell::NoCell)
+	{
+		double width;
+		for (int axis=0; axis<3; ++axis)
+		{
+			// Perpendicular width of the cell along this axis is the reciprocal of the reciprocal vector length
+			width = 1.0 / reciprocal_.columnAsVec3(axis).magnitude();
+			if (minimumWidth > 0.0) nCells_[axis] = int(width / minimumWidth);
+			if (nCells_[axis] < 1) nCells_[axis] = 1;
+			cellWidth_[axis] = width / nCells_[axis];
+		}
+	}
+	cellHead_.createEmpty(nCells_.x*nCells_.y*nCells_.z, -1);
+
+	// Clear any existing entries
+	positions_.clear();
+	radii_.clear();
+	owners_.clear();
+	indices_.clear();
+	entryCell_.clear();
+	entryNext_.clear();
+	entryPrev_.clear();
+	freeEntries_.clear();
+	nFreeEntries_ = 0;
+	nEntries_ = 0;
+	maximumRadius_ = 0.0;
+	resetStatistics();
+
+	Messenger::print(Messenger::Verbose, "Disorder overlap grid has %i x %i x %i cells.", nCells_.x, nCells_.y, nCells_.z);
+}
+
+// Return unit cell in which the grid is defined
+const UnitCell& DisorderGrid::cell() const
+{
+	return *cell_;
+}
+
+/*
+ * Entries
+ */
+
+// Link entry into specified cell
+void DisorderGrid::link(int id, int cell)
+{
+	entryCell_[id] = cell;
+	entryPrev_[id] = -1;
+	entryNext_[id] = cellHead_[cell];
+	if (cellHead_[cell] != -1) entryPrev_[cellHead_[cell]] = id;
+	cellHead_[cell] = id;
+}
+
+// Unlink entry from its current cell
+void DisorderGrid::unlink(int id)
+{
+	int cell = entryCell_[id];
+	if (entryPrev_[id] == -1) cellHead_[cell] = entryNext_[id];
+	else entryNext_[entryPrev_[id]] = entryNext_[id];
+	if (entryNext_[id] != -1) entryPrev_[entryNext_[id]] = entryPrev_[id];
+	entryCell_[id] = -1;
+	entryNext_[id] = -1;
+	entryPrev_[id] = -1;
+}
+
+// Add new entry, returning its id
+int DisorderGrid::add(const Vec3<double>& r, double radius, DisorderData* owner, int index)
+{
+	// Re-use an old entry if one is available
+	int id;
+	if (nFreeEntries_ > 0)
+	{
+		--nFreeEntries_;
+		id = freeEntries_[nFreeEntries_];
+		positions_[id] = r;
+		radii_[id] = radius;
+		owners_[id] = owner;
+		indices_[id] = index;
+	}
+	else
+	{
+		id = positions_.nItems();
+		positions_.add(r);
+		radii_.add(radius);
+		owners_.add(owner);
+		indices_.add(index);
+		entryCell_.add(-1);
+		entryNext_.add(-1);
+		entryPrev_.add(-1);
+	}
+	if (radius > maximumRadius_) maximumRadius_ = radius;
+
+	Vec3<int> pos = gridPosition(r);
+	link(id, cellIndex(pos.x, pos.y, pos.z));
+	++nEntries_;
+	return id;
+}
+
+// Remove specified entry
+void DisorderGrid::remove(int id)
+{
+	unlink(id);
+	owners_[id] = NULL;
+	indices_[id] = -1;
+
+	// Push entry onto the free stack
+	if (nFreeEntries_ < freeEntries_.nItems()) freeEntries_[nFreeEntries_] = id;
+	else freeEntries_.add(id);
+	++nFreeEntries_;
+	--nEntries_;
+}
+
+// Move specified entry to new coordinates
+void DisorderGrid::move(int id, const Vec3<double>& r)
+{
+	positions_[id] = r;
+	Vec3<int> pos = gridPosition(r);
+	int cell = cellIndex(pos.x, pos.y, pos.z);
+	if (cell == entryCell_[id]) return;
+	unlink(id);
+	link(id, cell);
+}
+
+// Set index of specified entry within its owner
+void DisorderGrid::setIndex(int id, int index)
+{
+	indices_[id] = index;
+}
+
+// Return number of entries in use
+int DisorderGrid::nEntries() const
+{
+	return nEntries_;
+}
+
+// Return whether a sphere at the supplied position overlaps any entry, ignoring those of the specified owner within the index range given, and incrementing the supplied pair counter
+bool DisorderGrid::overlaps(const Vec3<double>& r, double radius, double scaleFactor, DisorderData* excludeOwner, int excludeFirst, int excludeLast, int& nPairs)
+{
+	// Determine the range of cells which must be searched along each axis
+	double cutoff = scaleFactor * (radius + maximumRadius_);
+	Vec3<int> pos = gridPosition(r), minCell, maxCell;
+	int reach;
+	for (int axis=0; axis<3; ++axis)
+	{
+		reach = (cellWidth_[axis] > 0.0 ? int(ceil(cutoff / cellWidth_[axis])) : 0);
+		// If the search would wrap onto itself, just search every cell along this axis (once)
+		if (2*reach+1 >= nCells_[axis])
+		{
+			minCell[axis] = 0;
+			maxCell[axis] = nCells_[axis] - 1;
+		}
+		else
+		{
+			minCell[axis] = pos[axis] - reach;
+			maxCell[axis] = pos[axis] + reach;
+		}
+	}
+
+	int x, y, z, id;
+	double rij, rsq;
+	for (x = minCell.x; x <= maxCell.x; ++x)
+	{
+		for (y = minCell.y; y <= maxCell.y; ++y)
+		{
+			for (z = minCell.z; z <= maxCell.z; ++z)
+			{
+				id = cellHead_[cellIndex(x, y, z)];
+				for (; id != -1; id = entryNext_[id])
+				{
+					if ((owners_[id] == excludeOwner) && (excludeOwner != NULL) && (indices_[id] >= excludeFirst) && (indices_[id] <= excludeLast)) continue;
+					++nPairs;
+
+					// Simple penalty function - subtract off some multiple of the atomic radius of each atom...
+					rij = scaleFactor * (radius + radii_[id]);
+					rsq = cell_->mimVector(r, positions_[id]).magnitudeSq();
+					if (rsq < rij*rij) return true;
+				}
+			}
+		}
+	}
+	return false;
+}
+
+/*
+ * Statistics
+ */
+
+// Reset statistics
+void DisorderGrid::resetStatistics()
+{
+	nTests_ = 0;
+	nPairs_ = 0.0;
+	nPairsFull_ = 0.0;
+	testTime_ = 0.0;
+}
+
+// Register a completed overlap test of a molecule containing the specified number of atoms, with the time (in nanoseconds) it took and the number of pair distances calculated
+void DisorderGrid::registerTest(int nAtoms, double nsec, int nPairs)
+{
+	++nTests_;
+	testTime_ += nsec;
+	nPairs_ += nPairs;
+	nPairsFull_ += double(nAtoms) * nEntries_;
+}
+
+// Print statistics
+void DisorderGrid::printStatistics() const
+{
+	Messenger::print("Overlap tests: %i molecules tested in %8.3f s (%8.3f us per test).", nTests_, testTime_*1.0e-9, nTests_ > 0 ? testTime_*1.0e-3 / nTests_ : 0.0);
+	Messenger::print("Overlap tests: %12.0f pair distances calculated, versus %12.0f for a full search (%6.2f%%).", nPairs_, nPairsFull_, nPairsFull_ > 0.0 ? 100.0*nPairs_/nPairsFull_ : 0.0);
+}
@@ -0,0 +1,137 @@
+/*
+	*** Disorder Overlap Grid
+	*** src/methods/disordergrid.h
+	Copyright T. Youngs 2007-2017
+
+	This file is part of Aten.
+
+	Aten is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Aten is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Aten.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef ATEN_DISORDERGRID_H
+#define ATEN_DISORDERGRID_H
+
+#include "templates/vector3.h"
+#include "templates/array.h"
+#include "math/matrix.h"
+#include "base/namespace.h"
+
+ATEN_BEGIN_NAMESPACE
+
+// Forward Declarations (Aten)
+class UnitCell;
+class DisorderData;
+
+// Disorder Overlap Grid
+// Persistent spatial hash of all atoms placed by the disorder builder, so that overlap tests for a candidate molecule
+// need only consider atoms in nearby cells rather than the entire system.
+class DisorderGrid
+{
+	public:
+	// Constructor
+	DisorderGrid();
+
+
+	/*
+	 * Cells
+	 */
+	private:
+	// Unit cell in which the grid is defined
+	const UnitCell* cell_;
+	// Reciprocal axes of the unit cell
+	Matrix reciprocal_;
+	// Number of cells along each cell axis
+	Vec3<int> nCells_;
+	// Perpendicular width of a single cell along each axis
+	Vec3<double> cellWidth_;
+	// First entry in each cell (or -1)
+	Array<int> cellHead_;
+	// Return grid position of supplied coordinates
+	Vec3<int> gridPosition(const Vec3<double>& r) const;
+	// Return cell index of supplied grid position (folded into the grid)
+	int cellIndex(int x, int y, int z) const;
+
+	public:
+	// Initialise grid in the supplied unit cell, with cells no narrower than the width specified
+	void initialise(const UnitCell& cell, double minimumWidth);
+	// Return unit cell in which the grid is defined
+	const UnitCell& cell() const;
+
+
+	/*
+	 * Entries
+	 */
+	private:
+	// Coordinates of each entry
+	Array< Vec3<double> > positions_;
+	// Unscaled radius of each entry
+	Array<double> radii_;
+	// Component owning each entry (NULL for atoms in the destination model)
+	Array<DisorderData*> owners_;
+	// Index of each entry within its owner
+	Array<int> indices_;
+	// Cell in which each entry resides (or -1 if the entry is unused)
+	Array<int> entryCell_;
+	// Next and previous entries in the same cell (or -1)
+	Array<int> entryNext_, entryPrev_;
+	// Stack of unused entries, and number of items in it
+	Array<int> freeEntries_;
+	int nFreeEntries_;
+	// Number of entries in use
+	int nEntries_;
+	// Largest radius of any entry added
+	double maximumRadius_;
+	// Link entry into specified cell
+	void link(int id, int cell);
+	// Unlink entry from its current cell
+	void unlink(int id);
+
+	public:
+	// Add new entry, returning its id
+	int add(const Vec3<double>& r, double radius, DisorderData* owner, int index);
+	// Remove specified entry
+	void remove(int id);
+	// Move specified entry to new coordinates
+	void move(int id, const Vec3<double>& r);
+	// Set index of specified entry within its owner
+	void setIndex(int id, int index);
+	// Return number of entries in use
+	int nEntries() const;
+	// Return whether a sphere at the supplied position overlaps any entry, ignoring those of the specified owner within the index range given, and incrementing the supplied pair counter
+	bool overlaps(const Vec3<double>& r, double radius, double scaleFactor, DisorderData* excludeOwner, int excludeFirst, int excludeLast, int& nPairs);
+
+
+	/*
+	 * Statistics
+	 */
+	private:
+	// Number of molecule overlap tests performed
+	int nTests_;
+	// Number of pair distances calculated, and the number a full search would have required
+	double nPairs_, nPairsFull_;
+	// Time spent in overlap tests (in nanoseconds)
+	double testTime_;
+
+	public:
+	// Reset statistics
+	void resetStatistics();
+	// Register a completed overlap test of a molecule containing the specified number of atoms, with the time (in nanoseconds) it took and the number of pair distances calculated
+	void registerTest(int nAtoms, double nsec, int nPairs);
+	// Print statistics
+	void printStatistics() const;
+};
+
+ATEN_END_NAMESPACE
+
+#endif
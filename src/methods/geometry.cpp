@@ -100,13 +100,14 @@ bool Geometry::initialise()
 	return true;
 }
 
-// Accumulate quantity data from supplied model
-void Geometry::accumulate(Model* sourcemodel)
+// Accumulate quantity data from supplied model, using the accumulators of the specified thread
+void Geometry::accumulate(Model* sourcemodel, int thread)
 {
 	Messenger::enter("Geometry::accumulate");
 	int m1, m2, m3, m4, bin;
-	static Vec3<double> centre1, centre2, centre3, centre4;
+	Vec3<double> centre1, centre2, centre3, centre4;
 	UnitCell& cell = sourcemodel->cell();
+	double* data = (thread > 0 ? threadData_.array() + (thread-1)*nBins_ : data_);
 	double geom;
 	if (nSites_ == 2)
 	{
@@ -124,7 +125,7 @@ void Geometry::accumulate(Model* sourcemodel)
 				// Add distance to data array
 				bin = int(geom / binWidth_);
 				//printf("Adding distance %f to bin %i\n",mimd.magnitude(),bin);
-				if (bin < nBins_) data_[bin] += 1.0;
+				if (bin < nBins_) data[bin] += 1.0;
 			}
 		}
 	}
@@ -149,7 +150,7 @@ void Geometry::accumulate(Model* sourcemodel)
 					// Add distance to data array
 					bin = int(geom / binWidth_);
 					//printf("Adding distance %f to bin %i\n",mimd.magnitude(),bin);
-					if (bin < nBins_) data_[bin] += 1.0;
+					if (bin < nBins_) data[bin] += 1.0;
 				}
 			}
 		}
@@ -179,7 +180,7 @@ void Geometry::accumulate(Model* sourcemodel)
 						// Add distance to data array
 						bin = int(geom / binWidth_);
 						//printf("Adding distance %f to bin %i\n",mimd.magnitude(),bin);
-						if (bin < nBins_) data_[bin] += 1.0;
+						if (bin < nBins_) data[bin] += 1.0;
 					}
 				}
 			}
@@ -187,7 +188,8 @@ void Geometry::accumulate(Model* sourcemodel)
 	}
 
 	// Increase accumulation counter
-	nAdded_ ++;
+	if (thread > 0) ++threadAdded_[thread-1];
+	else nAdded_ ++;
 	Messenger::exit("Geometry::accumulate");
 }
 
@@ -195,6 +197,7 @@ void Geometry::accumulate(Model* sourcemodel)
 void Geometry::finalise(Model* sourcemodel)
 {
 	Messenger::enter("Geometry::finalise");
+	mergeThreads();
 	Messenger::exit("Geometry::finalise");
 }
 
@@ -202,6 +205,35 @@ void Geometry::finalise(Model* sourcemodel)
 bool Geometry::save()
 {
 	int n;
+	mergeThreads();
 	for (n=0; n<nBins_; n++) printf(" %f  %f\n",binWidth_ * (n + 0.5), data_[n]);
 	return true;
 }
+
+// Prepare separate accumulators for the specified number of threads
+void Geometry::prepareThreads(int nThreads)
+{
+	// Keep anything accumulated so far before resizing the thread arrays
+	mergeThreads();
+	Calculable::prepareThreads(nThreads);
+	threadData_.createEmpty((nThreads_-1)*nBins_, 0.0);
+	threadAdded_.createEmpty(nThreads_-1, 0);
+}
+
+// Merge data accumulated by other threads into the main histogram
+void Geometry::mergeThreads()
+{
+	if (data_ == NULL) return;
+	int n, t;
+	for (t=0; t<threadAdded_.nItems(); ++t)
+	{
+		double* data = threadData_.array() + t*nBins_;
+		for (n=0; n<nBins_; ++n)
+		{
+			data_[n] += data[n];
+			data[n] = 0.0;
+		}
+		nAdded_ += threadAdded_[t];
+		threadAdded_[t] = 0;
+	}
+}
@@ -23,6 +23,7 @@
 #define ATEN_GEOMETRY_H
 
 #include "methods/calculable.h"
+#include "templates/array.h"
 
 ATEN_BEGIN_NAMESPACE
 
@@ -58,12 +59,14 @@ class Geometry : public Calculable
 	public:
 	// Initialise structure
 	bool initialise();
-	// Accumulate quantity data from supplied config
-	void accumulate(Model*);
+	// Accumulate quantity data from supplied config, using the accumulators of the specified thread
+	void accumulate(Model*, int thread = 0);
 	// Finalise data
 	void finalise(Model*);
 	// Save data
 	bool save();
+	// Prepare separate accumulators for the specified number of threads
+	void prepareThreads(int nThreads);
 
 	/*
 	 * Data Description
@@ -94,6 +97,11 @@ class Geometry : public Calculable
 	double* data_;
 	// Count for number of added data (i.e. nframes)
 	int nAdded_;
+	// Histograms and counts accumulated by threads other than the first
+	Array<double> threadData_;
+	Array<int> threadAdded_;
+	// Merge data accumulated by other threads into the main histogram
+	void mergeThreads();
 };
 
 ATEN_END_NAMESPACE
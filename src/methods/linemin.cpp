@@ -68,6 +68,7 @@ void LineMinimiser::gradientMove(Model* srcmodel, double delta)
 		destatoms[i]->r() = srcatoms[i]->r();
 		if (!srcatoms[i]->isPositionFixed()) destatoms[i]->r() += srcatoms[i]->f() * delta;
 	}
+	tempModel_.logChange(Log::Coordinates);
 	Messenger::exit("LineMinimiser::gradientMove");
 }
 
@@ -24,6 +24,7 @@
 #include "model/clipboard.h"
 #include "base/pattern.h"
 #include "base/sysfunc.h"
+#include "ff/incrementalenergy.h"
 
 ATEN_BEGIN_NAMESPACE
 
@@ -89,6 +90,7 @@ MonteCarlo::MonteCarlo()
 	disorderRecoveryMaxCycles_ = 30;
 	disorderRecoveryMaxTweaks_ = 10;
 	disorderRecoveryThreshold_ = 0.90;
+	disorderBatchSize_ = 1;
 }
 
 // Destructor
@@ -329,6 +331,18 @@ double MonteCarlo::disorderRecoveryThreshold()
 	return disorderRecoveryThreshold_;
 }
 
+// Set number of candidate insertions to screen at once (in parallel) per component
+void MonteCarlo::setDisorderBatchSize(int n)
+{
+	disorderBatchSize_ = (n < 1 ? 1 : n);
+}
+
+// Return number of candidate insertions to screen at once (in parallel) per component
+int MonteCarlo::disorderBatchSize()
+{
+	return disorderBatchSize_;
+}
+
 // MC Geometry Minimise
 bool MonteCarlo::minimise(Model* srcmodel, double econ, double fcon)
 {
@@ -337,7 +351,7 @@ bool MonteCarlo::minimise(Model* srcmodel, double econ, double fcon)
 	Messenger::enter("MonteCarlo::minimise");
 	int n, cycle, nmoves, move, mol, randpat, npats;
 	double newEnergy, currentEnergy, lastPrintedEnergy, currentVdwEnergy, currentElecEnergy, phi, theta;
-	double deltaMoleculeEnergy, deltaVdwEnergy, deltaElecEnergy, referenceMoleculeEnergy, referenceVdwEnergy, referenceElecEnergy;
+	double deltaMoleculeEnergy, deltaVdwEnergy, deltaElecEnergy;
 	Vec3<double> v;
 	double beta = 1.0 / (prefs.gasConstant() * temperature_);
 	bool success;
@@ -373,6 +387,14 @@ bool MonteCarlo::minimise(Model* srcmodel, double econ, double fcon)
 	currentVdwEnergy = srcmodel->energy.vdw();
 	currentElecEnergy = srcmodel->energy.electrostatic();
 	lastPrintedEnergy = currentEnergy;
+
+	// Set up incremental energy data, so that energy changes for single molecule moves may be calculated locally
+	IncrementalEnergy incrementalEnergy;
+	if (!incrementalEnergy.initialise(srcmodel))
+	{
+		Messenger::exit("MonteCarlo::minimise");
+		return false;
+	}
 	Messenger::print("--     %13.6e               %13.6e %13.6e", currentEnergy,  currentVdwEnergy, currentElecEnergy);
 
 	// Cycle through move types; try and perform nTrials_ for each; move on.
@@ -409,11 +431,6 @@ bool MonteCarlo::minimise(Model* srcmodel, double econ, double fcon)
 				// Copy the coordinates of the current molecule
 				if (p->nMolecules() != 0) bakmodel.copyAtomData(srcmodel, Atom::PositionData, p->offset(mol),p->nAtoms());
 
-				// Calculate reference energy (before move)
-				referenceMoleculeEnergy = srcmodel->moleculeEnergy(srcmodel, p, mol, success);
-				referenceVdwEnergy = srcmodel->energy.vdw();
-				referenceElecEnergy = srcmodel->energy.electrostatic();
-
 				// Otherwise, generate the new configuration (in model's cfg space)
 				switch (move)
 				{
@@ -435,13 +452,8 @@ bool MonteCarlo::minimise(Model* srcmodel, double econ, double fcon)
 					// Other moves....
 				}
 
-				// Get the energy of this new configuration.
-				newEnergy = srcmodel->moleculeEnergy(srcmodel, p, mol, success);
-
-				// If the energy has gone up, undo the move.
-				deltaMoleculeEnergy = newEnergy - referenceMoleculeEnergy;
-				deltaVdwEnergy = srcmodel->energy.vdw() - referenceVdwEnergy;
-				deltaElecEnergy = srcmodel->energy.electrostatic() - referenceElecEnergy;
+				// Get the change in energy resulting from the move
+				deltaMoleculeEnergy = incrementalEnergy.trialMove(p, mol, deltaVdwEnergy, deltaElecEnergy);
 
 				// Do we accept the move?
 				if ((deltaMoleculeEnergy < acceptanceEnergy_[move]) || ( AtenMath::random() < exp(-beta*deltaMoleculeEnergy) ))
@@ -451,6 +463,7 @@ bool MonteCarlo::minimise(Model* srcmodel, double econ, double fcon)
 					currentVdwEnergy += deltaVdwEnergy;
 					currentElecEnergy += deltaElecEnergy;
 					acceptanceRatio_[0][move] ++;
+					incrementalEnergy.acceptMove();
 				}
 				else
 				{
@@ -129,6 +129,8 @@ class MonteCarlo
 	int disorderRecoveryMaxTweaks_;
 	// Fraction of non-overlapping component molecules required for success
 	double disorderRecoveryThreshold_;
+	// Number of candidate insertions to screen at once (in parallel) per component (1 for serial insertion)
+	int disorderBatchSize_;
 
 	public:
 	// Set maximum number of disorder cycles to perform
@@ -179,6 +181,10 @@ class MonteCarlo
 	void setDisorderRecoveryThreshold(double d);
 	// Return fraction of non-overlapping component molecules required for success
 	double disorderRecoveryThreshold();
+	// Set number of candidate insertions to screen at once (in parallel) per component
+	void setDisorderBatchSize(int n);
+	// Return number of candidate insertions to screen at once (in parallel) per component
+	int disorderBatchSize();
 	
 	
 	/*
@@ -344,6 +344,7 @@ void PartitioningScheme::recalculatePartitions()
 		Messenger::incrementTaskProgress(task);
 	}
 	Messenger::terminateTask(task);
+	grid_.logDataChange();
 
 	partitionLogPoint_ = changeLog_;
 
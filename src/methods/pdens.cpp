@@ -20,6 +20,7 @@
 */
 
 #include "methods/pdens.h"
+#include "methods/centrecelllist.h"
 #include "model/model.h"
 #include "base/site.h"
 #include "base/pattern.h"
@@ -34,8 +35,10 @@ Pdens::Pdens()
 	sites_[1] = NULL;
 	stepSize_ = 0.5;
 	nSteps_ = 30;
+	totalSteps_ = nSteps_ + nSteps_ + 1;
+	binary_ = true;
+	excludeSelf_ = false;
 	nAdded_ = 0;
-	data_ = NULL;
 }
 
 // Destructor
@@ -43,7 +46,6 @@ Pdens::~Pdens()
 {
 	if (sites_[0] != NULL) delete sites_[0];
 	if (sites_[1] != NULL) delete sites_[1];
-	if (data_ != NULL) delete[] data_;
 }
 
 // Get stepsize
@@ -58,6 +60,18 @@ int Pdens::nSteps() const
 	return nSteps_;
 }
 
+// Set whether to save data in binary format
+void Pdens::setBinary(bool b)
+{
+	binary_ = b;
+}
+
+// Return whether to save data in binary format
+bool Pdens::binary() const
+{
+	return binary_;
+}
+
 // Set site
 void Pdens::setSite(int i, Site* s)
 {
@@ -87,25 +101,24 @@ bool Pdens::initialise()
 	Messenger::enter("Pdens::initialise");
 
 	// Check site definitions....
-	if ((sites_[0] == NULL) || (sites_[1] == NULL))
+	if ((sites_[0] == NULL) || (sites_[1] == NULL) || (sites_[0]->pattern() == NULL) || (sites_[1]->pattern() == NULL))
 	{
 		Messenger::print("Pdens::initialise - At least one site has NULL value.");
-		Messenger::exit("calculable::initialise");
+		Messenger::exit("Pdens::initialise");
 		return false;
 	}
-
-	// Create the data_ array
-	int n, m, o;
-	data_ = new double**[totalSteps_];
-	for (n=0; n<totalSteps_; n++)
+	if ((nSteps_ < 0) || (stepSize_ <= 0.0))
 	{
-		data_[n] = new double*[totalSteps_];
-		for (m=0; m<totalSteps_; m++)
-		{
-			data_[n][m] = new double[totalSteps_];
-			for (o=0; o<totalSteps_; o++) data_[n][m][o] = 0.0;
-		}
+		Messenger::print("Pdens::initialise - Invalid grid definition (%i steps of %f).", nSteps_, stepSize_);
+		Messenger::exit("Pdens::initialise");
+		return false;
 	}
+
+	// Identical molecules in the two sites must not be paired with themselves
+	excludeSelf_ = (sites_[0] == sites_[1]) || ((sites_[0]->pattern() == sites_[1]->pattern()) && (sites_[0]->atoms == sites_[1]->atoms));
+
+	// Create the data_ array
+	data_.createEmpty(totalSteps_*totalSteps_*totalSteps_, 0.0);
 	Messenger::print("There are %i gridpoints of %f Angstrom along each cartesian axis in pdens '%s'.", totalSteps_, stepSize_, qPrintable(name_));
 	nAdded_ = 0;
 
@@ -113,79 +126,159 @@ bool Pdens::initialise()
 	return true;
 }
 
-// Accumulate quantity data_ from supplied model
-void Pdens::accumulate(Model* sourcemodel)
+// Accumulate quantity data_ from supplied model, using the accumulators of the specified thread
+void Pdens::accumulate(Model* sourcemodel, int thread)
 {
 	Messenger::enter("Pdens::accumulate");
 
-	int m1, m2;
-	static Vec3<double> centre1, centre2, mimd;
-	static Vec3<int> gridPoint;
-	Matrix axes;
+	int m1, m2, n, k, x, y, z;
 	UnitCell& cell = sourcemodel->cell();
+	double* data = (thread > 0 ? threadData_.array() + (thread-1)*totalSteps_*totalSteps_*totalSteps_ : data_.array());
 
-	// Loop over molecules for site1
-	for (m1=0; m1 < sites_[0]->pattern()->nMolecules(); m1++)
+	// Only molecules within the sphere enclosing the grid (whose gridpoints lie at -nsteps..0..+nsteps steps along each axis) can contribute
+	double halfExtent = (nSteps_ + 0.5) * stepSize_, cutoffSq = 3.0 * halfExtent * halfExtent, rStepSize = 1.0 / stepSize_;
+
+	// Calculate centres of both sites, and local coordinate systems of the first, once for this frame
+	int nMolecules1 = sites_[0]->pattern()->nMolecules(), nMolecules2 = sites_[1]->pattern()->nMolecules();
+	Array< Vec3<double> > centres1(nMolecules1), centres2(nMolecules2);
+	Array<Matrix> axes1(nMolecules1);
+	for (m1=0; m1<nMolecules1; ++m1)
 	{
-		// Get central position and local coordinate system
-		centre1 = sourcemodel->siteCentre(sites_[0],m1);
-		axes = sourcemodel->siteAxes(sites_[0],m1);
-		// Loop over molecules for site2
-		for (m2 = 0; m2 < sites_[1]->pattern()->nMolecules(); m2++)
+		centres1[m1] = sourcemodel->siteCentre(sites_[0], m1);
+		axes1[m1] = sourcemodel->siteAxes(sites_[0], m1);
+	}
+	for (m2=0; m2<nMolecules2; ++m2) centres2[m2] = sourcemodel->siteCentre(sites_[1], m2);
+
+	// Sort centres of the second site into cells no narrower than the grid's enclosing sphere, so that only neighbouring cells need be searched
+	CentreCellList cellList;
+	cellList.create(cell, centres2, centres1, sqrt(cutoffSq));
+
+	// Loop over molecules for site1, searching neighbouring cells for molecules of site2
+	int cells[27], nCells, nCellCentres;
+	const int* cellCentres;
+	Vec3<double> mimd;
+	for (m1=0; m1<nMolecules1; ++m1)
+	{
+		const Vec3<double> centre1 = centres1.value(m1);
+		Matrix& axes = axes1[m1];
+		nCells = cellList.neighbourCells(centre1, cells);
+		for (n=0; n<nCells; ++n)
 		{
-			centre2 = sourcemodel->siteCentre(sites_[1],m2);
-			// Calculate minimum image vector and translate into local coordinate system...
-			mimd = axes.transform(cell.mimVector(centre1,centre2));
-			// ...and work out the gridpoint (convert to 0..totalSteps_ from -nsteps..0..+nsteps)
-			gridPoint.x = int(mimd.x / stepSize_);
-			gridPoint.y = int(mimd.y / stepSize_);
-			gridPoint.z = int(mimd.z / stepSize_);
-			gridPoint += nSteps_;
-	//printf("Adding distance %f to bin %i\n",mimd.magnitude(),bin);
-			addPoint(gridPoint);
+			nCellCentres = cellList.nCentres(cells[n]);
+			cellCentres = cellList.centres(cells[n]);
+			for (k=0; k<nCellCentres; ++k)
+			{
+				m2 = cellCentres[k];
+				if (excludeSelf_ && (m1 == m2)) continue;
+
+				// Calculate minimum image vector, and discard it if it cannot lie within the grid...
+				mimd = cell.mimVector(centre1, centres2.value(m2));
+				if (mimd.magnitudeSq() > cutoffSq) continue;
+
+				// ...otherwise translate it into the local coordinate system and find the nearest gridpoint (converting to 0..totalSteps_ from -nsteps..0..+nsteps)
+				mimd = axes.transform(mimd);
+				x = int(floor(mimd.x * rStepSize + 0.5)) + nSteps_;
+				if ((x < 0) || (x >= totalSteps_)) continue;
+				y = int(floor(mimd.y * rStepSize + 0.5)) + nSteps_;
+				if ((y < 0) || (y >= totalSteps_)) continue;
+				z = int(floor(mimd.z * rStepSize + 0.5)) + nSteps_;
+				if ((z < 0) || (z >= totalSteps_)) continue;
+				data[(x*totalSteps_ + y)*totalSteps_ + z] += 1.0;
+			}
 		}
 	}
 
 	// Increase accumulation counter
-	nAdded_ ++;
+	if (thread > 0) ++threadAdded_[thread-1];
+	else nAdded_ ++;
 
 	Messenger::exit("Pdens::accumulate");
 }
 
-// Add point to data_ array
-void Pdens::addPoint(Vec3<int> &coords)
-{
-	// Check coordinates of gridpoint given
-	if ((coords.x < 0) || (coords.x >= totalSteps_)) return;
-	if ((coords.y < 0) || (coords.y >= totalSteps_)) return;
-	if ((coords.z < 0) || (coords.z >= totalSteps_)) return;
-	if (data_ == NULL) printf("Pdens::add_point <<<< Data array not initialised! >>>>\n");
-	else data_[coords.x][coords.y][coords.z] += 1.0;
-}
-
 // Finalise
 void Pdens::finalise(Model* sourcemodel)
 {
 	Messenger::enter("Pdens::finalise");
-	int n, m, o;
+	int n, nPoints = data_.nItems();
 	double factor, numberDensity;
+	mergeThreads();
 	// Normalise the pdens w.r.t. number of frames, number of central molecules, and number density of system
 	numberDensity = sites_[1]->pattern()->nMolecules() / sourcemodel->cell().volume() * (stepSize_ * stepSize_ * stepSize_);
 	factor = double(nAdded_) * sites_[0]->pattern()->nMolecules() * numberDensity;
-	for (n=0; n<totalSteps_; n++)
-		for (m=0; m<totalSteps_; m++)
-			for (o=0; o<totalSteps_; o++) data_[n][m][o] /= factor;
+	double* data = data_.array();
+	for (n=0; n<nPoints; ++n) data[n] /= factor;
 	Messenger::exit("Pdens::finalise");
 }
 
 // Save pdens data_
 bool Pdens::save()
 {
-	int n, m, o;
+	int n, nPoints = data_.nItems();
+	double origin = -nSteps_ * stepSize_;
+
+	// Both formats can be loaded by the pdens grid plugin, with values written so that z varies fastest
+	if (binary_)
+	{
+		// Binary format is the tag 'PDENSBIN', four 32-bit integers (number of gridpoints along x, y, and z, and the
+		// size of each value in bytes), nine doubles for the axis system, three for the origin, and then the values
+		std::ofstream output(qPrintable(filename_), std::ios::out | std::ios::binary);
+		if (!output.is_open())
+		{
+			Messenger::print("Couldn't open file '%s' for writing.", qPrintable(filename_));
+			return false;
+		}
+		qint32 header[4] = { totalSteps_, totalSteps_, totalSteps_, sizeof(float) };
+		double vectors[12] = { stepSize_, 0.0, 0.0, 0.0, stepSize_, 0.0, 0.0, 0.0, stepSize_, origin, origin, origin };
+		output.write("PDENSBIN", 8);
+		output.write((const char*) header, sizeof(header));
+		output.write((const char*) vectors, sizeof(vectors));
+		Array<float> values(nPoints);
+		for (n=0; n<nPoints; ++n) values[n] = data_.value(n);
+		output.write((const char*) values.array(), nPoints*sizeof(float));
+		output.close();
+		return !output.fail();
+	}
+
 	std::ofstream output(qPrintable(filename_), std::ios::out);
-	for (n=0; n<totalSteps_; n++)
-		for (m=0; m<totalSteps_; m++)
-			for (o=0; o<totalSteps_; o++) output << data_[n][m][o] << "\n";
+	if (!output.is_open())
+	{
+		Messenger::print("Couldn't open file '%s' for writing.", qPrintable(filename_));
+		return false;
+	}
+	output << totalSteps_ << " " << totalSteps_ << " " << totalSteps_ << "\n";
+	output << stepSize_ << " 0.0 0.0 0.0 " << stepSize_ << " 0.0 0.0 0.0 " << stepSize_ << "\n";
+	output << origin << " " << origin << " " << origin << "\n";
+	output << "zyx\n";
+	for (n=0; n<nPoints; ++n) output << data_.value(n) << "\n";
 	output.close();
 	return true;
 }
+
+// Prepare separate accumulators for the specified number of threads
+void Pdens::prepareThreads(int nThreads)
+{
+	// Keep anything accumulated so far before resizing the thread arrays
+	mergeThreads();
+	Calculable::prepareThreads(nThreads);
+	threadData_.createEmpty((nThreads_-1)*totalSteps_*totalSteps_*totalSteps_, 0.0);
+	threadAdded_.createEmpty(nThreads_-1, 0);
+}
+
+// Merge data accumulated by other threads into the main distribution
+void Pdens::mergeThreads()
+{
+	int n, t, nPoints = data_.nItems(), index = 0;
+	if (nPoints == 0) return;
+	double* data = data_.array();
+	double* threadData = threadData_.array();
+	for (t=0; t<threadAdded_.nItems(); ++t)
+	{
+		for (n=0; n<nPoints; ++n)
+		{
+			data[n] += threadData[index];
+			threadData[index++] = 0.0;
+		}
+		nAdded_ += threadAdded_[t];
+		threadAdded_[t] = 0;
+	}
+}
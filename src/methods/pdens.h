@@ -24,13 +24,14 @@
 
 #include "methods/calculable.h"
 #include "templates/vector3.h"
+#include "templates/array.h"
 
 ATEN_BEGIN_NAMESPACE
 
 // Forward Declarations (Aten)
 class Site;
 
-// Radial Distribution Function Class
+// Probability Density Class
 class Pdens : public Calculable
 {
 	public:
@@ -55,15 +56,21 @@ class Pdens : public Calculable
 	/*
 	 * Methods
 	 */
+	private:
+	// Whether pairs of identical molecules in the two sites must be excluded
+	bool excludeSelf_;
+
 	public:
 	// Initialise structure
 	bool initialise();
-	// Accumulate quantity data from supplied model
-	void accumulate(Model* model);
+	// Accumulate quantity data from supplied model, using the accumulators of the specified thread
+	void accumulate(Model* model, int thread = 0);
 	// Finalise data
 	void finalise(Model* model);
 	// Save data
 	bool save();
+	// Prepare separate accumulators for the specified number of threads
+	void prepareThreads(int nThreads);
 
 
 	/*
@@ -76,6 +83,8 @@ class Pdens : public Calculable
 	int totalSteps_;
 	// Step size between gridpoints
 	double stepSize_;
+	// Whether to save data in binary format
+	bool binary_;
 
 	public:
 	// Set distribution data
@@ -84,17 +93,24 @@ class Pdens : public Calculable
 	double stepSize() const;
 	// Get number of bins
 	int nSteps() const;
+	// Set whether to save data in binary format
+	void setBinary(bool b);
+	// Return whether to save data in binary format
+	bool binary() const;
 
 	/*
 	 * Data
 	 */
 	private:
-	// Distribution
-	double*** data_;
-	// Add point to data array
-	void addPoint(Vec3<int>& location);
+	// Distribution (flattened, with z varying fastest)
+	Array<double> data_;
 	// Count for number of added data (i.e. nframes)
 	int nAdded_;
+	// Distributions (flattened) and counts accumulated by threads other than the first
+	Array<double> threadData_;
+	Array<int> threadAdded_;
+	// Merge data accumulated by other threads into the main distribution
+	void mergeThreads();
 };
 
 ATEN_END_NAMESPACE
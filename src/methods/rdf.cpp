@@ -20,24 +20,44 @@
 */
 
 #include "methods/rdf.h"
+#include "methods/centrecelllist.h"
 #include "model/model.h"
 #include "base/site.h"
 #include "base/pattern.h"
+#include "base/elementmap.h"
+#include "base/forcefieldatom.h"
+#include "base/lineparser.h"
+#include "base/sysfunc.h"
 
 ATEN_USING_NAMESPACE
 
+// Partial RDF types
+const char* RdfPartialTypeKeywords[Rdf::nPartialTypes] = { "none", "element", "type" };
+Rdf::PartialType Rdf::partialType(QString s, bool reportError)
+{
+	Rdf::PartialType pt = (Rdf::PartialType) enumSearch("partial rdf type", Rdf::nPartialTypes, RdfPartialTypeKeywords, s, reportError);
+	if ((pt == Rdf::nPartialTypes) && reportError) enumPrintValid(Rdf::nPartialTypes,RdfPartialTypeKeywords);
+	return pt;
+}
+const char* Rdf::partialType(Rdf::PartialType pt)
+{
+	return RdfPartialTypeKeywords[pt];
+}
+
 // Constructor
 Rdf::Rdf()
 {
 	sites_[0] = NULL;
 	sites_[1] = NULL;
+	partialType_ = Rdf::NoPartials;
+	excludeSelf_ = false;
 	lower_ = 0.0;
 	upper_ = 15.0;
 	binWidth_ = 0.1;
 	nBins_ = 150;
 	range_ = 15.0;
+	nHistograms_ = 1;
 	nAdded_ = 0;
-	data_ = NULL;
 }
 
 // Destructor
@@ -45,7 +65,6 @@ Rdf::~Rdf()
 {
 	if (sites_[0] != NULL) delete sites_[0];
 	if (sites_[1] != NULL) delete sites_[1];
-	if (data_ != NULL) delete[] data_;
 }
 
 // Get lower limit
@@ -81,6 +100,18 @@ Site* Rdf::site(int i)
 	return NULL;
 }
 
+// Set type of partial RDFs to calculate
+void Rdf::setPartialType(Rdf::PartialType pt)
+{
+	partialType_ = pt;
+}
+
+// Return type of partial RDFs to calculate
+Rdf::PartialType Rdf::partialType() const
+{
+	return partialType_;
+}
+
 // Set RDF range_
 void Rdf::setRange(double d, double w, int n)
 {
@@ -91,58 +122,178 @@ void Rdf::setRange(double d, double w, int n)
 	range_ = upper_ - lower_;
 }
 
+// Calculate centres, their labels, and their identities for specified site in supplied model
+void Rdf::calculateCentres(Model* sourceModel, int site, Array< Vec3<double> >& centres, Array<int>& labels, Array<int>& ids)
+{
+	Site* s = sites_[site];
+	Pattern* p = s->pattern();
+	int m, n, id;
+
+	centres.forgetData();
+	labels.forgetData();
+	ids.forgetData();
+
+	if (partialType_ == Rdf::NoPartials)
+	{
+		// One centre per molecule, identified by molecule index
+		for (m=0; m<p->nMolecules(); ++m)
+		{
+			centres.add(sourceModel->siteCentre(s, m));
+			labels.add(0);
+			ids.add(m);
+		}
+	}
+	else
+	{
+		// Each atom of the site is a centre in its own right, identified by its atom index
+		AtomStore& store = sourceModel->atomStore();
+		for (m=0; m<p->nMolecules(); ++m)
+		{
+			id = p->startAtom() + m*p->nAtoms();
+			if (s->atoms.count() != 0) for (n=0; n<s->atoms.count(); ++n)
+			{
+				centres.add(store.r(id + s->atoms.at(n)));
+				labels.add(atomLabels_[site].value(s->atoms.at(n)));
+				ids.add(id + s->atoms.at(n));
+			}
+			else for (n=0; n<p->nAtoms(); ++n)
+			{
+				centres.add(store.r(id + n));
+				labels.add(atomLabels_[site].value(n));
+				ids.add(id + n);
+			}
+		}
+	}
+}
+
 // Initialise structure
 bool Rdf::initialise()
 {
 	Messenger::enter("Rdf::initialise");
 
 	// Check site definitions....
-	if ((sites_[0] == NULL) || (sites_[1] == NULL))
+	if ((sites_[0] == NULL) || (sites_[1] == NULL) || (sites_[0]->pattern() == NULL) || (sites_[1]->pattern() == NULL))
 	{
 		Messenger::print("Rdf::initialise - At least one site has NULL value.");
 		Messenger::exit("Rdf::initialise");
 		return false;
 	}
+	if ((nBins_ < 1) || (binWidth_ <= 0.0))
+	{
+		Messenger::print("Rdf::initialise - Invalid bin definition (%i bins of width %f).", nBins_, binWidth_);
+		Messenger::exit("Rdf::initialise");
+		return false;
+	}
+
+	int s, n, m, label;
+	Pattern* p;
+	Atom* i;
+
+	// Determine labels (elements or types) of atoms in each site's pattern
+	labels_.clear();
+	for (s=0; s<2; ++s)
+	{
+		p = sites_[s]->pattern();
+		atomLabels_[s].createEmpty(p->nAtoms(), 0);
+		if (partialType_ == Rdf::NoPartials) continue;
+		i = p->firstAtom();
+		for (n=0; n<p->nAtoms(); ++n)
+		{
+			QString name = ((partialType_ == Rdf::TypePartials) && i->type() ? i->type()->name() : QString(ElementMap::symbol(i)));
+			label = labels_.indexOf(name);
+			if (label == -1)
+			{
+				label = labels_.count();
+				labels_ << name;
+			}
+			atomLabels_[s][n] = label;
+			i = i->next;
+		}
+	}
+	nHistograms_ = 1 + labels_.count()*labels_.count();
+
+	// Count centres in each site (in total, and for each label)
+	for (s=0; s<2; ++s)
+	{
+		p = sites_[s]->pattern();
+		nCentres_[s].createEmpty(labels_.count()+1, 0);
+		if (partialType_ == Rdf::NoPartials) nCentres_[s][0] = p->nMolecules();
+		else for (m=0; m<p->nMolecules(); ++m)
+		{
+			int nSiteAtoms = (sites_[s]->atoms.count() != 0 ? sites_[s]->atoms.count() : p->nAtoms());
+			for (n=0; n<nSiteAtoms; ++n)
+			{
+				++nCentres_[s][0];
+				++nCentres_[s][1+atomLabels_[s].value(sites_[s]->atoms.count() != 0 ? sites_[s]->atoms.at(n) : n)];
+			}
+		}
+	}
+
+	// Identical centres in the two sites must not be paired with themselves
+	if (partialType_ != Rdf::NoPartials) excludeSelf_ = true;
+	else excludeSelf_ = (sites_[0] == sites_[1]) || ((sites_[0]->pattern() == sites_[1]->pattern()) && (sites_[0]->atoms == sites_[1]->atoms));
 
 	// Create the data_ arrays
-	data_ = new double[nBins_];
-	for (int n=0; n<nBins_; n++) data_[n] = 0.0;
+	data_.createEmpty(nHistograms_*nBins_, 0.0);
 	Messenger::print("There are %i bins in rdf '%s', beginning at r = %f.", nBins_, qPrintable(name_), lower_);
+	if (partialType_ != Rdf::NoPartials) Messenger::print("Partial RDFs will be calculated between %i distinct %ss.", labels_.count(), Rdf::partialType(partialType_));
 	nAdded_ = 0;
 
 	Messenger::exit("Rdf::initialise");
 	return true;
 }
 
-// Accumulate quantity data_ from supplied model
-void Rdf::accumulate(Model* sourcemodel)
+// Accumulate quantity data_ from supplied model, using the accumulators of the specified thread
+void Rdf::accumulate(Model* sourcemodel, int thread)
 {
 	Messenger::enter("Rdf::accumulate");
 
-	int m1, m2, bin;
-	static Vec3<double> centre1, centre2, mimd;
+	int i, j, k, n, bin, nLabels = labels_.count();
+	double rSq, lowerSq = (lower_ > 0.0 ? lower_*lower_ : 0.0), upperSq = upper_*upper_;
 	UnitCell& cell = sourcemodel->cell();
+	double* data = (thread > 0 ? threadData_.array() + (thread-1)*nHistograms_*nBins_ : data_.array());
+
+	// Calculate all centres once for this frame
+	Array< Vec3<double> > centres1, centres2;
+	Array<int> labels1, labels2, ids1, ids2;
+	calculateCentres(sourcemodel, 0, centres1, labels1, ids1);
+	calculateCentres(sourcemodel, 1, centres2, labels2, ids2);
+	int nCentres1 = centres1.nItems();
 
-	// Loop over molecules for site1
-	for (m1=0; m1 < sites_[0]->pattern()->nMolecules(); m1++)
+	// Sort centres of the second site into cells no narrower than the upper limit of the RDF, so that only neighbouring cells need be searched
+	CentreCellList cellList;
+	cellList.create(cell, centres2, centres1, upper_);
+
+	// Loop over centres of first site, searching neighbouring cells for centres of the second site
+	int cells[27], nCells, nCellCentres;
+	const int* cellCentres;
+	for (i=0; i<nCentres1; ++i)
 	{
-		// Get first centre
-		centre1 = sourcemodel->siteCentre(sites_[0],m1);
-		// Loop over molecules for site2
-		for (m2 = 0; m2 < sites_[1]->pattern()->nMolecules(); m2++)
+		const Vec3<double> r1 = centres1.value(i);
+		nCells = cellList.neighbourCells(r1, cells);
+		for (n=0; n<nCells; ++n)
 		{
-			centre2 = sourcemodel->siteCentre(sites_[1],m2);
-			// Calculate minimum image distance and bin
-			mimd = cell.mimVector(centre1,centre2);
-			// Add distance to data_ array
-			bin = int(mimd.magnitude() / binWidth_);
-	//printf("Adding distance %f to bin %i\n",mimd.magnitude(),bin);
-			if (bin < nBins_) data_[bin] += 1.0;
+			nCellCentres = cellList.nCentres(cells[n]);
+			cellCentres = cellList.centres(cells[n]);
+			for (k=0; k<nCellCentres; ++k)
+			{
+				j = cellCentres[k];
+				if (excludeSelf_ && (ids1.value(i) == ids2.value(j))) continue;
+
+				// Calculate minimum image distance, and bin it if it is within the range of the RDF
+				rSq = cell.mimVector(r1, centres2.value(j)).magnitudeSq();
+				if ((rSq < lowerSq) || (rSq >= upperSq)) continue;
+				bin = int((sqrt(rSq) - lower_) / binWidth_);
+				if ((bin < 0) || (bin >= nBins_)) continue;
+				data[bin] += 1.0;
+				if (nLabels > 0) data[(1 + labels1.value(i)*nLabels + labels2.value(j))*nBins_ + bin] += 1.0;
+			}
 		}
 	}
 
 	// Increase counter
-	nAdded_ ++;
+	if (thread > 0) ++threadAdded_[thread-1];
+	else nAdded_ ++;
 
 	Messenger::exit("Rdf::accumulate");
 }
@@ -151,20 +302,43 @@ void Rdf::accumulate(Model* sourcemodel)
 void Rdf::finalise(Model* sourcemodel)
 {
 	Messenger::enter("Rdf::finalise");
-	int n;
-	double factor, r1, r2, numDensity;
-
-	// Normalise the rdf w.r.t. number of frames and number of central molecules
-	for (n=0; n<nBins_; n++) data_[n] /= double(nAdded_) * sites_[0]->pattern()->nMolecules();
-	
-	// Normalise nAdded_ording to number density of sites_ in RDF shells
-	numDensity = sites_[1]->pattern()->nMolecules() / sourcemodel->cell().volume();
-	for (n=0; n<nBins_; n++)
+	int n, h, nLabels = labels_.count();
+	double factor, r1, r2, numDensity, volume, nCentres1, nCentres2;
+
+	mergeThreads();
+
+	if (nAdded_ == 0)
 	{
-		r1 = lower_ + double(n) * binWidth_;
-		r2 = r1 + binWidth_;
-		factor = (4.0 / 3.0) * PI * (r2*r2*r2 - r1*r1*r1) * numDensity;
-		data_[n] /= factor;
+		Messenger::print("No data has been accumulated in RDF '%s'.", qPrintable(name_));
+		Messenger::exit("Rdf::finalise");
+		return;
+	}
+
+	// Without a unit cell there is no number density, so only normalise w.r.t. frames and centres
+	volume = (sourcemodel->cell().type() != UnitCell::NoCell ? sourcemodel->cell().volume() : 0.0);
+	if (volume <= 0.0) Messenger::print("Model has no unit cell, so RDF '%s' will not be normalised to number density.", qPrintable(name_));
+
+	for (h=0; h<nHistograms_; ++h)
+	{
+		nCentres1 = nCentres_[0].value(h == 0 ? 0 : 1 + (h-1)/nLabels);
+		nCentres2 = nCentres_[1].value(h == 0 ? 0 : 1 + (h-1)%nLabels);
+		if ((nCentres1 == 0) || (nCentres2 == 0)) continue;
+
+		double* data = data_.array() + h*nBins_;
+
+		// Normalise the rdf w.r.t. number of frames and number of central molecules
+		for (n=0; n<nBins_; n++) data[n] /= double(nAdded_) * nCentres1;
+
+		// Normalise according to number density of sites in RDF shells
+		if (volume <= 0.0) continue;
+		numDensity = nCentres2 / volume;
+		for (n=0; n<nBins_; n++)
+		{
+			r1 = lower_ + double(n) * binWidth_;
+			r2 = r1 + binWidth_;
+			factor = (4.0 / 3.0) * PI * (r2*r2*r2 - r1*r1*r1) * numDensity;
+			data[n] /= factor;
+		}
 	}
 
 	Messenger::exit("Rdf::finalise");
@@ -173,7 +347,68 @@ void Rdf::finalise(Model* sourcemodel)
 // Save RDF data_
 bool Rdf::save()
 {
-	int n;
-	for (n=0; n<nBins_; n++) printf(" %f  %f\n",binWidth_ * (n + 0.5), data_[n]);
+	Messenger::enter("Rdf::save");
+
+	if (filename_.isEmpty())
+	{
+		Messenger::print("No filename set for RDF '%s' - data not saved.", qPrintable(name_));
+		Messenger::exit("Rdf::save");
+		return false;
+	}
+
+	LineParser parser;
+	if (!parser.openOutput(filename_, true))
+	{
+		Messenger::print("Couldn't open file '%s' for writing.", qPrintable(filename_));
+		Messenger::exit("Rdf::save");
+		return false;
+	}
+
+	int n, h, nLabels = labels_.count();
+
+	// Write header, naming the total and any partial RDFs
+	QString line = "#       r             total";
+	for (h=1; h<nHistograms_; ++h) line += QString("%1").arg(labels_.at((h-1)/nLabels) + "-" + labels_.at((h-1)%nLabels), 14);
+	parser.writeLine(line);
+
+	for (n=0; n<nBins_; n++)
+	{
+		line = QString("%1").arg(lower_ + binWidth_ * (n + 0.5), 12, 'f', 6);
+		for (h=0; h<nHistograms_; ++h) line += QString("  %1").arg(data_.value(h*nBins_ + n), 12, 'e', 5);
+		parser.writeLine(line);
+	}
+	parser.closeFiles();
+
+	Messenger::print("RDF '%s' saved to file '%s'.", qPrintable(name_), qPrintable(filename_));
+
+	Messenger::exit("Rdf::save");
 	return true;
 }
+
+// Prepare separate accumulators for the specified number of threads
+void Rdf::prepareThreads(int nThreads)
+{
+	// Keep anything accumulated so far before resizing the thread arrays
+	mergeThreads();
+	Calculable::prepareThreads(nThreads);
+	threadData_.createEmpty((nThreads_-1)*nHistograms_*nBins_, 0.0);
+	threadAdded_.createEmpty(nThreads_-1, 0);
+}
+
+// Merge data accumulated by other threads into the main histogram
+void Rdf::mergeThreads()
+{
+	if (data_.nItems() == 0) return;
+	int n, t, nData = nHistograms_*nBins_;
+	for (t=0; t<threadAdded_.nItems(); ++t)
+	{
+		double* data = threadData_.array() + t*nData;
+		for (n=0; n<nData; ++n)
+		{
+			data_[n] += data[n];
+			data[n] = 0.0;
+		}
+		nAdded_ += threadAdded_[t];
+		threadAdded_[t] = 0;
+	}
+}
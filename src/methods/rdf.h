@@ -23,6 +23,9 @@
 #define ATEN_RDF_H
 
 #include "methods/calculable.h"
+#include "templates/array.h"
+#include "templates/vector3.h"
+#include <QStringList>
 
 ATEN_BEGIN_NAMESPACE
 
@@ -36,6 +39,10 @@ class Rdf : public Calculable
 	// Constructor / Destructor
 	Rdf();
 	~Rdf();
+	// Partial RDF types
+	enum PartialType { NoPartials, ElementPartials, TypePartials, nPartialTypes };
+	static PartialType partialType(QString s, bool reportError = false);
+	static const char* partialType(PartialType pt);
 
 	/*
 	 * Sites
@@ -50,18 +57,45 @@ class Rdf : public Calculable
 	// Get site involved in RDF
 	Site* site(int);
 
+	/*
+	 * Partials
+	 */
+	private:
+	// Type of partial RDFs to calculate (if any)
+	PartialType partialType_;
+	// Names of distinct elements / types present in the sites
+	QStringList labels_;
+	// Label index of each atom in a molecule of each site's pattern
+	Array<int> atomLabels_[2];
+	// Number of centres of each site (and of each label, for partials) in each frame
+	Array<int> nCentres_[2];
+
+	public:
+	// Set type of partial RDFs to calculate
+	void setPartialType(PartialType pt);
+	// Return type of partial RDFs to calculate
+	PartialType partialType() const;
+
 	/*
 	 * Methods
 	 */
+	private:
+	// Whether pairs of identical centres (same atom, or same molecule for identical sites) must be excluded
+	bool excludeSelf_;
+	// Calculate centres, their labels, and their identities for specified site in supplied model
+	void calculateCentres(Model* sourceModel, int site, Array< Vec3<double> >& centres, Array<int>& labels, Array<int>& ids);
+
 	public:
 	// Initialise structure
 	bool initialise();
-	// Accumulate quantity data from supplied config
-	void accumulate(Model*);
+	// Accumulate quantity data from supplied config, using the accumulators of the specified thread
+	void accumulate(Model*, int thread = 0);
 	// Finalise data
 	void finalise(Model*);
 	// Save data
 	bool save();
+	// Prepare separate accumulators for the specified number of threads
+	void prepareThreads(int nThreads);
 
 	/*
 	 * Data Description
@@ -88,10 +122,17 @@ class Rdf : public Calculable
 	 * Data
 	 */
 	private:
-	// Distribution function
-	double* data_;
+	// Number of histograms held (total, plus one per label pair for partials)
+	int nHistograms_;
+	// Distribution functions (total first, then partials)
+	Array<double> data_;
 	// Count for number of added data (i.e. nframes)
 	int nAdded_;
+	// Histograms and counts accumulated by threads other than the first
+	Array<double> threadData_;
+	Array<int> threadAdded_;
+	// Merge data accumulated by other threads into the main histogram
+	void mergeThreads();
 };
 
 ATEN_END_NAMESPACE
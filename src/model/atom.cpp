@@ -249,6 +249,13 @@ Atom** Model::atomArray()
 	return atoms_.array();
 }
 
+// Return packed atom data, updating it first if the model has changed
+AtomStore& Model::atomStore()
+{
+	atomStore_.update(this);
+	return atomStore_;
+}
+
 // Clear atoms
 void Model::clearAtoms()
 {
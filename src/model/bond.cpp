@@ -25,6 +25,7 @@
 #include "undo/bond_change.h"
 #include "base/bond.h"
 #include "base/pattern.h"
+#include "base/threadpool.h"
 
 ATEN_USING_NAMESPACE
 
@@ -184,243 +185,80 @@ void Model::clearBonding()
 	Messenger::exit("Model::clearBonding");
 }
 
-// Initialise reflists based on current extent of model
-void Model::initialiseBondingCuboids()
+// Calculate bonding between atoms, optionally restricted to those currently selected
+void Model::rebond(bool selectionOnly)
 {
-	Messenger::enter("Model::initialiseBondingCuboids");
-	double size = 5.0;
-	Vec3<double> r;
-	extentMin_ = 1e6;
-	extentMax_ = -1e6;
-
-	// Nothing to do if there are no atoms in the system
-	cuboidSize_.set(size,size,size);
-	nCuboids_ = 0;
-	if (atoms_.nItems() == 0)
-	{
-		Messenger::exit("Model::initialiseBondingCuboids");
-		return;
-	}
-
-	// Prepare (if non-periodic cell)
-	if (cell_.type() == UnitCell::NoCell)
-	{
-		for (Atom* i = atoms_.first(); i != NULL; i = i->next)
-		{
-			r = i->r();
-			if (r.x < extentMin_.x) extentMin_.x = r.x;
-			if (r.x > extentMax_.x) extentMax_.x = r.x;
-			if (r.y < extentMin_.y) extentMin_.y = r.y;
-			if (r.y > extentMax_.y) extentMax_.y = r.y;
-			if (r.z < extentMin_.z) extentMin_.z = r.z;
-			if (r.z > extentMax_.z) extentMax_.z = r.z;
-		}
-		extentRange_ = extentMax_ - extentMin_;
-	}
-
-	// Main loop
-	do
-	{
-		cuboidSize_.set(size,size,size);
-		nCuboids_ = 0;
-		if (atoms_.nItems() == 0) return;
-		// Determine the number of cuboids to partition our space into
-		if (cell_.type() == UnitCell::NoCell)
-		{
-			cuboidBoxes_.x = int(extentRange_.x / cuboidSize_.x) + 1;
-			cuboidBoxes_.y = int(extentRange_.y / cuboidSize_.y) + 1;
-			cuboidBoxes_.z = int(extentRange_.z / cuboidSize_.z) + 1;
-		}
-		else
-		{
-			// For periodic systems, we will use fractional coordinates to partition the atoms
-// 			foldAllAtoms();
-			extentMin_ = 0.0;
-			extentMax_ = 1.0;
-			extentRange_ = 1.0;
-			// Work out the box sizes necessary in each direction to get a suitable box length and no remainder of 'overlap'
-			Vec3<double> lengths = cell_.lengths();
-			lengths /= cuboidSize_;
-			Vec3<int> ilengths;
-			ilengths.set( (int) lengths.x, (int) lengths.y, (int) lengths.z);
-			for (int n=0; n<3; ++n) if (ilengths.get(n) == 0) ilengths.set(n,1);
-			cuboidSize_.set(1.0 / ilengths.x, 1.0 / ilengths.y, 1.0 / ilengths.z);
-			cuboidBoxes_.set(ilengths.x, ilengths.y, ilengths.z);
-		}
-		nCuboids_ = cuboidBoxes_.x * cuboidBoxes_.y * cuboidBoxes_.z;
-		if (cuboidBoxes_.max() > prefs.maxCuboids())
-		{
-			size += 1.0;
-			Messenger::print(Messenger::Verbose, "Too many cuboids (%ix%ix%i) - bonding cuboid size increased to %f.", cuboidBoxes_.x, cuboidBoxes_.y, cuboidBoxes_.z, size);
-		}
-	} while (cuboidBoxes_.max() > prefs.maxCuboids());
-	cuboidYZ_ = cuboidBoxes_.y * cuboidBoxes_.z;
-	freeBondingCuboids();
-// 	printf("Box counts: x = %i, y = %i, z = %i, cube = %i\n", cuboidBoxes_.x, cuboidBoxes_.y, cuboidBoxes_.z, nCuboids_);
-// 	printf("CuboidSize = "); cuboidSize_.print();
-// 	printf("ExtentMin = "); extentMin_.print(); 
-// 	printf("ExtentMax = "); extentMax_.print();
-// 	printf("ExtentRange = "); extentRange_.print();
-	bondingCuboids_ = new RefList<Atom,double>[nCuboids_];
-	bondingOverlays_ = new RefList<Atom,double>[nCuboids_];
-	Messenger::exit("Model::initialiseBondingCuboids");
-}
-
-// Free any created reflists
-void Model::freeBondingCuboids()
-{
-	Messenger::enter("Model::freeBondingCuboids");
-	if (bondingCuboids_ != NULL) delete[] bondingCuboids_;
-	if (bondingOverlays_ != NULL) delete[] bondingOverlays_;
-	bondingCuboids_ = NULL;
-	bondingOverlays_ = NULL;
-	Messenger::exit("Model::freeBondingCuboids");
-}
-
-// Add atom to cuboid reflists
-void Model::addAtomToCuboid(Atom* i)
-{
-	int x,y,z;
-	Vec3<double> r;
-	if (cell_.type() == UnitCell::NoCell)
-	{
-		// No unit cell to use, so just use normal coordinates
-		r = i->r();
-	}
-	else
+	Messenger::enter("Model::rebond");
+	double tolerance = prefs.bondTolerance();
+	AtomStore& store = atomStore();
+	double* x = store.x(), *y = store.y(), *z = store.z();
+	int* elements = store.elements();
+	int nAtoms = store.nAtoms(), n;
+	Atom** modelatoms = atomArray();
+
+	// Determine the radius of each atom to be considered (or -1 if it is to be ignored), and the largest of them
+	Array<double> radii;
+	radii.createEmpty(nAtoms, -1.0);
+	double* radius = radii.array();
+	double maxRadius = 0.0;
+	for (n=0; n<nAtoms; ++n)
 	{
-		// There is a unit cell, so we must fold the atoms coordinates into the box
-		r = cell_.realToFrac(i->r());
-		cell_.foldFrac(r);
+		// Check for excluded elements
+		if (elements[n] == 0) continue;
+		if (selectionOnly && (!modelatoms[n]->isSelected())) continue;
+		radius[n] = ElementMap::atomicRadius(elements[n]);
+		if (radius[n] > maxRadius) maxRadius = radius[n];
 	}
-	r -= extentMin_;
-	double radius = ElementMap::atomicRadius(i->element());
-	x = int(r.x / cuboidSize_.x);
-	y = int(r.y / cuboidSize_.y);
-	z = int(r.z / cuboidSize_.z);
-
-	// 'Fold' cuboid range, just in case
-	if (x < 0) x += cuboidBoxes_.x;
-	else if (x >= cuboidBoxes_.x) x -= cuboidBoxes_.x;
-	if (y < 0) y += cuboidBoxes_.y;
-	else if (y >= cuboidBoxes_.y) y -= cuboidBoxes_.y;
-	if (z < 0) z += cuboidBoxes_.z;
-	else if (z >= cuboidBoxes_.z) z -= cuboidBoxes_.z;
-	
-	int boxnumber = x*cuboidYZ_+y*cuboidBoxes_.z+z;
-	//printf("Atom %i is in box %i-%i-%i=%i\n ", i->id(), x,y,z,x*cuboidYZ_+y*cuboidBoxes_.z+z);
-	if ((boxnumber < 0) || (boxnumber >= nCuboids_)) 
+	if (maxRadius <= 0.0)
 	{
-		printf("Fatal error : box number is out of range.\n");
+		Messenger::exit("Model::rebond");
 		return;
 	}
-	bondingCuboids_[x*cuboidYZ_+y*cuboidBoxes_.z+z].add(i, radius);
-	// Add to overlay box
-// 	printf("--> Original position"); r.print();
-	r += cuboidSize_*0.5;
-	if (r.x > extentRange_.x) r.x -= extentRange_.x;
-	if (r.y > extentRange_.y) r.y -= extentRange_.y;
-	if (r.z > extentRange_.z) r.z -= extentRange_.z;
-// 	printf("--> Overlay position"); r.print();
-	x = int(r.x / cuboidSize_.x);
-	y = int(r.y / cuboidSize_.y);
-	z = int(r.z / cuboidSize_.z);
-	if (x == cuboidBoxes_.x) x = 0;
-	if (y == cuboidBoxes_.y) y = 0;
-	if (z == cuboidBoxes_.z) z = 0;
-// 	printf("and overlay %i-%i-%i (%i)\n",x,y,z,x*cuboidBoxes_.y*cuboidBoxes_.z+y*cuboidBoxes_.z+z);
-	bondingOverlays_[x*cuboidYZ_+y*cuboidBoxes_.z+z].add(i, radius);
-	// We also add atoms that are on the very edges of the overlays to the ones on the other side (to account for MIM)
-// 	printf("If x == 0, overlay is %i\n",(cuboidBoxes_.x-1)*cuboidBoxes_.y*cuboidBoxes_.z+y*cuboidBoxes_.z+z);
-/*	if (cell_.type() != Cell::NoCell) //TGAY Oddness in non-periodic systems - This appears to break bonding on one 'edge'
-	{*/
-		if (x == 0)
-		{
-			bondingOverlays_[(cuboidBoxes_.x-1)*cuboidYZ_+y*cuboidBoxes_.z+z].add(i, radius);	// Xyz
-			if (y == 0)
-			{
-				bondingOverlays_[(cuboidBoxes_.x-1)*cuboidYZ_+(cuboidBoxes_.y-1)*cuboidBoxes_.z+z].add(i, radius);	//XYz
-				if (z == 0) bondingOverlays_[(cuboidBoxes_.x-1)*cuboidYZ_+(cuboidBoxes_.y-1)*cuboidBoxes_.z+cuboidBoxes_.z-1].add(i, radius); // XYZ
-			}
-			else if (z == 0) bondingOverlays_[(cuboidBoxes_.x-1)*cuboidYZ_+y*cuboidBoxes_.z+cuboidBoxes_.z-1].add(i, radius); // XyZ
-		}
-		if (y == 0)
-		{
-			bondingOverlays_[x*cuboidYZ_+(cuboidBoxes_.y-1)*cuboidBoxes_.z+z].add(i, radius);	// xYz
-			if (z == 0) bondingOverlays_[x*cuboidYZ_+(cuboidBoxes_.y-1)*cuboidBoxes_.z+cuboidBoxes_.z-1].add(i, radius); // xYZ
-		}
-		if (z == 0) bondingOverlays_[x*cuboidYZ_+y*cuboidBoxes_.z+cuboidBoxes_.z-1].add(i, radius);	// xyZ
-// 	}
-// 	bondingOverlays_[(cuboidBoxes_.x-1)*cuboidYZ_+y*cuboidBoxes_.z+z].add(i, radius);	// xyz
-// 	printf("If x == y, overlay is %i\n",x*cuboidBoxes_.y*cuboidBoxes_.z+(cuboidBoxes_.y-1)*cuboidBoxes_.z+z);
-// 	if (y == 0) bondingOverlays_[x*cuboidYZ_+(cuboidBoxes_.y-1)*cuboidBoxes_.z+z].add(i, radius);	// xYz
-// 	printf("If x == z, overlay is %i\n",x*cuboidBoxes_.y*cuboidBoxes_.z+y*cuboidBoxes_.z+cuboidBoxes_.z-1);
-// 	if (z == 0) bondingOverlays_[x*cuboidYZ_+y*cuboidBoxes_.z+cuboidBoxes_.z-1].add(i, radius);	// xyZ
-}
 
-// Calculate bonding from stored cuboid lists
-void Model::rebond()
-{
-	int n, m, x, y, z, x2, y2, z2, checklist[8];
-	double dist, radsum;
-	double tolerance = prefs.bondTolerance();
-	Atom* i, *j;
-	// Loop over cuboids, checking distances with atoms in adjacent boxes
-	RefListItem<Atom,double>* ri, *rj;
-	x = 0;
-	y = 0;
-	z = 0;
-	for (n = 0; n<nCuboids_; n++)
+	// Sort atoms into cells no smaller than the longest possible bond
+	NeighbourList cellList;
+	cellList.prepare(this, 2.0 * maxRadius * tolerance, 0.0);
+
+	// Search for bonded pairs over blocks of atoms in parallel, with each block storing the pairs it finds
+	int nThreads = prefs.nThreadsToUse();
+	int nBlocks = nThreads * 4 < nAtoms ? nThreads * 4 : nAtoms;
+	Array<int>* blockPairs = new Array<int>[nBlocks];
+	UnitCell& cell = cell_;
+	ThreadPool::run(nBlocks, nThreads, [&](int block, int thread)
 	{
-		if (bondingCuboids_[n].nItems() != 0)
+		Array<int> candidates;
+		candidates.setChunkIncrement(SMALLCHUNKSIZE);
+		Vec3<double> ri;
+		double radsum;
+		int i, j, m, first = (block * nAtoms) / nBlocks, last = ((block+1) * nAtoms) / nBlocks;
+		for (i = first; i < last; ++i)
 		{
-	// 		if (cuboids[n].nItems() > 0) printf("On cuboid %i (%ix%ix%i) which contains %i atoms\n", n, x, y, z, cuboids[n].nItems());
-			// For each of the atoms in the cuboid, check distance with each atom in eight of the closest
-			// overlay boxes. 
-			checklist[0] = n;
-			x2 = (x == (cuboidBoxes_.x-1) ? 0 : x+1);
-			y2 = (y == (cuboidBoxes_.y-1) ? 0 : y+1);
-			z2 = (z == (cuboidBoxes_.z-1) ? 0 : z+1);
-	// 		if (cuboids[n].nItems() > 0) printf("....xyz = %i,%i,%i, xyz2 = %i,%i,%i\n", x, y, z, x2, y2, z2);
-			checklist[1] = x2*cuboidYZ_+y*cuboidBoxes_.z+z;
-			checklist[2] = x2*cuboidYZ_+y2*cuboidBoxes_.z+z;
-			checklist[3] = x2*cuboidYZ_+y*cuboidBoxes_.z+z2;
-			checklist[4] = x2*cuboidYZ_+y2*cuboidBoxes_.z+z2;
-			checklist[5] = x*cuboidYZ_+y2*cuboidBoxes_.z+z;
-			checklist[6] = x*cuboidYZ_+y*cuboidBoxes_.z+z2;
-			checklist[7] = x*cuboidYZ_+y2*cuboidBoxes_.z+z2;
-			for (ri = bondingCuboids_[n].first(); ri != NULL; ri = ri->next)
+			if (radius[i] < 0.0) continue;
+			ri.set(x[i], y[i], z[i]);
+			candidates.forgetData();
+			cellList.neighbours(i, i+1, nAtoms-1, candidates);
+			for (m=0; m<candidates.nItems(); ++m)
 			{
-				i = ri->item;
-				// Check for excluded elements
-				if (i->element() == 0) continue;
-				for (m=0; m<8; m++)
+				j = candidates[m];
+				if (radius[j] < 0.0) continue;
+				radsum = (radius[i] + radius[j]) * tolerance;
+				if (cell.mimVector(ri, Vec3<double>(x[j], y[j], z[j])).magnitudeSq() < radsum*radsum)
 				{
-					for (rj = bondingOverlays_[checklist[m]].first(); rj != NULL; rj = rj->next)
-					{
-						j = rj->item;
-						if (i == j) continue;
-						if (j->element() == 0) continue;
-						dist = cell_.distance(i,j);
-						radsum = ri->data + rj->data;
-						if (dist < radsum*tolerance) bondAtoms(i,j,Bond::Single);
-					}
+					blockPairs[block].add(i);
+					blockPairs[block].add(j);
 				}
 			}
 		}
-		// Increase x,y,z indices for box lookup
-		z ++;
-		if (z == cuboidBoxes_.z)
-		{
-			z = 0;
-			y ++;
-			if (y == cuboidBoxes_.y)
-			{
-				y = 0;
-				x ++;
-			}
-		}
+	});
+
+	// Create bonds in block order, so that the result does not depend on the number of threads
+	for (int block=0; block<nBlocks; ++block)
+	{
+		for (n=0; n<blockPairs[block].nItems(); n += 2) bondAtoms(modelatoms[blockPairs[block][n]], modelatoms[blockPairs[block][n+1]], Bond::Single);
 	}
+	delete[] blockPairs;
+
+	Messenger::exit("Model::rebond");
 }
 
 // Calculate Bonding
@@ -428,25 +266,13 @@ void Model::calculateBonding(bool augment)
 {
 	Messenger::enter("Model::calculateBonding");
 	Messenger::print(Messenger::Verbose, "Calculating bonds in model (tolerance = %5.2f)...", prefs.bondTolerance());
-	Task* task = Messenger::initialiseTask("Calculating bonding", 6);
+	Task* task = Messenger::initialiseTask("Calculating bonding", 3);
 
 	clearBonding();
 	Messenger::incrementTaskProgress(task);
 
-	// Create cuboid lists
-	initialiseBondingCuboids();
-	Messenger::incrementTaskProgress(task);
-
-	// Add all atoms to cuboid list
-	for (Atom* i = atoms_.first(); i != NULL; i = i->next) addAtomToCuboid(i);
-	Messenger::incrementTaskProgress(task);
-
-	// Rebond within the cuboids
-	rebond();
-	Messenger::incrementTaskProgress(task);
-
-	// Free bonding cuboids
-	freeBondingCuboids();
+	// Calculate bonds between all atoms
+	rebond(false);
 	Messenger::incrementTaskProgress(task);
 
 	// Augment?
@@ -487,50 +313,43 @@ void Model::calculateBonding(bool augment)
 void Model::patternCalculateBonding(bool augment)
 {
 	Messenger::enter("Model::patternCalculateBonding");
-	Atom* i,*j;
-	int ii, jj, el, m;
+	int i, j, offset, el, m, nAtoms;
 	double dist;
 	double tolerance = prefs.bondTolerance();
 	double radius_i, radsum;
 	clearBonding();
 	Messenger::print("Calculating bonds within patterns (tolerance = %5.2f)...", tolerance);
+
+	// Distances and elements are taken from the packed atom store - Atom pointers are only needed to create the bonds
+	AtomStore& store = atomStore();
+	double* x = store.x(), *y = store.y(), *z = store.z();
+	int* elements = store.elements();
+	Atom** modelatoms = atomArray();
+
 	// For all the pattern nodes currently defined, bond within molecules
 	for (Pattern* p = patterns_.first(); p != NULL; p = p->next)
 	{
+		nAtoms = p->nAtoms();
 		// Loop over molecules
-		i = p->firstAtom();
+		offset = p->startAtom();
 		for (m=0; m<p->nMolecules(); m++)
 		{
-			for (ii = 0; ii < p->nAtoms()-1; ii ++)
+			for (i = offset; i < offset+nAtoms-1; ++i)
 			{
 				// Check for excluded elements
-				el = i->element();
-				if (el == 0)
-				{
-					i = i->next;
-					continue;
-				}
-				radius_i = ElementMap::atomicRadius(el);
+				if (elements[i] == 0) continue;
+				radius_i = ElementMap::atomicRadius(elements[i]);
 				// Start loop over second atom in molecule
-				j = i->next;
-				for (jj = ii+1; jj < p->nAtoms(); jj ++)
+				for (j = i+1; j < offset+nAtoms; ++j)
 				{
-					el = j->element();
-					if (el == 0)
-					{
-						j = j->next;
-						continue;
-					}
-					dist = cell_.distance(i,j);
-				//printf("i %i j %i dist %8.3f\n",i->id(),j->id(),dist);
+					el = elements[j];
+					if (el == 0) continue;
+					dist = cell_.distance(Vec3<double>(x[i], y[i], z[i]), Vec3<double>(x[j], y[j], z[j]));
 					radsum = radius_i + ElementMap::atomicRadius(el);
-					if (dist < radsum*tolerance) bondAtoms(i,j,Bond::Single);
-					j = j->next;
+					if (dist < radsum*tolerance) bondAtoms(modelatoms[i], modelatoms[j], Bond::Single);
 				}
-				i = i->next;
 			}
-			// Skip on one more atom, since the i loop ran from 0 to natoms-1
-			i = i->next;
+			offset += nAtoms;
 		}
 	}
 	// Augment?
@@ -543,14 +362,8 @@ void Model::patternCalculateBonding(bool augment)
 void Model::selectionCalculateBonding(bool augment)
 {
 	Messenger::enter("Model::selectionCalculateBonding");
-	// Create cuboid lists
-	initialiseBondingCuboids();
-	// Add all atoms to cuboid list
-	for (Atom* i = atoms_.first(); i != NULL; i = i->next) if (i->isSelected()) addAtomToCuboid(i);
-	// Rebond within the cuboids
-	rebond();
-	// Free bonding cuboids
-	freeBondingCuboids();
+	// Calculate bonds between selected atoms
+	rebond(true);
 	// Augment?
 	if (augment) augmentBonding();
 	Messenger::exit("Model::selectionCalculateBonding");
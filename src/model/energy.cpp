@@ -22,15 +22,164 @@
 #include "model/model.h"
 #include "base/pattern.h"
 #include "base/fourierdata.h"
+#include "base/threadpool.h"
 
 ATEN_USING_NAMESPACE
 
+// Block of molecules within a pattern, used to divide energy / force calculations between threads
+class PatternBlock
+{
+	public:
+	// Pattern containing the molecules
+	Pattern* pattern;
+	// First and last molecules in the block
+	int firstMolecule, lastMolecule;
+};
+
+// Divide molecules of supplied patterns into blocks for the specified number of threads
+void createPatternBlocks(Pattern* firstPattern, int nThreads, Array<PatternBlock>& blocks)
+{
+	PatternBlock block;
+	Pattern* p;
+	blocks.clear();
+
+	// For a single thread, each pattern is one block
+	if (nThreads == 1)
+	{
+		for (p = firstPattern; p != NULL; p = p->next)
+		{
+			block.pattern = p;
+			block.firstMolecule = 0;
+			block.lastMolecule = p->nMolecules() - 1;
+			blocks.add(block);
+		}
+		return;
+	}
+
+	// Otherwise, aim for several blocks per thread so that the work can be balanced between them
+	int nTotal = 0, blockSize, m;
+	for (p = firstPattern; p != NULL; p = p->next) nTotal += p->nMolecules();
+	blockSize = nTotal / (nThreads * 4);
+	if (blockSize < 1) blockSize = 1;
+	for (p = firstPattern; p != NULL; p = p->next)
+	{
+		for (m = 0; m < p->nMolecules(); m += blockSize)
+		{
+			block.pattern = p;
+			block.firstMolecule = m;
+			block.lastMolecule = (m + blockSize > p->nMolecules() ? p->nMolecules() : m + blockSize) - 1;
+			blocks.add(block);
+		}
+	}
+}
+
 // Return reference to FourierData structure
 FourierData& Model::fourierData()
 {
 	return fourierData_;
 }
 
+// Return reference to SpmeData structure
+SpmeData& Model::spmeData()
+{
+	return spmeData_;
+}
+
+// Return reference to neighbour list
+NeighbourList& Model::neighbourList()
+{
+	return neighbourList_;
+}
+
+// Prepare neighbour list of specified configuration, and any VDW tables, for pairwise interactions
+void Model::preparePairInteractions(Model* config)
+{
+	prepareVdwTables();
+
+	// Refresh the packed atom data only if the structure, coordinates, or style of the configuration have changed since it was last copied
+	config->atomStore_.update(config);
+
+	// The list is owned by the configuration, since it depends on its coordinates and cell
+	double cutoff = (prefs.vdwCutoff() > prefs.elecCutoff() ? prefs.vdwCutoff() : prefs.elecCutoff());
+	config->neighbourList_.prepare(config, cutoff, prefs.neighbourSkin());
+}
+
+// Calculate selected intramolecular / pairwise pattern energies of specified configuration over all available threads
+bool Model::calculatePatternEnergies(Model* config, EnergyStore* estore, bool bonded, bool vdw, Electrostatics::ElecMethod elecMethod)
+{
+	Messenger::enter("Model::calculatePatternEnergies");
+
+	// Make sure that cached arrays are up to date before any threads access them
+	config->atomArray();
+	for (Pattern* p = patterns_.first(); p != NULL; p = p->next) p->prepareArrays();
+
+	// Divide patterns into blocks of molecules, and create a separate energy store for each thread
+	int n, nThreads = prefs.nThreadsToUse();
+	Array<PatternBlock> blocks;
+	createPatternBlocks(patterns_.first(), nThreads, blocks);
+	if (nThreads > blocks.nItems()) nThreads = blocks.nItems();
+	if (nThreads < 1) nThreads = 1;
+	EnergyStore* threadStores = new EnergyStore[nThreads];
+	bool* threadSuccess = new bool[nThreads];
+	for (n=0; n<nThreads; ++n)
+	{
+		threadStores[n].resize(patterns_.nItems());
+		threadSuccess[n] = true;
+	}
+
+	// Calculate contributions from each block
+	PatternBlock* blockArray = blocks.array();
+	ThreadPool::run(blocks.nItems(), nThreads, [&](int task, int thread)
+	{
+		Pattern* p = blockArray[task].pattern, *p2;
+		int first = blockArray[task].firstMolecule, last = blockArray[task].lastMolecule;
+		EnergyStore* threadStore = &threadStores[thread];
+
+		// Intramolecular Interactions
+		if (bonded)
+		{
+			p->bondEnergy(config, threadStore, -1, first, last);
+			p->angleEnergy(config, threadStore, -1, first, last);
+			p->torsionEnergy(config, threadStore, -1, first, last);
+		}
+
+		// Van der Waals Interactions
+		if (vdw)
+		{
+			if (!p->vdwIntraPatternEnergy(config, threadStore, -1, first, last)) threadSuccess[thread] = false;
+			for (p2 = p; p2 != NULL; p2 = p2->next) if (!p->vdwInterPatternEnergy(config, p2, threadStore, -1, first, last)) threadSuccess[thread] = false;
+		}
+
+		// Electrostatic Interactions (real-space part only, in the case of the Ewald sum)
+		switch (elecMethod)
+		{
+			case (Electrostatics::None):
+				break;
+			case (Electrostatics::Coulomb):
+				p->coulombIntraPatternEnergy(config, threadStore, -1, first, last);
+				for (p2 = p; p2 != NULL; p2 = p2->next) p->coulombInterPatternEnergy(config, p2, threadStore, -1, first, last);
+				break;
+			default: // Ewald
+				p->ewaldRealIntraPatternEnergy(config, threadStore, -1, first, last);
+				for (p2 = p; p2 != NULL; p2 = p2->next) p->ewaldRealInterPatternEnergy(config, p2, threadStore, -1, first, last);
+				break;
+		}
+	});
+
+	// Sum energies from all threads
+	bool success = true;
+	for (n=0; n<nThreads; ++n)
+	{
+		estore->add(threadStores[n]);
+		if (!threadSuccess[n]) success = false;
+	}
+	delete[] threadStores;
+	delete[] threadSuccess;
+
+	Messenger::exit("Model::calculatePatternEnergies");
+	return success;
+}
+
 // Calculate total energy of model (from supplied coordinates)
 double Model::totalEnergy(Model* srcmodel, bool& success)
 {
@@ -49,7 +198,7 @@ double Model::totalEnergy(Model* srcmodel, bool& success)
 	energy.clear();
 
 	// Cycle through patterns, calculating the contributions from each
-	Pattern* p, *p2;
+	Pattern* p;
 	p = patterns_.first();
 
 	// Calculate VDW correction
@@ -65,7 +214,7 @@ double Model::totalEnergy(Model* srcmodel, bool& success)
 	
 	// Prepare Ewald sum (if necessary)
 	Electrostatics::ElecMethod emodel = prefs.electrostaticsMethod();
-	if ((emodel == Electrostatics::Ewald) || (emodel == Electrostatics::EwaldAuto))
+	if ((emodel == Electrostatics::Ewald) || (emodel == Electrostatics::EwaldAuto) || (emodel == Electrostatics::Spme))
 	{
 		// Only valid for a periodic system...
 		if (srcmodel->cell_.type() == UnitCell::NoCell)
@@ -76,60 +225,35 @@ double Model::totalEnergy(Model* srcmodel, bool& success)
 			return 0.0;
 		}
 		// Estimate parameters if automatic mode selected
-		if (emodel == Electrostatics::EwaldAuto) prefs.estimateEwaldParameters(srcmodel->cell_);
-		// Create the fourier space for use in the Ewald sum
-		fourierData_.prepare(srcmodel, prefs.ewaldKMax());
+		if ((emodel == Electrostatics::EwaldAuto) || (emodel == Electrostatics::Spme)) prefs.estimateEwaldParameters(srcmodel->cell_);
+		// Create the fourier space (or charge mesh, for SPME) for use in the Ewald sum
+		if (emodel == Electrostatics::Spme) spmeData_.prepare(srcmodel, prefs.ewaldKMax(), prefs.spmeOrder());
+		else fourierData_.prepare(srcmodel, prefs.ewaldKMax());
 	}
 	
-	// Loop over patterns
-	while (p != NULL)
+	// Prepare neighbour list for pairwise interactions
+	preparePairInteractions(srcmodel);
+
+	// Calculate intramolecular and pairwise contributions from all patterns
+	if (!calculatePatternEnergies(srcmodel, &energy, prefs.calculateIntra(), prefs.calculateVdw(), emodel))
 	{
-		// Intramolecular Interactions
-		if (prefs.calculateIntra())
-		{
-			p->bondEnergy(srcmodel, &energy);
-			p->angleEnergy(srcmodel, &energy);
-			p->torsionEnergy(srcmodel, &energy);
-		}
-		// Van der Waals Interactions
-		if (prefs.calculateVdw())
-		{
-			if (!p->vdwIntraPatternEnergy(srcmodel, &energy))
-			{
-				success = false;
-				Messenger::exit("Model::totalEnergy");
-				return 0.0;
-			}
-			for (p2 = p; p2 != NULL; p2 = p2->next)
-			{
-				if (!p->vdwInterPatternEnergy(srcmodel, p2, &energy))
-				{
-					success = false;
-					Messenger::exit("Model::totalEnergy");
-					return 0.0;
-				}
-			}
-		}
-		// Electrostatic Interactions
-		switch (emodel)
-		{
-			case (Electrostatics::None):
-				break;
-			case (Electrostatics::Coulomb):
-				p->coulombIntraPatternEnergy(srcmodel,&energy);
-				for (p2 = p; p2 != NULL; p2 = p2->next) p->coulombInterPatternEnergy(srcmodel,p2,&energy);
-				break;
-			default: // Ewald
-				p->ewaldRealIntraPatternEnergy(srcmodel,&energy);
-				p->ewaldCorrectEnergy(srcmodel,&energy);
-				for (p2 = p; p2 != NULL; p2 = p2->next) p->ewaldRealInterPatternEnergy(srcmodel,p2,&energy);
-				// Calculate reciprocal space part (called once from first pattern only)
-				if (p == patterns_.first())
-					p->ewaldReciprocalEnergy(srcmodel,p,patterns_.nItems(),&energy);
-				break;
-		}
-		p = p->next;
+		success = false;
+		Messenger::exit("Model::totalEnergy");
+		return 0.0;
 	}
+
+	// Remaining Ewald terms - corrections for each pattern, and reciprocal space part (called once from first pattern only)
+	if ((emodel == Electrostatics::Ewald) || (emodel == Electrostatics::EwaldAuto))
+	{
+		for (p = patterns_.first(); p != NULL; p = p->next) p->ewaldCorrectEnergy(srcmodel,&energy);
+		patterns_.first()->ewaldReciprocalEnergy(srcmodel,patterns_.first(),patterns_.nItems(),&energy);
+	}
+	else if (emodel == Electrostatics::Spme)
+	{
+		for (p = patterns_.first(); p != NULL; p = p->next) p->ewaldCorrectEnergy(srcmodel,&energy);
+		patterns_.first()->spmeReciprocalEnergy(srcmodel,&energy);
+	}
+
 	energy.totalise();
 	success = true;
 	Messenger::exit("Model::totalEnergy");
@@ -162,6 +286,7 @@ double Model::moleculeEnergy(Model* srcmodel, Pattern* molpattern, int molecule,
 			break;
 		case (Electrostatics::Ewald):
 		case (Electrostatics::EwaldAuto):
+		case (Electrostatics::Spme):
 			// Only valid for a periodic system...
 			if (srcmodel->cell_.type() == UnitCell::NoCell)
 			{
@@ -171,13 +296,17 @@ double Model::moleculeEnergy(Model* srcmodel, Pattern* molpattern, int molecule,
 				return 0.0;
 			}
 			// Estimate parameters if automatic mode selected
-			if (emodel == Electrostatics::EwaldAuto) prefs.estimateEwaldParameters(srcmodel->cell_);
-			fourierData_.prepare(srcmodel,prefs.ewaldKMax());
+			if ((emodel == Electrostatics::EwaldAuto) || (emodel == Electrostatics::Spme)) prefs.estimateEwaldParameters(srcmodel->cell_);
+			if (emodel == Electrostatics::Spme) spmeData_.prepare(srcmodel, prefs.ewaldKMax(), prefs.spmeOrder());
+			else fourierData_.prepare(srcmodel,prefs.ewaldKMax());
 			break;
     default:
       break;  
 	}
 	
+	// Prepare neighbour list for pairwise interactions
+	preparePairInteractions(srcmodel);
+
 	// Calculate VDW interactions between 'molecule' in pattern 'molpattern' and molecules in it and other's patterns
 	for (p = patterns_.first(); p != NULL; p = p->next)
 	{
@@ -197,6 +326,11 @@ double Model::moleculeEnergy(Model* srcmodel, Pattern* molpattern, int molecule,
 		case (Electrostatics::Coulomb):
 			for (p = patterns_.first(); p != NULL; p = p->next) molpattern->coulombInterPatternEnergy(srcmodel,p,&energy);
 			break;
+		case (Electrostatics::Spme):
+			for (p = patterns_.first(); p != NULL; p = p->next) molpattern->ewaldRealInterPatternEnergy(srcmodel,p,&energy,molecule);
+			// Reciprocal space part is calculated for the whole system, so only differences between configurations are meaningful
+			patterns_.first()->spmeReciprocalEnergy(srcmodel,&energy);
+			break;
 		default: // Ewald
 			for (p = patterns_.first(); p != NULL; p = p->next) p->ewaldRealInterPatternEnergy(srcmodel,p,&energy);
 			// Calculate reciprocal space part (called once from first pattern only)
@@ -282,6 +416,7 @@ double Model::electrostaticEnergy(Model* config, bool& success)
 			break;
 		case (Electrostatics::Ewald):
 		case (Electrostatics::EwaldAuto):
+		case (Electrostatics::Spme):
 			// Only valid for a periodic system...
 			if (config->cell_.type() == UnitCell::NoCell)
 			{
@@ -291,34 +426,30 @@ double Model::electrostaticEnergy(Model* config, bool& success)
 				return 0.0;
 			}
 			// Estimate parameters if automatic mode selected
-			if (emodel == Electrostatics::EwaldAuto) prefs.estimateEwaldParameters(config->cell_);
-			fourierData_.prepare(config,prefs.ewaldKMax());
+			if ((emodel == Electrostatics::EwaldAuto) || (emodel == Electrostatics::Spme)) prefs.estimateEwaldParameters(config->cell_);
+			if (emodel == Electrostatics::Spme) spmeData_.prepare(config, prefs.ewaldKMax(), prefs.spmeOrder());
+			else fourierData_.prepare(config,prefs.ewaldKMax());
 			break;
     default:
       break;  
 	}
 	
-	// Calculate total torsion energy over all patterns
+	// Prepare neighbour list for pairwise interactions
+	preparePairInteractions(config);
+
+	// Calculate total electrostatic energy over all patterns
 	EnergyStore tempenergy(patterns_.nItems());
-	Pattern* p2;
-	for (Pattern* p = patterns_.first(); p != NULL; p = p->next)
+	calculatePatternEnergies(config, &tempenergy, false, false, emodel);
+	if ((emodel == Electrostatics::Ewald) || (emodel == Electrostatics::EwaldAuto))
 	{
-		switch (emodel)
-		{
-			case (Electrostatics::None):
-				break;
-			case (Electrostatics::Coulomb):
-				p->coulombIntraPatternEnergy(config, &tempenergy);
-				for (p2 = p; p2 != NULL; p2 = p2->next) p->coulombInterPatternEnergy(config, p2, &tempenergy);
-				break;
-			default: // Ewald
-				p->ewaldRealIntraPatternEnergy(config, &tempenergy);
-				p->ewaldCorrectEnergy(config, &tempenergy);
-				for (p2 = p; p2 != NULL; p2 = p2->next) p->ewaldRealInterPatternEnergy(config, p2, &tempenergy);
-				// Calculate reciprocal space part (called once from first pattern only)
-				if (p == patterns_.first()) p->ewaldReciprocalEnergy(config, p, patterns_.nItems(), &tempenergy);
-				break;
-		}
+		for (Pattern* p = patterns_.first(); p != NULL; p = p->next) p->ewaldCorrectEnergy(config, &tempenergy);
+		// Calculate reciprocal space part (called once from first pattern only)
+		patterns_.first()->ewaldReciprocalEnergy(config, patterns_.first(), patterns_.nItems(), &tempenergy);
+	}
+	else if (emodel == Electrostatics::Spme)
+	{
+		for (Pattern* p = patterns_.first(); p != NULL; p = p->next) p->ewaldCorrectEnergy(config, &tempenergy);
+		patterns_.first()->spmeReciprocalEnergy(config, &tempenergy);
 	}
 	success = true;
 	tempenergy.totalise();
@@ -386,26 +517,16 @@ double Model::vdwEnergy(Model* config, bool& success)
 		return 0.0;
 	}
 	
-	// Calculate total torsion energy over all patterns
+	// Prepare neighbour list for pairwise interactions
+	preparePairInteractions(config);
+
+	// Calculate total van der Waals energy over all patterns
 	EnergyStore tempenergy(patterns_.nItems());
-	Pattern* p2;
-	for (Pattern* p = patterns_.first(); p != NULL; p = p->next)
+	if (!calculatePatternEnergies(config, &tempenergy, false, true, Electrostatics::None))
 	{
-		if (!p->vdwIntraPatternEnergy(config, &tempenergy))
-		{
-			success = false;
-			Messenger::exit("Model::totalEnergy");
-			return 0.0;
-		}
-		for (p2 = p; p2 != NULL; p2 = p2->next)
-		{
-			if (!p->vdwInterPatternEnergy(config, p2, &tempenergy))
-			{
-				success = false;
-				Messenger::exit("Model::totalEnergy");
-				return 0.0;
-			}
-		}
+		success = false;
+		Messenger::exit("Model::vdwEnergy");
+		return 0.0;
 	}
 	
 	success = true;
@@ -430,7 +551,7 @@ bool Model::calculateForces(Model* srcmodel)
 	srcmodel->zeroForces();
 
 	// Cycle through patterns, calculate the intrapattern forces for each
-	Pattern* p, *p2;
+	Pattern* p;
 	p = patterns_.first();
 	
 	// Prepare Ewald (if necessary)
@@ -442,6 +563,7 @@ bool Model::calculateForces(Model* srcmodel)
 			break;
 		case (Electrostatics::Ewald):
 		case (Electrostatics::EwaldAuto):
+		case (Electrostatics::Spme):
 			// Only valid for a periodic system...
 			if (srcmodel->cell_.type() == UnitCell::NoCell)
 			{
@@ -450,61 +572,103 @@ bool Model::calculateForces(Model* srcmodel)
 				return false;
 			}
 			// Estimate parameters if automatic mode selected
-			if (emodel == Electrostatics::EwaldAuto) prefs.estimateEwaldParameters(srcmodel->cell_);
-			// Create the fourier space for use in the Ewald sum
-			fourierData_.prepare(srcmodel, prefs.ewaldKMax());
+			if ((emodel == Electrostatics::EwaldAuto) || (emodel == Electrostatics::Spme)) prefs.estimateEwaldParameters(srcmodel->cell_);
+			// Create the fourier space (or charge mesh, for SPME) for use in the Ewald sum
+			if (emodel == Electrostatics::Spme) spmeData_.prepare(srcmodel, prefs.ewaldKMax(), prefs.spmeOrder());
+			else fourierData_.prepare(srcmodel, prefs.ewaldKMax());
 			break;
     default:
       break;  
 	}
 	
-	// Loop over patterns
-	while (p != NULL)
+	// Prepare neighbour list for pairwise interactions
+	preparePairInteractions(srcmodel);
+
+	// Make sure that cached arrays are up to date before any threads access them
+	Atom** modelatoms = srcmodel->atomArray();
+	for (p = patterns_.first(); p != NULL; p = p->next) p->prepareArrays();
+
+	// Divide patterns into blocks of molecules, and create a separate force array for each thread
+	int n, i, nThreads = prefs.nThreadsToUse();
+	Array<PatternBlock> blocks;
+	createPatternBlocks(patterns_.first(), nThreads, blocks);
+	if (nThreads > blocks.nItems()) nThreads = blocks.nItems();
+	if (nThreads < 1) nThreads = 1;
+	Array< Vec3<double> >* threadForces = new Array< Vec3<double> >[nThreads];
+	bool* threadSuccess = new bool[nThreads];
+	for (n=0; n<nThreads; ++n)
 	{
+		threadForces[n].createEmpty(srcmodel->nAtoms(), Vec3<double>());
+		threadSuccess[n] = true;
+	}
+
+	// Calculate forces from each block
+	PatternBlock* blockArray = blocks.array();
+	ThreadPool::run(blocks.nItems(), nThreads, [&](int task, int thread)
+	{
+		Pattern* p = blockArray[task].pattern, *p2;
+		int first = blockArray[task].firstMolecule, last = blockArray[task].lastMolecule;
+		Vec3<double>* forces = threadForces[thread].array();
+
 		// Bonded Interactions
 		if (prefs.calculateIntra())
 		{
-			p->bondForces(srcmodel);
-			p->angleForces(srcmodel);
-			p->torsionForces(srcmodel);
+			p->bondForces(srcmodel, forces, first, last);
+			p->angleForces(srcmodel, forces, first, last);
+			p->torsionForces(srcmodel, forces, first, last);
 		}
+
 		// VDW
 		if (prefs.calculateVdw())
 		{
-			if (!p->vdwIntraPatternForces(srcmodel))
-			{
-				Messenger::exit("Model::calculateForces");
-				return false;
-			}
-			for (p2 = p; p2 != NULL; p2 = p2->next)
-			{
-				if (!p->vdwInterPatternForces(srcmodel,p2))
-				{
-				Messenger::exit("Model::calculateForces");
-				return false;
-				}
-			}
+			if (!p->vdwIntraPatternForces(srcmodel, forces, first, last)) threadSuccess[thread] = false;
+			for (p2 = p; p2 != NULL; p2 = p2->next) if (!p->vdwInterPatternForces(srcmodel, p2, forces, first, last)) threadSuccess[thread] = false;
 		}
-		// Electrostatics
+
+		// Electrostatics (real-space part only, in the case of the Ewald sum)
 		switch (emodel)
 		{
 			case (Electrostatics::None):
 				break;
 			case (Electrostatics::Coulomb):
-				p->coulombIntraPatternForces(srcmodel);
-				for (p2 = p; p2 != NULL; p2 = p2->next) p->coulombInterPatternForces(srcmodel,p2);
+				p->coulombIntraPatternForces(srcmodel, forces, first, last);
+				for (p2 = p; p2 != NULL; p2 = p2->next) p->coulombInterPatternForces(srcmodel, p2, forces, first, last);
 				break;
 			default: // Ewald
-				p->ewaldRealIntraPatternForces(srcmodel);
-				p->ewaldCorrectForces(srcmodel);
-				for (p2 = p; p2 != NULL; p2 = p2->next) p->ewaldRealInterPatternForces(srcmodel,p2);
-				// Calculate reciprocal space part (called once from first pattern only)
-				if (p == patterns_.first()) p->ewaldReciprocalForces(srcmodel);
+				p->ewaldRealIntraPatternForces(srcmodel, forces, first, last);
+				for (p2 = p; p2 != NULL; p2 = p2->next) p->ewaldRealInterPatternForces(srcmodel, p2, forces, first, last);
 				break;
 		}
-		p = p->next;
+	});
+
+	// Remaining Ewald terms - corrections for each pattern, and reciprocal space part (called once from first pattern only)
+	if ((emodel == Electrostatics::Ewald) || (emodel == Electrostatics::EwaldAuto))
+	{
+		for (p = patterns_.first(); p != NULL; p = p->next) p->ewaldCorrectForces(srcmodel, threadForces[0].array());
+		patterns_.first()->ewaldReciprocalForces(srcmodel, threadForces[0].array());
 	}
-	
+	else if (emodel == Electrostatics::Spme)
+	{
+		for (p = patterns_.first(); p != NULL; p = p->next) p->ewaldCorrectForces(srcmodel, threadForces[0].array());
+		patterns_.first()->spmeReciprocalForces(srcmodel, threadForces[0].array());
+	}
+
+	// Sum forces from all threads into atoms
+	bool success = true;
+	for (n=0; n<nThreads; ++n)
+	{
+		if (!threadSuccess[n]) success = false;
+		Vec3<double>* forces = threadForces[n].array();
+		for (i=0; i<srcmodel->nAtoms(); ++i) modelatoms[i]->f() += forces[i];
+	}
+	delete[] threadForces;
+	delete[] threadSuccess;
+	if (!success)
+	{
+		Messenger::exit("Model::calculateForces");
+		return false;
+	}
+
 	// Calculate RMS force
 	rmsForce_ = 0.0;
 	for (Atom* i = atoms_.first(); i != NULL; i = i->next) rmsForce_ += i->f().magnitudeSq();
@@ -115,6 +115,7 @@ bool Model::assignForcefieldCharges()
 			totalq += i->type()->charge();
 		}
 	}
+	logChange(Log::Coordinates);
 	if (nfailed == 0) Messenger::print("Charges assigned successfully to all atoms.\nTotal charge in model is %f e.", totalq);
 	else Messenger::print("Failed to assign charges to %i atoms.", nfailed);
 	Messenger::exit("Model::assignForcefieldCharges");
@@ -156,7 +157,7 @@ bool Model::createExpression(Choice vdwOnly, Choice allowDummy, Choice assignCha
 	// 0) If the expression is already valid, just update scaling terms in pattern matrices and return
 	if (isExpressionValid() && (vdwOnly == expressionVdwOnly_))
 	{
-		for (Pattern* p = patterns_.first(); p != NULL; p = p->next) p->updateScaleMatrices();
+		for (Pattern* p = patterns_.first(); p != NULL; p = p->next) p->updateScaleFactors();
 		Messenger::exit("Model::createExpression");
 		return true;
 	}
@@ -234,7 +235,7 @@ bool Model::createExpression(Choice vdwOnly, Choice allowDummy, Choice assignCha
 			}
 			else done = true;
 		}
-		p->createMatrices();
+		p->createExclusions();
 	}
 
 	// 3) Check the electrostatic setup for the model
@@ -266,8 +267,10 @@ bool Model::createExpression(Choice vdwOnly, Choice allowDummy, Choice assignCha
 		return false;
 	}
 	
-	// 6) Create VDW lookup table of combined parameters
+	// 6) Create VDW lookup table of combined parameters (any tabulated interactions are recreated when next required)
 	combinationTable_.clear();
+	vdwTables_.clear();
+	vdwTablesPoints_ = 0;
 	PointerPair<ForcefieldAtom,double>* pp;
 	ForcefieldAtom* ffa, *ffb;
 	CombinationRules::CombinationRule *crflags;
@@ -372,3 +375,56 @@ PointerPair<ForcefieldAtom,double>* Model::combinedParameters(ForcefieldAtom* at
 	if (pp == NULL) printf("Internal Error : Couldn't find combined parameters for atom types '%s' and '%s'.\n", qPrintable(at1->name()), qPrintable(at2->name()));
 	return pp;
 }
+
+// Create (or recreate) tabulated VDW interactions, if requested and out of date
+void Model::prepareVdwTables()
+{
+	int nPoints = prefs.vdwTablePoints();
+	double cutoff = prefs.vdwCutoff();
+	if ((nPoints == vdwTablesPoints_) && (cutoff == vdwTablesCutoff_)) return;
+
+	vdwTables_.clear();
+	vdwTablesPoints_ = nPoints;
+	vdwTablesCutoff_ = cutoff;
+	if (nPoints == 0) return;
+
+	// Tabulate interactions between all pairs of types in which either has a suitable functional form
+	// Each table uses the same form as the combined parameters it is built from, so that it matches the untabulated interaction
+	PointerPair<ForcefieldAtom,double>* pp;
+	PointerPair<ForcefieldAtom,VdwTable>* table;
+	ForcefieldAtom* ffa, *ffb;
+	int nTables = 0;
+	for (RefListItem<ForcefieldAtom,int>* rfa = allForcefieldTypes_.first(); rfa != NULL; rfa = rfa->next)
+	{
+		ffa = rfa->item;
+		for (RefListItem<ForcefieldAtom,int>* rfb = rfa; rfb != NULL; rfb = rfb->next)
+		{
+			ffb = rfb->item;
+			if ((!VdwTable::isTabulated(ffa->vdwForm())) && (!VdwTable::isTabulated(ffb->vdwForm()))) continue;
+			pp = combinationTable_.find(ffa, ffb);
+			if (pp == NULL) continue;
+			table = vdwTables_.add(ffa, ffb, 1);
+			table->data()->initialise(pp->ptr1()->vdwForm(), pp->data(), cutoff, nPoints);
+			++nTables;
+		}
+	}
+	Messenger::print(Messenger::Verbose, "Tabulated %i VDW interactions with %i points up to %f Angstroms.", nTables, nPoints, cutoff);
+}
+
+// Return whether tabulated VDW interactions are in use
+bool Model::hasVdwTables() const
+{
+	return (vdwTablesPoints_ > 0);
+}
+
+// Return tabulated VDW interaction for specified pair of types
+VdwTable* Model::vdwTable(ForcefieldAtom* at1, ForcefieldAtom* at2)
+{
+	PointerPair<ForcefieldAtom,VdwTable>* table = vdwTables_.find(at1, at2);
+	if (table == NULL)
+	{
+		printf("Internal Error : Couldn't find tabulated VDW interaction for atom types '%s' and '%s'.\n", qPrintable(at1->name()), qPrintable(at2->name()));
+		return NULL;
+	}
+	return table->data();
+}
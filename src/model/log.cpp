@@ -26,6 +26,8 @@ ATEN_USING_NAMESPACE
 // Set complete log structure
 void Model::setChangeLog(Log& source)
 {
+	// Any log quantity whose value changes (even back to an earlier value) counts as a new revision
+	for (int n=0; n<Log::Total; ++n) if (!changeLog_.isSame((Log::LogType) n, source)) revisions_.add((Log::LogType) n);
 	changeLog_ = source;
 }
 
@@ -38,6 +40,7 @@ Log& Model::changeLog()
 // Reset changelog
 void Model::resetLogs()
 {
+	for (int n=0; n<Log::Total; ++n) if (changeLog_.log((Log::LogType) n) != 0) revisions_.add((Log::LogType) n);
 	changeLog_.reset();
 }
 
@@ -45,6 +48,7 @@ void Model::resetLogs()
 void Model::logChange(Log::LogType logType)
 {
 	changeLog_.add(logType);
+	revisions_.add(logType);
 }
 
 // Return log quantity specified
@@ -53,6 +57,12 @@ int Model::log(Log::LogType logType) const
 	return changeLog_.log(logType);
 }
 
+// Return revision count of log quantity specified
+int Model::revision(Log::LogType logType) const
+{
+	return revisions_.log(logType);
+}
+
 // Return whether model has been modified
 bool Model::isModified() const
 {
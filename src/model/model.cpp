@@ -58,6 +58,8 @@ Model::Model() : ListItem<Model>()
 	patternsPoint_ = -1;
 	expressionPoint_ = -1;
 	expressionVdwOnly_ = false;
+	vdwTablesPoints_ = 0;
+	vdwTablesCutoff_ = 0.0;
 	cell_.setParent(this);
 	rmsForce_ = 0.0;
 	zMatrixPoint_ = -1;
@@ -75,6 +77,7 @@ Model::Model() : ListItem<Model>()
 	trajectoryPlaying_ = false;
 	trajectoryCurrentFrame_ = NULL;
 	trajectoryPropagateParentStyle_ = false;
+	trajectoryFrames_.setParent(this);
 	
 	// Component
 	componentInsertionPolicy_ = Model::NoPolicy;
@@ -83,11 +86,6 @@ Model::Model() : ListItem<Model>()
 	componentDensity_ = 1.0;
 	componentRotatable_ = true;
 
-	// Misc Function Data
-	bondingCuboids_ = NULL;
-	bondingOverlays_ = NULL;
-	nCuboids_ = 0;
-
 	// Vibration info
 	vibrationCurrentFrame_ = NULL;
 	vibrationForward_ = true;
@@ -170,6 +168,7 @@ void Model::clear()
 	zMatrixPoint_ = -1;
 	iconPoint_ = -1;
 	renderGroupPoint_ = -1;
+	atomStore_.invalidate();
 	icon_ = QIcon();
 }
 
@@ -247,6 +246,8 @@ void Model::copyAtomData(Model* srcmodel, int dat)
 		if ((dat&Atom::FixedData) || (dat == Atom::AllData)) i->setPositionFixed(j->isPositionFixed());
 		j = j->next;
 	}
+	// Charges, fixed flags, and elements are held alongside coordinates in the packed atom store, so log them as coordinate changes too
+	if ((dat&(Atom::PositionData|Atom::ChargeData|Atom::FixedData|Atom::ElementData)) || (dat == Atom::AllData)) logChange(Log::Coordinates);
 	//Messenger::print(Messenger::Verbose, "Copied data for %i atoms from model '%s' to model '%s'.", count);
 // name(), srcmodel->name());
 	Messenger::exit("Model::copyAtomData");
@@ -285,6 +286,7 @@ void Model::copyAtomData(Model* srcmodel, int dat, int startatom, int ncopy)
 				if ((dat&Atom::ChargeData) || (dat == Atom::AllData)) ii[n]->setCharge(jj[n]->charge());
 				if ((dat&Atom::FixedData) || (dat == Atom::AllData)) ii[n]->setPositionFixed(jj[n]->isPositionFixed());
 			}
+			if ((dat&(Atom::PositionData|Atom::ChargeData|Atom::FixedData|Atom::ElementData)) || (dat == Atom::AllData)) logChange(Log::Coordinates);
 			Messenger::print(Messenger::Verbose, "Copied data for %i atoms starting at %i from model '%s' to model '%s'.", ncopy, startatom, qPrintable(name_), qPrintable(srcmodel->name()));
 		}
 	}
@@ -36,9 +36,15 @@
 #include "base/basisshell.h"
 #include "base/vibration.h"
 #include "base/zmatrix.h"
+#include "base/atomstore.h"
+#include "base/framestore.h"
 #include "base/namespace.h"
 #include "render/rendergroup.h"
 #include "base/fourierdata.h"
+#include "base/spmedata.h"
+#include "ff/neighbourlist.h"
+#include "ff/vdwkernels.h"
+#include "ff/forms.h"
 #include <QIcon>
 
 ATEN_BEGIN_NAMESPACE
@@ -133,6 +139,8 @@ class Model : public ListItem<Model>
 	 */
 	private:
 	Log changeLog_;
+	// Number of changes made to each log quantity (which, unlike the logs themselves, are never rewound by undo/redo or reset)
+	Log revisions_;
 
 	public:
 	// Set complete log structure
@@ -145,6 +153,8 @@ class Model : public ListItem<Model>
 	void logChange(Log::LogType logType);
 	// Return log quantity specified
 	int log(Log::LogType logType) const;
+	// Return revision count of log quantity specified
+	int revision(Log::LogType logType) const;
 	// Return whether model has been modified
 	bool isModified() const;
 	// Update save point for model
@@ -175,6 +185,8 @@ class Model : public ListItem<Model>
 	void reduceMass(int element);
 	// Increase the mass (and unknown element count) of the model
 	void increaseMass(int element);
+	// Packed copy of atom data
+	AtomStore atomStore_;
 	
 	public:
 	// Create a new atom
@@ -215,6 +227,8 @@ class Model : public ListItem<Model>
 	void swapAtoms(int id1, int id2);
 	// Return (and autocreate if necessary) the static atoms array
 	Atom** atomArray();
+	// Return packed atom data, updating it first if the model has changed
+	AtomStore& atomStore();
 	// Set visibility of specified atom
 	void atomSetHidden(Atom* i, bool hidden);
 	// Set fixed status of specified atom
@@ -299,24 +313,8 @@ class Model : public ListItem<Model>
 	private:
 	// Bonds in the model
 	List<Bond> bonds_;
-	// Atom reflists (pointers) for bond calculation
-	RefList<Atom,double>* bondingCuboids_, *bondingOverlays_;
-	// Number of cuboids in atom reflists
-	int nCuboids_;
-	// Integer number of boxes in each direction
-	Vec3<int> cuboidBoxes_;
-	// Product of y and z cuboidBoxes_
-	int cuboidYZ_;
-	// Extent of model, and size of cuboids
-	Vec3<double> extentMin_, extentMax_, extentRange_, cuboidSize_;
-	// Initialise reflists based on current extent of model
-	void initialiseBondingCuboids();
-	// Free any created reflists
-	void freeBondingCuboids();
-	// Add atom to cuboid reflists
-	void addAtomToCuboid(Atom* i);
-	// Calculate bonding from stored cuboid lists
-	void rebond();
+	// Calculate bonding between atoms, optionally restricted to those currently selected
+	void rebond(bool selectionOnly);
 
 	public:
 	// Return first bond in the model
@@ -589,6 +587,11 @@ class Model : public ListItem<Model>
 	RefList<ForcefieldAtom,int> allForcefieldTypes_;
 	// Combination table, containing pre-combined VDW parameters
 	PairTable<ForcefieldAtom,double> combinationTable_;
+	// Tabulated VDW interactions for pairs of types with expensive functional forms
+	PairTable<ForcefieldAtom,VdwTable> vdwTables_;
+	// Number of points and cutoff with which the VDW tables were last created
+	int vdwTablesPoints_;
+	double vdwTablesCutoff_;
 
 	public:
 	// Set type of specified atom
@@ -639,6 +642,12 @@ class Model : public ListItem<Model>
 	void fillExpression(int);
 	// Return specified pair data from combination table
 	PointerPair<ForcefieldAtom,double>* combinedParameters(ForcefieldAtom* at1, ForcefieldAtom* at2);
+	// Create (or recreate) tabulated VDW interactions, if requested and out of date
+	void prepareVdwTables();
+	// Return whether tabulated VDW interactions are in use
+	bool hasVdwTables() const;
+	// Return tabulated VDW interaction for specified pair of types
+	VdwTable* vdwTable(ForcefieldAtom* at1, ForcefieldAtom* at2);
 
 
 	/*
@@ -647,12 +656,24 @@ class Model : public ListItem<Model>
 	private:
 	// Fourier data
 	FourierData fourierData_;
+	// Smooth Particle Mesh Ewald data
+	SpmeData spmeData_;
+	// Neighbour list for pairwise interactions
+	NeighbourList neighbourList_;
 	// RMS force for last calculated forces
 	double rmsForce_;
+	// Prepare neighbour list of specified configuration, and any VDW tables, for pairwise interactions
+	void preparePairInteractions(Model* config);
+	// Calculate selected intramolecular / pairwise pattern energies of specified configuration over all available threads
+	bool calculatePatternEnergies(Model* config, EnergyStore* estore, bool bonded, bool vdw, Electrostatics::ElecMethod elecMethod);
 
 	public:
 	// Return reference to FourierData structure
 	FourierData& fourierData();
+	// Return reference to SpmeData structure
+	SpmeData& spmeData();
+	// Return reference to neighbour list
+	NeighbourList& neighbourList();
 	// Storage for energy
 	EnergyStore energy;
 	// Calculate (and return) the total energy of the specified model configuration
@@ -840,8 +861,8 @@ class Model : public ListItem<Model>
 	private:
 	// Plugin for trajectory read
 	FilePluginInterface* trajectoryPlugin_;
-	// Frame list
-	List<Model> trajectoryFrames_;
+	// Cached frames
+	FrameStore trajectoryFrames_;
 	// Current trajectory frame to be drawn
 	Model* trajectoryCurrentFrame_;
 	// Whether this is a cached trajectory (true) or is being read sequentially from disk (false)
@@ -858,6 +879,8 @@ class Model : public ListItem<Model>
 	Model* addTrajectoryFrame();
 	// Remove frame from trajectory
 	void removeTrajectoryFrame(Model* frame);
+	// Pack completed frame into the compact frame store, releasing its full model
+	bool packTrajectoryFrame(Model* frame);
 	// Return whether a trajectory for this model exists
 	bool hasTrajectory() const;
 	// Return whether the trajectory is cached (if there is one)
@@ -870,8 +893,6 @@ class Model : public ListItem<Model>
 	FilePluginInterface* trajectoryPlugin();
 	// Return the current frame pointer
 	Model* trajectoryCurrentFrame() const;
-	// Return pointer to trajectory frames
-	Model* trajectoryFrames() const;
 	// Return pointer to specified frame number
 	Model* trajectoryFrame(int n);
 	// Return the total number of frames in the trajectory (file or cached)
@@ -894,6 +915,8 @@ class Model : public ListItem<Model>
 	void setTrajectoryPropagateParentStyle(bool b);
 	// Copy style of the supplied model to all trajectory frames
 	void trajectoryCopyAtomStyle(Model* source);
+	// Accumulate pending quantities over the specified trajectory frames, returning the number of frames used
+	int analyseTrajectory(const Array<int>& frames, int nThreads);
 
 
 	/*
@@ -63,7 +63,11 @@ void Model::translateMolecule(Pattern* p, int mol, const Vec3<double>& v)
 	pnatoms = p->nAtoms();
 	offset = p->startAtom() + pnatoms * mol;
 	Messenger::print(Messenger::Verbose, "Model::translateMolecule : Moving %i atoms starting at %i (%i atoms currently in model)", pnatoms, offset, atoms_.nItems());
-	if (offset < atoms_.nItems()) for (n=offset; n<offset+pnatoms; n++) modelatoms[n]->r() += v;
+	if (offset < atoms_.nItems())
+	{
+		for (n=offset; n<offset+pnatoms; n++) modelatoms[n]->r() += v;
+		logChange(Log::Coordinates);
+	}
 	else printf("Model::translateMolecule : Requested a molecule past end of model contents. (%s %i)\n", qPrintable(p->name()), mol);  
 	Messenger::exit("Model::translateMolecule");
 }
@@ -95,6 +99,7 @@ void Model::rotateMolecule(Pattern* p, int mol, double rotx, double roty)
 			// Store the new position
 			modelatoms[n]->r() = newpos;
 		}
+		logChange(Log::Coordinates);
 	}
 	else printf("Model::rotateMolecule : Requested a molecule past end of model contents. (%s %i)\n", qPrintable(p->name()), mol); 
 	Messenger::exit("Model::rotateMolecule");
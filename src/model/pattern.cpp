@@ -22,9 +22,12 @@
 #include "model/model.h"
 #include "base/pattern.h"
 #include "base/atomaddress.h"
-#include "model/clipboard.h"
+#include "base/threadpool.h"
 #include "ff/forcefield.h"
 
+// Number of atoms above which molecules are compared in parallel when detecting patterns
+#define PATTERNTHREADATOMS 20000
+
 ATEN_USING_NAMESPACE
 
 // Number of nodes in pattern
@@ -185,21 +188,60 @@ void Model::clearPatterns()
 	Messenger::exit("Model::clearPatterns");
 }
 
+// Return hash of the molecule occupying the specified range of atoms, from its element sequence, fixed states, and bond topology
+static unsigned int moleculeHash(Atom** atoms, int first, int nAtoms)
+{
+	// FNV-1a over the properties of each atom in turn, with bonded partners (relative to the first atom) combined independently of their order
+	unsigned int hash = 2166136261u, partners;
+	Atom* i;
+	for (int n=first; n<first+nAtoms; ++n)
+	{
+		i = atoms[n];
+		partners = 0;
+		for (RefListItem<Bond,int>* rb = i->bonds(); rb != NULL; rb = rb->next) partners += (unsigned int) (rb->item->partner(i)->id() - first + 1) * 2654435761u;
+		hash = (hash ^ (unsigned int) i->element()) * 16777619u;
+		hash = (hash ^ (i->isPositionFixed() ? 1u : 0u) ^ (i->hasFixedType() ? 2u : 0u)) * 16777619u;
+		hash = (hash ^ (unsigned int) i->nBonds()) * 16777619u;
+		hash = (hash ^ partners) * 16777619u;
+	}
+	return hash;
+}
+
+// Return whether the molecules occupying the two ranges of atoms specified are identical (in element sequence, fixed states, and bonding)
+static bool moleculesMatch(Atom** atoms, int first, int other, int nAtoms)
+{
+	Atom* i, *j;
+	RefListItem<Bond,int>* rb, *rc;
+	int localId;
+	for (int n=0; n<nAtoms; ++n)
+	{
+		i = atoms[first+n];
+		j = atoms[other+n];
+		if (i->element() != j->element()) return false;
+		if (i->isPositionFixed() != j->isPositionFixed()) return false;
+		if (i->hasFixedType() != j->hasFixedType()) return false;
+		if (i->hasFixedType() && (i->type() != j->type())) return false;
+		if (i->nBonds() != j->nBonds()) return false;
+		for (rb = i->bonds(); rb != NULL; rb = rb->next)
+		{
+			localId = rb->item->partner(i)->id() - first;
+			for (rc = j->bonds(); rc != NULL; rc = rc->next) if (rc->item->partner(j)->id() - other == localId) break;
+			if (rc == NULL) return false;
+		}
+	}
+	return true;
+}
+
 // Autocreate patterns
 bool Model::createPatterns()
 {
 	// Determine the pattern (molecule) layout of the model
 	Messenger::enter("Model::createPatterns");
-	int n, atomid, nsel2, nmols, idi, idj, idoff, count;
-	bool same;
+	int m, k, id, nAtoms, first, size, lastId, nMolecules, nmols, nPatterns;
 	QString empirical;
-	Clipboard patclip;
-	Pattern* p;
+	Atom** atoms, *i;
 	RefListItem<Bond,int>* rb;
-	Atom* i, *selectSource;
-	ClipAtom* clipi;
-	RefListItem<Atom,int>* isel;
-	
+
 	// Check current pattern first...
 	if (arePatternsValid())
 	{
@@ -219,139 +261,103 @@ bool Model::createPatterns()
 		return true;
 	}
 	
-	// To autodetect, we start off at the first atom in the model, tree-select this atom and copy the selection to the clipboard. Use the clipboard to check subsequent selections, and if its the same just increase the nmols counter by one. If it's different, assume its the start of a new type of molecule and reset the counters.
-	atomid = 0;
-	nmols = 0;
-	i = atoms_.first();
-	while (atomid != atoms_.nItems())
+	// Find the bound molecules in the model, in atom order. We insist that each molecule consists of consecutively ordered atoms,
+	// otherwise we can't proceed (a molecule whose atoms extend beyond the range it should occupy means we must force a 1*N pattern)
+	nAtoms = atoms_.nItems();
+	atoms = atomArray();
+	Array<int> moleculeFirst, moleculeSize, stack, visited;
+	visited.createEmpty(nAtoms, 0);
+	stack.createEmpty(nAtoms, 0);
+	int nStack;
+	first = 0;
+	while (first != nAtoms)
 	{
-		selectNone(true);
-		
-		// Select molecule starting at atom 'i' and calculate fingerprint
-		selectTree(i, true);
-		selectSource = i;
-		
-		// We insist that the molecule consists of consecutively ordered atoms, otherwise we can't proceed, so count the number of selected
-		// atoms in those that we now skip (if != nselected then we must force a 1*N pattern)
-		nsel2 = 0;
-		atomid += marked_.nItems();
-		//selectionGetEmpirical(emp);
-		for (n=0; n<marked_.nItems(); n++)
+		// Search outwards from the first unassigned atom, finding the size and highest id of its molecule
+		size = 0;
+		lastId = first;
+		visited[first] = 1;
+		stack[0] = first;
+		nStack = 1;
+		while (nStack != 0)
 		{
-			if (i->isSelected(true)) nsel2 ++;
-			i = i->next;
+			i = atoms[stack[--nStack]];
+			++size;
+			if (i->id() > lastId) lastId = i->id();
+			for (rb = i->bonds(); rb != NULL; rb = rb->next)
+			{
+				id = rb->item->partner(i)->id();
+				if (visited[id]) continue;
+				visited[id] = 1;
+				stack[nStack++] = id;
+			}
 		}
-		if (nsel2 != marked_.nItems())
+
+		if (lastId != first+size-1)
 		{
+			// Count the patterns which would have been completed before this molecule, for the error message
+			nPatterns = 0;
+			for (m=1; m<moleculeFirst.nItems(); ++m) if ((moleculeSize[m] != moleculeSize[m-1]) || (!moleculesMatch(atoms, moleculeFirst[m-1], moleculeFirst[m], moleculeSize[m]))) ++nPatterns;
+
 			Messenger::error("Pattern creation failed because of bad atom ordering or the presence of additional bonds.");
-			Messenger::error("Problem occurred in pattern %i whilst selecting from atom %i.", patterns_.nItems()+1, selectSource->id()+1);
+			Messenger::error("Problem occurred in pattern %i whilst selecting from atom %i.", nPatterns+1, first+1);
 
 			// Remove any patterns added so far
 			patterns_.clear();
-			nmols = 0;
 
 			Messenger::exit("Model::createPatterns");
 			return false;
 		}
-		// If this is the first pass (molecule), copy the selection. If not, compare it
-		if (nmols == 0)
+
+		moleculeFirst.add(first);
+		moleculeSize.add(size);
+		first += size;
+	}
+	nMolecules = moleculeFirst.nItems();
+
+	// Compare each molecule with the previous one (equality being transitive, this is the same as comparing it with the first in its run)
+	// Hashes are calculated first so that most differing molecules are rejected cheaply. Both passes are independent per molecule, so large
+	// models are processed in parallel.
+	int nThreads = (nAtoms >= PATTERNTHREADATOMS ? prefs.nThreadsToUse() : 1);
+	Array<unsigned int> hashes;
+	Array<bool> sameAsPrevious;
+	hashes.createEmpty(nMolecules, 0);
+	sameAsPrevious.createEmpty(nMolecules, false);
+	ThreadPool::run(nMolecules, nThreads, [&](int molecule, int thread)
+	{
+		hashes[molecule] = moleculeHash(atoms, moleculeFirst.value(molecule), moleculeSize.value(molecule));
+	});
+	ThreadPool::run(nMolecules, nThreads, [&](int molecule, int thread)
+	{
+		if (molecule == 0) return;
+		if (moleculeSize.value(molecule) != moleculeSize.value(molecule-1)) return;
+		if (hashes.value(molecule) != hashes.value(molecule-1)) return;
+		sameAsPrevious[molecule] = moleculesMatch(atoms, moleculeFirst.value(molecule-1), moleculeFirst.value(molecule), moleculeSize.value(molecule));
+	});
+
+	// Create patterns from runs of identical molecules
+	nmols = 0;
+	for (m=0; m<=nMolecules; ++m)
+	{
+		if ((m < nMolecules) && sameAsPrevious[m])
 		{
-			patclip.copyMarked(this);
-			empirical = selectionEmpirical(true);
-			nmols = 1;
+			++nmols;
+			continue;
 		}
-		else
-		{
-			// Compare clipboard contents with current selection
-			same = true;
-			// Check number of atoms first....
-			if (marked_.nItems() != patclip.nAtoms()) same = false;
-			else
-			{
-				// Atoms
-				clipi = patclip.atoms();
-				for (isel = marked_.first(); isel != NULL; isel = isel->next)
-				{
-					count++;
-					
-					// Element check
-					if (clipi->atom().element() != isel->item->element())
-					{
-						same = false;
-						break;
-					}
-					
-					// Fixed position
-					if (clipi->atom().isPositionFixed() != isel->item->isPositionFixed())
-					{
-						same = false;
-						break;
-					}
-
-					// Fixed forcefield type check
-					if (clipi->atom().hasFixedType() != isel->item->hasFixedType())
-					{
-						same = false;
-						break;
-					}
-					else if (clipi->atom().hasFixedType())
-					{
-						// Both have fixed type - make sure types are the same
-						if (clipi->atom().type() != isel->item->type())
-						{
-							same = false;
-							break;
-						}
-					}
-					clipi = clipi->next;
-				}
-				
-				// Bonding between atoms (but only if atoms themselves check out)...
-				if (same)
-				{
-					idoff = selection(true)->item->id();
-					count = 0;
-					for (isel = marked_.first(); isel != NULL; isel = isel->next)
-					{
-						// Convert IDs so they start at zero (i.e. subtract ID of current atom 'i')
-						idi = isel->item->id() - idoff;
-						for (rb = isel->item->bonds(); rb != NULL; rb = rb->next)
-						{
-							idj = rb->item->partner(isel->item)->id() - idoff;
-							if (idi < idj) continue;
-							++count;
-							if (!patclip.hasBond(idi,idj))
-							{
-								same = false;
-								break;
-							}
-						}
-						if (!same) break;
-					}
-					// Check for difference between number of bonds between marked atoms and clipboard atoms
-					if (count != patclip.nBonds()) same = false;
-				}
-			}
 
-			// If we get to here with same == true then we increase nmols. Otherwise, we create a new pattern.
-			if (same) ++nmols;
-			else
-			{
-				// Not the same as the last stored pattern, so store old data and start a new one
-				Messenger::print(Messenger::Verbose, "New pattern found: %s", qPrintable(empirical));
-				p = addPattern(qPrintable(empirical), nmols, patclip.nAtoms());
-				patclip.copyMarked(this);
-				empirical = selectionEmpirical(true);
-				nmols = 1;
-			}
+		// Not the same as the last stored pattern, so store old data and start a new one
+		if (nmols != 0)
+		{
+			first = moleculeFirst[m-nmols];
+			size = moleculeSize[m-nmols];
+			selectNone(true);
+			for (k=first; k<first+size; ++k) selectAtom(atoms[k], true);
+			empirical = selectionEmpirical(true);
+			Messenger::print(Messenger::Verbose, "New pattern found: %s", qPrintable(empirical));
+			addPattern(qPrintable(empirical), nmols, size);
 		}
+		nmols = 1;
 	}
-	// Store last pattern data 
-	if (nmols != 0)
-	{
-		Messenger::print(Messenger::Verbose, "New pattern found: %s", qPrintable(empirical));
-		p = addPattern(qPrintable(empirical), nmols, patclip.nAtoms());
-	}
+	selectNone(true);
 
 	// Describe the atoms / rings in the patterns
 	describeAtoms();
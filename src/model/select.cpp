@@ -732,75 +732,37 @@ void Model::moveSelectionToEnd(bool markOnly)
 void Model::selectOverlaps(double tolerance, bool markonly)
 {
 	Messenger::enter("Model::selectOverlaps");
-	int n, m, x, y, z, x2, y2, z2, checklist[8], count;
+	int i, j, m, count = 0;
 	double dist;
-	Atom* i, *j;
 	selectNone(markonly);
-	// Create cuboid lists
-	initialiseBondingCuboids();
-	// Add all atoms to cuboid list
-	for (i = atoms_.first(); i != NULL; i = i->next) addAtomToCuboid(i);
-	// Loop over cuboids, checking distances with atoms in adjacent boxes
-	RefListItem<Atom,double>* ri, *rj;
-	x = 0;
-	y = 0;
-	z = 0;
-	count = 0;
-	for (n = 0; n<nCuboids_; n++)
-	{
-		if (bondingCuboids_[n].nItems() != 0)
-		{
-// 			if (bondingCuboids_[n].nItems() > 0) printf("On cuboid %i (%ix%ix%i) which contains %i atoms\n", n, x, y, z, bondingCuboids_[n].nItems());
-			// For each of the atoms in the cuboid, check distance with each atom in eight of the closest
-			// overlay boxes. 
-			checklist[0] = n;
-			x2 = (x == (cuboidBoxes_.x-1) ? 0 : x+1);
-			y2 = (y == (cuboidBoxes_.y-1) ? 0 : y+1);
-			z2 = (z == (cuboidBoxes_.z-1) ? 0 : z+1);
-// 			if (bondingCuboids_[n].nItems() > 0) printf("....xyz = %i,%i,%i, xyz2 = %i,%i,%i\n", x, y, z, x2, y2, z2);
-			checklist[1] = x2*cuboidYZ_+y*cuboidBoxes_.z+z;
-			checklist[2] = x2*cuboidYZ_+y2*cuboidBoxes_.z+z;
-			checklist[3] = x2*cuboidYZ_+y*cuboidBoxes_.z+z2;
-			checklist[4] = x2*cuboidYZ_+y2*cuboidBoxes_.z+z2;
-			checklist[5] = x*cuboidYZ_+y2*cuboidBoxes_.z+z;
-			checklist[6] = x*cuboidYZ_+y*cuboidBoxes_.z+z2;
-			checklist[7] = x*cuboidYZ_+y2*cuboidBoxes_.z+z2;
-			for (ri = bondingCuboids_[n].first(); ri != NULL; ri = ri->next)
-			{
-				i = ri->item;
-				if (i->isSelected(markonly)) continue;
-				for (m=0; m<8; m++)
-				{
-					for (rj = bondingOverlays_[checklist[m]].first(); rj != NULL; rj = rj->next)
-					{
-						j = rj->item;
-						if ((j->isSelected(markonly)) || (i == j)) continue;
-						dist = cell_.distance(i,j);
-						if (dist < tolerance)
-						{
-							Messenger::print(Messenger::Verbose, "Atom %i (%s) is %f from atom %i (%s).", j->id()+1, ElementMap::symbol(j), dist, i->id()+1, ElementMap::symbol(i));
-							selectAtom(j, markonly);
-							++count;
-						}
-					}
-				}
-			}
-		}
-		// Increase x,y,z indices for box lookup
-		z ++;
-		if (z == cuboidBoxes_.z)
+
+	// Sort atoms into cells no smaller than the tolerance
+	NeighbourList cellList;
+	cellList.prepare(this, tolerance, 0.0);
+	AtomStore& store = atomStore();
+	Atom** modelatoms = atomArray();
+	Array<int> candidates;
+	candidates.setChunkIncrement(SMALLCHUNKSIZE);
+
+	// Check distances between each unselected atom and its unselected neighbours
+	for (i=0; i<store.nAtoms(); ++i)
+	{
+		if (modelatoms[i]->isSelected(markonly)) continue;
+		candidates.forgetData();
+		cellList.neighbours(i, candidates);
+		for (m=0; m<candidates.nItems(); ++m)
 		{
-			z = 0;
-			y ++;
-			if (y == cuboidBoxes_.y)
+			j = candidates[m];
+			if (modelatoms[j]->isSelected(markonly)) continue;
+			dist = cell_.distance(store.r(i), store.r(j));
+			if (dist < tolerance)
 			{
-				y = 0;
-				x ++;
+				Messenger::print(Messenger::Verbose, "Atom %i (%s) is %f from atom %i (%s).", j+1, ElementMap::symbol(modelatoms[j]), dist, i+1, ElementMap::symbol(modelatoms[i]));
+				selectAtom(modelatoms[j], markonly);
+				++count;
 			}
 		}
 	}
-	// Free bonding cuboids
-	freeBondingCuboids();
 	Messenger::print("%i overlapping atoms selected.", count);
 	Messenger::exit("Model::selectOverlaps");
 }
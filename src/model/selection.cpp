@@ -344,11 +344,11 @@ void Model::reorderSelectedAtoms()
 		else Messenger::print("Typing for reference fragment atom %i is not unique - reordering of symmetric subgroups may not be exact.", rk->item->id()+1);
 	}
 
-	// We will create a pattern here to allow us to get a connectivity matrix easily
+	// We will create a pattern here to allow us to get a connectivity easily
 	Pattern referencePattern;
 	referencePattern.setParent(this);
 	referencePattern.initialise(0, 0, 1, referenceFragment.nItems());
-	referencePattern.createMatrices();
+	referencePattern.createExclusions();
 
 	// We now select fragments sequentially, and reorder the atoms in each one...
 	Messenger::print("Reordering atoms in individual fragments...");
@@ -41,8 +41,8 @@ Vec3<double> Model::siteCentre(Site* s, int mol)
 	Messenger::enter("Model::calculateCentre");
 
 	int offset, n, ii;
-	Atom** modelatoms = atomArray();
-	static Vec3<double> firstid, mim, centre;
+	AtomStore& store = atomStore();
+	Vec3<double> firstid, centre;
 	Pattern* sitep = s->pattern();
 	offset = sitep->startAtom();
 	offset += sitep->nAtoms() * mol;
@@ -51,11 +51,11 @@ Vec3<double> Model::siteCentre(Site* s, int mol)
 	if (s->atoms.count() != 0)
 	{
 		ii = s->atoms.first();
-		centre = modelatoms[offset + ii]->r();
+		centre = store.r(offset + ii);
 		firstid = centre;
 		for (n=1; n<s->atoms.count(); ++n)
 		{
-			centre += cell_.mim(modelatoms[offset + n]->r(), firstid);
+			centre += cell_.mim(store.r(offset + s->atoms.at(n)), firstid);
 		}
 		// Take average
 		centre /= s->atoms.count();
@@ -63,17 +63,15 @@ Vec3<double> Model::siteCentre(Site* s, int mol)
 	else
 	{
 		// Use all atoms for centre. Grab first as the MIM point
-		centre = modelatoms[offset]->r();
+		centre = store.r(offset);
 		firstid = centre;
 		for (n=1; n<sitep->nAtoms(); ++n)
 		{
-			centre += cell_.mim(modelatoms[offset + n]->r(), firstid);
+			centre += cell_.mim(store.r(offset + n), firstid);
 		}
 		// Take average
 		centre /= sitep->nAtoms();
 	}
-	s->setCentre(centre);
-
 	Messenger::exit("Model::calculateCentre");
 	return centre;
 }
@@ -83,30 +81,29 @@ Matrix Model::siteAxes(Site* s, int mol)
 {
 	Messenger::enter("Model::calculateAxes");
 	int offset, n;
-	Atom** modelatoms = atomArray();
-	static Vec3<double> mim, v1, v2, centre;
+	AtomStore& store = atomStore();
+	Vec3<double> mim, v1, v2, centre = siteCentre(s, mol);
 	Matrix axes;
-	ListItem<int>* li;
 	Pattern* sitep = s->pattern();
 	offset = sitep->startAtom();
 	offset += sitep->nAtoms() * mol;
 	// Calculate 'position' of x-axis (defining vector COG->xpos)
-	// Get mim coordinates relative to (already-calculated) site centre
+	// Get mim coordinates relative to site centre
 	v1.zero();
 	for (n=0; n<s->xAxisAtoms.count(); ++n)
 	{
-		mim = cell_.mim(modelatoms[offset + s->xAxisAtoms.at(n)]->r(), centre);
+		mim = cell_.mim(store.r(offset + s->xAxisAtoms.at(n)), centre);
 		v1 += mim;
 	}
 	// Take average and subtract site centre to get vector
 	v1 /= s->xAxisAtoms.count();
 	v1 -= centre;
 	// Calculate 'position' of y-axis (defining vector COG->xpos)
-	// Get mim coordinates relative to (already-calculated) site centre
+	// Get mim coordinates relative to site centre
 	v2.zero();
 	for (n=0; n<s->yAxisAtoms.count(); ++n)
 	{
-		mim = cell_.mim(modelatoms[offset + s->yAxisAtoms.at(n)]->r(), centre);
+		mim = cell_.mim(store.r(offset + s->yAxisAtoms.at(n)), centre);
 		v2 += mim;
 	}
 	// Take average and subtract site centre to get vector
@@ -120,7 +117,6 @@ Matrix Model::siteAxes(Site* s, int mol)
 	axes.setColumn(1,v2,0.0);
 	axes.setColumn(2,v1 * v2,0.0);
 	//axes.print();
-	s->setAxes(axes);
-	Messenger::enter("Model::calculateAxes");
+	Messenger::exit("Model::calculateAxes");
 	return axes;
 }
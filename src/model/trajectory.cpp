@@ -22,6 +22,10 @@
 #include "model/model.h"
 #include "parser/tree.h"
 #include "plugins/interfaces/fileplugin.h"
+#include "methods/calculable.h"
+#include "base/threadpool.h"
+#include <QMutex>
+#include <QWaitCondition>
 
 ATEN_USING_NAMESPACE
 
@@ -40,7 +44,7 @@ FilePluginInterface* Model::trajectoryPlugin()
 // Return whether a trajectory for this model exists
 bool Model::hasTrajectory() const
 {
-	return (trajectoryFrames_.nItems() != 0);
+	return (trajectoryFrames_.nFrames() != 0);
 }
 
 // Return whether the trajectory is cached (if there is one)
@@ -55,12 +59,6 @@ Model* Model::trajectoryCurrentFrame() const
 	return trajectoryCurrentFrame_;
 }
 
-// Return pointer to trajectory frames
-Model* Model::trajectoryFrames() const
-{
-	return trajectoryFrames_.first();
-}
-
 // Return pointer to specified frame number
 Model* Model::trajectoryFrame(int n)
 {
@@ -68,7 +66,7 @@ Model* Model::trajectoryFrame(int n)
 	if (trajectoryFramesAreCached_)
 	{
 		if ((n < 0) || (n >= nTrajectoryFrames())) Messenger::print("Frame %i is out of range for trajectory associated to model '%s'.", n, qPrintable(name_));
-		else frame = trajectoryFrames_[n];
+		else frame = trajectoryFrames_.frame(n);
 	}
 	else Messenger::print("Trajectory for model '%s' is not cached: individual frames not available.", qPrintable(name_));
 	return frame;
@@ -77,7 +75,7 @@ Model* Model::trajectoryFrame(int n)
 // Return the total number of frames in the trajectory (file or cached)
 int Model::nTrajectoryFrames() const
 {
-	if (trajectoryFramesAreCached_) return trajectoryFrames_.nItems();
+	if (trajectoryFramesAreCached_) return trajectoryFrames_.nFrames();
 	else if (trajectoryPlugin_) return trajectoryPlugin_->nDataParts();
 	else return 0;
 }
@@ -114,13 +112,11 @@ Model* Model::addTrajectoryFrame()
 	Messenger::enter("Model::addFrame");	
 
 	Model* newFrame = trajectoryFrames_.add();
-	newFrame->setType(Model::TrajectoryFrameType);
 
 	// Set trajectoryCurrentFrame_ here (always points to the last added frame)
 	trajectoryCurrentFrame_ = newFrame;
-	newFrame->setParent(this);
-	if (trajectoryFrames_.nItems() > 1) trajectoryFramesAreCached_ = true;
-	trajectoryFrameIndex_ = trajectoryFrames_.nItems()-1;
+	if (trajectoryFrames_.nFrames() > 1) trajectoryFramesAreCached_ = true;
+	trajectoryFrameIndex_ = trajectoryFrames_.nFrames()-1;
 
 	Messenger::exit("Model::addFrame");	
 	return newFrame;
@@ -131,12 +127,37 @@ void Model::removeTrajectoryFrame(Model* frame)
 {
 	Messenger::enter("Model::removeTrajectoryFrame");
 
-	if (frame == trajectoryCurrentFrame_) trajectoryCurrentFrame_ = (frame->next == NULL ? frame->prev : frame->next);
-	trajectoryFrames_.remove(frame);
+	int index = trajectoryFrames_.remove(frame);
+	if (index == -1)
+	{
+		Messenger::print("Internal Error: Frame to remove is not in the trajectory of model '%s'.", qPrintable(name_));
+		Messenger::exit("Model::removeTrajectoryFrame");
+		return;
+	}
+
+	// Current frame becomes the one after the removed frame (or the one before, if it was the last)
+	if (frame == trajectoryCurrentFrame_)
+	{
+		if (index >= trajectoryFrames_.nFrames()) index = trajectoryFrames_.nFrames()-1;
+		trajectoryCurrentFrame_ = trajectoryFrames_.displayFrame(index);
+		trajectoryFrameIndex_ = index;
+	}
+	else if (index < trajectoryFrameIndex_) --trajectoryFrameIndex_;
 
 	Messenger::exit("Model::removeTrajectoryFrame");
 }
 
+// Pack completed frame into the compact frame store, releasing its full model
+bool Model::packTrajectoryFrame(Model* frame)
+{
+	if (!trajectoryFrames_.pack(frame)) return false;
+
+	// If the frame was the current one, display its packed data instead
+	if (frame == trajectoryCurrentFrame_) trajectoryCurrentFrame_ = trajectoryFrames_.displayFrame(trajectoryFrameIndex_);
+
+	return true;
+}
+
 // Seek to first frame
 void Model::seekFirstTrajectoryFrame()
 {
@@ -233,7 +254,7 @@ void Model::seekTrajectoryFrame(int frameno, bool quiet)
 		Messenger::exit("Model::seekTrajectoryFrame");
 		return;
 	}
-	if (trajectoryFramesAreCached_) trajectoryCurrentFrame_ = trajectoryFrames_[frameno];
+	if (trajectoryFramesAreCached_) trajectoryCurrentFrame_ = trajectoryFrames_.displayFrame(frameno);
 	else
 	{
 		if (!trajectoryPlugin_)
@@ -288,13 +309,132 @@ void Model::trajectoryCopyAtomStyle(Model* source)
 		return;
 	}
 
-	Task* task = Messenger::initialiseTask("Applying style to trajectory frames...", trajectoryFrames_.nItems());
-	for (Model* m = trajectoryFrames_.first(); m != NULL; m = m->next)
+	// Packed frames share the style of a single topology model, so only that and any materialised frames need updating
+	int nUpdated = trajectoryFrames_.copyAtomStyle(source);
+	Messenger::print(Messenger::Verbose, "Applied style to %i trajectory frame model(s).", nUpdated);
+
+	Messenger::exit("Model::trajectoryCopyAtomStyle");
+}
+
+// Accumulate pending quantities over the specified trajectory frames, returning the number of frames used
+int Model::analyseTrajectory(const Array<int>& frames, int nThreads)
+{
+	Messenger::enter("Model::analyseTrajectory");
+
+	if (frames.nItems() == 0)
 	{
-		if (m != source) m->copyAtomStyle(source);
-		Messenger::incrementTaskProgress(task);
+		Messenger::exit("Model::analyseTrajectory");
+		return 0;
 	}
-	Messenger::terminateTask(task);
+	if (nThreads > frames.nItems()) nThreads = frames.nItems();
+	if (nThreads < 1) nThreads = 1;
+	Calculable* calc;
+	for (calc = pendingQuantities.first(); calc != NULL; calc = calc->next) calc->prepareThreads(nThreads);
 
-	Messenger::exit("Model::trajectoryCopyAtomStyle");
+	// If the trajectory is cached, the frames can simply be shared out between the threads, each unpacking them into its own model
+	if (trajectoryFramesAreCached_)
+	{
+		trajectoryFrames_.prepareThreads(nThreads);
+		ThreadPool::run(frames.nItems(), nThreads, [&](int task, int thread)
+		{
+			Model* frame = trajectoryFrames_.threadFrame(frames.value(task), thread);
+			for (Calculable* c = pendingQuantities.first(); c != NULL; c = c->next) c->accumulate(frame, thread);
+		});
+		trajectoryFrames_.prepareThreads(0);
+
+		Messenger::exit("Model::analyseTrajectory");
+		return frames.nItems();
+	}
+
+	if (!trajectoryPlugin_)
+	{
+		printf("Fatal Error - Trajectory is not cached, but no plugin set.\n");
+		Messenger::exit("Model::analyseTrajectory");
+		return 0;
+	}
+
+	// Otherwise, frames are read from disk by one thread into a fixed pool of frame buffers, and taken from there by the
+	// others for accumulation. Buffers are passed between the two via stacks of free and ready (decoded) frames.
+	int nBuffers = 2*nThreads, nFree = nBuffers, nReady = 0, nFramesRead = 0;
+	List<Model> buffers;
+	Array<Model*> freeBuffers, readyBuffers;
+	freeBuffers.createEmpty(nBuffers, NULL);
+	readyBuffers.createEmpty(nBuffers, NULL);
+	for (int n=0; n<nBuffers; ++n)
+	{
+		freeBuffers[n] = buffers.add();
+		freeBuffers[n]->setType(Model::TrajectoryFrameType);
+		freeBuffers[n]->setParent(this);
+	}
+	bool finished = false;
+	QMutex mutex;
+	QWaitCondition bufferFreed, frameReady;
+
+	ThreadPool::run(nThreads, nThreads, [&](int task, int thread)
+	{
+		Model* buffer;
+		Calculable* c;
+		mutex.lock();
+
+		// The first task reads frames into free buffers, accumulating quantities from ready frames itself if there are no free buffers
+		if (task == 0)
+		{
+			for (int n=0; n<frames.nItems(); ++n)
+			{
+				while (nFree == 0)
+				{
+					if (nReady > 0)
+					{
+						buffer = readyBuffers[--nReady];
+						mutex.unlock();
+						for (c = pendingQuantities.first(); c != NULL; c = c->next) c->accumulate(buffer, thread);
+						mutex.lock();
+						freeBuffers[nFree++] = buffer;
+					}
+					else bufferFreed.wait(&mutex);
+				}
+				buffer = freeBuffers[--nFree];
+				mutex.unlock();
+
+				buffer->clear();
+				trajectoryPlugin_->setParentModel(this);
+				trajectoryPlugin_->setTargetModel(buffer);
+				bool success = trajectoryPlugin_->importPart(frames.value(n));
+				buffer->logChange(Log::Structure);
+
+				mutex.lock();
+				if (!success)
+				{
+					Messenger::print("Failed to read frame %i from trajectory - analysis stopped.", frames.value(n)+1);
+					freeBuffers[nFree++] = buffer;
+					break;
+				}
+				readyBuffers[nReady++] = buffer;
+				++nFramesRead;
+				frameReady.wakeOne();
+			}
+			finished = true;
+			frameReady.wakeAll();
+		}
+
+		// All tasks (including the reader, once it has finished) accumulate quantities from ready frames until none remain
+		while (true)
+		{
+			while ((nReady == 0) && (!finished)) frameReady.wait(&mutex);
+			if (nReady == 0) break;
+			buffer = readyBuffers[--nReady];
+			mutex.unlock();
+			for (c = pendingQuantities.first(); c != NULL; c = c->next) c->accumulate(buffer, thread);
+			mutex.lock();
+			freeBuffers[nFree++] = buffer;
+			bufferFreed.wakeOne();
+		}
+		mutex.unlock();
+	});
+
+	// Point the plugin back at the current frame, since the buffers are about to be deleted
+	trajectoryPlugin_->setTargetModel(trajectoryCurrentFrame_);
+
+	Messenger::exit("Model::analyseTrajectory");
+	return nFramesRead;
 }
@@ -528,7 +528,7 @@ bool GridVariable::performFunction(int i, ReturnValue& rv, TreeNode* node)
 						Messenger::print("Error: Z value for grid (%i) is out of range (nz = %i)", nz+1, ptr->nXYZ().z);
 						result = false;
 					}
-					else rv.set( ptr->data3d()[nx][ny][nz] );
+					else rv.set( ptr->value(nx, ny, nz) );
 					break;
 				case (Grid::FreeXYZData):
 					Messenger::print("Free (irregular) grid data cannot be accessed with the 'data' function.");
@@ -45,6 +45,7 @@ MonteCarloVariable::~MonteCarloVariable()
 // Accessor data - name, type, arraysize, ro?
 Accessor MonteCarloVariable::accessorData[MonteCarloVariable::nAccessors] = {
 	{ "disorderAccuracy",		VTypes::DoubleData,	0, false },
+	{ "disorderBatchSize",		VTypes::IntegerData,	0, false },
 	{ "disorderDeltaAngle",		VTypes::DoubleData,	0, false },
 	{ "disorderDeltaDistance",	VTypes::DoubleData,	0, false },
 	{ "disorderMaxCycles",		VTypes::IntegerData,	0, false },
@@ -173,6 +174,9 @@ bool MonteCarloVariable::retrieveAccessor(int i, ReturnValue& rv, bool hasArrayI
 		case (MonteCarloVariable::DisorderAccuracy):
 			rv.set( ptr->disorderAccuracy() );
 			break;
+		case (MonteCarloVariable::DisorderBatchSize):
+			rv.set( ptr->disorderBatchSize() );
+			break;
 		case (MonteCarloVariable::DisorderDeltaAngle):
 			rv.set( ptr->disorderDeltaAngle() );
 			break;
@@ -255,6 +259,9 @@ bool MonteCarloVariable::setAccessor(int i, ReturnValue& sourcerv, ReturnValue&
 		case (MonteCarloVariable::DisorderAccuracy):
 			ptr->setDisorderAccuracy( newValue.asDouble(result) );
 			break;
+		case (MonteCarloVariable::DisorderBatchSize):
+			ptr->setDisorderBatchSize( newValue.asInteger(result) );
+			break;
 		case (MonteCarloVariable::DisorderDeltaAngle):
 			ptr->setDisorderDeltaAngle( newValue.asDouble(result) );
 			break;
@@ -44,7 +44,7 @@ class MonteCarloVariable : public Variable
 	 */
 	public:
 	// Accessor list
-	enum Accessors { DisorderAccuracy, DisorderDeltaAngle, DisorderDeltaDistance, DisorderMaxCycles, DisorderMaxFailures, DisorderMaximumScaleFactor, DisorderMinimumScaleFactor, DisorderNTweaks, DisorderRecoveryMaxCycles, DisorderRecoveryMaxTweaks, DisorderRecoveryThreshold, DisorderReductionFactor, NCycles, Temperature, nAccessors };
+	enum Accessors { DisorderAccuracy, DisorderBatchSize, DisorderDeltaAngle, DisorderDeltaDistance, DisorderMaxCycles, DisorderMaxFailures, DisorderMaximumScaleFactor, DisorderMinimumScaleFactor, DisorderNTweaks, DisorderRecoveryMaxCycles, DisorderRecoveryMaxTweaks, DisorderRecoveryThreshold, DisorderReductionFactor, NCycles, Temperature, nAccessors };
 	// Function list
 	enum Functions { AcceptanceEnergy, MaxStep, MoveAllowed, NTrials, SetAcceptanceEnergy, SetMaxStep, SetMoveAllowed, SetNTrials, nFunctions };
 	// Search variable access list for provided accessor
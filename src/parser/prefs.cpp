@@ -99,7 +99,9 @@ Accessor PreferencesVariable::accessorData[PreferencesVariable::nAccessors] = {
 	{ "mouseAction",		VTypes::StringData,		Prefs::nMouseButtons, false },
 	{ "mouseMoveFilter",		VTypes::IntegerData,		0, false },
 	{ "multiSampling",		VTypes::IntegerData,		0, false },
+	{ "neighbourSkin",		VTypes::DoubleData,		0, false },
 	{ "noQtSettings",		VTypes::IntegerData,		0, false },
+	{ "nThreads",			VTypes::IntegerData,		0, false },
 	{ "partitionGrid",		VTypes::IntegerData,		3, false },
 	{ "perspective"	,		VTypes::IntegerData,		0, false },
 	{ "perspectiveFOV",		VTypes::DoubleData,		0, false },
@@ -108,7 +110,9 @@ Accessor PreferencesVariable::accessorData[PreferencesVariable::nAccessors] = {
 	{ "reuseQuality",		VTypes::IntegerData,		0, false },
 	{ "selectionScale",		VTypes::DoubleData,		0, false },
 	{ "shininess",			VTypes::IntegerData,		0, false },
+	{ "singlePrecisionFrames",	VTypes::IntegerData,		0, false },
 	{ "specularColour",		VTypes::DoubleData,		4, false },
+	{ "spmeOrder",			VTypes::IntegerData,		0, false },
 	{ "spotlight",			VTypes::IntegerData,		0, false },
 	{ "spotlightAmbient",		VTypes::DoubleData,		4, false },
 	{ "spotlightDiffuse",		VTypes::DoubleData,		4, false },
@@ -117,8 +121,10 @@ Accessor PreferencesVariable::accessorData[PreferencesVariable::nAccessors] = {
 	{ "stickNormalWidth",		VTypes::DoubleData,		4, false },
 	{ "stickSelectedWidth",		VTypes::DoubleData,		4, false },
 	{ "tempDir",			VTypes::StringData,		0, false },
+	{ "trajectoryIndexFiles",	VTypes::IntegerData,		0, false },
 	{ "useWidgetForegroundBackground", VTypes::IntegerData,		0, false },
 	{ "vdwCutoff",			VTypes::DoubleData,		0, false },
+	{ "vdwTablePoints",		VTypes::IntegerData,		0, false },
 	{ "vibrationArrowColour",	VTypes::DoubleData,		4, false },
 	{ "viewerFontFilename",		VTypes::StringData,		0, false },
 	{ "viewLock",			VTypes::StringData,		0, false },
@@ -389,9 +395,15 @@ bool PreferencesVariable::retrieveAccessor(int i, ReturnValue& rv, bool hasArray
 		case (PreferencesVariable::MultiSampling):
 			rv.set( ptr->multiSampling() );
 			break;
+		case (PreferencesVariable::NeighbourSkin):
+			rv.set( ptr->neighbourSkin() );
+			break;
 		case (PreferencesVariable::NoQtSettings):
 			rv.set( ptr->loadQtSettings() );
 			break;
+		case (PreferencesVariable::NThreads):
+			rv.set( ptr->nThreads() );
+			break;
 		case (PreferencesVariable::PartitionGrid):
 			if (hasArrayIndex) rv.set( ptr->partitionGridSize()[arrayIndex-1] );
 			else rv.setArray(ptr->partitionGridSize());
@@ -417,10 +429,16 @@ bool PreferencesVariable::retrieveAccessor(int i, ReturnValue& rv, bool hasArray
 		case (PreferencesVariable::Shininess):
 			rv.set( (int) ptr->shininess() );
 			break;
+		case (PreferencesVariable::SinglePrecisionFrames):
+			rv.set( ptr->singlePrecisionFrames() );
+			break;
 		case (PreferencesVariable::SpecularColour):
 			if (hasArrayIndex) rv.set( ptr->colour(Prefs::SpecularColour)[arrayIndex-1] );
 			else rv.setArray( VTypes::DoubleData, ptr->colour(Prefs::SpecularColour), 4);
 			break;
+		case (PreferencesVariable::SpmeOrder):
+			rv.set( ptr->spmeOrder() );
+			break;
 		case (PreferencesVariable::Spotlight):
 			rv.set( ptr->spotlightActive() );
 			break;
@@ -449,12 +467,18 @@ bool PreferencesVariable::retrieveAccessor(int i, ReturnValue& rv, bool hasArray
 		case (PreferencesVariable::TempDir):
 			rv.set( ptr->tempDir().path() );
 			break;
+		case (PreferencesVariable::TrajectoryIndexFiles):
+			rv.set( ptr->trajectoryIndexFiles() );
+			break;
 		case (PreferencesVariable::UseWidgetForegroundBackground):
 			rv.set( ptr->useWidgetForegroundBackground() );
 			break;
 		case (PreferencesVariable::VdwCutoff):
 			rv.set( ptr->vdwCutoff() );
 			break;
+		case (PreferencesVariable::VdwTablePoints):
+			rv.set( ptr->vdwTablePoints() );
+			break;
 		case (PreferencesVariable::VibrationArrowColour):
 			if (hasArrayIndex) rv.set( ptr->colour(Prefs::VibrationArrowColour)[arrayIndex-1] );
 			else rv.setArray( VTypes::DoubleData, ptr->colour(Prefs::VibrationArrowColour), 4);
@@ -733,9 +757,15 @@ bool PreferencesVariable::setAccessor(int i, ReturnValue& sourcerv, ReturnValue&
 		case (PreferencesVariable::MultiSampling):
 			ptr->setMultiSampling( newValue.asBool() );
 			break;
+		case (PreferencesVariable::NeighbourSkin):
+			ptr->setNeighbourSkin( newValue.asDouble(result) );
+			break;
 		case (PreferencesVariable::NoQtSettings):
 			ptr->setLoadQtSettings( newValue.asBool() );
 			break;
+		case (PreferencesVariable::NThreads):
+			ptr->setNThreads( newValue.asInteger(result) );
+			break;
 		case (PreferencesVariable::PartitionGrid):
 			if (newValue.arraySize() == 3) for (n=0; n<3; ++n) ptr->setPartitionGridSize(n, newValue.asInteger(n, result));
 			else if (hasArrayIndex) ptr->setPartitionGridSize(arrayIndex-1, newValue.asInteger(result));
@@ -764,12 +794,18 @@ bool PreferencesVariable::setAccessor(int i, ReturnValue& sourcerv, ReturnValue&
 		case (PreferencesVariable::Shininess):
 			ptr->setShininess( newValue.asInteger(result) );
 			break;
+		case (PreferencesVariable::SinglePrecisionFrames):
+			ptr->setSinglePrecisionFrames( newValue.asBool() );
+			break;
 		case (PreferencesVariable::SpecularColour):
 			if (newValue.type() == VTypes::VectorData) for (n=0; n<3; ++n) ptr->setColour(Prefs::SpecularColour, n, newValue.asVector(result)[n]);
 			else if (newValue.arraySize() != -1) for (n=0; n<newValue.arraySize(); ++n) ptr->setColour(Prefs::SpecularColour, n, newValue.asDouble(n, result));
 			else if (hasArrayIndex) ptr->setColour(Prefs::SpecularColour, arrayIndex-1, newValue.asDouble(result));
 			else for (n=0; n<4; ++n) ptr->setColour(Prefs::SpecularColour, n, newValue.asDouble(result));
 			break;
+		case (PreferencesVariable::SpmeOrder):
+			ptr->setSpmeOrder( newValue.asInteger(result) );
+			break;
 		case (PreferencesVariable::Spotlight):
 			ptr->setSpotlightActive( newValue.asBool() );
 			break;
@@ -806,12 +842,18 @@ bool PreferencesVariable::setAccessor(int i, ReturnValue& sourcerv, ReturnValue&
 		case (PreferencesVariable::TempDir):
 			ptr->setTempDir( newValue.asString(result) );
 			break;
+		case (PreferencesVariable::TrajectoryIndexFiles):
+			ptr->setTrajectoryIndexFiles( newValue.asBool() );
+			break;
 		case (PreferencesVariable::UseWidgetForegroundBackground):
 			ptr->setUseWidgetForegroundBackground( newValue.asBool() );
 			break;
 		case (PreferencesVariable::VdwCutoff):
 			ptr->setVdwCutoff( newValue.asDouble(result) );
 			break;
+		case (PreferencesVariable::VdwTablePoints):
+			ptr->setVdwTablePoints( newValue.asInteger(result) );
+			break;
 		case (PreferencesVariable::VibrationArrowColour):
 			if (newValue.type() == VTypes::VectorData) for (n=0; n<3; ++n) ptr->setColour(Prefs::VibrationArrowColour, n, newValue.asVector(result)[n]);
 			else if (newValue.arraySize() != -1) for (n=0; n<newValue.arraySize(); ++n) ptr->setColour(Prefs::VibrationArrowColour, n, newValue.asDouble(n, result));
@@ -43,7 +43,7 @@ class PreferencesVariable : public Variable
 	 */
 	public:
 	// Accessor list
-	enum Accessors { AllowDialogs, AngleLabelFormat, AromaticRingColour, AtomStyleRadius, BackCull, BackgroundColour, BondStyleRadius, BondTolerance, CalculateIntra, CalculateVdw, ChargeLabelFormat, ClipFar, ClipNear, ColourScales, CorrectTransparentGrids, DashedAromatics, DefaultDrawStyle, DensityUnit, DepthCue, DepthFar, DepthNear, DistanceLabelFormat, DynamicPanels, ElecCutoff, ElecMethod, EnergyUnit, EwaldAlpha, EwaldKMax, EwaldPrecision, FontFileName, ForegroundColour, GlobeSize, GlyphDefaultColour, HBonds, HBondDotRadius, HDistance, ImageQuality, KeyAction, LabelSize, LabelDepthScaling, LineAliasing, MaxCuboids, MaxRings, MaxRingSize, MaxUndo, MessagesFontSize, MopacExe, MouseAction, MouseMoveFilter, MultiSampling, NoQtSettings, PartitionGrid, Perspective, PerspectiveFov, PolygonAliasing, Quality, ReuseQuality, SelectionScale, Shininess, SpecularColour, Spotlight, SpotlightAmbient, SpotlightDiffuse, SpotlightPosition, SpotlightSpecular, StickNormalWidth, StickSelectedWidth, TempDir, UseWidgetForegroundBackground, VdwCutoff, VibrationArrowColour, ViewerFontFileName, ViewLock, ViewRotationGlobe, ZoomThrottle, nAccessors };
+	enum Accessors { AllowDialogs, AngleLabelFormat, AromaticRingColour, AtomStyleRadius, BackCull, BackgroundColour, BondStyleRadius, BondTolerance, CalculateIntra, CalculateVdw, ChargeLabelFormat, ClipFar, ClipNear, ColourScales, CorrectTransparentGrids, DashedAromatics, DefaultDrawStyle, DensityUnit, DepthCue, DepthFar, DepthNear, DistanceLabelFormat, DynamicPanels, ElecCutoff, ElecMethod, EnergyUnit, EwaldAlpha, EwaldKMax, EwaldPrecision, FontFileName, ForegroundColour, GlobeSize, GlyphDefaultColour, HBonds, HBondDotRadius, HDistance, ImageQuality, KeyAction, LabelSize, LabelDepthScaling, LineAliasing, MaxCuboids, MaxRings, MaxRingSize, MaxUndo, MessagesFontSize, MopacExe, MouseAction, MouseMoveFilter, MultiSampling, NeighbourSkin, NoQtSettings, NThreads, PartitionGrid, Perspective, PerspectiveFov, PolygonAliasing, Quality, ReuseQuality, SelectionScale, Shininess, SinglePrecisionFrames, SpecularColour, SpmeOrder, Spotlight, SpotlightAmbient, SpotlightDiffuse, SpotlightPosition, SpotlightSpecular, StickNormalWidth, StickSelectedWidth, TempDir, TrajectoryIndexFiles, UseWidgetForegroundBackground, VdwCutoff, VdwTablePoints, VibrationArrowColour, ViewerFontFileName, ViewLock, ViewRotationGlobe, ZoomThrottle, nAccessors };
 	// Function list
 	enum Functions { DummyFunction, nFunctions };
 	// Search variable access list for provided accessor
@@ -32,17 +32,24 @@
 #include "base/fileparser.h"
 #include "base/namespace.h"
 #include "base/grid.h"
+#include "base/prefs.h"
 #include "ff/forcefield.h"
 #include "templates/reflist.h"
 #include <QStringList>
 #include <QtPlugin>
 #include <QFileInfo>
+#include <QFile>
+#include <QDataStream>
+#include <QDateTime>
 
 ATEN_BEGIN_NAMESPACE
 
 // Forward Declarations
 /* none */
 
+// Number of trajectory parts ahead of the current one to prefetch
+#define TRAJECTORYPREFETCHPARTS 4
+
 // File Plugin Standard Import Options
 class FilePluginStandardImportOptions
 {
@@ -246,6 +253,14 @@ class FilePluginInterface : public BasePluginInterface
 	// Create frame in parent model
 	Model* createFrame()
 	{
+		// The previously-created frame is now complete, so pack it into the parent model's frame store
+		RefListItem<Model,int>* lastFrame = createdFrames_.last();
+		if (lastFrame && parentModel()->packTrajectoryFrame(lastFrame->item))
+		{
+			if (targetModel_ == lastFrame->item) targetModel_ = parentModel_;
+			createdFrames_.remove(lastFrame);
+		}
+
 		Model* frame = parentModel()->addTrajectoryFrame();
 		createdFrames_.add(frame);
 		targetModel_ = frame;
@@ -361,10 +376,10 @@ class FilePluginInterface : public BasePluginInterface
 	FileParser fileParser_;
 
 	public:
-	// Open specified file for input
+	// Open specified file for input (mapping trajectory files into memory, since their frames are read and seeked repeatedly)
 	bool openInput(QString filename)
 	{
-		lineParser_.openInput(filename);
+		lineParser_.openInput(filename, category() == PluginTypes::TrajectoryFilePlugin);
 		if (!lineParser_.isFileGoodForReading())
 		{
 			Messenger::error("Couldn't open file '" + filename + "' for reading.");
@@ -372,10 +387,15 @@ class FilePluginInterface : public BasePluginInterface
 		}
 		return true;
 	}
+	// Return whether the plugin writes binary (unformatted) files
+	virtual bool writesBinary() const
+	{
+		return false;
+	}
 	// Open specified file for output
 	bool openOutput(QString filename)
 	{
-		lineParser_.openOutput(filename);
+		lineParser_.openOutput(filename, true, writesBinary());
 		if (!lineParser_.isFileGoodForWriting())
 		{
 			Messenger::error("Couldn't open file '" + filename + "' for writing.");
@@ -426,6 +446,105 @@ class FilePluginInterface : public BasePluginInterface
 	int nDataParts_;
 	// Whether the number of partial data present in the file is estimated
 	bool nDataPartsEstimated_;
+	// Return name of index file for the current input file
+	QString dataPartIndexFilename() const
+	{
+		return lineParser_.inputFilename() + ".atenidx";
+	}
+	// Read part offsets from index file, returning false if it doesn't exist or is out of date
+	bool readDataPartIndex()
+	{
+		QFile indexFile(dataPartIndexFilename());
+		if (!indexFile.open(QIODevice::ReadOnly)) return false;
+		QFileInfo fileInfo(lineParser_.inputFilename());
+		QDataStream stream(&indexFile);
+
+		// Check header against input file and plugin
+		QString magic, pluginNickname;
+		qint64 fileSize, fileModified, nOffsets;
+		stream >> magic >> fileSize >> fileModified >> pluginNickname >> nOffsets;
+		if ((stream.status() != QDataStream::Ok) || (magic != "ATENIDX1")) return false;
+		if ((fileSize != fileInfo.size()) || (fileModified != fileInfo.lastModified().toMSecsSinceEpoch())) return false;
+		if ((pluginNickname != nickname()) || (nOffsets < 2)) return false;
+
+		// Offsets must start with the two we already have
+		Array<std::streampos> offsets;
+		qint64 offset;
+		for (qint64 n=0; n<nOffsets; ++n)
+		{
+			stream >> offset;
+			offsets.add(std::streampos(offset));
+		}
+		if (stream.status() != QDataStream::Ok) return false;
+		if ((offsets.value(0) != dataPartOffsets_.value(0)) || (offsets.value(1) != dataPartOffsets_.value(1))) return false;
+
+		dataPartOffsets_ = offsets;
+		return true;
+	}
+	// Write part offsets to index file
+	bool writeDataPartIndex()
+	{
+		QFile indexFile(dataPartIndexFilename());
+		if (!indexFile.open(QIODevice::WriteOnly)) return false;
+		QFileInfo fileInfo(lineParser_.inputFilename());
+		QDataStream stream(&indexFile);
+
+		stream << QString("ATENIDX1") << qint64(fileInfo.size()) << qint64(fileInfo.lastModified().toMSecsSinceEpoch()) << nickname() << qint64(dataPartOffsets_.nItems());
+		for (int n=0; n<dataPartOffsets_.nItems(); ++n) stream << qint64(dataPartOffsets_.value(n));
+
+		// Don't leave an incomplete index behind
+		bool flushed = indexFile.flush();
+		indexFile.close();
+		if ((stream.status() != QDataStream::Ok) || (!flushed))
+		{
+			indexFile.remove();
+			return false;
+		}
+		return true;
+	}
+	// Build offsets for all parts in the file, starting from the last known offset, returning false if parts can't be skipped
+	bool indexDataParts()
+	{
+		// Try to reuse a previously-written index first (if index files are enabled)
+		if (prefs.trajectoryIndexFiles() && readDataPartIndex())
+		{
+			Messenger::print(Messenger::Verbose, "Read offsets of %i parts from index file '%s'.", dataPartOffsets_.nItems()-1, qPrintable(dataPartIndexFilename()));
+		}
+		else
+		{
+			// Skip through the whole file, storing the position of each part
+			lineParser_.seekg(dataPartOffsets_.last());
+			while (!lineParser_.eofOrBlank())
+			{
+				if (!skipNextPart()) break;
+				dataPartOffsets_.add(lineParser_.tellg());
+			}
+
+			// If we couldn't skip even a single part, the plugin probably doesn't support it
+			if ((dataPartOffsets_.nItems() == 2) && (!lineParser_.eofOrBlank()))
+			{
+				lineParser_.seekg(dataPartOffsets_.value(1));
+				return false;
+			}
+
+			if (prefs.trajectoryIndexFiles() && (!writeDataPartIndex())) Messenger::warn("Couldn't write index file '%s' - set 'aten.prefs.trajectoryIndexFiles = FALSE' to stop trying.", qPrintable(dataPartIndexFilename()));
+		}
+
+		// Final offset marks the end of the last part
+		nDataParts_ = dataPartOffsets_.nItems() - 1;
+		nDataPartsEstimated_ = false;
+		lineParser_.seekg(dataPartOffsets_.value(1));
+		Messenger::print("Indexed %i parts in file.", nDataParts_);
+		return true;
+	}
+	// Prefetch parts following the one specified
+	void prefetchDataParts(int partId)
+	{
+		int lastPart = partId + 1 + TRAJECTORYPREFETCHPARTS;
+		if (lastPart >= dataPartOffsets_.nItems()) lastPart = dataPartOffsets_.nItems() - 1;
+		if (lastPart <= partId+1) return;
+		lineParser_.prefetch(dataPartOffsets_.value(partId+1), dataPartOffsets_.value(lastPart));
+	}
 
 	public:
 	// Return whether this plugin is related to the specified file(name)
@@ -483,6 +602,9 @@ class FilePluginInterface : public BasePluginInterface
 	{
 		Messenger::print(Messenger::Verbose, "FilePluginInterface::importPart() - trying to import part %i from file.", partId);
 
+		// Make sure the file hasn't been truncated underneath a memory mapping of it
+		if (!lineParser_.checkMappedInput()) return false;
+
 		// First check (sanity) - are there any file positions stored in the array?
 		if (dataPartOffsets_.nItems() == 0)
 		{
@@ -504,8 +626,18 @@ class FilePluginInterface : public BasePluginInterface
 					// Add offset for the second datum
 					dataPartOffsets_.add(lineParser_.tellg());
 
-					// Estimate total number of parts if we have not already been told the number to expect
-					if (nDataParts_ == 0)
+					// Index all parts in the file unless we are caching everything - even if the number to expect has already been set (e.g. from
+					// a file header) the offsets are still needed, so the expected number is only used to cross-check the result
+					bool indexed = false;
+					if (!standardOptions_.isSetAndOn(FilePluginStandardImportOptions::CacheAllSwitch))
+					{
+						int nExpectedParts = nDataParts_;
+						indexed = indexDataParts();
+						if (indexed && (nExpectedParts > 0) && (nExpectedParts != nDataParts_)) Messenger::warn("Number of parts found in file (%i) differs from that expected (%i).", nDataParts_, nExpectedParts);
+					}
+
+					// Otherwise, estimate total number of parts
+					if ((nDataParts_ == 0) && (!indexed))
 					{
 						// First, get data size from difference between file positions for zeroth and first parts
 						long int partSize = dataPartOffsets_.last() - dataPartOffsets_.first();
@@ -522,6 +654,7 @@ class FilePluginInterface : public BasePluginInterface
 				}
 
 				Messenger::print(Messenger::Verbose, "FilePluginInterface::importPart() - result of initial part read was %i, nOffsets now %i.", result, dataPartOffsets_.nItems());
+				if (result) prefetchDataParts(0);
 
 				return result;
 			}
@@ -551,6 +684,9 @@ class FilePluginInterface : public BasePluginInterface
 				if (frame) frame->copyAtomStyle(parentModel_);
 			}
 
+			// Read in the following parts while this one is in use
+			if (result) prefetchDataParts(partId);
+
 			return result;
 		}
 
@@ -586,6 +722,7 @@ class FilePluginInterface : public BasePluginInterface
 		{
 			// Now at start of next data, so store the file position
 			dataPartOffsets_.add(lineParser_.tellg());
+			prefetchDataParts(partId);
 
 			// Copy style if requested
 			if (standardOptions_.isSetAndOn(FilePluginStandardImportOptions::InheritStyleSwitch))
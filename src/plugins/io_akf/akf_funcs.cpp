@@ -369,7 +369,7 @@ bool AKFModelPlugin::exportData()
 		{
 			for (x=0; x<g->nXYZ().x; ++x)
 				for (y=0; y<g->nXYZ().y; ++y)
-					for (z=0; z<g->nXYZ().z; ++z) if (!fileParser_.writeLineF("    %f", g->data3d()[x][y][z])) return false;
+					for (z=0; z<g->nXYZ().z; ++z) if (!fileParser_.writeLineF("    %f", g->value(x, y, z))) return false;
 		}
 		if (!fileParser_.writeLineF("endgrid")) return false;
 	}
@@ -0,0 +1,553 @@
+/*
+        *** Aten Binary Trajectory Plugin Functions
+        *** src/plugins/io_atb/atbtraj_funcs.cpp
+        Copyright T. Youngs 2016-2017
+
+        This file is part of Aten.
+
+        Aten is free software: you can redistribute it and/or modify
+        it under the terms of the GNU General Public License as published by
+        the Free Software Foundation, either version 3 of the License, or
+        (at your option) any later version.
+
+        Aten is distributed in the hope that it will be useful,
+        but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+        GNU General Public License for more details.
+
+        You should have received a copy of the GNU General Public License
+        along with Aten.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "plugins/io_atb/atbtraj.hui"
+#include "model/model.h"
+#include <math.h>
+
+// File identifier, written at the very start of the file
+#define ATBMAGIC "ATENTRJ1"
+#define ATBMAGICLENGTH 8
+
+// Constructor
+ATBTrajectoryPlugin::ATBTrajectoryPlugin()
+{
+	// Setup option keywords
+	pluginOptions_.add("precision", "0");
+	pluginOptions_.add("single", "false");
+	pluginOptions_.add("velocities", "false");
+	pluginOptions_.add("forces", "false");
+
+	nAtoms_ = 0;
+	flags_ = 0;
+	precision_ = 0.0;
+}
+
+// Destructor
+ATBTrajectoryPlugin::~ATBTrajectoryPlugin()
+{
+}
+
+/*
+ * Instance Handling
+ */
+
+// Return a copy of the plugin object
+BasePluginInterface* ATBTrajectoryPlugin::makeCopy() const
+{
+	return new ATBTrajectoryPlugin;
+}
+
+/*
+ * Aten Binary Trajectory Import / Export Plugin
+ */
+
+// Return type of plugin
+PluginTypes::PluginType ATBTrajectoryPlugin::type() const
+{
+	return PluginTypes::FilePlugin;
+}
+
+// Return category of plugin
+int ATBTrajectoryPlugin::category() const
+{
+	return PluginTypes::TrajectoryFilePlugin;
+}
+
+// Name of plugin
+QString ATBTrajectoryPlugin::name() const
+{
+	return QString("Aten Binary Trajectory Files");
+}
+
+// Nickname of plugin
+QString ATBTrajectoryPlugin::nickname() const
+{
+	return QString("atb");
+}
+
+// Return whether the plugin is enabled
+bool ATBTrajectoryPlugin::enabled() const
+{
+	return true;
+}
+
+// Description (long name) of plugin
+QString ATBTrajectoryPlugin::description() const
+{
+	return QString("Import/export for Aten's compact binary trajectory format");
+}
+
+// Related file extensions
+QStringList ATBTrajectoryPlugin::extensions() const
+{
+	return QStringList() << "atb";
+}
+
+// Exact names
+QStringList ATBTrajectoryPlugin::exactNames() const
+{
+	return QStringList();
+}
+
+// Return whether the plugin writes binary (unformatted) files
+bool ATBTrajectoryPlugin::writesBinary() const
+{
+	return true;
+}
+
+/*
+ * Input / Output
+ */
+
+// Return whether this plugin can import data
+bool ATBTrajectoryPlugin::canImport() const
+{
+	return true;
+}
+
+// Import data from the specified file
+bool ATBTrajectoryPlugin::importData()
+{
+	// Check file identifier
+	if (fileParser_.readChars(ATBMAGICLENGTH, false) != ATBMAGIC)
+	{
+		Messenger::error("File '%s' is not an Aten binary trajectory.", qPrintable(fileParser_.filename()));
+		return false;
+	}
+
+	// Read header - number of atoms, content flags, and coordinate precision
+	if (!fileParser_.readRawInteger(nAtoms_)) return false;
+	if (!fileParser_.readRawInteger(flags_)) return false;
+	if (!fileParser_.readRawDouble(precision_)) return false;
+	if ((nAtoms_ < 0) || ((flags_&ATBTrajectoryPlugin::CompressedFlag) && (precision_ <= 0.0)))
+	{
+		Messenger::error("Header of binary trajectory is corrupt.");
+		return false;
+	}
+
+	// Topology - elements and bonds
+	if (!fileParser_.readRawIntegerArray(elements_, nAtoms_)) return false;
+	int nBonds;
+	if (!fileParser_.readRawInteger(nBonds)) return false;
+	if (!fileParser_.readRawIntegerArray(bonds_, nBonds*3)) return false;
+
+	Messenger::print("Binary trajectory has %i atoms and %i bonds per frame (%s precision%s%s%s).", nAtoms_, nBonds, flags_&ATBTrajectoryPlugin::SinglePrecisionFlag ? "single" : "double", flags_&ATBTrajectoryPlugin::CompressedFlag ? ", compressed" : "", flags_&ATBTrajectoryPlugin::VelocitiesFlag ? ", velocities" : "", flags_&ATBTrajectoryPlugin::ForcesFlag ? ", forces" : "");
+
+	// Read the first trajectory frame.
+	// The model where we should put the frame data will have been set in the FileParser (in parentModel()).
+	// Calling FilePluginInterface::importPart(0) will set the file positions we need, and read in the first frame.
+	Model* frame = createFrame();
+	if (!importPart(0))
+	{
+		discardFrame(frame);
+		return false;
+	}
+
+	if (standardOptions_.isSetAndOn(FilePluginStandardImportOptions::CacheAllSwitch))
+	{
+		Messenger::print("Caching all frames from binary trajectory (%i %s)...", nDataParts(), isNPartialDataEstimated() ? "estimated" : "actual");
+		int count = 0;
+		bool frameResult;
+		do
+		{
+			// Add a new trajectory frame
+			Model* frame = createFrame();
+
+			// Attempt to read in the next data part in the file
+			frameResult = importPart(++count);
+			if (!frameResult) discardFrame(frame);
+
+		} while (frameResult && (!fileParser_.eofOrBlank()));
+
+		closeFiles();
+	}
+
+	return true;
+}
+
+// Return whether this plugin can export data
+bool ATBTrajectoryPlugin::canExport() const
+{
+	return true;
+}
+
+// Export data to the specified file
+bool ATBTrajectoryPlugin::exportData()
+{
+	// The parent model is the one whose trajectory we are to write - if it has no trajectory, write the model itself as a single frame
+	Model* source = parentModel();
+	bool hasTrajectory = source->hasTrajectory();
+	int nFrames = hasTrajectory ? source->nTrajectoryFrames() : 1;
+	int initialFrame = source->trajectoryFrameIndex();
+	if (hasTrajectory && (initialFrame != 0)) source->seekTrajectoryFrame(0, true);
+	Model* frame = hasTrajectory ? source->trajectoryCurrentFrame() : source;
+
+	// Set up content flags from options
+	precision_ = pluginOptions_.value("precision").toDouble();
+	flags_ = 0;
+	if (toBool(pluginOptions_.value("single"))) flags_ |= ATBTrajectoryPlugin::SinglePrecisionFlag;
+	if (toBool(pluginOptions_.value("velocities"))) flags_ |= ATBTrajectoryPlugin::VelocitiesFlag;
+	if (toBool(pluginOptions_.value("forces"))) flags_ |= ATBTrajectoryPlugin::ForcesFlag;
+	if (precision_ > 0.0) flags_ |= ATBTrajectoryPlugin::CompressedFlag;
+
+	// Topology is taken from the first frame
+	nAtoms_ = frame->nAtoms();
+	elements_.createEmpty(nAtoms_);
+	int n = 0;
+	for (Atom* i = frame->atoms(); i != NULL; i = i->next) elements_[n++] = i->element();
+	bonds_.forgetData();
+	for (Bond* b = frame->bonds(); b != NULL; b = b->next)
+	{
+		bonds_.add(b->atomI()->id());
+		bonds_.add(b->atomJ()->id());
+		bonds_.add(b->type());
+	}
+
+	// Write header
+	if (!fileParser_.writeRawChars(ATBMAGIC, ATBMAGICLENGTH)) return false;
+	if (!fileParser_.writeRawInteger(nAtoms_)) return false;
+	if (!fileParser_.writeRawInteger(flags_)) return false;
+	if (!fileParser_.writeRawDouble(precision_)) return false;
+	if (!fileParser_.writeRawIntegerArray(elements_.array(), nAtoms_)) return false;
+	if (!fileParser_.writeRawInteger(bonds_.nItems()/3)) return false;
+	if (!fileParser_.writeRawIntegerArray(bonds_.array(), bonds_.nItems())) return false;
+
+	// Write frames
+	bool result = true;
+	Task* task = Messenger::initialiseTask("Writing binary trajectory...", nFrames);
+	for (n = 0; n < nFrames; ++n)
+	{
+		if (hasTrajectory && (n != source->trajectoryFrameIndex()))
+		{
+			source->seekTrajectoryFrame(n, true);
+			frame = source->trajectoryCurrentFrame();
+		}
+
+		// An empty frame means the (estimated) number of frames was too high
+		if ((n > 0) && (frame->nAtoms() == 0)) break;
+		if (frame->nAtoms() != nAtoms_)
+		{
+			Messenger::error("Frame %i contains %i atoms, but the first frame contains %i.", n+1, frame->nAtoms(), nAtoms_);
+			result = false;
+			break;
+		}
+
+		if (!writeFrame(frame))
+		{
+			result = false;
+			break;
+		}
+
+		if (!Messenger::incrementTaskProgress(task)) break;
+	}
+	Messenger::terminateTask(task);
+
+	// Return to the original frame
+	if (hasTrajectory && (source->trajectoryFrameIndex() != initialFrame)) source->seekTrajectoryFrame(initialFrame, true);
+
+	if (result) Messenger::print("Wrote %i frames to binary trajectory.", n);
+
+	return result;
+}
+
+// Import next partial data chunk
+bool ATBTrajectoryPlugin::importNextPart()
+{
+	Model* frame = targetModel();
+
+	// Frame size, cell, and name
+	int frameBytes, hasCell, nameLength;
+	double axes[9];
+	if (!fileParser_.readRawInteger(frameBytes)) return false;
+	if (!fileParser_.readRawInteger(hasCell)) return false;
+	if (!fileParser_.readRawDoubleArray(axes, 9)) return false;
+	if (!fileParser_.readRawInteger(nameLength)) return false;
+	if ((nameLength < 0) || (nameLength > MAXLINELENGTH))
+	{
+		Messenger::error("Error reading frame name from binary trajectory.");
+		return false;
+	}
+	if (nameLength > 0) frame->setName(fileParser_.readChars(nameLength, false));
+
+	// Coordinates
+	if (flags_&ATBTrajectoryPlugin::CompressedFlag)
+	{
+		int minimum[3], nBits[3], nWords;
+		if (!fileParser_.readRawIntegerArray(packed_, 7)) return false;
+		for (int n=0; n<3; ++n)
+		{
+			minimum[n] = packed_[n];
+			nBits[n] = packed_[n+3];
+		}
+		nWords = packed_[6];
+		if (!fileParser_.readRawIntegerArray(packed_, nWords)) return false;
+		if (!unpackCoordinates(minimum, nBits, nWords)) return false;
+	}
+	else if (!readValues(r_)) return false;
+
+	// Velocities and forces
+	if ((flags_&ATBTrajectoryPlugin::VelocitiesFlag) && (!readValues(v_))) return false;
+	if ((flags_&ATBTrajectoryPlugin::ForcesFlag) && (!readValues(f_))) return false;
+
+	// Create atoms
+	Vec3<double> v, f;
+	for (int n=0; n<nAtoms_; ++n)
+	{
+		if (flags_&ATBTrajectoryPlugin::VelocitiesFlag) v.set(v_[n*3], v_[n*3+1], v_[n*3+2]);
+		if (flags_&ATBTrajectoryPlugin::ForcesFlag) f.set(f_[n*3], f_[n*3+1], f_[n*3+2]);
+		frame->addAtom(elements_[n], Vec3<double>(r_[n*3], r_[n*3+1], r_[n*3+2]), v, f);
+	}
+
+	// Set cell
+	if (hasCell)
+	{
+		Matrix mat;
+		mat.setColumn(0, axes[0], axes[1], axes[2]);
+		mat.setColumn(1, axes[3], axes[4], axes[5]);
+		mat.setColumn(2, axes[6], axes[7], axes[8]);
+		frame->setCell(mat);
+	}
+
+	// Recreate bonds from stored topology, or calculate them if there were none
+	if (bonds_.nItems() > 0)
+	{
+		Atom** atoms = frame->atomArray();
+		for (int n=0; n<bonds_.nItems(); n += 3)
+		{
+			if ((bonds_[n] < 0) || (bonds_[n] >= nAtoms_) || (bonds_[n+1] < 0) || (bonds_[n+1] >= nAtoms_)) continue;
+			frame->bondAtoms(atoms[bonds_[n]], atoms[bonds_[n+1]], (Bond::BondType) bonds_[n+2]);
+		}
+	}
+	else if (!standardOptions_.isSetAndOn(FilePluginStandardImportOptions::PreventRebondingSwitch)) frame->calculateBonding(true);
+
+	return true;
+}
+
+// Skip next partial data chunk
+bool ATBTrajectoryPlugin::skipNextPart()
+{
+	int frameBytes;
+	if (!fileParser_.readRawInteger(frameBytes)) return false;
+	fileParser_.seekg(frameBytes, std::ios::cur);
+	return (fileParser_.tellg() >= 0);
+}
+
+/*
+ * Options
+ */
+
+// Return whether the plugin has import options
+bool ATBTrajectoryPlugin::hasImportOptions() const
+{
+	return false;
+}
+
+// Show import options dialog
+bool ATBTrajectoryPlugin::showImportOptionsDialog(KVMap& targetOptions) const
+{
+	return false;
+}
+
+// Return whether the plugin has export options
+bool ATBTrajectoryPlugin::hasExportOptions() const
+{
+	return false;
+}
+
+// Show export options dialog
+bool ATBTrajectoryPlugin::showExportOptionsDialog(KVMap& targetOptions) const
+{
+	return false;
+}
+
+/*
+ * Format
+ */
+
+// Read array of values stored at file precision
+bool ATBTrajectoryPlugin::readValues(Array<double>& values)
+{
+	if (flags_&ATBTrajectoryPlugin::SinglePrecisionFlag)
+	{
+		singleValues_.createEmpty(nAtoms_*3);
+		if (!fileParser_.readRawFloatArray(singleValues_.array(), nAtoms_*3)) return false;
+		values.createEmpty(nAtoms_*3);
+		for (int n=0; n<nAtoms_*3; ++n) values[n] = singleValues_[n];
+		return true;
+	}
+
+	return fileParser_.readRawDoubleArray(values, nAtoms_*3);
+}
+
+// Write array of values at file precision
+bool ATBTrajectoryPlugin::writeValues(Array<double>& values)
+{
+	if (flags_&ATBTrajectoryPlugin::SinglePrecisionFlag)
+	{
+		singleValues_.createEmpty(nAtoms_*3);
+		for (int n=0; n<nAtoms_*3; ++n) singleValues_[n] = (float) values[n];
+		return fileParser_.writeRawFloatArray(singleValues_.array(), nAtoms_*3);
+	}
+
+	return fileParser_.writeRawDoubleArray(values.array(), nAtoms_*3);
+}
+
+// Quantise and pack r_ into packed_, returning the number of words used (or -1 if coordinates are out of range)
+int ATBTrajectoryPlugin::packCoordinates(int* minimum, int* nBits)
+{
+	// Quantise coordinates, storing them in packed_ for now, and determine the range in each direction
+	int maximum[3];
+	double q;
+	packed_.createEmpty(nAtoms_*3);
+	for (int n=0; n<nAtoms_*3; ++n)
+	{
+		q = floor(r_[n]*precision_ + 0.5);
+		if (fabs(q) > 1.0e9) return -1;
+		packed_[n] = (int) q;
+		if ((n < 3) || (packed_[n] < minimum[n%3])) minimum[n%3] = packed_[n];
+		if ((n < 3) || (packed_[n] > maximum[n%3])) maximum[n%3] = packed_[n];
+	}
+	for (int n=0; n<3; ++n)
+	{
+		nBits[n] = 0;
+		if (nAtoms_ == 0) minimum[n] = 0;
+		else while ((1LL << nBits[n]) <= ((long long) maximum[n] - minimum[n])) ++nBits[n];
+	}
+
+	// Pack offsets from the minimum into as few bits as possible, overwriting the quantised values as we go (we never write ahead of what we have read)
+	unsigned long long buffer = 0;
+	int nBuffered = 0, nWords = 0;
+	for (int n=0; n<nAtoms_*3; ++n)
+	{
+		buffer |= ((unsigned long long) (packed_[n] - minimum[n%3])) << nBuffered;
+		nBuffered += nBits[n%3];
+		while (nBuffered >= 32)
+		{
+			packed_[nWords++] = (int) (unsigned int) (buffer & 0xffffffffULL);
+			buffer >>= 32;
+			nBuffered -= 32;
+		}
+	}
+	if (nBuffered > 0) packed_[nWords++] = (int) (unsigned int) (buffer & 0xffffffffULL);
+
+	return nWords;
+}
+
+// Unpack coordinates in packed_ into r_
+bool ATBTrajectoryPlugin::unpackCoordinates(const int* minimum, const int* nBits, int nWords)
+{
+	unsigned long long buffer = 0, mask;
+	int nBuffered = 0, word = 0, b;
+	r_.createEmpty(nAtoms_*3);
+	for (int n=0; n<nAtoms_*3; ++n)
+	{
+		b = nBits[n%3];
+		if ((b < 0) || (b > 32)) return false;
+		while (nBuffered < b)
+		{
+			if (word == nWords)
+			{
+				Messenger::error("Compressed coordinates in binary trajectory are corrupt.");
+				return false;
+			}
+			buffer |= ((unsigned long long) (unsigned int) packed_[word++]) << nBuffered;
+			nBuffered += 32;
+		}
+		mask = (b == 0 ? 0ULL : (~0ULL) >> (64 - b));
+		r_[n] = (minimum[n%3] + (long long) (buffer & mask)) / precision_;
+		buffer >>= b;
+		nBuffered -= b;
+	}
+
+	return true;
+}
+
+// Write single frame to file
+bool ATBTrajectoryPlugin::writeFrame(Model* frame)
+{
+	// Gather coordinates, velocities, and forces
+	r_.createEmpty(nAtoms_*3);
+	v_.createEmpty(nAtoms_*3);
+	f_.createEmpty(nAtoms_*3);
+	int n = 0;
+	for (Atom* i = frame->atoms(); i != NULL; i = i->next)
+	{
+		for (int m=0; m<3; ++m)
+		{
+			r_[n+m] = i->r()[m];
+			v_[n+m] = i->v()[m];
+			f_[n+m] = i->f()[m];
+		}
+		n += 3;
+	}
+
+	// Pack coordinates if requested
+	int minimum[3], nBits[3], nWords = 0;
+	if (flags_&ATBTrajectoryPlugin::CompressedFlag)
+	{
+		nWords = packCoordinates(minimum, nBits);
+		if (nWords == -1)
+		{
+			Messenger::error("Coordinates are too large to be stored at the requested precision (%f).", precision_);
+			return false;
+		}
+	}
+
+	// Cell and name
+	int hasCell = frame->isPeriodic() ? 1 : 0;
+	double axes[9];
+	Matrix mat = frame->cell().axes();
+	for (n=0; n<3; ++n)
+	{
+		Vec3<double> column = mat.columnAsVec3(n);
+		axes[n*3] = column.x;
+		axes[n*3+1] = column.y;
+		axes[n*3+2] = column.z;
+	}
+	QByteArray name = frame->name().toLatin1().left(MAXLINELENGTH);
+
+	// Determine size of frame data following the size itself, so that frames can be skipped without reading them
+	int realSize = (flags_&ATBTrajectoryPlugin::SinglePrecisionFlag ? sizeof(float) : sizeof(double));
+	int frameBytes = 2*sizeof(int) + 9*sizeof(double) + name.size();
+	if (flags_&ATBTrajectoryPlugin::CompressedFlag) frameBytes += (7 + nWords)*sizeof(int);
+	else frameBytes += nAtoms_*3*realSize;
+	if (flags_&ATBTrajectoryPlugin::VelocitiesFlag) frameBytes += nAtoms_*3*realSize;
+	if (flags_&ATBTrajectoryPlugin::ForcesFlag) frameBytes += nAtoms_*3*realSize;
+
+	// Write frame
+	if (!fileParser_.writeRawInteger(frameBytes)) return false;
+	if (!fileParser_.writeRawInteger(hasCell)) return false;
+	if (!fileParser_.writeRawDoubleArray(axes, 9)) return false;
+	if (!fileParser_.writeRawInteger(name.size())) return false;
+	if (!fileParser_.writeRawChars(name.constData(), name.size())) return false;
+	if (flags_&ATBTrajectoryPlugin::CompressedFlag)
+	{
+		int header[7] = { minimum[0], minimum[1], minimum[2], nBits[0], nBits[1], nBits[2], nWords };
+		if (!fileParser_.writeRawIntegerArray(header, 7)) return false;
+		if (!fileParser_.writeRawIntegerArray(packed_.array(), nWords)) return false;
+	}
+	else if (!writeValues(r_)) return false;
+	if ((flags_&ATBTrajectoryPlugin::VelocitiesFlag) && (!writeValues(v_))) return false;
+	if ((flags_&ATBTrajectoryPlugin::ForcesFlag) && (!writeValues(f_))) return false;
+
+	return true;
+}
@@ -101,27 +101,27 @@ bool DLPOLYPluginCommon::readCONFIGModel ( FilePluginInterface* plugin, FilePars
 
   int n=0;
   do {
-    if ( !parser.parseLine() ) {
+    if ( !parser.parseLineFast() ) {
       break;
     }
-    QString el = parser.argc ( 0 );
-    if ( !parser.parseLine() ) {
+    QString el = parser.fastArgc ( 0 );
+    if ( !parser.parseLineFast() ) {
       break;
     }
     // Create the new atom
-    Vec3<double> r = parser.arg3d ( 0 );
+    Vec3<double> r = parser.fastArg3d ( 0 );
     Vec3<double> v,f;
     if ( levcfg > 0 ) {
-      if ( !parser.parseLine() ) {
+      if ( !parser.parseLineFast() ) {
         break;
       }
-      v=parser.arg3d ( 0 );
+      v=parser.fastArg3d ( 0 );
     }
     if ( levcfg > 1 ) {
-      if ( !parser.parseLine() ) {
+      if ( !parser.parseLineFast() ) {
         break;
       }
-      f=parser.arg3d ( 0 );
+      f=parser.fastArg3d ( 0 );
     }
 
     plugin->createAtom ( targetModel, el, r, v, f );
@@ -615,15 +615,15 @@ bool DLPOLYPluginCommon::readDEFECTSModel ( FilePluginInterface* plugin, FilePar
       int readInter=BasePluginInterface::toBool(plugin->pluginOptions().value("interstitial"));  
       if (readInter){
         do {
-          if ( !parser.parseLine() ) {
+          if ( !parser.parseLineFast() ) {
             break;
           }
-          QString el = parser.argc ( 0 );
-          if ( !parser.parseLine() ) {
+          QString el = parser.fastArgc ( 0 );
+          if ( !parser.parseLineFast() ) {
             break;
           }
           // Create the new atom
-          Vec3<double> r = parser.arg3d ( 0 );
+          Vec3<double> r = parser.fastArg3d ( 0 );
           plugin->createAtom ( targetModel, el, r);
           n++;
           if (n==nInter) break;
@@ -638,15 +638,15 @@ bool DLPOLYPluginCommon::readDEFECTSModel ( FilePluginInterface* plugin, FilePar
       int readVac=BasePluginInterface::toBool(plugin->pluginOptions().value("vacancy"));  
       if (readVac){
         do {
-          if ( !parser.parseLine() ) {
+          if ( !parser.parseLineFast() ) {
             break;
           }
-          QString el = parser.argc ( 0 );
-          if ( !parser.parseLine() ) {
+          QString el = parser.fastArgc ( 0 );
+          if ( !parser.parseLineFast() ) {
             break;
           }
           // Create the new atom
-          Vec3<double> r = parser.arg3d ( 0 );
+          Vec3<double> r = parser.fastArg3d ( 0 );
           plugin->createAtom ( targetModel, el, r);
           n++;
           if (n==nVac+nInter) break;
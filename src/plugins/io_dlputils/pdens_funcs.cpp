@@ -21,6 +21,8 @@
 
 #include "plugins/io_dlputils/pdens.hui"
 #include "model/model.h"
+#include <QFile>
+#include <string.h>
 
 // Constructor
 PDensGridPlugin::PDensGridPlugin()
@@ -111,6 +113,37 @@ bool PDensGridPlugin::importData()
 	Grid* grid = createGrid(targetModel());
 	grid->setName(fileParser_.filename());
 
+	// Binary files begin with the tag 'PDENSBIN', then four 32-bit integers (the number of gridpoints along x, y, and z,
+	// and the size of each value in bytes), nine doubles for the axis system, three for the origin, and finally the values
+	// themselves, ordered with z varying fastest. The values are mapped straight into the grid rather than being read.
+	QFile file(fileParser_.filename());
+	char tag[8];
+	if (file.open(QIODevice::ReadOnly) && (file.read(tag, 8) == 8) && (strncmp(tag, "PDENSBIN", 8) == 0))
+	{
+		qint32 header[4];
+		double vectors[12];
+		if ((file.read((char*) header, sizeof(header)) != sizeof(header)) || (file.read((char*) vectors, sizeof(vectors)) != sizeof(vectors)))
+		{
+			Messenger::error("Failed to read header from binary pdens file.\n");
+			return false;
+		}
+		if ((header[3] != sizeof(float)) && (header[3] != sizeof(double)))
+		{
+			Messenger::error("Binary pdens file contains values of unrecognised size (%i bytes).\n", header[3]);
+			return false;
+		}
+		Messenger::print("GridXYZ from file = %i %i %i\n", header[0], header[1], header[2]);
+		if (!grid->initialiseMapped(Vec3<int>(header[0], header[1], header[2]), fileParser_.filename(), file.pos(), header[3] == sizeof(float) ? Grid::FloatStorage : Grid::DoubleStorage)) return false;
+		Matrix axes;
+		axes.setColumn(0, Vec3<double>(vectors[0], vectors[1], vectors[2]), 0.0);
+		axes.setColumn(1, Vec3<double>(vectors[3], vectors[4], vectors[5]), 0.0);
+		axes.setColumn(2, Vec3<double>(vectors[6], vectors[7], vectors[8]), 0.0);
+		grid->setAxes(axes);
+		grid->setOrigin(Vec3<double>(vectors[9], vectors[10], vectors[11]));
+		return true;
+	}
+	file.close();
+
 	// First line contains number of gridpoints in each direction x,y,z
 	if (!fileParser_.parseLine(Parser::SkipBlanks)) return false;
 	Messenger::print("GridXYZ from file = %i %i %i\n", fileParser_.argi(0), fileParser_.argi(1), fileParser_.argi(2));
@@ -50,10 +50,10 @@ bool XYZFilePluginCommon::readXYZModel(FilePluginInterface* plugin, FileParser&
 	// Load atoms for model
 	for (n=0; n<nAtoms; ++n)
 	{
-		if (!parser.parseLine()) break;
+		if (!parser.parseLineFast()) break;
 		
 		// Create the new atom
-		plugin->createAtom(targetModel, parser.argc(0), parser.arg3d(1));
+		plugin->createAtom(targetModel, parser.fastArgc(0), parser.fastArg3d(1));
 	}
 	
 	// Rebond the model
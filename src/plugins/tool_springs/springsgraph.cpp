@@ -0,0 +1,390 @@
+/*
+        *** SPRings Graph
+        *** src/plugins/tool_springs/springsgraph.cpp
+        Copyright T. Youngs 2016-2017
+
+        This file is part of Aten.
+
+        Aten is free software: you can redistribute it and/or modify
+        it under the terms of the GNU General Public License as published by
+        the Free Software Foundation, either version 3 of the License, or
+        (at your option) any later version.
+
+        Aten is distributed in the hope that it will be useful,
+        but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+        GNU General Public License for more details.
+
+        You should have received a copy of the GNU General Public License
+        along with Aten.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "plugins/tool_springs/springsgraph.h"
+#include "model/model.h"
+#include "base/threadpool.h"
+#include <math.h>
+
+ATEN_USING_NAMESPACE
+
+/*
+ * SPRings Search Workspace
+ */
+
+// Initialise workspace for the specified number of vertices
+void SPRingsSearch::initialise(int nVertices)
+{
+	stamp.createEmpty(nVertices, -1);
+	currentStamp = -1;
+	lastImage.createEmpty(nVertices, -1);
+	reset();
+	paths.clear();
+	otherPaths.clear();
+	path.clear();
+	ring.clear();
+}
+
+// Clear nodes reached, ready for a new search
+void SPRingsSearch::reset()
+{
+	++currentStamp;
+	nodeVertex.forgetData();
+	nodeShift.forgetData();
+	nodeDistance.forgetData();
+	otherImage.forgetData();
+}
+
+// Add node for the specified image of a vertex, returning its index
+int SPRingsSearch::addNode(int vertex, const Vec3<int>& shift, int distance)
+{
+	int index = nodeVertex.nItems();
+	nodeVertex.add(vertex);
+	nodeShift.add(shift);
+	nodeDistance.add(distance);
+	otherImage.add(stamp[vertex] == currentStamp ? lastImage[vertex] : -1);
+	stamp[vertex] = currentStamp;
+	lastImage[vertex] = index;
+	return index;
+}
+
+// Return node for the specified image of a vertex reached by the current search (or -1 if it was not reached)
+int SPRingsSearch::node(int vertex, const Vec3<int>& shift) const
+{
+	if (stamp.value(vertex) != currentStamp) return -1;
+	for (int n = lastImage.value(vertex); n != -1; n = otherImage.value(n))
+	{
+		const Vec3<int>& nodeImage = nodeShift.value(n);
+		if ((nodeImage.x == shift.x) && (nodeImage.y == shift.y) && (nodeImage.z == shift.z)) return n;
+	}
+	return -1;
+}
+
+/*
+ * SPRings Graph
+ */
+
+// Constructor
+SPRingsGraph::SPRingsGraph()
+{
+	// Private variables
+	nVertices_ = 0;
+	maxRingSize_ = 0;
+	debug_ = false;
+}
+
+/*
+ * Graph
+ */
+
+// Construct graph from atoms of the specified element, optionally adding edges between those bridged by a link element
+void SPRingsGraph::create(Model* sourceModel, int element, bool links, int linkElement)
+{
+	Messenger::enter("SPRingsGraph::create");
+
+	// Assign vertex indices to atoms of the element of interest
+	Array<int> vertexIndex;
+	vertexIndex.createEmpty(sourceModel->nAtoms(), -1);
+	atomIds_.clear();
+	Atom** atoms = sourceModel->atomArray();
+	int n, m, vi, vj;
+	for (n=0; n<sourceModel->nAtoms(); ++n)
+	{
+		if (atoms[n]->element() != element) continue;
+		vertexIndex[n] = atomIds_.nItems();
+		atomIds_.add(n);
+	}
+	nVertices_ = atomIds_.nItems();
+
+	// Periodic image shifts are determined from the fractional separation of each pair of bound atoms
+	UnitCell& cell = sourceModel->cell();
+	bool periodic = (cell.type() != UnitCell::NoCell);
+	Vec3<double> frac;
+	Vec3<int> shift, bondShift;
+
+	// Construct edges for each vertex in turn, from direct bonds and (if requested) bridges through link atoms
+	offsets_.createEmpty(nVertices_+1, 0);
+	neighbours_.clear();
+	shifts_.clear();
+	Array<int> candidates;
+	Array< Vec3<int> > candidateShifts;
+	for (vi=0; vi<nVertices_; ++vi)
+	{
+		offsets_[vi] = neighbours_.nItems();
+		Atom* i = atoms[atomIds_[vi]];
+		candidates.forgetData();
+		candidateShifts.forgetData();
+		for (RefListItem<Bond,int>* ri = i->bonds(); ri != NULL; ri = ri->next)
+		{
+			Atom* j = ri->item->partner(i);
+			bondShift.zero();
+			if (periodic)
+			{
+				frac = cell.realToFrac(j->r() - i->r());
+				bondShift.set(-int(floor(frac.x+0.5)), -int(floor(frac.y+0.5)), -int(floor(frac.z+0.5)));
+			}
+			if (vertexIndex[j->id()] != -1)
+			{
+				candidates.add(vertexIndex[j->id()]);
+				candidateShifts.add(bondShift);
+			}
+			else if (links && (j->element() == linkElement))
+			{
+				for (RefListItem<Bond,int>* rj = j->bonds(); rj != NULL; rj = rj->next)
+				{
+					Atom* k = rj->item->partner(j);
+					if ((k == i) || (vertexIndex[k->id()] == -1)) continue;
+					shift = bondShift;
+					if (periodic)
+					{
+						frac = cell.realToFrac(k->r() - j->r());
+						shift.x -= int(floor(frac.x+0.5));
+						shift.y -= int(floor(frac.y+0.5));
+						shift.z -= int(floor(frac.z+0.5));
+					}
+					candidates.add(vertexIndex[k->id()]);
+					candidateShifts.add(shift);
+				}
+			}
+		}
+
+		// Add unique edges (the same pair may be both bound and bridged, or bridged more than once)
+		for (n=0; n<candidates.nItems(); ++n)
+		{
+			vj = candidates[n];
+			shift = candidateShifts[n];
+			// A vertex may be bridged to one of its own images in a small cell, but not to itself
+			if ((vj == vi) && (shift.x == 0) && (shift.y == 0) && (shift.z == 0)) continue;
+			for (m=offsets_[vi]; m<neighbours_.nItems(); ++m) if ((neighbours_[m] == vj) && (shifts_[m].x == shift.x) && (shifts_[m].y == shift.y) && (shifts_[m].z == shift.z)) break;
+			if (m < neighbours_.nItems()) continue;
+			neighbours_.add(vj);
+			shifts_.add(shift);
+		}
+	}
+	offsets_[nVertices_] = neighbours_.nItems();
+
+	Messenger::print(Messenger::Verbose, "SPRings graph contains %i vertices and %i edges.", nVertices_, neighbours_.nItems()/2);
+
+	Messenger::exit("SPRingsGraph::create");
+}
+
+// Return number of vertices in the graph
+int SPRingsGraph::nVertices() const
+{
+	return nVertices_;
+}
+
+// Return number of (directed) edges in the graph
+int SPRingsGraph::nEdges() const
+{
+	return neighbours_.nItems();
+}
+
+/*
+ * Shortest-Path Rings
+ */
+
+// Breadth-first search outwards from the specified vertex, up to the maximum distance given
+void SPRingsGraph::search(SPRingsSearch& ws, int source, int maxDepth) const
+{
+	int n = 0, u, e, d;
+	Vec3<int> shift;
+	ws.reset();
+	ws.addNode(source, Vec3<int>(0,0,0), 0);
+
+	// The list of reached nodes doubles as the search queue
+	while (n < ws.nodeVertex.nItems())
+	{
+		u = ws.nodeVertex[n];
+		d = ws.nodeDistance[n];
+		shift = ws.nodeShift[n];
+		++n;
+		if (d == maxDepth) continue;
+		for (e=offsets_.value(u); e<offsets_.value(u+1); ++e)
+		{
+			if (ws.node(neighbours_.value(e), shift + shifts_.value(e)) != -1) continue;
+			ws.addNode(neighbours_.value(e), shift + shifts_.value(e), d + 1);
+		}
+	}
+}
+
+// Extend path backwards from the specified node towards the source, storing any completed paths
+void SPRingsGraph::extendPath(SPRingsSearch& ws, int source, int node, int depth, Array<int>& paths) const
+{
+	ws.path[depth] = node;
+	if (depth == 0)
+	{
+		for (int n=0; n<ws.path.nItems(); ++n) paths.add(ws.path[n]);
+		return;
+	}
+
+	// Step to any neighbouring node one closer to the source, as long as its vertex is the source or lies after it
+	int e, u, previous, vertex = ws.nodeVertex[node];
+	Vec3<int> shift = ws.nodeShift[node];
+	for (e=offsets_.value(vertex); e<offsets_.value(vertex+1); ++e)
+	{
+		u = neighbours_.value(e);
+		if (u < source) continue;
+		previous = ws.node(u, shift + shifts_.value(e));
+		if ((previous == -1) || (ws.nodeDistance[previous] != depth-1)) continue;
+		extendPath(ws, source, previous, depth-1, paths);
+	}
+}
+
+// Find all shortest paths from the source to the target node, which use only vertices after the source
+void SPRingsGraph::findPaths(SPRingsSearch& ws, int source, int target, Array<int>& paths) const
+{
+	paths.forgetData();
+	ws.path.createEmpty(ws.nodeDistance[target]+1, -1);
+	extendPath(ws, source, target, ws.nodeDistance[target], paths);
+}
+
+// Return whether the second node of the ring was reached by the check search made from the first
+bool SPRingsGraph::reached(const SPRingsSearch& ws, const SPRingsSearch& check, int from, int to) const
+{
+	// The check search starts from the image of the vertex in the original cell, so shift the target node by the same amount
+	return (check.node(ws.nodeVertex.value(to), ws.nodeShift.value(to) - ws.nodeShift.value(from)) != -1);
+}
+
+// Test candidate ring formed from the two paths specified, adding it to the counts if it is a shortest-path ring
+void SPRingsGraph::testRing(SPRingsSearch& ws, SPRingsSearch& check, const int* path1, const int* path2, int pathLength, bool odd, double* counts) const
+{
+	int n, m;
+
+	// Paths must not share any nodes other than the source (and, for even rings, the target at which they meet)
+	int last = (odd ? pathLength : pathLength-1);
+	for (n=1; n<=last; ++n)
+		for (m=1; m<=last; ++m) if (path1[n] == path2[m]) return;
+
+	// Construct ring - outwards along the first path, and back along the second
+	ws.ring.forgetData();
+	for (n=0; n<=pathLength; ++n) ws.ring.add(path1[n]);
+	for (n=last; n>0; --n) ws.ring.add(path2[n]);
+
+	/*
+	 * The ring is a shortest-path ring if no pair of antipodes is connected by a path shorter than the ring diameter (section VI.C).
+	 * Distances from the source are already known to be correct, since the ring was constructed from shortest paths, so
+	 * search outwards from each of the other atoms in the first half of the ring to a depth of one less than the diameter,
+	 * and check that the antipode(s) are not reached.
+	 */
+	int ringSize = ws.ring.nItems(), diameter = ringSize / 2, scope = diameter + (odd ? 1 : 0);
+	for (n=1; n<scope; ++n)
+	{
+		search(check, ws.nodeVertex[ws.ring[n]], diameter-1);
+		if (reached(ws, check, ws.ring[n], ws.ring[(n+diameter)%ringSize])) return;
+		if (odd && reached(ws, check, ws.ring[n], ws.ring[(n+1+diameter)%ringSize])) return;
+	}
+
+	// In a small cell the ring may pass through several images of the source, and will then be found (translated) from each
+	int nImages = 0;
+	for (n=0; n<ringSize; ++n) if (ws.nodeVertex[ws.ring[n]] == ws.nodeVertex[ws.ring[0]]) ++nImages;
+	counts[ringSize-1] += 1.0 / nImages;
+
+	if (debug_)
+	{
+		QString ringAtomInfo;
+		for (n=0; n<ringSize; ++n)
+		{
+			if (n > 0) ringAtomInfo += "-";
+			ringAtomInfo += QString::number(atomIds_.value(ws.nodeVertex[ws.ring[n]]) + 1);
+		}
+		Messenger::print(QString("Found SP ring of size %1 with atom indices %2").arg(ringSize).arg(ringAtomInfo));
+	}
+}
+
+// Find all shortest-path rings for which the specified vertex is the lowest-numbered
+void SPRingsGraph::findRings(SPRingsSearch& ws, SPRingsSearch& check, int source, double* counts) const
+{
+	/*
+	 * Any SP ring through the source consists of two shortest paths from the source which meet either at a single vertex (even
+	 * rings) or at either end of an edge whose vertices are equidistant from the source (odd rings).
+	 * Search to half the maximum ring size, and consider all pairs of paths meeting at each vertex / edge reached.
+	 * Rings are only built from vertices after the source so that each is found once, but distances are always taken from the full graph.
+	 */
+	search(ws, source, maxRingSize_/2);
+
+	int n, a, b, d, e, other, nPaths, nOtherPaths;
+	Vec3<int> shift;
+	for (n=1; n<ws.nodeVertex.nItems(); ++n)
+	{
+		if (ws.nodeVertex[n] < source) continue;
+		d = ws.nodeDistance[n];
+
+		findPaths(ws, source, n, ws.paths);
+		nPaths = ws.paths.nItems() / (d+1);
+		if (nPaths == 0) continue;
+
+		// Even rings - pairs of paths to this node
+		if ((d > 1) && (d*2 <= maxRingSize_))
+		{
+			for (a=0; a<nPaths-1; ++a)
+				for (b=a+1; b<nPaths; ++b) testRing(ws, check, ws.paths.array()+a*(d+1), ws.paths.array()+b*(d+1), d, false, counts);
+		}
+
+		// Odd rings - paths to either end of an edge from this node to another at the same distance (considering each edge once)
+		if (d*2+1 > maxRingSize_) continue;
+		shift = ws.nodeShift[n];
+		for (e=offsets_.value(ws.nodeVertex[n]); e<offsets_.value(ws.nodeVertex[n]+1); ++e)
+		{
+			other = ws.node(neighbours_.value(e), shift + shifts_.value(e));
+			if ((other <= n) || (ws.nodeDistance[other] != d) || (ws.nodeVertex[other] < source)) continue;
+
+			findPaths(ws, source, other, ws.otherPaths);
+			nOtherPaths = ws.otherPaths.nItems() / (d+1);
+			for (a=0; a<nPaths; ++a)
+				for (b=0; b<nOtherPaths; ++b) testRing(ws, check, ws.paths.array()+a*(d+1), ws.otherPaths.array()+b*(d+1), d, true, counts);
+		}
+	}
+}
+
+// Count shortest-path rings up to the maximum size specified, using the number of threads given
+void SPRingsGraph::countRings(int maxRingSize, int nThreads, Array<double>& counts, bool debug)
+{
+	Messenger::enter("SPRingsGraph::countRings");
+
+	maxRingSize_ = maxRingSize;
+	debug_ = debug;
+	counts.createEmpty(maxRingSize_, 0.0);
+	if ((nVertices_ == 0) || (maxRingSize_ < 3))
+	{
+		Messenger::exit("SPRingsGraph::countRings");
+		return;
+	}
+
+	// Debug output from several threads at once would be unreadable
+	nThreads = (debug_ ? 1 : ThreadPool::threadCount(nThreads));
+
+	// Each thread needs two workspaces (one for ring construction, one for checking), and its own counts
+	SPRingsSearch* workspaces = new SPRingsSearch[nThreads*2];
+	for (int n=0; n<nThreads*2; ++n) workspaces[n].initialise(nVertices_);
+	Array<double> threadCounts;
+	threadCounts.createEmpty(nThreads*maxRingSize_, 0.0);
+
+	ThreadPool::run(nVertices_, nThreads, [&](int task, int thread)
+	{
+		findRings(workspaces[thread*2], workspaces[thread*2+1], task, threadCounts.array() + thread*maxRingSize_);
+	});
+
+	for (int n=0; n<threadCounts.nItems(); ++n) counts[n%maxRingSize_] += threadCounts[n];
+	delete[] workspaces;
+
+	Messenger::exit("SPRingsGraph::countRings");
+}
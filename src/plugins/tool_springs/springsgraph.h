@@ -0,0 +1,134 @@
+/*
+        *** SPRings Graph
+        *** src/plugins/tool_springs/springsgraph.h
+        Copyright T. Youngs 2016-2017
+
+        This file is part of Aten.
+
+        Aten is free software: you can redistribute it and/or modify
+        it under the terms of the GNU General Public License as published by
+        the Free Software Foundation, either version 3 of the License, or
+        (at your option) any later version.
+
+        Aten is distributed in the hope that it will be useful,
+        but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+        GNU General Public License for more details.
+
+        You should have received a copy of the GNU General Public License
+        along with Aten.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef ATEN_SPRINGSGRAPH_H
+#define ATEN_SPRINGSGRAPH_H
+
+#include "templates/array.h"
+#include "templates/vector3.h"
+#include "base/namespace.h"
+
+ATEN_BEGIN_NAMESPACE
+
+// Forward Declarations (Aten)
+class Model;
+
+// SPRings Search Workspace
+// Per-thread storage used while searching for the rings through a single vertex
+// Searches are made over nodes (periodic images of vertices) so that a vertex is never confused with its own images in small cells
+class SPRingsSearch
+{
+	public:
+	// Initialise workspace for the specified number of vertices
+	void initialise(int nVertices);
+	// Clear nodes reached, ready for a new search
+	void reset();
+	// Add node for the specified image of a vertex, returning its index
+	int addNode(int vertex, const Vec3<int>& shift, int distance);
+	// Return node for the specified image of a vertex reached by the current search (or -1 if it was not reached)
+	int node(int vertex, const Vec3<int>& shift) const;
+	// Index of the search which last reached each vertex
+	Array<int> stamp;
+	// Index of current search (incremented for each new search)
+	int currentStamp;
+	// Most recent node reached by the current search for each vertex
+	Array<int> lastImage;
+	// Vertex of each node reached, in order of increasing distance
+	Array<int> nodeVertex;
+	// Periodic image shift of each node reached, relative to the source
+	Array< Vec3<int> > nodeShift;
+	// Distance of each node reached from the source
+	Array<int> nodeDistance;
+	// Previous node reached which is an image of the same vertex (or -1)
+	Array<int> otherImage;
+	// Shortest paths (as nodes) from the source to the current target, stored consecutively
+	Array<int> paths;
+	// Shortest paths from the source to a second target (for odd rings)
+	Array<int> otherPaths;
+	// Path under construction
+	Array<int> path;
+	// Ring (as nodes) under test
+	Array<int> ring;
+};
+
+// SPRings Graph
+// Compact (CSR) bond graph of the atoms of interest in a model, with the periodic image shift of each edge, from which
+// shortest-path ring statistics are calculated directly (Phys. Rev. B 1991, 44, 4925)
+class SPRingsGraph
+{
+	public:
+	// Constructor
+	SPRingsGraph();
+
+
+	/*
+	 * Graph
+	 */
+	private:
+	// Number of vertices in the graph
+	int nVertices_;
+	// Index of first edge of each vertex (plus one extra marking the end of the last vertex's edges)
+	Array<int> offsets_;
+	// Vertex at the other end of each edge
+	Array<int> neighbours_;
+	// Periodic image shift (in cell vectors) crossed by each edge
+	Array< Vec3<int> > shifts_;
+	// Atom ids corresponding to each vertex
+	Array<int> atomIds_;
+
+	public:
+	// Construct graph from atoms of the specified element, optionally adding edges between those bridged by a link element
+	void create(Model* sourceModel, int element, bool links, int linkElement);
+	// Return number of vertices in the graph
+	int nVertices() const;
+	// Return number of (directed) edges in the graph
+	int nEdges() const;
+
+
+	/*
+	 * Shortest-Path Rings
+	 */
+	private:
+	// Maximum ring size to search for
+	int maxRingSize_;
+	// Whether to print information on each ring found
+	bool debug_;
+	// Breadth-first search outwards from the specified vertex, up to the maximum distance given
+	void search(SPRingsSearch& ws, int source, int maxDepth) const;
+	// Extend path backwards from the specified node towards the source, storing any completed paths
+	void extendPath(SPRingsSearch& ws, int source, int node, int depth, Array<int>& paths) const;
+	// Find all shortest paths from the source to the target node, which use only vertices after the source
+	void findPaths(SPRingsSearch& ws, int source, int target, Array<int>& paths) const;
+	// Return whether the second node of the ring was reached by the check search made from the first
+	bool reached(const SPRingsSearch& ws, const SPRingsSearch& check, int from, int to) const;
+	// Test candidate ring formed from the two paths specified, adding it to the counts if it is a shortest-path ring
+	void testRing(SPRingsSearch& ws, SPRingsSearch& check, const int* path1, const int* path2, int pathLength, bool odd, double* counts) const;
+	// Find all shortest-path rings for which the specified vertex is the lowest-numbered
+	void findRings(SPRingsSearch& ws, SPRingsSearch& check, int source, double* counts) const;
+
+	public:
+	// Count shortest-path rings up to the maximum size specified, using the number of threads given (or all available if < 1)
+	void countRings(int maxRingSize, int nThreads, Array<double>& counts, bool debug = false);
+};
+
+ATEN_END_NAMESPACE
+
+#endif
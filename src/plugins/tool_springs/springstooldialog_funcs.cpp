@@ -65,7 +65,6 @@ void SPRingsToolDialog::applyPluginOptions()
 	ui.LinkElementCheck->setChecked(pluginOptions_.value("links") == "true");
 	ui.CalculateForAllCheck->setChecked(pluginOptions_.value("calculateForAll") == "true");
 	ui.MaxRingSizeSpin->setValue(pluginOptions_.value("maxRingSize").toInt());
-	ui.MaxDistanceSpin->setValue(pluginOptions_.value("maxDistance").toDouble());
 	ui.DebugCheck->setChecked(pluginOptions_.value("debug") == "true");
 }
 
@@ -77,6 +76,5 @@ void SPRingsToolDialog::setPluginOptions()
 	pluginOptions_.add("links", ui.LinkElementCheck->isChecked() ? "true" : "false");
 	pluginOptions_.add("calculateForAll", ui.CalculateForAllCheck->isChecked() ? "true" : "false");
 	pluginOptions_.add("maxRingSize", QString::number(ui.MaxRingSizeSpin->value()));
-	pluginOptions_.add("maxDistance", QString::number(ui.MaxDistanceSpin->value()));
 	pluginOptions_.add("debug", ui.DebugCheck->isChecked() ? "true" : "false");
 }
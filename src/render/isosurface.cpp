@@ -0,0 +1,750 @@
+/*
+	*** Isosurface extraction
+	*** src/render/isosurface.cpp
+	Copyright T. Youngs 2007-2017
+
+	This file is part of Aten.
+
+	Aten is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Aten is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Aten.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "render/isosurface.h"
+#include "base/grid.h"
+#include "base/threadpool.h"
+#include "base/messenger.h"
+#include <QHash>
+
+/*
+	Marching Cube vertex and [edge] numbering
+
+		7---------6			128------64
+	       /|        /|		       /|        /|
+	      / |       / |		      / |       / |
+	     3---------2  |		     8---------4  |
+	     |  |      |  |		     |  |      |  |
+	     |  4------|--5		     |  16-----|-32
+ y z	     | /       | /		     | /       | /
+ |/	     |/        |/		     |/        |/
+ o->x	     0---------1		     1---------2
+
+     4---[4]---5	3     2     6     7		   7--[6]--6
+ [8]/         /		|[3]  |[1]  |[5]  |[7]	      [10]/       /
+   /         /[9]	|     |     |     |		 /       /[11]
+  0---[0]---1		0     1     5     4		3--[2]--2
+*/
+
+// Marching Cube Edge Vertex Lookup Table
+int edgevertices[12][2] = { { 0,1 }, { 1,2 }, { 2,3 }, { 0,3 },
+	{ 4,5 }, { 5,6 }, { 6,7 }, { 4,7 },
+	{ 0,4 }, { 1,5 }, { 3,7 }, { 2,6 } };
+
+// Marching Cube Vertex Position Lookup Table
+int vertexPos[8][3] = { { 0,0,0 }, { 1,0,0 }, { 1,1,0 }, { 0,1,0 },
+	{ 0,0,1 }, { 1,0,1 }, { 1,1,1 }, { 0,1,1 } };
+
+// Marching Cube Face Triplet Lookup Table
+int facetriples[256][15] = {
+	{ -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+	{ 0, 8, 3, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+	{ 0, 1, 9, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+	{ 1, 8, 3, 9, 8, 1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+	{ 1, 2, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+	{ 0, 8, 3, 1, 2, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+	{ 9, 2, 11, 0, 2, 9, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+	{ 2, 8, 3, 2, 11, 8, 11, 9, 8, -1, -1, -1, -1, -1, -1},
+	{ 3, 10, 2, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+	{ 0, 10, 2, 8, 10, 0, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+	{ 1, 9, 0, 2, 3, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+	{ 1, 10, 2, 1, 9, 10, 9, 8, 10, -1, -1, -1, -1, -1, -1},
+	{ 3, 11, 1, 10, 11, 3, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+	{ 0, 11, 1, 0, 8, 11, 8, 10, 11, -1, -1, -1, -1, -1, -1},
+	{ 3, 9, 0, 3, 10, 9, 10, 11, 9, -1, -1, -1, -1, -1, -1},
+	{ 9, 8, 11, 11, 8, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1}, 
+	{ 4, 7, 8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1}, 
+	{ 4, 3, 0, 7, 3, 4, -1, -1, -1, -1, -1, -1, -1, -1, -1}, 
+	{ 0, 1, 9, 8, 4, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1}, 
+	{ 4, 1, 9, 4, 7, 1, 7, 3, 1, -1, -1, -1, -1, -1, -1}, 
+	{ 1, 2, 11, 8, 4, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1}, 
+	{ 3, 4, 7, 3, 0, 4, 1, 2, 11, -1, -1, -1, -1, -1, -1}, 
+	{ 9, 2, 11, 9, 0, 2, 8, 4, 7, -1, -1, -1, -1, -1, -1}, 
+	{ 2, 11, 9, 2, 9, 7, 2, 7, 3, 7, 9, 4, -1, -1, -1}, 
+	{ 8, 4, 7, 3, 10, 2, -1, -1, -1, -1, -1, -1, -1, -1, -1}, 
+	{ 10, 4, 7, 10, 2, 4, 2, 0, 4, -1, -1, -1, -1, -1, -1}, 
+	{ 9, 0, 1, 8, 4, 7, 2, 3, 10, -1, -1, -1, -1, -1, -1}, 
+	{ 4, 7, 10, 9, 4, 10, 9, 10, 2, 9, 2, 1, -1, -1, -1}, 
+	{ 3, 11, 1, 3, 10, 11, 7, 8, 4, -1, -1, -1, -1, -1, -1}, 
+	{ 1, 10, 11, 1, 4, 10, 1, 0, 4, 7, 10, 4, -1, -1, -1}, 
+	{ 4, 7, 8, 9, 0, 10, 9, 10, 11, 10, 0, 3, -1, -1, -1}, 
+	{ 4, 7, 10, 4, 10, 9, 9, 10, 11, -1, -1, -1, -1, -1, -1}, 
+	{ 9, 5, 4, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1}, 
+	{ 9, 5, 4, 0, 8, 3, -1, -1, -1, -1, -1, -1, -1, -1, -1}, 
+	{ 0, 5, 4, 1, 5, 0, -1, -1, -1, -1, -1, -1, -1, -1, -1}, 
+	{ 8, 5, 4, 8, 3, 5, 3, 1, 5, -1, -1, -1, -1, -1, -1}, 
+	{ 1, 2, 11, 9, 5, 4, -1, -1, -1, -1, -1, -1, -1, -1, -1}, 
+	{ 3, 0, 8, 1, 2, 11, 4, 9, 5, -1, -1, -1, -1, -1, -1}, 
+	{ 5, 2, 11, 5, 4, 2, 4, 0, 2, -1, -1, -1, -1, -1, -1}, 
+	{ 2, 11, 5, 3, 2, 5, 3, 5, 4, 3, 4, 8, -1, -1, -1}, 
+	{ 9, 5, 4, 2, 3, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+	{ 0, 10, 2, 0, 8, 10, 4, 9, 5, -1, -1, -1, -1, -1, -1}, 
+	{ 0, 5, 4, 0, 1, 5, 2, 3, 10, -1, -1, -1, -1, -1, -1}, 
+	{ 2, 1, 5, 2, 5, 8, 2, 8, 10, 4, 8, 5, -1, -1, -1}, 
+	{ 11, 3, 10, 11, 1, 3, 9, 5, 4, -1, -1, -1, -1, -1, -1}, 
+	{ 4, 9, 5, 0, 8, 1, 8, 11, 1, 8, 10, 11, -1, -1, -1}, 
+	{ 5, 4, 0, 5, 0, 10, 5, 10, 11, 10, 0, 3, -1, -1, -1}, 
+	{ 5, 4, 8, 5, 8, 11, 11, 8, 10, -1, -1, -1, -1, -1, -1}, 
+	{ 9, 7, 8, 5, 7, 9, -1, -1, -1, -1, -1, -1, -1, -1, -1}, 
+	{ 9, 3, 0, 9, 5, 3, 5, 7, 3, -1, -1, -1, -1, -1, -1}, 
+	{ 0, 7, 8, 0, 1, 7, 1, 5, 7, -1, -1, -1, -1, -1, -1}, 
+	{ 1, 5, 3, 3, 5, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1}, 
+	{ 9, 7, 8, 9, 5, 7, 11, 1, 2, -1, -1, -1, -1, -1, -1}, 
+	{ 11, 1, 2, 9, 5, 0, 5, 3, 0, 5, 7, 3, -1, -1, -1}, 
+	{ 8, 0, 2, 8, 2, 5, 8, 5, 7, 11, 5, 2, -1, -1, -1}, 
+	{ 2, 11, 5, 2, 5, 3, 3, 5, 7, -1, -1, -1, -1, -1, -1}, 
+	{ 7, 9, 5, 7, 8, 9, 3, 10, 2, -1, -1, -1, -1, -1, -1}, 
+	{ 9, 5, 7, 9, 7, 2, 9, 2, 0, 2, 7, 10, -1, -1, -1}, 
+	{ 2, 3, 10, 0, 1, 8, 1, 7, 8, 1, 5, 7, -1, -1, -1}, 
+	{ 10, 2, 1, 10, 1, 7, 7, 1, 5, -1, -1, -1, -1, -1, -1}, 
+	{ 9, 5, 8, 8, 5, 7, 11, 1, 3, 11, 3, 10, -1, -1, -1}, 
+	{ 5, 7, 10, 5, 10, 11, 1, 0, 9, -1, -1, -1, -1, -1, -1}, 
+	{ 10, 11, 5, 10, 5, 7, 8, 0, 3, -1, -1, -1, -1, -1, -1}, 
+	{ 10, 11, 5, 7, 10, 5, -1, -1, -1, -1, -1, -1, -1, -1, -1}, 
+	{ 11, 6, 5, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1}, 
+	{ 0, 8, 3, 5, 11, 6, -1, -1, -1, -1, -1, -1, -1, -1, -1}, 
+	{ 9, 0, 1, 5, 11, 6, -1, -1, -1, -1, -1, -1, -1, -1, -1}, 
+	{ 1, 8, 3, 1, 9, 8, 5, 11, 6, -1, -1, -1, -1, -1, -1}, 
+	{ 1, 6, 5, 2, 6, 1, -1, -1, -1, -1, -1, -1, -1, -1, -1}, 
+	{ 1, 6, 5, 1, 2, 6, 3, 0, 8, -1, -1, -1, -1, -1, -1}, 
+	{ 9, 6, 5, 9, 0, 6, 0, 2, 6, -1, -1, -1, -1, -1, -1}, 
+	{ 5, 9, 8, 5, 8, 2, 5, 2, 6, 3, 2, 8, -1, -1, -1}, 
+	{ 2, 3, 10, 11, 6, 5, -1, -1, -1, -1, -1, -1, -1, -1, -1}, 
+	{ 10, 0, 8, 10, 2, 0, 11, 6, 5, -1, -1, -1, -1, -1, -1}, 
+	{ 0, 1, 9, 2, 3, 10, 5, 11, 6, -1, -1, -1, -1, -1, -1}, 
+	{ 5, 11, 6, 1, 9, 2, 9, 10, 2, 9, 8, 10, -1, -1, -1}, 
+	{ 6, 3, 10, 6, 5, 3, 5, 1, 3, -1, -1, -1, -1, -1, -1}, 
+	{ 0, 8, 10, 0, 10, 5, 0, 5, 1, 5, 10, 6, -1, -1, -1}, 
+	{ 3, 10, 6, 0, 3, 6, 0, 6, 5, 0, 5, 9, -1, -1, -1}, 
+	{ 6, 5, 9, 6, 9, 10, 10, 9, 8, -1, -1, -1, -1, -1, -1}, 
+	{ 5, 11, 6, 4, 7, 8, -1, -1, -1, -1, -1, -1, -1, -1, -1}, 
+	{ 4, 3, 0, 4, 7, 3, 6, 5, 11, -1, -1, -1, -1, -1, -1}, 
+	{ 1, 9, 0, 5, 11, 6, 8, 4, 7, -1, -1, -1, -1, -1, -1}, 
+	{ 11, 6, 5, 1, 9, 7, 1, 7, 3, 7, 9, 4, -1, -1, -1}, 
+	{ 6, 1, 2, 6, 5, 1, 4, 7, 8, -1, -1, -1, -1, -1, -1}, 
+	{ 1, 2, 5, 5, 2, 6, 3, 0, 4, 3, 4, 7, -1, -1, -1}, 
+	{ 8, 4, 7, 9, 0, 5, 0, 6, 5, 0, 2, 6, -1, -1, -1}, 
+	{ 7, 3, 2, 7, 2, 6, 5, 9, 4, -1, -1, -1, -1, -1, -1}, 
+	{ 3, 10, 2, 7, 8, 4, 11, 6, 5, -1, -1, -1, -1, -1, -1}, 
+	{ 5, 11, 6, 4, 7, 2, 4, 2, 0, 2, 7, 10, -1, -1, -1}, 
+	{ 0, 1, 9, 4, 7, 8, 2, 3, 10, 5, 11, 6, -1, -1, -1}, 
+	{ 9, 4, 5, 11, 2, 1, 7, 10, 6, -1, -1, -1, -1, -1, -1}, 
+	{ 8, 4, 7, 3, 10, 5, 3, 5, 1, 5, 10, 6, -1, -1, -1}, 
+	{ 5, 1, 0, 5, 0, 4, 7, 10, 6, -1, -1, -1, -1, -1, -1}, 
+	{ 0, 3, 8, 4, 5, 9, 10, 6, 7, -1, -1, -1, -1, -1, -1}, 
+	{ 4, 5, 9, 7, 10, 6, -1, -1, -1, -1, -1, -1, -1, -1, -1}, 
+	{ 11, 4, 9, 6, 4, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1}, 
+	{ 4, 11, 6, 4, 9, 11, 0, 8, 3, -1, -1, -1, -1, -1, -1}, 
+	{ 11, 0, 1, 11, 6, 0, 6, 4, 0, -1, -1, -1, -1, -1, -1}, 
+	{ 8, 3, 1, 8, 1, 6, 8, 6, 4, 6, 1, 11, -1, -1, -1}, 
+	{ 1, 4, 9, 1, 2, 4, 2, 6, 4, -1, -1, -1, -1, -1, -1}, 
+	{ 3, 0, 8, 1, 2, 9, 2, 4, 9, 2, 6, 4, -1, -1, -1}, 
+	{ 0, 2, 4, 4, 2, 6, -1, -1, -1, -1, -1, -1, -1, -1, -1}, 
+	{ 8, 3, 2, 8, 2, 4, 4, 2, 6, -1, -1, -1, -1, -1, -1}, 
+	{ 11, 4, 9, 11, 6, 4, 10, 2, 3, -1, -1, -1, -1, -1, -1}, 
+	{ 0, 8, 2, 2, 8, 10, 4, 9, 11, 4, 11, 6, -1, -1, -1}, 
+	{ 3, 10, 2, 0, 1, 6, 0, 6, 4, 6, 1, 11, -1, -1, -1}, 
+	{ 6, 4, 8, 6, 8, 10, 2, 1, 11, -1, -1, -1, -1, -1, -1}, 
+	{ 9, 6, 4, 9, 3, 6, 9, 1, 3, 10, 6, 3, -1, -1, -1}, 
+	{ 8, 10, 6, 8, 6, 4, 9, 1, 0, -1, -1, -1, -1, -1, -1}, 
+	{ 3, 10, 6, 3, 6, 0, 0, 6, 4, -1, -1, -1, -1, -1, -1}, 
+	{ 6, 4, 8, 10, 6, 8, -1, -1, -1, -1, -1, -1, -1, -1, -1}, 
+	{ 7, 11, 6, 7, 8, 11, 8, 9, 11, -1, -1, -1, -1, -1, -1}, 
+	{ 0, 7, 3, 0, 11, 7, 0, 9, 11, 6, 7, 11, -1, -1, -1}, 
+	{ 11, 6, 7, 1, 11, 7, 1, 7, 8, 1, 8, 0, -1, -1, -1}, 
+	{ 11, 6, 7, 11, 7, 1, 1, 7, 3, -1, -1, -1, -1, -1, -1}, 
+	{ 1, 2, 6, 1, 6, 8, 1, 8, 9, 8, 6, 7, -1, -1, -1}, 
+	{ 2, 6, 7, 2, 7, 3, 0, 9, 1, -1, -1, -1, -1, -1, -1}, 
+	{ 7, 8, 0, 7, 0, 6, 6, 0, 2, -1, -1, -1, -1, -1, -1}, 
+	{ 7, 3, 2, 6, 7, 2, -1, -1, -1, -1, -1, -1, -1, -1, -1}, 
+	{ 2, 3, 10, 11, 6, 8, 11, 8, 9, 8, 6, 7, -1, -1, -1}, 
+	{ 2, 0, 9, 2, 9, 11, 6, 7, 10, -1, -1, -1, -1, -1, -1}, 
+	{ 1, 11, 2, 3, 8, 0, 6, 7, 10, -1, -1, -1, -1, -1, -1}, 
+	{ 11, 2, 1, 6, 7, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1}, 
+	{ 8, 9, 1, 8, 1, 3, 10, 6, 7, -1, -1, -1, -1, -1, -1}, 
+	{ 0, 9, 1, 10, 6, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1}, 
+	{ 3, 8, 0, 10, 6, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1}, 
+	{ 7, 10, 6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1}, 
+	{ 7, 6, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1}, 
+	{ 3, 0, 8, 10, 7, 6, -1, -1, -1, -1, -1, -1, -1, -1, -1}, 
+	{ 0, 1, 9, 10, 7, 6, -1, -1, -1, -1, -1, -1, -1, -1, -1}, 
+	{ 8, 1, 9, 8, 3, 1, 10, 7, 6, -1, -1, -1, -1, -1, -1}, 
+	{ 11, 1, 2, 6, 10, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1}, 
+	{ 1, 2, 11, 3, 0, 8, 6, 10, 7, -1, -1, -1, -1, -1, -1}, 
+	{ 2, 9, 0, 2, 11, 9, 6, 10, 7, -1, -1, -1, -1, -1, -1}, 
+	{ 2, 10, 3, 11, 8, 6, 11, 9, 8, 8, 7, 6, -1, -1, -1}, 
+	{ 7, 2, 3, 6, 2, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1}, 
+	{ 7, 0, 8, 7, 6, 0, 6, 2, 0, -1, -1, -1, -1, -1, -1}, 
+	{ 2, 7, 6, 2, 3, 7, 0, 1, 9, -1, -1, -1, -1, -1, -1}, 
+	{ 1, 6, 2, 1, 8, 6, 1, 9, 8, 8, 7, 6, -1, -1, -1}, 
+	{ 11, 7, 6, 11, 1, 7, 1, 3, 7, -1, -1, -1, -1, -1, -1}, 
+	{ 11, 7, 6, 1, 7, 11, 1, 8, 7, 1, 0, 8, -1, -1, -1}, 
+	{ 0, 3, 7, 0, 7, 11, 0, 11, 9, 6, 11, 7, -1, -1, -1}, 
+	{ 7, 6, 11, 7, 11, 8, 8, 11, 9, -1, -1, -1, -1, -1, -1}, 
+	{ 6, 8, 4, 10, 8, 6, -1, -1, -1, -1, -1, -1, -1, -1, -1}, 
+	{ 3, 6, 10, 3, 0, 6, 0, 4, 6, -1, -1, -1, -1, -1, -1}, 
+	{ 8, 6, 10, 8, 4, 6, 9, 0, 1, -1, -1, -1, -1, -1, -1}, 
+	{ 9, 4, 6, 9, 6, 3, 9, 3, 1, 10, 3, 6, -1, -1, -1}, 
+	{ 6, 8, 4, 6, 10, 8, 2, 11, 1, -1, -1, -1, -1, -1, -1}, 
+	{ 3, 2, 10, 0, 6, 1, 0, 4, 6, 6, 11, 1, -1, -1, -1}, 
+	{ 0, 2, 8, 2, 10, 8, 4, 11, 9, 4, 6, 11, -1, -1, -1}, 
+	{ 11, 9, 4, 11, 4, 6, 10, 3, 2, -1, -1, -1, -1, -1, -1}, 
+	{ 8, 2, 3, 8, 4, 2, 4, 6, 2, -1, -1, -1, -1, -1, -1}, 
+	{ 0, 4, 2, 4, 6, 2, -1, -1, -1, -1, -1, -1, -1, -1, -1}, 
+	{ 3, 8, 0, 1, 9, 2, 2, 9, 4, 2, 4, 6, -1, -1, -1}, 
+	{ 1, 9, 4, 1, 4, 2, 2, 4, 6, -1, -1, -1, -1, -1, -1}, 
+	{ 8, 1, 3, 8, 6, 1, 8, 4, 6, 6, 11, 1, -1, -1, -1}, 
+	{ 11, 1, 0, 11, 0, 6, 6, 0, 4, -1, -1, -1, -1, -1, -1}, 
+	{ 4, 6, 11, 4, 11, 9, 0, 3, 8, -1, -1, -1, -1, -1, -1}, 
+	{ 11, 9, 4, 6, 11, 4, -1, -1, -1, -1, -1, -1, -1, -1, -1}, 
+	{ 4, 9, 5, 7, 6, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1}, 
+	{ 0, 8, 3, 4, 9, 5, 10, 7, 6, -1, -1, -1, -1, -1, -1}, 
+	{ 5, 0, 1, 5, 4, 0, 7, 6, 10, -1, -1, -1, -1, -1, -1}, 
+	{ 8, 7, 4, 3, 5, 10, 3, 1, 5, 5, 6, 10, -1, -1, -1}, 
+	{ 9, 5, 4, 11, 1, 2, 7, 6, 10, -1, -1, -1, -1, -1, -1}, 
+	{ 0, 9, 1, 4, 8, 7, 2, 10, 3, 5, 6, 11, -1, -1, -1}, 
+	{ 5, 6, 11, 4, 2, 7, 4, 0, 2, 2, 10, 7, -1, -1, -1}, 
+	{ 3, 2, 10, 7, 4, 8, 11, 5, 6, -1, -1, -1, -1, -1, -1}, 
+	{ 7, 2, 3, 7, 6, 2, 5, 4, 9, -1, -1, -1, -1, -1, -1}, 
+	{ 8, 7, 4, 9, 5, 0, 0, 5, 6, 0, 6, 2, -1, -1, -1}, 
+	{ 1, 5, 2, 5, 6, 2, 3, 4, 0, 3, 7, 4, -1, -1, -1}, 
+	{ 6, 2, 1, 6, 1, 5, 4, 8, 7, -1, -1, -1, -1, -1, -1}, 
+	{ 11, 5, 6, 1, 7, 9, 1, 3, 7, 7, 4, 9, -1, -1, -1}, 
+	{ 1, 0, 9, 5, 6, 11, 8, 7, 4, -1, -1, -1, -1, -1, -1}, 
+	{ 4, 0, 3, 4, 3, 7, 6, 11, 5, -1, -1, -1, -1, -1, -1}, 
+	{ 5, 6, 11, 4, 8, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1}, 
+	{ 6, 9, 5, 6, 10, 9, 10, 8, 9, -1, -1, -1, -1, -1, -1}, 
+	{ 3, 6, 10, 0, 6, 3, 0, 5, 6, 0, 9, 5, -1, -1, -1}, 
+	{ 0, 10, 8, 0, 5, 10, 0, 1, 5, 5, 6, 10, -1, -1, -1}, 
+	{ 6, 10, 3, 6, 3, 5, 5, 3, 1, -1, -1, -1, -1, -1, -1}, 
+	{ 5, 6, 11, 1, 2, 9, 9, 2, 10, 9, 10, 8, -1, -1, -1}, 
+	{ 0, 9, 1, 2, 10, 3, 5, 6, 11, -1, -1, -1, -1, -1, -1}, 
+	{ 10, 8, 0, 10, 0, 2, 11, 5, 6, -1, -1, -1, -1, -1, -1}, 
+	{ 2, 10, 3, 11, 5, 6, -1, -1, -1, -1, -1, -1, -1, -1, -1}, 
+	{ 5, 8, 9, 5, 2, 8, 5, 6, 2, 3, 8, 2, -1, -1, -1}, 
+	{ 9, 5, 6, 9, 6, 0, 0, 6, 2, -1, -1, -1, -1, -1, -1}, 
+	{ 1, 5, 6, 1, 6, 2, 3, 8, 0, -1, -1, -1, -1, -1, -1}, 
+	{ 1, 5, 6, 2, 1, 6, -1, -1, -1, -1, -1, -1, -1, -1, -1}, 
+	{ 1, 3, 8, 1, 8, 9, 5, 6, 11, -1, -1, -1, -1, -1, -1}, 
+	{ 9, 1, 0, 5, 6, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1}, 
+	{ 0, 3, 8, 5, 6, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1}, 
+	{ 11, 5, 6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1}, 
+	{ 10, 5, 11, 7, 5, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1}, 
+	{ 10, 5, 11, 10, 7, 5, 8, 3, 0, -1, -1, -1, -1, -1, -1}, 
+	{ 5, 10, 7, 5, 11, 10, 1, 9, 0, -1, -1, -1, -1, -1, -1}, 
+	{ 9, 8, 5, 8, 7, 5, 11, 3, 1, 11, 10, 3, -1, -1, -1}, 
+	{ 10, 1, 2, 10, 7, 1, 7, 5, 1, -1, -1, -1, -1, -1, -1}, 
+	{ 2, 10, 3, 0, 8, 1, 1, 8, 7, 1, 7, 5, -1, -1, -1}, 
+	{ 9, 7, 5, 9, 2, 7, 9, 0, 2, 2, 10, 7, -1, -1, -1}, 
+	{ 7, 5, 9, 7, 9, 8, 3, 2, 10, -1, -1, -1, -1, -1, -1}, 
+	{ 2, 5, 11, 2, 3, 5, 3, 7, 5, -1, -1, -1, -1, -1, -1}, 
+	{ 8, 2, 0, 8, 5, 2, 8, 7, 5, 11, 2, 5, -1, -1, -1}, 
+	{ 11, 2, 1, 9, 0, 5, 5, 0, 3, 5, 3, 7, -1, -1, -1}, 
+	{ 9, 8, 7, 9, 7, 5, 11, 2, 1, -1, -1, -1, -1, -1, -1}, 
+	{ 1, 3, 5, 3, 7, 5, -1, -1, -1, -1, -1, -1, -1, -1, -1}, 
+	{ 0, 8, 7, 0, 7, 1, 1, 7, 5, -1, -1, -1, -1, -1, -1}, 
+	{ 9, 0, 3, 9, 3, 5, 5, 3, 7, -1, -1, -1, -1, -1, -1}, 
+	{ 9, 8, 7, 5, 9, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1}, 
+	{ 5, 8, 4, 5, 11, 8, 11, 10, 8, -1, -1, -1, -1, -1, -1}, 
+	{ 5, 0, 4, 5, 10, 0, 5, 11, 10, 10, 3, 0, -1, -1, -1}, 
+	{ 4, 5, 9, 0, 1, 8, 8, 1, 11, 8, 11, 10, -1, -1, -1}, 
+	{ 11, 10, 3, 11, 3, 1, 9, 4, 5, -1, -1, -1, -1, -1, -1}, 
+	{ 2, 5, 1, 2, 8, 5, 2, 10, 8, 4, 5, 8, -1, -1, -1}, 
+	{ 0, 4, 5, 0, 5, 1, 2, 10, 3, -1, -1, -1, -1, -1, -1}, 
+	{ 0, 2, 10, 0, 10, 8, 4, 5, 9, -1, -1, -1, -1, -1, -1}, 
+	{ 9, 4, 5, 2, 10, 3, -1, -1, -1, -1, -1, -1, -1, -1, -1}, 
+	{ 2, 5, 11, 3, 5, 2, 3, 4, 5, 3, 8, 4, -1, -1, -1}, 
+	{ 5, 11, 2, 5, 2, 4, 4, 2, 0, -1, -1, -1, -1, -1, -1}, 
+	{ 3, 8, 0, 1, 11, 2, 4, 5, 9, -1, -1, -1, -1, -1, -1}, 
+	{ 1, 11, 2, 9, 4, 5, -1, -1, -1, -1, -1, -1, -1, -1, -1}, 
+	{ 8, 4, 5, 8, 5, 3, 3, 5, 1, -1, -1, -1, -1, -1, -1}, 
+	{ 0, 4, 5, 1, 0, 5, -1, -1, -1, -1, -1, -1, -1, -1, -1}, 
+	{ 9, 4, 5, 0, 3, 8, -1, -1, -1, -1, -1, -1, -1, -1, -1}, 
+	{ 9, 4, 5, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1}, 
+	{ 4, 10, 7, 4, 9, 10, 9, 11, 10, -1, -1, -1, -1, -1, -1}, 
+	{ 4, 8, 7, 9, 10, 0, 9, 11, 10, 10, 3, 0, -1, -1, -1}, 
+	{ 1, 11, 10, 1, 10, 4, 1, 4, 0, 7, 4, 10, -1, -1, -1}, 
+	{ 3, 1, 11, 3, 11, 10, 7, 4, 8, -1, -1, -1, -1, -1, -1}, 
+	{ 4, 10, 7, 9, 10, 4, 9, 2, 10, 9, 1, 2, -1, -1, -1}, 
+	{ 9, 1, 0, 8, 7, 4, 2, 10, 3, -1, -1, -1, -1, -1, -1}, 
+	{ 10, 7, 4, 10, 4, 2, 2, 4, 0, -1, -1, -1, -1, -1, -1}, 
+	{ 8, 7, 4, 3, 2, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1}, 
+	{ 2, 9, 11, 2, 7, 9, 2, 3, 7, 7, 4, 9, -1, -1, -1}, 
+	{ 9, 11, 2, 9, 2, 0, 8, 7, 4, -1, -1, -1, -1, -1, -1}, 
+	{ 3, 7, 4, 3, 4, 0, 1, 11, 2, -1, -1, -1, -1, -1, -1}, 
+	{ 1, 11, 2, 8, 7, 4, -1, -1, -1, -1, -1, -1, -1, -1, -1}, 
+	{ 4, 9, 1, 4, 1, 7, 7, 1, 3, -1, -1, -1, -1, -1, -1}, 
+	{ 0, 9, 1, 8, 7, 4, -1, -1, -1, -1, -1, -1, -1, -1, -1}, 
+	{ 4, 0, 3, 7, 4, 3, -1, -1, -1, -1, -1, -1, -1, -1, -1}, 
+	{ 4, 8, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1}, 
+	{ 9, 11, 8, 11, 10, 8, -1, -1, -1, -1, -1, -1, -1, -1, -1}, 
+	{ 3, 0, 9, 3, 9, 10, 10, 9, 11, -1, -1, -1, -1, -1, -1}, 
+	{ 0, 1, 11, 0, 11, 8, 8, 11, 10, -1, -1, -1, -1, -1, -1}, 
+	{ 3, 1, 11, 10, 3, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1}, 
+	{ 1, 2, 10, 1, 10, 9, 9, 10, 8, -1, -1, -1, -1, -1, -1}, 
+	{ 1, 0, 9, 2, 10, 3, -1, -1, -1, -1, -1, -1, -1, -1, -1}, 
+	{ 0, 2, 10, 8, 0, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1}, 
+	{ 3, 2, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1}, 
+	{ 2, 3, 8, 2, 8, 11, 11, 8, 9, -1, -1, -1, -1, -1, -1}, 
+	{ 9, 11, 2, 0, 9, 2, -1, -1, -1, -1, -1, -1, -1, -1, -1}, 
+	{ 0, 3, 8, 1, 11, 2, -1, -1, -1, -1, -1, -1, -1, -1, -1}, 
+	{ 1, 11, 2, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1}, 
+	{ 1, 3, 8, 9, 1, 8, -1, -1, -1, -1, -1, -1, -1, -1, -1}, 
+	{ 0, 9, 1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1}, 
+	{ 0, 3, 8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1}, 
+	{ 0, 3, 8, 11, 1, 2, 6, 10, 7, 4, 9, 5, -1, -1, -1 }
+// 	{ -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1}
+};
+
+ATEN_USING_NAMESPACE
+
+// Return central difference of block values at the specified point along the specified axis
+static inline double centralDifference(const double* values, const Vec3<int>& nLocal, Vec3<int> point, int axis)
+{
+	++point[axis];
+	double next = values[((point.x+1)*nLocal.y+point.y+1)*nLocal.z+point.z+1];
+	point[axis] -= 2;
+	return next - values[((point.x+1)*nLocal.y+point.y+1)*nLocal.z+point.z+1];
+}
+
+// Copy values of the points of a block (including its border) from contiguous grid data, via the supplied point index maps
+template <class T> static void loadBlockValues(const T* data, Vec3<int> nPoints, int* pointIndex[3], Vec3<int> origin, Vec3<int> nLocal, double* values)
+{
+	for (int i=0; i<nLocal.x; ++i)
+	{
+		const T* dataX = &data[pointIndex[0][origin.x+i]*nPoints.y*nPoints.z];
+		for (int j=0; j<nLocal.y; ++j)
+		{
+			const T* dataXY = &dataX[pointIndex[1][origin.y+j]*nPoints.z];
+			for (int k=0; k<nLocal.z; ++k) values[(i*nLocal.y+j)*nLocal.z+k] = dataXY[pointIndex[2][origin.z+k]];
+		}
+	}
+}
+
+/*
+ * Isosurface Block
+ */
+
+// Constructor
+IsosurfaceBlock::IsosurfaceBlock()
+{
+	positions.setChunkIncrement(SMALLCHUNKSIZE);
+	normals.setChunkIncrement(SMALLCHUNKSIZE);
+	values.setChunkIncrement(SMALLCHUNKSIZE);
+	edgeKeys.setChunkIncrement(SMALLCHUNKSIZE);
+	triangles.setChunkIncrement(SMALLCHUNKSIZE);
+	wholeCubes.setChunkIncrement(SMALLCHUNKSIZE);
+}
+
+// Clear all data
+void IsosurfaceBlock::clear()
+{
+	positions.clear();
+	normals.clear();
+	values.clear();
+	edgeKeys.clear();
+	triangles.clear();
+	wholeCubes.clear();
+}
+
+/*
+ * Isosurface
+ */
+
+// Constructor
+Isosurface::Isosurface()
+{
+	// Private variables
+	blockSize_ = 16;
+	nBlocks_ = 0;
+	nSkippedBlocks_ = 0;
+}
+
+// Destructor
+Isosurface::~Isosurface()
+{
+}
+
+/*
+ * Mesh
+ */
+
+// Clear mesh
+void Isosurface::clear()
+{
+	positions_.clear();
+	normals_.clear();
+	values_.clear();
+	triangles_.clear();
+	wholeCubes_.clear();
+}
+
+// Return number of vertices in mesh
+int Isosurface::nVertices() const
+{
+	return values_.nItems();
+}
+
+// Return vertex positions
+float* Isosurface::positions()
+{
+	return positions_.array();
+}
+
+// Return vertex normals
+float* Isosurface::normals()
+{
+	return normals_.array();
+}
+
+// Return data values at vertices
+float* Isosurface::values()
+{
+	return values_.array();
+}
+
+// Return number of triangles in mesh
+int Isosurface::nTriangles() const
+{
+	return triangles_.nItems() / 3;
+}
+
+// Return triangle vertex indices
+int* Isosurface::triangles()
+{
+	return triangles_.array();
+}
+
+// Return number of cubes lying entirely within the cutoffs
+int Isosurface::nWholeCubes() const
+{
+	return wholeCubes_.nItems() / 3;
+}
+
+// Return lower-left corners of cubes lying entirely within the cutoffs
+int* Isosurface::wholeCubes()
+{
+	return wholeCubes_.array();
+}
+
+/*
+ * Extraction
+ */
+
+// Set number of cubes along each side of an extraction block
+void Isosurface::setBlockSize(int size)
+{
+	blockSize_ = (size < 1 ? 1 : size);
+}
+
+// Return number of blocks considered in last extraction
+int Isosurface::nBlocks() const
+{
+	return nBlocks_;
+}
+
+// Return number of blocks skipped in last extraction
+int Isosurface::nSkippedBlocks() const
+{
+	return nSkippedBlocks_;
+}
+
+// Extract surface enclosing values between the cutoffs supplied, over the specified number of threads
+bool Isosurface::extract(Grid* source, double lowerCutoff, double upperCutoff, bool findWholeCubes, int nThreads)
+{
+	Messenger::enter("Isosurface::extract");
+
+	clear();
+	nBlocks_ = 0;
+	nSkippedBlocks_ = 0;
+
+	// Grid values may be held in either double or single precision
+	const double* data = source->voxels();
+	const float* floatData = source->floatVoxels();
+	if ((data == NULL) && (floatData == NULL))
+	{
+		Messenger::print("Grid contains no 3D data from which to extract a surface.");
+		Messenger::exit("Isosurface::extract");
+		return false;
+	}
+
+	Vec3<int> nPoints = source->nXYZ(), shift = source->shift();
+	Vec3<int> dirs = source->axisLoopOrder(), signs = source->axisLoopSigns();
+	bool periodic = source->periodic();
+	int n, axis;
+
+	// Determine the range of cubes to consider - a periodic grid wraps around at its edges, while a non-periodic one
+	// loses its outermost cubes so that gradients can be calculated at every corner
+	Vec3<int> firstCube, nCubes, nBlocks;
+	for (axis=0; axis<3; ++axis)
+	{
+		firstCube[axis] = (periodic ? 0 : 1);
+		nCubes[axis] = (periodic ? nPoints[axis] : nPoints[axis]-3);
+		if (nCubes[axis] < 1)
+		{
+			Messenger::exit("Isosurface::extract");
+			return true;
+		}
+		nBlocks[axis] = (nCubes[axis] + blockSize_ - 1) / blockSize_;
+	}
+	nBlocks_ = nBlocks.x * nBlocks.y * nBlocks.z;
+
+	// Map grid points (from one before the first cube to two after the last) onto data indices, wrapping and shifting as necessary
+	Array<int> pointIndices[3];
+	int* pointIndex[3];
+	for (axis=0; axis<3; ++axis)
+	{
+		pointIndices[axis].createEmpty(nCubes[axis]+3);
+		pointIndex[axis] = pointIndices[axis].array();
+		for (n=0; n<nCubes[axis]+3; ++n) pointIndex[axis][n] = (((firstCube[axis] + n - 1 - shift[axis]) % nPoints[axis]) + nPoints[axis]) % nPoints[axis];
+	}
+
+	// Get distances between grid points
+	Vec3<double> twoDelta = source->lengths();
+	twoDelta.x *= 2.0 / nPoints.x;
+	twoDelta.y *= 2.0 / nPoints.y;
+	twoDelta.z *= 2.0 / nPoints.z;
+
+	// Dimensions of global point coordinates, used to generate unique keys for edges on block faces
+	Vec3<qint64> keyDims(firstCube.x+nCubes.x+1, firstCube.y+nCubes.y+1, firstCube.z+nCubes.z+1);
+
+	// Working space for each thread - data values for the points of a block (plus a border for gradients), and vertex indices for its edges
+	nThreads = ThreadPool::threadCount(nThreads);
+	Vec3<int> edgeDims;
+	for (axis=0; axis<3; ++axis) edgeDims[axis] = (nCubes[axis] < blockSize_ ? nCubes[axis] : blockSize_) + 1;
+	int nEdges = edgeDims.x*edgeDims.y*edgeDims.z*3;
+	Array<double>* threadValues = new Array<double>[nThreads];
+	Array<int>* threadEdgeVertices = new Array<int>[nThreads];
+	for (n=0; n<nThreads; ++n)
+	{
+		threadValues[n].createEmpty((edgeDims.x+2)*(edgeDims.y+2)*(edgeDims.z+2));
+		threadEdgeVertices[n].createEmpty(nEdges);
+	}
+
+	// Make sure the octree over the grid data is up to date before it is used by the threads
+	GridOctree& tree = source->octree();
+
+	// Generate surface over blocks in parallel, ordered along the axis loop order and signs of the grid (so that the triangle order is suitable for transparency)
+	IsosurfaceBlock* blocks = new IsosurfaceBlock[nBlocks_];
+	Array<int> skippedBlocks;
+	skippedBlocks.createEmpty(nBlocks_, 0);
+	int* skipped = skippedBlocks.array();
+	ThreadPool::run(nBlocks_, nThreads, [&](int task, int thread)
+	{
+		IsosurfaceBlock& block = blocks[task];
+		Vec3<int> origin, size, nLocal, local, lower, upper, global;
+		int i, j, k, m, a, b, c, cubeType, edge, edgeAxis = 0, vertex, *faces;
+		double value, minimum, maximum, valueA, valueB, ipol;
+		Vec3<double> gradientA, gradientB, normal;
+
+		// Determine block indices from the task, then the origin and extent of the block in cubes
+		origin[dirs.z] = task % nBlocks[dirs.z];
+		origin[dirs.y] = (task / nBlocks[dirs.z]) % nBlocks[dirs.y];
+		origin[dirs.x] = task / (nBlocks[dirs.z] * nBlocks[dirs.y]);
+		if (signs.x == -1) origin[dirs.x] = nBlocks[dirs.x] - 1 - origin[dirs.x];
+		if (signs.y == -1) origin[dirs.y] = nBlocks[dirs.y] - 1 - origin[dirs.y];
+		if (signs.z == -1) origin[dirs.z] = nBlocks[dirs.z] - 1 - origin[dirs.z];
+		for (m=0; m<3; ++m)
+		{
+			origin[m] *= blockSize_;
+			size[m] = (nCubes[m] - origin[m] < blockSize_ ? nCubes[m] - origin[m] : blockSize_);
+			nLocal[m] = size[m] + 3;
+		}
+
+		// Get limits on the values at the corners of the block's cubes from the octree
+		tree.bounds(firstCube + origin - shift, firstCube + origin - shift + size, minimum, maximum);
+
+		// If no corner lies within the cutoffs the block is empty, and if all do it contains only whole cubes
+		if ((maximum < lowerCutoff) || (minimum > upperCutoff))
+		{
+			skipped[task] = 1;
+			return;
+		}
+		if ((minimum >= lowerCutoff) && (maximum <= upperCutoff))
+		{
+			skipped[task] = 1;
+			if (!findWholeCubes) return;
+			for (i=0; i<size.x; ++i)
+			{
+				for (j=0; j<size.y; ++j)
+				{
+					for (k=0; k<size.z; ++k)
+					{
+						block.wholeCubes.add(firstCube.x+origin.x+i);
+						block.wholeCubes.add(firstCube.y+origin.y+j);
+						block.wholeCubes.add(firstCube.z+origin.z+k);
+					}
+				}
+			}
+			return;
+		}
+
+		// Load values for the block
+		double* values = threadValues[thread].array();
+		if (floatData != NULL) loadBlockValues(floatData, nPoints, pointIndex, origin, nLocal, values);
+		else loadBlockValues(data, nPoints, pointIndex, origin, nLocal, values);
+
+		// Reset vertex indices for block edges
+		int* edgeVertices = threadEdgeVertices[thread].array();
+		for (m=0; m<nEdges; ++m) edgeVertices[m] = -1;
+
+		// Loop over cubes in the block, ordered in the same way as the blocks themselves
+		for (a=0; a<size[dirs.x]; ++a)
+		{
+			local[dirs.x] = (signs.x == 1 ? a : size[dirs.x]-1-a);
+			for (b=0; b<size[dirs.y]; ++b)
+			{
+				local[dirs.y] = (signs.y == 1 ? b : size[dirs.y]-1-b);
+				for (c=0; c<size[dirs.z]; ++c)
+				{
+					local[dirs.z] = (signs.z == 1 ? c : size[dirs.z]-1-c);
+
+					// Determine cube type
+					cubeType = 0;
+					for (m=0; m<8; ++m)
+					{
+						value = values[((local.x+vertexPos[m][0]+1)*nLocal.y+local.y+vertexPos[m][1]+1)*nLocal.z+local.z+vertexPos[m][2]+1];
+						if ((value >= lowerCutoff) && (value <= upperCutoff)) cubeType += 1 << m;
+					}
+
+					// Quick checks for 'empty' and 'whole' cubes
+					if (cubeType == 0) continue;
+					if (cubeType == 255)
+					{
+						if (!findWholeCubes) continue;
+						block.wholeCubes.add(firstCube.x+origin.x+local.x);
+						block.wholeCubes.add(firstCube.y+origin.y+local.y);
+						block.wholeCubes.add(firstCube.z+origin.z+local.z);
+						continue;
+					}
+
+					// Get edges from list, creating vertices for those not already visited
+					faces = facetriples[cubeType];
+					for (m=0; m<15; ++m)
+					{
+						if (faces[m] == -1) break;
+
+						// Get lower point of edge, and the axis along which it lies
+						for (i=0; i<3; ++i)
+						{
+							j = vertexPos[edgevertices[faces[m]][0]][i];
+							k = vertexPos[edgevertices[faces[m]][1]][i];
+							lower[i] = local[i] + (j < k ? j : k);
+							if (j != k) edgeAxis = i;
+						}
+						edge = ((lower.x*edgeDims.y+lower.y)*edgeDims.z+lower.z)*3+edgeAxis;
+						vertex = edgeVertices[edge];
+						if (vertex == -1)
+						{
+							upper = lower;
+							++upper[edgeAxis];
+
+							// Interpolate position along edge and gradient between its ends
+							valueA = values[((lower.x+1)*nLocal.y+lower.y+1)*nLocal.z+lower.z+1];
+							valueB = values[((upper.x+1)*nLocal.y+upper.y+1)*nLocal.z+upper.z+1];
+							ipol = (valueB == valueA ? 0.5 : (lowerCutoff - valueA) / (valueB - valueA));
+							if (ipol > 1.0) ipol = 1.0;
+							if (ipol < 0.0) ipol = 0.0;
+							for (i=0; i<3; ++i)
+							{
+								gradientA[i] = centralDifference(values, nLocal, lower, i) / twoDelta[i];
+								gradientB[i] = centralDifference(values, nLocal, upper, i) / twoDelta[i];
+							}
+							normal = -(gradientA + (gradientB - gradientA) * ipol);
+							normal.normalise();
+
+							vertex = block.values.nItems();
+							edgeVertices[edge] = vertex;
+							for (i=0; i<3; ++i)
+							{
+								block.positions.add(firstCube[i] + origin[i] + lower[i] + (i == edgeAxis ? ipol : 0.0));
+								block.normals.add(normal[i]);
+							}
+							block.values.add((valueA + valueB) * 0.5);
+
+							// Edges on the faces of the block may be shared with neighbouring blocks, so store a key for them
+							if (((edgeAxis != 0) && ((lower.x == 0) || (lower.x == size.x))) || ((edgeAxis != 1) && ((lower.y == 0) || (lower.y == size.y))) || ((edgeAxis != 2) && ((lower.z == 0) || (lower.z == size.z))))
+							{
+								global = firstCube + origin + lower;
+								block.edgeKeys.add(((global.x*keyDims.y + global.y)*keyDims.z + global.z)*3 + edgeAxis);
+							}
+							else block.edgeKeys.add(-1);
+						}
+						block.triangles.add(vertex);
+					}
+				}
+			}
+		}
+	});
+	delete[] threadValues;
+	delete[] threadEdgeVertices;
+
+	// Merge block meshes in order, welding vertices on shared block faces
+	int nTotalVertices = 0, nTriangleIndices = 0, nWholeCubeIndices = 0;
+	for (n=0; n<nBlocks_; ++n)
+	{
+		nTotalVertices += blocks[n].values.nItems();
+		nTriangleIndices += blocks[n].triangles.nItems();
+		nWholeCubeIndices += blocks[n].wholeCubes.nItems();
+		nSkippedBlocks_ += skipped[n];
+	}
+	positions_.reserve(nTotalVertices*3);
+	normals_.reserve(nTotalVertices*3);
+	values_.reserve(nTotalVertices);
+	triangles_.reserve(nTriangleIndices);
+	wholeCubes_.reserve(nWholeCubeIndices);
+	QHash<qint64,int> sharedVertices;
+	Array<int> globalIndices;
+	for (n=0; n<nBlocks_; ++n)
+	{
+		IsosurfaceBlock& block = blocks[n];
+		globalIndices.forgetData();
+		for (int m=0; m<block.values.nItems(); ++m)
+		{
+			qint64 key = block.edgeKeys[m];
+			if (key != -1)
+			{
+				QHash<qint64,int>::const_iterator it = sharedVertices.constFind(key);
+				if (it != sharedVertices.constEnd())
+				{
+					globalIndices.add(it.value());
+					continue;
+				}
+				sharedVertices.insert(key, values_.nItems());
+			}
+			globalIndices.add(values_.nItems());
+			for (int i=0; i<3; ++i)
+			{
+				positions_.add(block.positions[m*3+i]);
+				normals_.add(block.normals[m*3+i]);
+			}
+			values_.add(block.values[m]);
+		}
+		for (int m=0; m<block.triangles.nItems(); ++m) triangles_.add(globalIndices[block.triangles[m]]);
+		for (int m=0; m<block.wholeCubes.nItems(); ++m) wholeCubes_.add(block.wholeCubes[m]);
+	}
+	delete[] blocks;
+
+	Messenger::print(Messenger::Verbose, "Isosurface contains %i vertices and %i triangles (%i of %i blocks skipped).", nVertices(), nTriangles(), nSkippedBlocks_, nBlocks_);
+
+	Messenger::exit("Isosurface::extract");
+	return true;
+}
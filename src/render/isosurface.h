@@ -0,0 +1,122 @@
+/*
+	*** Isosurface extraction
+	*** src/render/isosurface.h
+	Copyright T. Youngs 2007-2017
+
+	This file is part of Aten.
+
+	Aten is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Aten is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Aten.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef ATEN_ISOSURFACE_H
+#define ATEN_ISOSURFACE_H
+
+#include "templates/array.h"
+#include "templates/vector3.h"
+#include "base/namespace.h"
+#include <QtGlobal>
+
+ATEN_BEGIN_NAMESPACE
+
+// Forward Declarations (Aten)
+class Grid;
+
+// Isosurface Block
+// Mesh generated from a single block of grid cubes, with vertices numbered locally
+class IsosurfaceBlock
+{
+	public:
+	// Constructor
+	IsosurfaceBlock();
+	// Vertex positions, normals (x,y,z for each vertex) and data values
+	Array<float> positions, normals, values;
+	// Global edge keys of vertices lying on the faces of the block (or -1 for interior vertices)
+	Array<qint64> edgeKeys;
+	// Triangle vertex indices (local to the block)
+	Array<int> triangles;
+	// Lower-left corners (x,y,z) of cubes lying entirely within the cutoffs
+	Array<int> wholeCubes;
+	// Clear all data
+	void clear();
+};
+
+// Isosurface
+// Indexed triangle mesh enclosing grid values between two cutoffs, generated with marching cubes over independent blocks of the grid
+class Isosurface
+{
+	public:
+	// Constructor / Destructor
+	Isosurface();
+	~Isosurface();
+
+
+	/*
+	 * Mesh
+	 */
+	private:
+	// Vertex positions (x,y,z for each vertex, in grid point units)
+	Array<float> positions_;
+	// Vertex normals (x,y,z for each vertex)
+	Array<float> normals_;
+	// Data values at vertices
+	Array<float> values_;
+	// Triangle vertex indices
+	Array<int> triangles_;
+	// Lower-left corners (x,y,z) of cubes lying entirely within the cutoffs
+	Array<int> wholeCubes_;
+
+	public:
+	// Clear mesh
+	void clear();
+	// Return number of vertices in mesh
+	int nVertices() const;
+	// Return vertex positions
+	float* positions();
+	// Return vertex normals
+	float* normals();
+	// Return data values at vertices
+	float* values();
+	// Return number of triangles in mesh
+	int nTriangles() const;
+	// Return triangle vertex indices
+	int* triangles();
+	// Return number of cubes lying entirely within the cutoffs
+	int nWholeCubes() const;
+	// Return lower-left corners of cubes lying entirely within the cutoffs
+	int* wholeCubes();
+
+
+	/*
+	 * Extraction
+	 */
+	private:
+	// Number of cubes along each side of an extraction block
+	int blockSize_;
+	// Number of blocks considered, and number skipped, in last extraction
+	int nBlocks_, nSkippedBlocks_;
+
+	public:
+	// Set number of cubes along each side of an extraction block
+	void setBlockSize(int size);
+	// Return number of blocks considered in last extraction
+	int nBlocks() const;
+	// Return number of blocks skipped in last extraction
+	int nSkippedBlocks() const;
+	// Extract surface enclosing values between the cutoffs supplied, over the specified number of threads
+	bool extract(Grid* source, double lowerCutoff, double upperCutoff, bool findWholeCubes, int nThreads);
+};
+
+ATEN_END_NAMESPACE
+
+#endif